@@ -0,0 +1,33 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency.hpp
+/// @brief Master include file of the Idlib concurrency library.
+/// @author Michael Heilmann
+
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE (1)
+
+#include "idlib/concurrency/mpsc_queue.hpp"
+#include "idlib/concurrency/task_group.hpp"
+#include "idlib/concurrency/thread_pool.hpp"
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
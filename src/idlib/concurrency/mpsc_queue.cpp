@@ -0,0 +1,76 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency/mpsc_queue.cpp
+/// @brief An intrusive, lock-free multiple-producer single-consumer queue.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/concurrency/mpsc_queue.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/concurrency/header.in"
+
+mpsc_queue::mpsc_queue() noexcept
+    : m_head(&m_stub), m_tail(&m_stub), m_stub()
+{}
+
+void mpsc_queue::push(mpsc_queue_hook *element) noexcept
+{
+    element->next.store(nullptr, std::memory_order_relaxed);
+    mpsc_queue_hook *previous = m_head.exchange(element, std::memory_order_acq_rel);
+    // (*) Between the exchange and this store, the queue is disconnected and the consumer sees fewer elements.
+    previous->next.store(element, std::memory_order_release);
+}
+
+mpsc_queue_hook *mpsc_queue::pop() noexcept
+{
+    mpsc_queue_hook *tail = m_tail;
+    mpsc_queue_hook *next = tail->next.load(std::memory_order_acquire);
+    // Skip the stub.
+    if (tail == &m_stub)
+    {
+        if (nullptr == next)
+        {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (nullptr != next)
+    {
+        m_tail = next;
+        return tail;
+    }
+    // The tail is the last element or a producer is at (*).
+    if (tail != m_head.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    // The tail is the last element: push the stub such that the tail can be removed.
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (nullptr != next)
+    {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+#include "idlib/concurrency/footer.in"
@@ -0,0 +1,84 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency/mpsc_queue.hpp
+/// @brief An intrusive, lock-free multiple-producer single-consumer queue.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/concurrency/header.in"
+
+/// @brief The hook of an element of an id::mpsc_queue.
+/// Types of elements of an id::mpsc_queue derive from this type.
+struct mpsc_queue_hook
+{
+    /// @brief A pointer to the successor of this element or a null pointer.
+    std::atomic<mpsc_queue_hook *> next;
+
+    mpsc_queue_hook() noexcept
+        : next(nullptr)
+    {}
+
+    mpsc_queue_hook(const mpsc_queue_hook&) = delete; // Do not allow copying.
+    const mpsc_queue_hook& operator=(const mpsc_queue_hook&) = delete; // Do not allow copying.
+
+}; // struct mpsc_queue_hook
+
+/// @brief An intrusive, lock-free multiple-producer single-consumer queue.
+/// @detail
+/// Any number of threads may push elements concurrently. Pushing is wait-free (a single atomic exchange).
+/// Only one thread at a time may pop elements. The queue does not own its elements.
+/// @remark The algorithm is Dmitry Vyukov's intrusive MPSC node-based queue.
+class mpsc_queue
+{
+private:
+    /// @brief The most recently pushed element.
+    std::atomic<mpsc_queue_hook *> m_head;
+    /// @brief The least recently pushed element (only accessed by the consumer).
+    mpsc_queue_hook *m_tail;
+    /// @brief The stub element.
+    mpsc_queue_hook m_stub;
+
+public:
+    /// @brief Construct this queue.
+    /// @post The queue is empty.
+    mpsc_queue() noexcept;
+
+    mpsc_queue(const mpsc_queue&) = delete; // Do not allow copying.
+    const mpsc_queue& operator=(const mpsc_queue&) = delete; // Do not allow copying.
+
+    /// @brief Push an element.
+    /// @param element a pointer to the element
+    /// @remark May be invoked by any thread.
+    void push(mpsc_queue_hook *element) noexcept;
+
+    /// @brief Pop an element.
+    /// @return a pointer to the element, a null pointer if the queue is empty
+    /// @remark Must only be invoked by one thread at a time.
+    /// A null pointer may also be returned if a concurrent push has not completed yet.
+    mpsc_queue_hook *pop() noexcept;
+
+}; // class mpsc_queue
+
+#include "idlib/concurrency/footer.in"
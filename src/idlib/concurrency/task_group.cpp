@@ -0,0 +1,75 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency/task_group.cpp
+/// @brief A group of tasks whose completion can be awaited.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/concurrency/task_group.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/concurrency/header.in"
+
+task_group::task_group() noexcept
+    : m_count(0), m_exception(), m_mutex(), m_condition()
+{}
+
+task_group::~task_group()
+{
+    assert(0 == m_count);
+}
+
+void task_group::add(size_t count) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_count += count;
+}
+
+void task_group::done(std::exception_ptr exception) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (exception && !m_exception)
+    {
+        m_exception = exception;
+    }
+    if (0 == --m_count)
+    {
+        // Notify while holding the lock: a waiter may destroy this group as soon as it observes a count of zero.
+        m_condition.notify_all();
+    }
+}
+
+void task_group::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return 0 == m_count; });
+    if (m_exception)
+    {
+        std::exception_ptr exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+bool task_group::is_done() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return 0 == m_count;
+}
+
+#include "idlib/concurrency/footer.in"
@@ -0,0 +1,82 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency/task_group.hpp
+/// @brief A group of tasks whose completion can be awaited.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/concurrency/header.in"
+
+/// @brief A group of tasks whose completion can be awaited.
+/// @detail
+/// A task is added to the group by id::task_group::add before it is started and
+/// is removed from the group by id::task_group::done when it has completed.
+/// id::task_group::wait blocks until all tasks of the group have completed.
+/// @remark Non-copyable.
+class task_group
+{
+private:
+    /// @brief The number of incomplete tasks.
+    size_t m_count;
+    /// @brief The first exception raised by a task of this group or a null pointer.
+    std::exception_ptr m_exception;
+    /// @brief The mutex.
+    mutable std::mutex m_mutex;
+    /// @brief The condition variable signaled when the count becomes zero.
+    std::condition_variable m_condition;
+
+public:
+    task_group(const task_group&) = delete; // Do not allow copying.
+    const task_group& operator=(const task_group&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this task group.
+    /// @post The group has no tasks.
+    task_group() noexcept;
+
+    /// @brief Destruct this task group.
+    /// @pre The group has no incomplete tasks.
+    ~task_group();
+
+public:
+    /// @brief Add tasks to this group.
+    /// @param count the number of tasks
+    void add(size_t count = 1) noexcept;
+
+    /// @brief Mark a task of this group as completed.
+    /// @param exception the exception raised by the task or a null pointer
+    void done(std::exception_ptr exception = nullptr) noexcept;
+
+    /// @brief Wait until all tasks of this group have completed.
+    /// @throw the first exception raised by a task of this group (the exception is cleared)
+    void wait();
+
+    /// @brief Get if all tasks of this group have completed.
+    /// @return @a true if all tasks of this group have completed, @a false otherwise
+    bool is_done() const noexcept;
+
+}; // class task_group
+
+#include "idlib/concurrency/footer.in"
@@ -0,0 +1,177 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency/thread_pool.cpp
+/// @brief A work-stealing thread pool.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/concurrency/thread_pool.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/concurrency/header.in"
+
+namespace {
+
+/// @brief The pool of the calling worker thread or a null pointer.
+thread_local const thread_pool *g_current_pool = nullptr;
+/// @brief The index of the calling worker thread.
+thread_local size_t g_current_index = 0;
+
+} // namespace
+
+thread_pool::thread_pool(size_t number_of_threads)
+    : m_queues(), m_threads(), m_pending(0), m_next(0), m_mutex(), m_condition(), m_stop(false)
+{
+    if (0 == number_of_threads)
+    {
+        number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < number_of_threads; ++i)
+    {
+        m_queues.push_back(std::make_unique<queue>());
+    }
+    try
+    {
+        for (size_t i = 0; i < number_of_threads; ++i)
+        {
+            m_threads.emplace_back([this, i]() { run(i); });
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        throw;
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+thread_pool& thread_pool::shared()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+size_t thread_pool::size() const noexcept
+{
+    return m_threads.size();
+}
+
+bool thread_pool::is_worker() const noexcept
+{
+    return this == g_current_pool;
+}
+
+void thread_pool::post(internal::thread_pool_task *task)
+{
+    size_t index = is_worker() ? g_current_index
+                               : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    // Increment the number of pending tasks before the task can be taken.
+    m_pending.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        try
+        {
+            m_queues[index]->tasks.push_back(task);
+        }
+        catch (...)
+        {
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            delete task;
+            throw;
+        }
+    }
+    // Acquire the mutex such that a worker can not miss the increment between checking and sleeping.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_one();
+}
+
+internal::thread_pool_task *thread_pool::take(size_t index) noexcept
+{
+    // Take the most recently added task from the own queue.
+    {
+        queue& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            auto *task = own.tasks.back();
+            own.tasks.pop_back();
+            return task;
+        }
+    }
+    // Steal the least recently added task from the queue of another worker.
+    for (size_t i = 1; i < m_queues.size(); ++i)
+    {
+        queue& other = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty())
+        {
+            auto *task = other.tasks.front();
+            other.tasks.pop_front();
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void thread_pool::run(size_t index)
+{
+    g_current_pool = this;
+    g_current_index = index;
+    while (true)
+    {
+        internal::thread_pool_task *task = take(index);
+        if (nullptr != task)
+        {
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            task->run();
+            delete task;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_stop || 0 != m_pending.load(std::memory_order_acquire); });
+        if (m_stop && 0 == m_pending.load(std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+    g_current_pool = nullptr;
+}
+
+#include "idlib/concurrency/footer.in"
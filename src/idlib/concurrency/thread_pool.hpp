@@ -0,0 +1,198 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/concurrency/thread_pool.hpp
+/// @brief A work-stealing thread pool.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/concurrency/task_group.hpp"
+
+#include "idlib/concurrency/header.in"
+
+namespace internal {
+
+/// @brief A task of an id::thread_pool.
+struct thread_pool_task
+{
+    virtual ~thread_pool_task()
+    {}
+
+    /// @brief Run this task.
+    /// @remark Must not raise exceptions.
+    virtual void run() noexcept = 0;
+
+}; // struct thread_pool_task
+
+/// @brief A thread pool task wrapping a function.
+template <class Function>
+struct function_thread_pool_task : thread_pool_task
+{
+    Function function;
+
+    template <class Argument>
+    explicit function_thread_pool_task(Argument&& argument)
+        : thread_pool_task(), function(std::forward<Argument>(argument))
+    {}
+
+    void run() noexcept override
+    {
+        function();
+    }
+
+}; // struct function_thread_pool_task
+
+} // namespace internal
+
+/// @brief A work-stealing thread pool.
+/// @detail
+/// Each worker thread owns a task queue. A task posted by a worker thread is added to the queue of that worker
+/// and the worker takes the most recently added task from its own queue first (good cache locality for
+/// tasks posting tasks). A task posted by any other thread is added to the queues in round-robin order.
+/// A worker whose queue is empty steals the least recently added task from the queues of the other workers.
+/// Idle workers sleep until tasks are posted.
+///
+/// The pool is not specific to any library: id::thread_pool::shared provides a process-wide pool which
+/// is used by Idlib subsystems unless a pool is specified explicitly.
+/// @remark Non-copyable.
+class thread_pool
+{
+private:
+    /// @brief The queue of a worker.
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<internal::thread_pool_task *> tasks;
+    };
+
+    /// @brief The queues of the workers.
+    std::vector<std::unique_ptr<queue>> m_queues;
+    /// @brief The workers.
+    std::vector<std::thread> m_threads;
+    /// @brief The number of queued tasks.
+    std::atomic<size_t> m_pending;
+    /// @brief The index of the queue to add the next task from a non-worker thread to.
+    std::atomic<size_t> m_next;
+    /// @brief The mutex guarding sleeping and stopping.
+    std::mutex m_mutex;
+    /// @brief The condition variable on which idle workers sleep.
+    std::condition_variable m_condition;
+    /// @brief If the workers should stop.
+    bool m_stop;
+
+public:
+    thread_pool(const thread_pool&) = delete; // Do not allow copying.
+    const thread_pool& operator=(const thread_pool&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this thread pool.
+    /// @param number_of_threads the number of worker threads. If @a 0, the number of hardware threads is used.
+    explicit thread_pool(size_t number_of_threads = 0);
+
+    /// @brief Destruct this thread pool.
+    /// Queued tasks are run before the workers are joined.
+    ~thread_pool();
+
+public:
+    /// @brief Get the process-wide thread pool.
+    /// @return the process-wide thread pool
+    /// @remark The pool is created on first use with one worker per hardware thread.
+    static thread_pool& shared();
+
+    /// @brief Get the number of worker threads.
+    /// @return the number of worker threads
+    size_t size() const noexcept;
+
+    /// @brief Get if the calling thread is a worker thread of this pool.
+    /// @return @a true if the calling thread is a worker thread of this pool, @a false otherwise
+    bool is_worker() const noexcept;
+
+    /// @brief Post a function.
+    /// @param function the function. Must not raise exceptions.
+    template <class Function,
+              class = std::enable_if_t<!std::is_convertible<Function, internal::thread_pool_task *>::value>>
+    void post(Function&& function)
+    {
+        post(new internal::function_thread_pool_task<std::decay_t<Function>>(std::forward<Function>(function)));
+    }
+
+    /// @brief Post a function as a task of a task group.
+    /// @param group the task group
+    /// @param function the function. Exceptions raised by the function are passed to the task group.
+    template <class Function>
+    void post(task_group& group, Function&& function)
+    {
+        group.add();
+        try
+        {
+            post([&group, function = std::forward<Function>(function)]() mutable noexcept
+            {
+                try
+                {
+                    function();
+                    group.done();
+                }
+                catch (...)
+                {
+                    group.done(std::current_exception());
+                }
+            });
+        }
+        catch (...)
+        {
+            group.done();
+            throw;
+        }
+    }
+
+    /// @brief Submit a function.
+    /// @param function the function
+    /// @return a future of the result of the function
+    template <class Function>
+    auto submit(Function&& function) -> std::future<decltype(function())>
+    {
+        using result_type = decltype(function());
+        auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        post([task]() noexcept { (*task)(); });
+        return future;
+    }
+
+    /// @brief Post a task.
+    /// @param task a pointer to the task
+    /// @remark The pool takes ownership of the task.
+    void post(internal::thread_pool_task *task);
+
+private:
+    /// @brief The loop of a worker.
+    /// @param index the index of the worker
+    void run(size_t index);
+
+    /// @brief Take a task.
+    /// @param index the index of the worker
+    /// @return a pointer to the task or a null pointer
+    internal::thread_pool_task *take(size_t index) noexcept;
+
+}; // class thread_pool
+
+#include "idlib/concurrency/footer.in"
@@ -25,9 +25,38 @@
 #error(do not include directly, include `idlib/idlib.hpp` instead)
 #endif
 
+#include "idlib/file_system/access_advice.hpp"
 #include "idlib/file_system/access_mode.hpp"
+#include "idlib/file_system/aligned_buffer.hpp"
+#include "idlib/file_system/async_reader.hpp"
+#include "idlib/file_system/atomic_file_writer.hpp"
+#include "idlib/file_system/atomic_write_batch.hpp"
+#include "idlib/file_system/block_codec.hpp"
+#include "idlib/file_system/buffer.hpp"
+#include "idlib/file_system/buffered_reader.hpp"
+#include "idlib/file_system/buffered_writer.hpp"
+#include "idlib/file_system/compressed_file_reader.hpp"
+#include "idlib/file_system/compressed_file_writer.hpp"
+#include "idlib/file_system/content_hash.hpp"
+#include "idlib/file_system/direct_reader.hpp"
+#include "idlib/file_system/directory_entry.hpp"
+#include "idlib/file_system/directory_scanner.hpp"
+#include "idlib/file_system/directory_stream.hpp"
+#include "idlib/file_system/durability.hpp"
 #include "idlib/file_system/error.hpp"
 #include "idlib/file_system/file.hpp"
+#include "idlib/file_system/file_change.hpp"
+#include "idlib/file_system/file_watcher.hpp"
+#include "idlib/file_system/fingerprint_cache.hpp"
+#include "idlib/file_system/flush_mode.hpp"
 #include "idlib/file_system/mapped_file.hpp"
+#include "idlib/file_system/mapped_file_pool.hpp"
+#include "idlib/file_system/mapped_view.hpp"
+#include "idlib/file_system/mapped_view_cache.hpp"
+#include "idlib/file_system/open_flags.hpp"
+#include "idlib/file_system/pack_archive.hpp"
+#include "idlib/file_system/pack_builder.hpp"
+#include "idlib/file_system/virtual_file_system.hpp"
+#include "idlib/file_system/virtual_path.hpp"
 #include "idlib/file_system/working_directory.hpp"
 #include "idlib/file_system/directory_separator.hpp"
@@ -0,0 +1,68 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/access_advice.hpp
+/// @brief Access advice for memory mapped files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Advice on how a memory mapped file will be accessed.
+/// The advice is a hint to the operating system: it does not change the semantics of the mapping.
+enum class access_advice
+{
+    normal, ///< No specific advice (the default).
+    sequential, ///< The file will be accessed sequentially: read ahead aggressively, pages can be freed soon after access.
+    random, ///< The file will be accessed randomly: do not read ahead.
+    will_need, ///< The range will be accessed in the near future: start reading it.
+    dont_need, ///< The range will not be accessed in the near future: its pages can be freed.
+    huge_page, ///< Back the range by huge pages if possible.
+};
+
+/// @brief Options for mapping a file.
+/// Huge pages and NUMA placement are hints: mapping does not fail if they are not available.
+enum class map_flags : uint8_t
+{
+    none = 0, ///< No options.
+    populate = (1 << 0), ///< Read the whole file into memory and populate the page tables when the file is mapped.
+    huge_pages = (1 << 1), ///< Back the mapping by transparent huge pages if possible, reducing TLB misses of random accesses.
+    /// Read the file into private memory instead of mapping the page cache, backed by explicit (hugetlb) huge pages if
+    /// reserved and by transparent huge pages otherwise. Each process holds its own copy. Only applies when reading.
+    private_copy = (1 << 2),
+    /// Place the pages on the NUMA node of the calling thread.
+    /// Only applies to pages allocated for the mapping i.e. to private copies: the page cache is placed when it is read.
+    numa_local = (1 << 3),
+    /// Interleave the pages across the NUMA nodes the process may use.
+    /// Only applies to pages allocated for the mapping i.e. to private copies: the page cache is placed when it is read.
+    numa_interleave = (1 << 4),
+};
+
+#include "idlib/file_system/footer.in"
+
+inline id::file_system::map_flags operator|(id::file_system::map_flags lhs, id::file_system::map_flags rhs)
+{
+    return static_cast<id::file_system::map_flags>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+}
+
+inline id::file_system::map_flags operator&(id::file_system::map_flags lhs, id::file_system::map_flags rhs)
+{
+    return static_cast<id::file_system::map_flags>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+}
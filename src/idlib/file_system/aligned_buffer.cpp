@@ -0,0 +1,93 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/aligned_buffer.cpp
+/// @brief Aligned memory for direct input and output.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/aligned_buffer.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+aligned_buffer::aligned_buffer() noexcept :
+    m_data(nullptr), m_size(0), m_alignment(default_alignment)
+{}
+
+aligned_buffer::aligned_buffer(size_t size, size_t alignment) :
+    m_data(nullptr), m_size(0), m_alignment(alignment)
+{
+    if (0 == alignment || 0 != (alignment & (alignment - 1)))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid alignment: alignment is not a power of two");
+    }
+    if (0 != size)
+    {
+        m_data = static_cast<char *>(::operator new(size, std::align_val_t(alignment)));
+        m_size = size;
+    }
+}
+
+aligned_buffer::~aligned_buffer() noexcept
+{
+    if (m_data)
+    {
+        ::operator delete(m_data, std::align_val_t(m_alignment));
+    }
+}
+
+aligned_buffer::aligned_buffer(aligned_buffer&& other) noexcept :
+    m_data(other.m_data), m_size(other.m_size), m_alignment(other.m_alignment)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+aligned_buffer& aligned_buffer::operator=(aligned_buffer&& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_alignment, other.m_alignment);
+    return *this;
+}
+
+char *aligned_buffer::data() noexcept
+{
+    return m_data;
+}
+
+const char *aligned_buffer::data() const noexcept
+{
+    return m_data;
+}
+
+size_t aligned_buffer::size() const noexcept
+{
+    return m_size;
+}
+
+size_t aligned_buffer::alignment() const noexcept
+{
+    return m_alignment;
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,142 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/aligned_buffer.hpp
+/// @brief Aligned memory for direct input and output.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A buffer of Bytes aligned to a power of two.
+/// @detail Files opened with id::file_system::open_flags::direct require buffers, offsets, and lengths aligned to the
+/// logical block size of the device. The default alignment satisfies the requirements of common devices and file systems.
+/// Non-copyable.
+class aligned_buffer
+{
+public:
+    /// @brief The default alignment, in Bytes.
+    static constexpr size_t default_alignment = 4096;
+
+private:
+    /// @brief A pointer to the Bytes or a null pointer.
+    char *m_data;
+    /// @brief The size, in Bytes.
+    size_t m_size;
+    /// @brief The alignment, in Bytes.
+    size_t m_alignment;
+
+public:
+    /// @brief Construct this aligned buffer.
+    /// @post The buffer is empty.
+    aligned_buffer() noexcept;
+
+    /// @brief Construct this aligned buffer.
+    /// @param size the size, in Bytes
+    /// @param alignment the alignment, in Bytes. Must be a power of two.
+    /// @throw id::file_system::error the alignment is not a power of two
+    /// @throw std::bad_alloc an allocation failed
+    explicit aligned_buffer(size_t size, size_t alignment = default_alignment);
+
+    /// @brief Destruct this aligned buffer.
+    ~aligned_buffer() noexcept;
+
+    aligned_buffer(aligned_buffer&& other) noexcept;
+    aligned_buffer& operator=(aligned_buffer&& other) noexcept;
+
+    // Delete copy constructor.
+    aligned_buffer(const aligned_buffer&) = delete;
+
+    // Delete copy assignment operator.
+    aligned_buffer& operator=(const aligned_buffer&) = delete;
+
+public:
+    /// @brief Get a pointer to the Bytes.
+    /// @return a pointer to an array of size() Bytes
+    char *data() noexcept;
+
+    /// @brief Get a pointer to the Bytes.
+    /// @return a pointer to an array of size() Bytes
+    const char *data() const noexcept;
+
+    /// @brief Get the size, in Bytes.
+    /// @return the size, in Bytes
+    size_t size() const noexcept;
+
+    /// @brief Get the alignment, in Bytes.
+    /// @return the alignment, in Bytes
+    size_t alignment() const noexcept;
+
+}; // class aligned_buffer
+
+/// @brief An allocator allocating storage aligned to a power of two.
+/// @tparam T the value type
+/// @tparam Alignment the alignment, in Bytes. Must be a power of two not smaller than the alignment of @a T.
+template <class T, size_t Alignment = aligned_buffer::default_alignment>
+class aligned_allocator
+{
+    static_assert(0 == (Alignment & (Alignment - 1)), "alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment must not be smaller than the alignment of the value type");
+
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() noexcept
+    {}
+
+    template <class U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+    {}
+
+    T *allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T *p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <class U>
+    bool operator==(const aligned_allocator<U, Alignment>&) const noexcept
+    {
+        return true;
+    }
+
+    template <class U>
+    bool operator!=(const aligned_allocator<U, Alignment>&) const noexcept
+    {
+        return false;
+    }
+
+}; // class aligned_allocator
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,124 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/async_reader.cpp
+/// @brief Asynchronous reading of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/async_reader.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/async_reader_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/async_reader_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+async_reader::async_reader(size_t queue_depth, async_backend backend) :
+    m_pimpl()
+{
+    if (0 == queue_depth)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid queue depth: queue depth is zero");
+    }
+    m_pimpl = std::make_unique<async_reader_impl>(queue_depth, backend);
+}
+
+async_reader::~async_reader() noexcept
+{}
+
+async_backend async_reader::backend() const noexcept
+{
+    return m_pimpl->backend();
+}
+
+size_t async_reader::queue_depth() const noexcept
+{
+    return m_pimpl->queue_depth();
+}
+
+void async_reader::read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length, read_handler handler)
+{
+    m_pimpl->read(file_descriptor, offset, buffer, length, std::move(handler));
+}
+
+std::future<size_t> async_reader::read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length)
+{
+    auto promise = std::make_shared<std::promise<size_t>>();
+    auto future = promise->get_future();
+    m_pimpl->read(file_descriptor, offset, buffer, length, [promise](size_t result, std::exception_ptr error)
+    {
+        if (error)
+        {
+            promise->set_exception(error);
+        }
+        else
+        {
+            promise->set_value(result);
+        }
+    });
+    return future;
+}
+
+void async_reader::register_buffers(const std::vector<buffer>& buffers)
+{
+    m_pimpl->register_buffers(buffers);
+}
+
+void async_reader::unregister_buffers()
+{
+    m_pimpl->unregister_buffers();
+}
+
+void async_reader::read_fixed(file_descriptor& file_descriptor, size_t offset, size_t buffer_index, size_t buffer_offset,
+                              size_t length, read_handler handler)
+{
+    m_pimpl->read_fixed(file_descriptor, offset, buffer_index, buffer_offset, length, std::move(handler));
+}
+
+size_t async_reader::submit()
+{
+    return m_pimpl->submit();
+}
+
+size_t async_reader::poll()
+{
+    return m_pimpl->poll();
+}
+
+size_t async_reader::wait()
+{
+    return m_pimpl->wait();
+}
+
+size_t async_reader::pending() const noexcept
+{
+    return m_pimpl->pending();
+}
+
+#include "idlib/file_system/footer.in"
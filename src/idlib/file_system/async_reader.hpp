@@ -0,0 +1,165 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/async_reader.hpp
+/// @brief Asynchronous reading of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/buffer.hpp"
+#include "idlib/file_system/file.hpp"
+
+#include "idlib/file_system/header.in"
+
+// Forward declaration.
+class async_reader_impl;
+
+/// @brief The backend of an asynchronous reader.
+enum class async_backend
+{
+    /// @brief Use io_uring if available, the thread pool otherwise.
+    automatic,
+    /// @brief Submit the reads to an io_uring instance. Linux only.
+    io_uring,
+    /// @brief Perform positional reads on the shared thread pool.
+    /// Reads submitted by a worker thread of the shared thread pool are performed synchronously by that thread.
+    thread_pool,
+};
+
+/// @brief A handler invoked when a read completed.
+/// @detail The first argument is the number of Bytes read which is less than the requested number of Bytes only
+/// if the end of the file was reached. The second argument is a null pointer if the read succeeded and a pointer
+/// to an id::file_system::error otherwise.
+using read_handler = std::function<void(size_t, std::exception_ptr)>;
+
+/// @brief Reads files asynchronously.
+/// @detail
+/// Reads are queued by read() and submitted as a batch by submit(). Completed reads are reaped by poll() or wait()
+/// which invoke the handlers of the reads on the calling thread. Consequently, the future returned by read() is
+/// satisfied only once its read was reaped.
+/// @code
+/// id::file_system::async_reader reader;
+/// for (auto& file : files)
+/// {
+///     reader.read(file.descriptor, 0, file.buffer, file.size,
+///                 [&file](size_t n, std::exception_ptr e) { file.loaded(n, e); });
+/// }
+/// reader.wait();
+/// @endcode
+/// An asynchronous reader is not thread-safe.
+/// @remark The file descriptors and buffers of a read must remain valid until the read completed.
+class async_reader
+{
+public:
+    /// @brief A buffer to be registered.
+    using buffer = mutable_buffer;
+
+private:
+    /// @brief The pointer to the implementation.
+    std::unique_ptr<async_reader_impl> m_pimpl;
+
+public:
+    /// @brief Construct this asynchronous reader.
+    /// @param queue_depth the maximum number of reads in flight. Must be positive.
+    /// @param backend the backend
+    /// @throw id::file_system::error the queue depth is zero or the backend is not available
+    explicit async_reader(size_t queue_depth = 256, async_backend backend = async_backend::automatic);
+
+    /// @brief Destruct this asynchronous reader.
+    /// @remark Waits for the reads in flight to complete. Their handlers and the handlers of queued reads are not invoked.
+    ~async_reader() noexcept;
+
+    // Delete copy constructor.
+    async_reader(const async_reader&) = delete;
+
+    // Delete copy assignment operator.
+    async_reader& operator=(const async_reader&) = delete;
+
+public:
+    /// @brief Get the backend of this asynchronous reader.
+    /// @return the backend, either id::file_system::async_backend::io_uring or id::file_system::async_backend::thread_pool
+    async_backend backend() const noexcept;
+
+    /// @brief Get the maximum number of reads in flight.
+    /// @return the maximum number of reads in flight
+    size_t queue_depth() const noexcept;
+
+    /// @brief Queue a read.
+    /// @param file_descriptor the file descriptor
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @param handler the handler invoked when the read completed
+    /// @throw id::file_system::error the file descriptor is not open
+    void read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length, read_handler handler);
+
+    /// @brief Queue a read.
+    /// @param file_descriptor the file descriptor
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @return a future for the number of Bytes read
+    /// @throw id::file_system::error the file descriptor is not open
+    std::future<size_t> read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length);
+
+    /// @brief Register buffers for use with read_fixed().
+    /// @param buffers the buffers
+    /// @throw id::file_system::error reads are pending or the environment fails
+    /// @remark Registered buffers are pinned by the io_uring backend which avoids mapping them for each read.
+    void register_buffers(const std::vector<buffer>& buffers);
+
+    /// @brief Unregister the registered buffers.
+    /// @throw id::file_system::error reads are pending
+    void unregister_buffers();
+
+    /// @brief Queue a read into a registered buffer.
+    /// @param file_descriptor the file descriptor
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer_index the index of the registered buffer
+    /// @param buffer_offset the offset, in Bytes, in the registered buffer
+    /// @param length the number of Bytes to read
+    /// @param handler the handler invoked when the read completed
+    /// @throw id::file_system::error the file descriptor is not open or the range is not within the registered buffer
+    void read_fixed(file_descriptor& file_descriptor, size_t offset, size_t buffer_index, size_t buffer_offset,
+                    size_t length, read_handler handler);
+
+    /// @brief Submit the queued reads.
+    /// @return the number of reads submitted
+    /// @throw id::file_system::error the environment fails
+    /// @remark At most queue_depth() reads are in flight, the remaining reads stay queued.
+    size_t submit();
+
+    /// @brief Reap the completed reads without blocking.
+    /// @return the number of reads reaped
+    /// @throw id::file_system::error the environment fails
+    /// @remark Exceptions raised by handlers are propagated.
+    size_t poll();
+
+    /// @brief Submit the queued reads and block until all reads completed.
+    /// @return the number of reads reaped
+    /// @throw id::file_system::error the environment fails
+    /// @remark Exceptions raised by handlers are propagated.
+    size_t wait();
+
+    /// @brief Get the number of queued reads and reads in flight.
+    /// @return the number of queued reads and reads in flight
+    size_t pending() const noexcept;
+
+}; // class async_reader
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,506 @@
+#include "idlib/file_system/async_reader_linux.hpp"
+
+#if defined(ID_LINUX)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define IDLIB_PRIVATE 1
+#include "idlib/concurrency/thread_pool.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+#if defined(__NR_io_uring_setup)
+
+int io_uring_setup(unsigned entries, struct io_uring_params *parameters) noexcept
+{
+    return (int)syscall(__NR_io_uring_setup, entries, parameters);
+}
+
+int io_uring_enter(int ring, unsigned to_submit, unsigned minimum_completions, unsigned flags) noexcept
+{
+    return (int)syscall(__NR_io_uring_enter, ring, to_submit, minimum_completions, flags, nullptr, 0);
+}
+
+int io_uring_register(int ring, unsigned opcode, const void *arguments, unsigned number_of_arguments) noexcept
+{
+    return (int)syscall(__NR_io_uring_register, ring, opcode, arguments, number_of_arguments);
+}
+
+#else
+
+int io_uring_setup(unsigned, struct io_uring_params *) noexcept
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int io_uring_enter(int, unsigned, unsigned, unsigned) noexcept
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int io_uring_register(int, unsigned, const void *, unsigned) noexcept
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif
+
+std::exception_ptr make_read_error(int error)
+{
+    return std::make_exception_ptr(id::file_system::error(__FILE__, __LINE__, std::string("unable to read file: ") + strerror(error)));
+}
+
+} // namespace
+
+async_reader_impl::async_reader_impl(size_t queue_depth, async_backend backend) :
+    m_backend(async_backend::thread_pool), m_queue_depth(queue_depth), m_queued(), m_in_flight(0), m_buffers(),
+    m_ring(-1), m_sq_mapping(MAP_FAILED), m_sq_mapping_size(0), m_cq_mapping(MAP_FAILED), m_cq_mapping_size(0),
+    m_sqes((struct io_uring_sqe *)MAP_FAILED), m_sqes_size(0), m_to_submit(0), m_discarding(false), m_mutex(), m_condition(), m_completed()
+{
+    if (async_backend::thread_pool != backend)
+    {
+        if (setup_ring())
+        {
+            m_backend = async_backend::io_uring;
+        }
+        else if (async_backend::io_uring == backend)
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to create asynchronous reader: io_uring not available");
+        }
+    }
+}
+
+async_reader_impl::~async_reader_impl() noexcept
+{
+    // The kernel or the thread pool may still write into the buffers of the reads in flight.
+    m_queued.clear();
+    m_discarding = true;
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {}
+    teardown_ring();
+}
+
+bool async_reader_impl::setup_ring() noexcept
+{
+    struct io_uring_params parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+    unsigned entries = (unsigned)std::min<size_t>(m_queue_depth, 4096);
+    m_ring = io_uring_setup(entries, &parameters);
+    if (m_ring < 0)
+    {
+        m_ring = -1;
+        return false;
+    }
+    m_sq_entries = parameters.sq_entries;
+    m_cq_entries = parameters.cq_entries;
+    m_sq_mapping_size = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+    m_cq_mapping_size = parameters.cq_off.cqes + parameters.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mapping = 0 != (parameters.features & IORING_FEAT_SINGLE_MMAP);
+    if (single_mapping)
+    {
+        m_sq_mapping_size = m_cq_mapping_size = std::max(m_sq_mapping_size, m_cq_mapping_size);
+    }
+    m_sq_mapping = mmap(nullptr, m_sq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == m_sq_mapping)
+    {
+        teardown_ring();
+        return false;
+    }
+    if (single_mapping)
+    {
+        m_cq_mapping = m_sq_mapping;
+    }
+    else
+    {
+        m_cq_mapping = mmap(nullptr, m_cq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == m_cq_mapping)
+        {
+            teardown_ring();
+            return false;
+        }
+    }
+    m_sqes_size = parameters.sq_entries * sizeof(struct io_uring_sqe);
+    m_sqes = (struct io_uring_sqe *)mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+    if (MAP_FAILED == (void *)m_sqes)
+    {
+        teardown_ring();
+        return false;
+    }
+    char *sq = static_cast<char *>(m_sq_mapping);
+    m_sq_head = (unsigned *)(sq + parameters.sq_off.head);
+    m_sq_tail = (unsigned *)(sq + parameters.sq_off.tail);
+    m_sq_mask = (unsigned *)(sq + parameters.sq_off.ring_mask);
+    m_sq_array = (unsigned *)(sq + parameters.sq_off.array);
+    char *cq = static_cast<char *>(m_cq_mapping);
+    m_cq_head = (unsigned *)(cq + parameters.cq_off.head);
+    m_cq_tail = (unsigned *)(cq + parameters.cq_off.tail);
+    m_cq_mask = (unsigned *)(cq + parameters.cq_off.ring_mask);
+    m_cqes = (struct io_uring_cqe *)(cq + parameters.cq_off.cqes);
+    // At most as many reads are in flight as the submission queue has entries.
+    m_queue_depth = std::min<size_t>(m_queue_depth, m_sq_entries);
+    return true;
+}
+
+void async_reader_impl::teardown_ring() noexcept
+{
+    if (MAP_FAILED != (void *)m_sqes)
+    {
+        munmap(m_sqes, m_sqes_size);
+        m_sqes = (struct io_uring_sqe *)MAP_FAILED;
+    }
+    if (MAP_FAILED != m_cq_mapping && m_cq_mapping != m_sq_mapping)
+    {
+        munmap(m_cq_mapping, m_cq_mapping_size);
+    }
+    m_cq_mapping = MAP_FAILED;
+    if (MAP_FAILED != m_sq_mapping)
+    {
+        munmap(m_sq_mapping, m_sq_mapping_size);
+        m_sq_mapping = MAP_FAILED;
+    }
+    if (-1 != m_ring)
+    {
+        ::close(m_ring);
+        m_ring = -1;
+    }
+}
+
+async_backend async_reader_impl::backend() const noexcept
+{
+    return m_backend;
+}
+
+size_t async_reader_impl::queue_depth() const noexcept
+{
+    return m_queue_depth;
+}
+
+void async_reader_impl::enqueue(file_descriptor& file_descriptor, size_t offset, char *buffer, size_t length,
+                                int buffer_index, read_handler handler)
+{
+    if (!file_descriptor.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    std::unique_ptr<request> request(new async_reader_impl::request());
+    request->handle = *static_cast<int *>(file_descriptor.handle());
+    request->offset = offset;
+    request->buffer = buffer;
+    request->length = length;
+    request->result = 0;
+    request->buffer_index = buffer_index;
+    request->error = 0;
+    request->handler = std::move(handler);
+    m_queued.push_back(std::move(request));
+}
+
+void async_reader_impl::read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length, read_handler handler)
+{
+    enqueue(file_descriptor, offset, static_cast<char *>(buffer), length, -1, std::move(handler));
+}
+
+void async_reader_impl::register_buffers(const std::vector<async_reader::buffer>& buffers)
+{
+    if (0 != pending())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to register buffers: reads are pending");
+    }
+    unregister_buffers();
+    std::vector<struct iovec> iovecs;
+    iovecs.reserve(buffers.size());
+    for (const auto& buffer : buffers)
+    {
+        iovecs.push_back({ buffer.data, buffer.size });
+    }
+    if (async_backend::io_uring == m_backend && !iovecs.empty())
+    {
+        if (io_uring_register(m_ring, IORING_REGISTER_BUFFERS, iovecs.data(), (unsigned)iovecs.size()) < 0)
+        {
+            throw id::file_system::error(__FILE__, __LINE__, std::string("unable to register buffers: ") + strerror(errno));
+        }
+    }
+    m_buffers = std::move(iovecs);
+}
+
+void async_reader_impl::unregister_buffers()
+{
+    if (0 != pending())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to unregister buffers: reads are pending");
+    }
+    if (async_backend::io_uring == m_backend && !m_buffers.empty())
+    {
+        io_uring_register(m_ring, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    }
+    m_buffers.clear();
+}
+
+void async_reader_impl::read_fixed(file_descriptor& file_descriptor, size_t offset, size_t buffer_index,
+                                   size_t buffer_offset, size_t length, read_handler handler)
+{
+    if (buffer_index >= m_buffers.size() || buffer_offset > m_buffers[buffer_index].iov_len ||
+        length > m_buffers[buffer_index].iov_len - buffer_offset)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: range not within registered buffer");
+    }
+    char *buffer = static_cast<char *>(m_buffers[buffer_index].iov_base) + buffer_offset;
+    enqueue(file_descriptor, offset, buffer, length, (int)buffer_index, std::move(handler));
+}
+
+size_t async_reader_impl::submit()
+{
+    size_t count = 0;
+    if (async_backend::io_uring == m_backend)
+    {
+        unsigned tail = *m_sq_tail;
+        while (!m_queued.empty() && m_in_flight < m_queue_depth)
+        {
+            request *request = m_queued.front().release();
+            m_queued.pop_front();
+            unsigned index = tail & *m_sq_mask;
+            struct io_uring_sqe *sqe = &m_sqes[index];
+            std::memset(sqe, 0, sizeof(struct io_uring_sqe));
+            sqe->fd = request->handle;
+            sqe->off = request->offset;
+            // Reads are capped such that the result fits into the 32 bit result of a completion.
+            unsigned length = (unsigned)std::min<size_t>(request->length, 1u << 30);
+            if (-1 != request->buffer_index)
+            {
+                sqe->opcode = IORING_OP_READ_FIXED;
+                sqe->addr = (uint64_t)(uintptr_t)request->buffer;
+                sqe->len = length;
+                sqe->buf_index = (uint16_t)request->buffer_index;
+            }
+            else
+            {
+                // Vectored reads are supported by all kernels supporting io_uring.
+                request->iovec.iov_base = request->buffer;
+                request->iovec.iov_len = length;
+                sqe->opcode = IORING_OP_READV;
+                sqe->addr = (uint64_t)(uintptr_t)&request->iovec;
+                sqe->len = 1;
+            }
+            sqe->user_data = (uint64_t)(uintptr_t)request;
+            m_sq_array[index] = index;
+            tail++;
+            m_in_flight++;
+            m_to_submit++;
+            count++;
+        }
+        __atomic_store_n(m_sq_tail, tail, __ATOMIC_RELEASE);
+        if (0 != m_to_submit)
+        {
+            enter(0);
+        }
+    }
+    else
+    {
+        // Reads performed on the pool from a worker thread could deadlock if the workers wait for them: read inline.
+        const bool read_inline = thread_pool::shared().is_worker();
+        while (!m_queued.empty() && m_in_flight < m_queue_depth)
+        {
+            request *request = m_queued.front().release();
+            m_queued.pop_front();
+            m_in_flight++;
+            if (read_inline)
+            {
+                perform(request);
+                count++;
+                continue;
+            }
+            try
+            {
+                thread_pool::shared().post([this, request]() noexcept { perform(request); });
+            }
+            catch (...)
+            {
+                m_in_flight--;
+                m_queued.emplace_front(request);
+                throw;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+void async_reader_impl::enter(unsigned minimum_completions)
+{
+    unsigned flags = 0 != minimum_completions ? IORING_ENTER_GETEVENTS : 0;
+    int result = io_uring_enter(m_ring, m_to_submit, minimum_completions, flags);
+    if (result < 0)
+    {
+        // The entries remain in the submission queue and are submitted by the next call.
+        if (EINTR == errno || EAGAIN == errno || EBUSY == errno)
+        {
+            return;
+        }
+        throw id::file_system::error(__FILE__, __LINE__, std::string("unable to submit reads: ") + strerror(errno));
+    }
+    m_to_submit -= (unsigned)result;
+}
+
+void async_reader_impl::perform(request *request) noexcept
+{
+    while (request->length > 0)
+    {
+        ssize_t result = ::pread(request->handle, request->buffer, request->length, (off_t)request->offset);
+        if (result < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            request->error = errno;
+            break;
+        }
+        if (0 == result)
+        {
+            break;
+        }
+        request->offset += (size_t)result;
+        request->buffer += result;
+        request->length -= (size_t)result;
+        request->result += (size_t)result;
+    }
+    // Notify while holding the lock: the reader may be destroyed as soon as the lock is released.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed.push_back(request);
+    m_condition.notify_one();
+}
+
+bool async_reader_impl::advance(request *request, int result) noexcept
+{
+    if (m_discarding)
+    {
+        return true;
+    }
+    if (result < 0)
+    {
+        if (-EINTR == result || -EAGAIN == result)
+        {
+            m_queued.emplace_front(request);
+            return false;
+        }
+        request->error = -result;
+        return true;
+    }
+    request->offset += (size_t)result;
+    request->buffer += result;
+    request->length -= (size_t)result;
+    request->result += (size_t)result;
+    if (0 == result || 0 == request->length)
+    {
+        return true;
+    }
+    // A short read before the end of the file: queue the remaining Bytes.
+    m_queued.emplace_front(request);
+    return false;
+}
+
+void async_reader_impl::finish(request *request)
+{
+    std::unique_ptr<async_reader_impl::request> owner(request);
+    read_handler handler = std::move(request->handler);
+    size_t result = request->result;
+    std::exception_ptr error = 0 != request->error ? make_read_error(request->error) : nullptr;
+    owner.reset();
+    if (handler && !m_discarding)
+    {
+        handler(result, error);
+    }
+}
+
+size_t async_reader_impl::poll()
+{
+    size_t count = 0;
+    if (async_backend::io_uring == m_backend)
+    {
+        while (true)
+        {
+            unsigned head = *m_cq_head;
+            unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+            if (head == tail)
+            {
+                break;
+            }
+            struct io_uring_cqe *cqe = &m_cqes[head & *m_cq_mask];
+            request *request = reinterpret_cast<async_reader_impl::request *>(cqe->user_data);
+            int result = cqe->res;
+            __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+            m_in_flight--;
+            if (advance(request, result))
+            {
+                count++;
+                finish(request);
+            }
+        }
+    }
+    else
+    {
+        while (true)
+        {
+            request *request;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_completed.empty())
+                {
+                    break;
+                }
+                request = m_completed.front();
+                m_completed.pop_front();
+            }
+            m_in_flight--;
+            count++;
+            finish(request);
+        }
+    }
+    return count;
+}
+
+size_t async_reader_impl::wait()
+{
+    size_t count = 0;
+    while (0 != pending())
+    {
+        submit();
+        size_t reaped = poll();
+        count += reaped;
+        if (0 != reaped || 0 == m_in_flight)
+        {
+            continue;
+        }
+        if (async_backend::io_uring == m_backend)
+        {
+            enter(1);
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return !m_completed.empty(); });
+        }
+    }
+    return count;
+}
+
+size_t async_reader_impl::pending() const noexcept
+{
+    return m_queued.size() + m_in_flight;
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
@@ -0,0 +1,155 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/file_system/async_reader.hpp"
+
+#if defined(ID_LINUX)
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#include "idlib/file_system/header.in"
+
+/// @brief A Linux asynchronous reader.
+/// @detail Uses an io_uring instance set up by raw system calls (liburing is not required). If io_uring is not
+/// available, then positional reads are performed on the shared thread pool.
+class async_reader_impl
+{
+private:
+    /// @brief A read.
+    struct request
+    {
+        /// @brief The Linux file handle.
+        int handle;
+        /// @brief The offset, in Bytes, in the file of the remaining Bytes.
+        size_t offset;
+        /// @brief A pointer to the buffer of the remaining Bytes.
+        char *buffer;
+        /// @brief The number of remaining Bytes.
+        size_t length;
+        /// @brief The number of Bytes read so far.
+        size_t result;
+        /// @brief The index of the registered buffer or -1.
+        int buffer_index;
+        /// @brief @a 0 or the error number of a failed read.
+        int error;
+        /// @brief The vector of a vectored read.
+        struct iovec iovec;
+        /// @brief The handler.
+        read_handler handler;
+    };
+
+    /// @brief The backend.
+    async_backend m_backend;
+    /// @brief The maximum number of reads in flight.
+    size_t m_queue_depth;
+    /// @brief The queued reads.
+    std::deque<std::unique_ptr<request>> m_queued;
+    /// @brief The number of reads in flight.
+    size_t m_in_flight;
+    /// @brief The registered buffers.
+    std::vector<struct iovec> m_buffers;
+
+    /// @brief The io_uring file handle or -1.
+    int m_ring;
+    /// @brief The mapping of the submission queue ring.
+    void *m_sq_mapping;
+    /// @brief The size, in Bytes, of the mapping of the submission queue ring.
+    size_t m_sq_mapping_size;
+    /// @brief The mapping of the completion queue ring. Might be the mapping of the submission queue ring.
+    void *m_cq_mapping;
+    /// @brief The size, in Bytes, of the mapping of the completion queue ring.
+    size_t m_cq_mapping_size;
+    /// @brief The submission queue entries.
+    struct io_uring_sqe *m_sqes;
+    /// @brief The size, in Bytes, of the mapping of the submission queue entries.
+    size_t m_sqes_size;
+    /// @brief Pointers into the submission queue ring.
+    unsigned *m_sq_head, *m_sq_tail, *m_sq_mask, *m_sq_array;
+    /// @brief The number of entries of the submission queue.
+    unsigned m_sq_entries;
+    /// @brief Pointers into the completion queue ring.
+    unsigned *m_cq_head, *m_cq_tail, *m_cq_mask;
+    /// @brief The completion queue entries.
+    struct io_uring_cqe *m_cqes;
+    /// @brief The number of entries of the completion queue.
+    unsigned m_cq_entries;
+    /// @brief The number of entries placed into the submission queue but not yet consumed by the kernel.
+    unsigned m_to_submit;
+    /// @brief If @a true, then reads are completed without invoking their handlers.
+    bool m_discarding;
+
+    /// @brief The mutex protecting the reads completed by the thread pool.
+    std::mutex m_mutex;
+    /// @brief Signalled if a read was completed by the thread pool.
+    std::condition_variable m_condition;
+    /// @brief The reads completed by the thread pool.
+    std::deque<request *> m_completed;
+
+public:
+    /// @brief Construct this asynchronous reader.
+    /// @param queue_depth the maximum number of reads in flight
+    /// @param backend the backend
+    /// @throw id::file_system::error the backend is not available
+    async_reader_impl(size_t queue_depth, async_backend backend);
+
+    /// @brief Destruct this asynchronous reader.
+    ~async_reader_impl() noexcept;
+
+    // Delete copy constructor.
+    async_reader_impl(const async_reader_impl&) = delete;
+
+    // Delete copy assignment operator.
+    async_reader_impl& operator=(const async_reader_impl&) = delete;
+
+public:
+    async_backend backend() const noexcept;
+    size_t queue_depth() const noexcept;
+    void read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length, read_handler handler);
+    void register_buffers(const std::vector<async_reader::buffer>& buffers);
+    void unregister_buffers();
+    void read_fixed(file_descriptor& file_descriptor, size_t offset, size_t buffer_index, size_t buffer_offset,
+                    size_t length, read_handler handler);
+    size_t submit();
+    size_t poll();
+    size_t wait();
+    size_t pending() const noexcept;
+
+private:
+    /// @brief Set up the io_uring instance.
+    /// @return @a true on success, @a false otherwise
+    bool setup_ring() noexcept;
+
+    /// @brief Tear down the io_uring instance.
+    void teardown_ring() noexcept;
+
+    /// @brief Enter the io_uring instance.
+    /// @param minimum_completions the minimum number of completions to wait for
+    void enter(unsigned minimum_completions);
+
+    /// @brief Perform a read on the thread pool.
+    void perform(request *request) noexcept;
+
+    /// @brief Account for the result of a read submitted to the io_uring instance.
+    /// @param request the read
+    /// @param result the number of Bytes read or a negative error number
+    /// @return @a true if the read is complete, @a false if its remaining Bytes were queued again
+    bool advance(request *request, int result) noexcept;
+
+    /// @brief Invoke the handler of a complete read and destroy the read.
+    /// @param request the read
+    void finish(request *request);
+
+    /// @brief Queue a read.
+    void enqueue(file_descriptor& file_descriptor, size_t offset, char *buffer, size_t length, int buffer_index,
+                 read_handler handler);
+
+}; // class async_reader_impl
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
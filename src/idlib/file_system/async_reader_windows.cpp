@@ -0,0 +1,225 @@
+#include "idlib/file_system/async_reader_windows.hpp"
+
+#if defined(ID_WINDOWS)
+
+#define IDLIB_PRIVATE 1
+#include "idlib/concurrency/thread_pool.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+async_reader_impl::async_reader_impl(size_t queue_depth, async_backend backend) :
+    m_queue_depth(queue_depth), m_queued(), m_in_flight(0), m_buffers(), m_discarding(false),
+    m_mutex(), m_condition(), m_completed()
+{
+    if (async_backend::io_uring == backend)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to create asynchronous reader: io_uring not available");
+    }
+}
+
+async_reader_impl::~async_reader_impl() noexcept
+{
+    // The thread pool may still write into the buffers of the reads in flight.
+    m_queued.clear();
+    m_discarding = true;
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {}
+}
+
+async_backend async_reader_impl::backend() const noexcept
+{
+    return async_backend::thread_pool;
+}
+
+size_t async_reader_impl::queue_depth() const noexcept
+{
+    return m_queue_depth;
+}
+
+void async_reader_impl::enqueue(file_descriptor& file_descriptor, size_t offset, char *buffer, size_t length,
+                                read_handler handler)
+{
+    if (!file_descriptor.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    std::unique_ptr<request> request(new async_reader_impl::request());
+    request->handle = *static_cast<HANDLE *>(file_descriptor.handle());
+    request->offset = offset;
+    request->buffer = buffer;
+    request->length = length;
+    request->result = 0;
+    request->error = 0;
+    request->handler = std::move(handler);
+    m_queued.push_back(std::move(request));
+}
+
+void async_reader_impl::read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length, read_handler handler)
+{
+    enqueue(file_descriptor, offset, static_cast<char *>(buffer), length, std::move(handler));
+}
+
+void async_reader_impl::register_buffers(const std::vector<async_reader::buffer>& buffers)
+{
+    if (0 != pending())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to register buffers: reads are pending");
+    }
+    m_buffers = buffers;
+}
+
+void async_reader_impl::unregister_buffers()
+{
+    if (0 != pending())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to unregister buffers: reads are pending");
+    }
+    m_buffers.clear();
+}
+
+void async_reader_impl::read_fixed(file_descriptor& file_descriptor, size_t offset, size_t buffer_index,
+                                   size_t buffer_offset, size_t length, read_handler handler)
+{
+    if (buffer_index >= m_buffers.size() || buffer_offset > m_buffers[buffer_index].size ||
+        length > m_buffers[buffer_index].size - buffer_offset)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: range not within registered buffer");
+    }
+    char *buffer = static_cast<char *>(m_buffers[buffer_index].data) + buffer_offset;
+    enqueue(file_descriptor, offset, buffer, length, std::move(handler));
+}
+
+size_t async_reader_impl::submit()
+{
+    size_t count = 0;
+    // Reads performed on the pool from a worker thread could deadlock if the workers wait for them: read inline.
+    const bool read_inline = thread_pool::shared().is_worker();
+    while (!m_queued.empty() && m_in_flight < m_queue_depth)
+    {
+        request *request = m_queued.front().release();
+        m_queued.pop_front();
+        m_in_flight++;
+        if (read_inline)
+        {
+            perform(request);
+            count++;
+            continue;
+        }
+        try
+        {
+            thread_pool::shared().post([this, request]() noexcept { perform(request); });
+        }
+        catch (...)
+        {
+            m_in_flight--;
+            m_queued.emplace_front(request);
+            throw;
+        }
+        count++;
+    }
+    return count;
+}
+
+void async_reader_impl::perform(request *request) noexcept
+{
+    while (request->length > 0)
+    {
+        // A synchronous handle reads at the offset specified by the overlapped structure.
+        OVERLAPPED overlapped;
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)(request->offset & 0xffffffff);
+        overlapped.OffsetHigh = (DWORD)((uint64_t)request->offset >> 32);
+        DWORD length = (DWORD)std::min<size_t>(request->length, 1u << 30), result = 0;
+        if (!ReadFile(request->handle, request->buffer, length, &result, &overlapped))
+        {
+            DWORD error = GetLastError();
+            if (ERROR_HANDLE_EOF != error)
+            {
+                request->error = error;
+            }
+            break;
+        }
+        if (0 == result)
+        {
+            break;
+        }
+        request->offset += result;
+        request->buffer += result;
+        request->length -= result;
+        request->result += result;
+    }
+    // Notify while holding the lock: the reader may be destroyed as soon as the lock is released.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed.push_back(request);
+    m_condition.notify_one();
+}
+
+void async_reader_impl::finish(request *request)
+{
+    std::unique_ptr<async_reader_impl::request> owner(request);
+    read_handler handler = std::move(request->handler);
+    size_t result = request->result;
+    std::exception_ptr error = 0 != request->error
+                             ? std::make_exception_ptr(id::file_system::error(__FILE__, __LINE__, "unable to read file: error " + std::to_string(request->error)))
+                             : nullptr;
+    owner.reset();
+    if (handler && !m_discarding)
+    {
+        handler(result, error);
+    }
+}
+
+size_t async_reader_impl::poll()
+{
+    size_t count = 0;
+    while (true)
+    {
+        request *request;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_completed.empty())
+            {
+                break;
+            }
+            request = m_completed.front();
+            m_completed.pop_front();
+        }
+        m_in_flight--;
+        count++;
+        finish(request);
+    }
+    return count;
+}
+
+size_t async_reader_impl::wait()
+{
+    size_t count = 0;
+    while (0 != pending())
+    {
+        submit();
+        size_t reaped = poll();
+        count += reaped;
+        if (0 != reaped || 0 == m_in_flight)
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return !m_completed.empty(); });
+    }
+    return count;
+}
+
+size_t async_reader_impl::pending() const noexcept
+{
+    return m_queued.size() + m_in_flight;
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
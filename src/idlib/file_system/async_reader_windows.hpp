@@ -0,0 +1,104 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/file_system/async_reader.hpp"
+
+#if defined(ID_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include "idlib/file_system/header.in"
+
+/// @brief A Windows asynchronous reader.
+/// @detail Performs positional reads on the shared thread pool.
+class async_reader_impl
+{
+private:
+    /// @brief A read.
+    struct request
+    {
+        /// @brief The Windows file handle.
+        HANDLE handle;
+        /// @brief The offset, in Bytes, in the file of the remaining Bytes.
+        size_t offset;
+        /// @brief A pointer to the buffer of the remaining Bytes.
+        char *buffer;
+        /// @brief The number of remaining Bytes.
+        size_t length;
+        /// @brief The number of Bytes read so far.
+        size_t result;
+        /// @brief @a 0 or the error code of a failed read.
+        DWORD error;
+        /// @brief The handler.
+        read_handler handler;
+    };
+
+    /// @brief The maximum number of reads in flight.
+    size_t m_queue_depth;
+    /// @brief The queued reads.
+    std::deque<std::unique_ptr<request>> m_queued;
+    /// @brief The number of reads in flight.
+    size_t m_in_flight;
+    /// @brief The registered buffers.
+    std::vector<async_reader::buffer> m_buffers;
+    /// @brief If @a true, then reads are completed without invoking their handlers.
+    bool m_discarding;
+
+    /// @brief The mutex protecting the reads completed by the thread pool.
+    std::mutex m_mutex;
+    /// @brief Signalled if a read was completed by the thread pool.
+    std::condition_variable m_condition;
+    /// @brief The reads completed by the thread pool.
+    std::deque<request *> m_completed;
+
+public:
+    /// @brief Construct this asynchronous reader.
+    /// @param queue_depth the maximum number of reads in flight
+    /// @param backend the backend
+    /// @throw id::file_system::error the backend is not available
+    async_reader_impl(size_t queue_depth, async_backend backend);
+
+    /// @brief Destruct this asynchronous reader.
+    ~async_reader_impl() noexcept;
+
+    // Delete copy constructor.
+    async_reader_impl(const async_reader_impl&) = delete;
+
+    // Delete copy assignment operator.
+    async_reader_impl& operator=(const async_reader_impl&) = delete;
+
+public:
+    async_backend backend() const noexcept;
+    size_t queue_depth() const noexcept;
+    void read(file_descriptor& file_descriptor, size_t offset, void *buffer, size_t length, read_handler handler);
+    void register_buffers(const std::vector<async_reader::buffer>& buffers);
+    void unregister_buffers();
+    void read_fixed(file_descriptor& file_descriptor, size_t offset, size_t buffer_index, size_t buffer_offset,
+                    size_t length, read_handler handler);
+    size_t submit();
+    size_t poll();
+    size_t wait();
+    size_t pending() const noexcept;
+
+private:
+    /// @brief Perform a read on the thread pool.
+    void perform(request *request) noexcept;
+
+    /// @brief Invoke the handler of a complete read and destroy the read.
+    /// @param request the read
+    void finish(request *request);
+
+    /// @brief Queue a read.
+    void enqueue(file_descriptor& file_descriptor, size_t offset, char *buffer, size_t length, read_handler handler);
+
+}; // class async_reader_impl
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
@@ -0,0 +1,271 @@
+#include "idlib/file_system/atomic_file_linux.hpp"
+
+#if defined(ID_LINUX)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The number of temporary files created by this process.
+std::atomic<uint64_t> number_of_temporary_files(0);
+
+/// @brief Write the contents of files to the storage devices one by one.
+bool synchronize_each_file(const std::vector<std::string>& pathnames) noexcept
+{
+    for (const auto& pathname : pathnames)
+    {
+        int handle = ::open(pathname.c_str(), O_RDONLY | O_CLOEXEC);
+        if (-1 == handle)
+        {
+            return false;
+        }
+        int result = fdatasync(handle);
+        ::close(handle);
+        if (0 != result)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+atomic_file_impl::atomic_file_impl() noexcept :
+    m_handle(-1), m_temporary_pathname()
+{}
+
+atomic_file_impl::~atomic_file_impl() noexcept
+{
+    discard();
+}
+
+bool atomic_file_impl::create(const std::string& pathname) noexcept
+{
+    discard();
+    const size_t separator = pathname.find_last_of('/');
+    const size_t name = std::string::npos == separator ? 0 : separator + 1;
+    if (name == pathname.size())
+    {
+        return false;
+    }
+    try
+    {
+        for (size_t attempt = 0; attempt < 16; ++attempt)
+        {
+            m_temporary_pathname = pathname.substr(0, name) + "." + pathname.substr(name) + "." + std::to_string(getpid())
+                                 + "-" + std::to_string(number_of_temporary_files++) + ".tmp";
+            // Files are created with read and write permissions for everyone (subject to the umask).
+            m_handle = ::open(m_temporary_pathname.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+            if (-1 != m_handle)
+            {
+                break;
+            }
+            if (EEXIST != errno)
+            {
+                m_temporary_pathname.clear();
+                return false;
+            }
+        }
+    }
+    catch (...)
+    {
+        discard();
+        return false;
+    }
+    if (-1 == m_handle)
+    {
+        m_temporary_pathname.clear();
+        return false;
+    }
+    // The replacement of an existing file keeps the permissions of the file.
+    struct stat attributes;
+    if (0 == stat(pathname.c_str(), &attributes) && S_ISREG(attributes.st_mode))
+    {
+        fchmod(m_handle, attributes.st_mode & 07777);
+    }
+    return true;
+}
+
+bool atomic_file_impl::is_open() const noexcept
+{
+    return -1 != m_handle;
+}
+
+const std::string& atomic_file_impl::temporary_pathname() const noexcept
+{
+    return m_temporary_pathname;
+}
+
+void atomic_file_impl::write(size_t offset, const void *bytes, size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    const char *buffer = static_cast<const char *>(bytes);
+    while (length > 0)
+    {
+        ssize_t result = ::pwrite(m_handle, buffer, length, (off_t)offset);
+        if (-1 == result)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            throw id::file_system::error(__FILE__, __LINE__, std::string("unable to write file: ") + strerror(errno));
+        }
+        if (0 == result)
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to write file: no Bytes written");
+        }
+        buffer += result;
+        offset += (size_t)result;
+        length -= (size_t)result;
+    }
+}
+
+void atomic_file_impl::start_writeback() noexcept
+{
+    if (is_open())
+    {
+        sync_file_range(m_handle, 0, 0, SYNC_FILE_RANGE_WRITE);
+    }
+}
+
+void atomic_file_impl::synchronize()
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to synchronize file: file is not open");
+    }
+    if (0 != fdatasync(m_handle))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, std::string("unable to synchronize file: ") + strerror(errno));
+    }
+}
+
+void atomic_file_impl::close()
+{
+    if (!is_open())
+    {
+        return;
+    }
+    int result = ::close(m_handle);
+    m_handle = -1;
+    // The handle is closed even if the close was interrupted.
+    if (0 != result && EINTR != errno)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, std::string("unable to close file: ") + strerror(errno));
+    }
+}
+
+bool atomic_file_impl::replace(const std::string& pathname, bool synchronize) noexcept
+{
+    // The directory is synchronized by id::file_system::synchronize_directory.
+    (void)synchronize;
+    if (is_open() || m_temporary_pathname.empty() || 0 != rename(m_temporary_pathname.c_str(), pathname.c_str()))
+    {
+        return false;
+    }
+    m_temporary_pathname.clear();
+    return true;
+}
+
+void atomic_file_impl::discard() noexcept
+{
+    if (is_open())
+    {
+        ::close(m_handle);
+        m_handle = -1;
+    }
+    if (!m_temporary_pathname.empty())
+    {
+        unlink(m_temporary_pathname.c_str());
+        m_temporary_pathname.clear();
+    }
+}
+
+std::string get_parent_directory(const std::string& pathname)
+{
+    const size_t separator = pathname.find_last_of('/');
+    if (std::string::npos == separator)
+    {
+        return ".";
+    }
+    return pathname.substr(0, 0 == separator ? 1 : separator);
+}
+
+bool synchronize_files(const std::vector<std::string>& pathnames, bool verify) noexcept
+{
+    // Synchronize each file system once instead of each file: a single commit of the journal of the file system
+    // covers all files.
+    try
+    {
+        std::unordered_set<std::string> directories;
+        std::vector<dev_t> devices;
+        for (const auto& pathname : pathnames)
+        {
+            std::string directory = get_parent_directory(pathname);
+            if (!directories.insert(directory).second)
+            {
+                continue;
+            }
+            struct stat attributes;
+            if (0 != stat(directory.c_str(), &attributes))
+            {
+                return false;
+            }
+            if (devices.end() != std::find(devices.begin(), devices.end(), attributes.st_dev))
+            {
+                continue;
+            }
+            devices.push_back(attributes.st_dev);
+            int handle = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (-1 == handle)
+            {
+                return false;
+            }
+            int result = syncfs(handle);
+            ::close(handle);
+            if (0 != result)
+            {
+                // The file system can not be synchronized as a whole or reported an error.
+                return synchronize_each_file(pathnames);
+            }
+        }
+        // Before Linux 5.8, syncfs does not report errors writing the contents of files. If they must be detected,
+        // then each file is synchronized in addition. As the contents were written by syncfs, this does not wait for
+        // the storage device again but reports errors of the files.
+        return !verify || synchronize_each_file(pathnames);
+    }
+    catch (...)
+    {
+        return synchronize_each_file(pathnames);
+    }
+}
+
+bool synchronize_directory(const std::string& pathname) noexcept
+{
+    int handle = ::open(pathname.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (-1 == handle)
+    {
+        return false;
+    }
+    int result = fsync(handle);
+    ::close(handle);
+    return 0 == result;
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
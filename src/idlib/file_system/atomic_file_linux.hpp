@@ -0,0 +1,106 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+#include "idlib/utility/platform.hpp"
+
+#if defined(ID_LINUX)
+
+#include "idlib/file_system/header.in"
+
+/// @brief A temporary file which replaces a file when it is complete.
+/// @detail
+/// The temporary file is created in the directory of the file, hence it is on the same file system as the file and
+/// replacing the file is atomic. The name of the temporary file is the name of the file prefixed by a dot and
+/// suffixed by the process identifier, a counter, and `.tmp`.
+class atomic_file_impl final
+{
+private:
+    /// @brief The Linux file handle or @a -1.
+    int m_handle;
+    /// @brief The pathname of the temporary file or the empty string.
+    std::string m_temporary_pathname;
+
+public:
+    /// @brief Construct this atomic file.
+    /// @post The atomic file has no temporary file.
+    atomic_file_impl() noexcept;
+
+    /// @brief Destruct this atomic file.
+    /// @post The temporary file is closed and removed.
+    ~atomic_file_impl() noexcept;
+
+    // Delete copy constructor.
+    atomic_file_impl(const atomic_file_impl&) = delete;
+
+    // Delete copy assignment operator.
+    atomic_file_impl& operator=(const atomic_file_impl&) = delete;
+
+public:
+    /// @brief Create and open the temporary file.
+    /// @param pathname the pathname of the file to replace
+    /// @return @a true on success, @a false on failure
+    bool create(const std::string& pathname) noexcept;
+
+    /// @brief Get if the temporary file is open.
+    /// @return @a true if the temporary file is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Get the pathname of the temporary file.
+    /// @return the pathname of the temporary file or the empty string
+    const std::string& temporary_pathname() const noexcept;
+
+    /// @brief Write Bytes at an offset.
+    /// @param offset the offset, in Bytes, in the temporary file
+    /// @param bytes a pointer to an array of @a length Bytes
+    /// @param length the number of Bytes
+    /// @throw id::file_system::error the temporary file is not open or the environment fails
+    void write(size_t offset, const void *bytes, size_t length);
+
+    /// @brief Start writing the contents of the temporary file to the storage device without waiting for completion.
+    void start_writeback() noexcept;
+
+    /// @brief Write the contents of the temporary file to the storage device and wait for completion.
+    /// @throw id::file_system::error the temporary file is not open or the environment fails
+    void synchronize();
+
+    /// @brief Close the temporary file.
+    /// @throw id::file_system::error the environment fails
+    void close();
+
+    /// @brief Replace a file by the temporary file.
+    /// @param pathname the pathname of the file
+    /// @param synchronize if the replacement must be written to the storage device before returning
+    /// @return @a true on success, @a false on failure
+    /// @pre The temporary file is closed.
+    /// @post On success, the atomic file has no temporary file.
+    bool replace(const std::string& pathname, bool synchronize) noexcept;
+
+    /// @brief Close and remove the temporary file.
+    /// @post The atomic file has no temporary file.
+    void discard() noexcept;
+
+}; // class atomic_file_impl
+
+/// @brief Get the directory of a file.
+/// @param pathname the pathname of the file
+/// @return the pathname of the directory of the file
+std::string get_parent_directory(const std::string& pathname);
+
+/// @brief Write the contents of files to the storage devices and wait for completion.
+/// @param pathnames the pathnames of the files
+/// @param verify if errors writing the contents of the files must be detected reliably
+/// @return @a true on success, @a false on failure
+bool synchronize_files(const std::vector<std::string>& pathnames, bool verify) noexcept;
+
+/// @brief Write the entries of a directory to the storage device and wait for completion.
+/// @param pathname the pathname of the directory
+/// @return @a true on success, @a false on failure
+bool synchronize_directory(const std::string& pathname) noexcept;
+
+#include "idlib/file_system/footer.in"
+
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
@@ -0,0 +1,203 @@
+#include "idlib/file_system/atomic_file_windows.hpp"
+
+#if defined(ID_WINDOWS)
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The number of temporary files created by this process.
+std::atomic<uint64_t> number_of_temporary_files(0);
+
+} // namespace
+
+atomic_file_impl::atomic_file_impl() noexcept :
+    m_handle(INVALID_HANDLE_VALUE), m_temporary_pathname()
+{}
+
+atomic_file_impl::~atomic_file_impl() noexcept
+{
+    discard();
+}
+
+bool atomic_file_impl::create(const std::string& pathname) noexcept
+{
+    discard();
+    const size_t separator = pathname.find_last_of("/\\");
+    const size_t name = std::string::npos == separator ? 0 : separator + 1;
+    if (name == pathname.size())
+    {
+        return false;
+    }
+    try
+    {
+        for (size_t attempt = 0; attempt < 16; ++attempt)
+        {
+            m_temporary_pathname = pathname.substr(0, name) + "." + pathname.substr(name) + "." + std::to_string(GetCurrentProcessId())
+                                 + "-" + std::to_string(number_of_temporary_files++) + ".tmp";
+            m_handle = CreateFileA(m_temporary_pathname.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (INVALID_HANDLE_VALUE != m_handle)
+            {
+                break;
+            }
+            if (ERROR_FILE_EXISTS != GetLastError())
+            {
+                m_temporary_pathname.clear();
+                return false;
+            }
+        }
+    }
+    catch (...)
+    {
+        discard();
+        return false;
+    }
+    if (INVALID_HANDLE_VALUE == m_handle)
+    {
+        m_temporary_pathname.clear();
+        return false;
+    }
+    return true;
+}
+
+bool atomic_file_impl::is_open() const noexcept
+{
+    return INVALID_HANDLE_VALUE != m_handle;
+}
+
+const std::string& atomic_file_impl::temporary_pathname() const noexcept
+{
+    return m_temporary_pathname;
+}
+
+void atomic_file_impl::write(size_t offset, const void *bytes, size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    const char *buffer = static_cast<const char *>(bytes);
+    while (length > 0)
+    {
+        // A synchronous handle writes at the offset specified by the overlapped structure.
+        OVERLAPPED overlapped;
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)((uint64_t)offset & 0xffffffff);
+        overlapped.OffsetHigh = (DWORD)((uint64_t)offset >> 32);
+        DWORD request = (DWORD)std::min<size_t>(length, 1u << 30), result = 0;
+        if (!WriteFile(m_handle, buffer, request, &result, &overlapped) || 0 == result)
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to write file: error " + std::to_string(GetLastError()));
+        }
+        buffer += result;
+        offset += result;
+        length -= result;
+    }
+}
+
+void atomic_file_impl::start_writeback() noexcept
+{
+    // Windows provides no means to start writing without waiting.
+}
+
+void atomic_file_impl::synchronize()
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to synchronize file: file is not open");
+    }
+    if (!FlushFileBuffers(m_handle))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to synchronize file: error " + std::to_string(GetLastError()));
+    }
+}
+
+void atomic_file_impl::close()
+{
+    if (!is_open())
+    {
+        return;
+    }
+    BOOL result = CloseHandle(m_handle);
+    m_handle = INVALID_HANDLE_VALUE;
+    if (!result)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to close file: error " + std::to_string(GetLastError()));
+    }
+}
+
+bool atomic_file_impl::replace(const std::string& pathname, bool synchronize) noexcept
+{
+    // Windows can not synchronize directories, instead the move is written through.
+    const DWORD flags = MOVEFILE_REPLACE_EXISTING | (synchronize ? MOVEFILE_WRITE_THROUGH : 0);
+    if (is_open() || m_temporary_pathname.empty() || !MoveFileExA(m_temporary_pathname.c_str(), pathname.c_str(), flags))
+    {
+        return false;
+    }
+    m_temporary_pathname.clear();
+    return true;
+}
+
+void atomic_file_impl::discard() noexcept
+{
+    if (is_open())
+    {
+        CloseHandle(m_handle);
+        m_handle = INVALID_HANDLE_VALUE;
+    }
+    if (!m_temporary_pathname.empty())
+    {
+        DeleteFileA(m_temporary_pathname.c_str());
+        m_temporary_pathname.clear();
+    }
+}
+
+std::string get_parent_directory(const std::string& pathname)
+{
+    const size_t separator = pathname.find_last_of("/\\");
+    if (std::string::npos == separator)
+    {
+        return ".";
+    }
+    // Keep the separator of a root directory e.g. of "\\file" or "C:\\file".
+    const bool root = 0 == separator || (2 == separator && ':' == pathname[1]);
+    return pathname.substr(0, root ? separator + 1 : separator);
+}
+
+bool synchronize_files(const std::vector<std::string>& pathnames, bool verify) noexcept
+{
+    // Windows can not synchronize a volume without administrator privileges, hence each file is synchronized and
+    // errors are always detected.
+    (void)verify;
+    for (const auto& pathname : pathnames)
+    {
+        HANDLE handle = CreateFileA(pathname.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (INVALID_HANDLE_VALUE == handle)
+        {
+            return false;
+        }
+        BOOL result = FlushFileBuffers(handle);
+        CloseHandle(handle);
+        if (!result)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool synchronize_directory(const std::string& pathname) noexcept
+{
+    // The entries of a directory are written through by id::file_system::atomic_file_impl::replace.
+    (void)pathname;
+    return true;
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
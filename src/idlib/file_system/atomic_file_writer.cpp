@@ -0,0 +1,170 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/atomic_file_writer.cpp
+/// @brief Crash-safe replacement of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/atomic_file_writer.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/atomic_file_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/atomic_file_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+atomic_file_writer::atomic_file_writer() :
+    m_pimpl(std::make_unique<atomic_file_impl>()), m_pathname(), m_durability(durability::full), m_buffer(), m_size(0),
+    m_file_offset(0)
+{}
+
+atomic_file_writer::~atomic_file_writer() noexcept
+{
+    discard();
+}
+
+void atomic_file_writer::open(const std::string& pathname, durability durability, size_t buffer_size) noexcept
+{
+    discard();
+    if (0 == buffer_size)
+    {
+        return;
+    }
+    try
+    {
+        m_pathname = pathname;
+        m_durability = durability;
+        m_buffer.resize(buffer_size);
+        if (!m_pimpl->create(pathname))
+        {
+            discard();
+        }
+    }
+    catch (...)
+    {
+        discard();
+    }
+}
+
+bool atomic_file_writer::is_open() const noexcept
+{
+    return m_pimpl->is_open();
+}
+
+size_t atomic_file_writer::position() const noexcept
+{
+    return m_file_offset + m_size;
+}
+
+void atomic_file_writer::write(const void *bytes, size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    if (0 == length)
+    {
+        return;
+    }
+    if (length <= m_buffer.size() - m_size)
+    {
+        memcpy(m_buffer.data() + m_size, bytes, length);
+        m_size += length;
+        return;
+    }
+    // Write the buffered Bytes and write Bytes which do not fit into the buffer without buffering them.
+    flush();
+    if (length < m_buffer.size())
+    {
+        memcpy(m_buffer.data(), bytes, length);
+        m_size = length;
+        return;
+    }
+    m_pimpl->write(m_file_offset, bytes, length);
+    m_file_offset += length;
+}
+
+void atomic_file_writer::write(std::string_view bytes)
+{
+    write(bytes.data(), bytes.size());
+}
+
+void atomic_file_writer::commit()
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to commit file: file is not open");
+    }
+    try
+    {
+        flush();
+        if (durability::none != m_durability)
+        {
+            m_pimpl->synchronize();
+        }
+        m_pimpl->close();
+        if (!m_pimpl->replace(m_pathname, durability::full == m_durability))
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to commit file `" + m_pathname + "`: unable to replace file");
+        }
+        if (durability::full == m_durability && !synchronize_directory(get_parent_directory(m_pathname)))
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to commit file `" + m_pathname + "`: unable to synchronize directory");
+        }
+    }
+    catch (...)
+    {
+        discard();
+        throw;
+    }
+    discard();
+}
+
+void atomic_file_writer::discard() noexcept
+{
+    m_pimpl->discard();
+    m_pathname.clear();
+    m_buffer = std::vector<char>();
+    m_size = 0;
+    m_file_offset = 0;
+}
+
+void atomic_file_writer::flush()
+{
+    if (0 == m_size)
+    {
+        return;
+    }
+    m_pimpl->write(m_file_offset, m_buffer.data(), m_size);
+    m_file_offset += m_size;
+    m_size = 0;
+}
+
+#include "idlib/file_system/footer.in"
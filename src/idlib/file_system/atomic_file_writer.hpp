@@ -0,0 +1,119 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/atomic_file_writer.hpp
+/// @brief Crash-safe replacement of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/durability.hpp"
+
+#include "idlib/file_system/header.in"
+
+class atomic_file_impl;
+
+/// @brief Writes a file sequentially and replaces the file atomically when the writing is committed.
+/// @detail
+/// The Bytes are written to a temporary file in the directory of the file. When the writing is committed, the
+/// temporary file is synchronized according to the durability and renamed to the file. Hence readers and, depending
+/// on the durability, crashes never leave an incomplete file behind.
+/// If the writer is discarded or destroyed before the writing is committed, then the temporary file is removed and the
+/// file is not changed.
+/// @code
+/// id::file_system::atomic_file_writer writer;
+/// writer.open("output.bin");
+/// writer.write(data, size);
+/// writer.commit();
+/// @endcode
+/// @remark If a file is replaced, then its permissions are retained.
+class atomic_file_writer
+{
+private:
+    /// @brief A pointer to the temporary file.
+    std::unique_ptr<atomic_file_impl> m_pimpl;
+    /// @brief The pathname of the file.
+    std::string m_pathname;
+    /// @brief The durability.
+    durability m_durability;
+    /// @brief The buffer.
+    std::vector<char> m_buffer;
+    /// @brief The number of buffered Bytes.
+    size_t m_size;
+    /// @brief The offset, in Bytes, in the temporary file of the first buffered Byte.
+    size_t m_file_offset;
+
+public:
+    /// @brief Construct this atomic file writer.
+    /// @post The atomic file writer is closed.
+    atomic_file_writer();
+
+    /// @brief Destruct this atomic file writer.
+    /// @post The atomic file writer is closed. If the writing was not committed, then the file is not changed.
+    ~atomic_file_writer() noexcept;
+
+    // Delete copy constructor.
+    atomic_file_writer(const atomic_file_writer&) = delete;
+
+    // Delete copy assignment operator.
+    atomic_file_writer& operator=(const atomic_file_writer&) = delete;
+
+public:
+    /// @brief Ensure the atomic file writer is open.
+    /// @param pathname the pathname of the file
+    /// @param durability the durability
+    /// @param buffer_size the size, in Bytes, of the buffer. Must be positive.
+    /// @remark If the temporary file can not be created, then the atomic file writer is closed.
+    void open(const std::string& pathname, durability durability = durability::full, size_t buffer_size = 256 * 1024) noexcept;
+
+    /// @brief Get if the atomic file writer is open.
+    /// @return @a true if the atomic file writer is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Get the offset, in Bytes, in the file of the next Byte to be written.
+    /// @return the offset, in Bytes, in the file of the next Byte to be written
+    size_t position() const noexcept;
+
+    /// @brief Write Bytes.
+    /// @param bytes a pointer to an array of @a length Bytes
+    /// @param length the number of Bytes
+    /// @throw id::file_system::error the atomic file writer is not open or the environment fails
+    void write(const void *bytes, size_t length);
+
+    /// @brief Write Bytes.
+    /// @param bytes the Bytes
+    /// @throw id::file_system::error the atomic file writer is not open or the environment fails
+    void write(std::string_view bytes);
+
+    /// @brief Write the buffered Bytes, replace the file by the temporary file, and ensure the atomic file writer is
+    /// closed.
+    /// @throw id::file_system::error the atomic file writer is not open or the environment fails. The atomic file
+    /// writer is closed nevertheless.
+    void commit();
+
+    /// @brief Remove the temporary file and ensure the atomic file writer is closed.
+    /// @post The file is not changed.
+    void discard() noexcept;
+
+private:
+    /// @brief Write the buffered Bytes.
+    void flush();
+
+}; // class atomic_file_writer
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,129 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/atomic_write_batch.cpp
+/// @brief Crash-safe replacement of many files with grouped synchronization.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/atomic_write_batch.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/atomic_file_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/atomic_file_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+atomic_write_batch::atomic_write_batch(durability durability) :
+    m_durability(durability), m_entries()
+{}
+
+atomic_write_batch::~atomic_write_batch() noexcept
+{
+    discard();
+}
+
+void atomic_write_batch::write(const std::string& pathname, const void *bytes, size_t length)
+{
+    auto file = std::make_unique<atomic_file_impl>();
+    if (!file->create(pathname))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file `" + pathname + "`: unable to create temporary file");
+    }
+    file->write(0, bytes, length);
+    if (durability::none != m_durability)
+    {
+        file->start_writeback();
+    }
+    file->close();
+    m_entries.push_back({ pathname, std::move(file) });
+}
+
+void atomic_write_batch::write(const std::string& pathname, std::string_view bytes)
+{
+    write(pathname, bytes.data(), bytes.size());
+}
+
+size_t atomic_write_batch::size() const noexcept
+{
+    return m_entries.size();
+}
+
+void atomic_write_batch::commit()
+{
+    try
+    {
+        if (durability::none != m_durability)
+        {
+            std::vector<std::string> temporary_pathnames;
+            temporary_pathnames.reserve(m_entries.size());
+            for (const auto& entry : m_entries)
+            {
+                temporary_pathnames.push_back(entry.file->temporary_pathname());
+            }
+            if (!synchronize_files(temporary_pathnames, durability::full == m_durability))
+            {
+                throw id::file_system::error(__FILE__, __LINE__, "unable to commit files: unable to synchronize files");
+            }
+        }
+        for (auto& entry : m_entries)
+        {
+            if (!entry.file->replace(entry.pathname, durability::full == m_durability))
+            {
+                throw id::file_system::error(__FILE__, __LINE__, "unable to commit file `" + entry.pathname + "`: unable to replace file");
+            }
+        }
+        if (durability::full == m_durability)
+        {
+            std::unordered_set<std::string> directories;
+            for (const auto& entry : m_entries)
+            {
+                std::string directory = get_parent_directory(entry.pathname);
+                if (directories.insert(directory).second && !synchronize_directory(directory))
+                {
+                    throw id::file_system::error(__FILE__, __LINE__, "unable to commit files: unable to synchronize directory `" + directory + "`");
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        discard();
+        throw;
+    }
+    m_entries.clear();
+}
+
+void atomic_write_batch::discard() noexcept
+{
+    // Destroying a temporary file removes it.
+    m_entries.clear();
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,434 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/block_codec.cpp
+/// @brief Codecs compressing blocks of Bytes.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/block_codec.hpp"
+#include "idlib/file_system/error.hpp"
+#include "idlib/utility/byte_order.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The minimum length, in Bytes, of a match.
+constexpr size_t min_match = 4;
+/// @brief The last Bytes of a block are literals.
+constexpr size_t last_literals = 5;
+/// @brief A match must start at least this number of Bytes before the end of a block.
+constexpr size_t match_start_limit = 12;
+/// @brief The maximum distance, in Bytes, of a match.
+constexpr size_t max_distance = 65535;
+/// @brief The binary logarithm of the number of entries of the hash table.
+constexpr unsigned hash_log = 12;
+/// @brief Each 2^skip_trigger Bytes without a match the step of the search increases by one Byte.
+constexpr unsigned skip_trigger = 6;
+/// @brief The number of Bytes which must be available beyond a copy such that it may copy more Bytes than required.
+constexpr size_t wild_copy_margin = 16;
+
+inline uint32_t read32(const uint8_t *p) noexcept
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read64_little_endian(const uint8_t *p) noexcept
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return convert_byte_order(v, get_byte_order(), byte_order::little_endian);
+}
+
+inline uint32_t hash4(uint32_t v) noexcept
+{
+    return (v * 2654435761U) >> (32 - hash_log);
+}
+
+inline unsigned count_trailing_zeros(uint64_t v) noexcept
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (unsigned)index;
+#elif defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(v);
+#else
+    unsigned n = 0;
+    for (; 0 == (v & 1); v >>= 1)
+    {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/// @brief Get the end of the common prefix of two ranges.
+/// @param p, q the beginnings of the ranges
+/// @param limit the end of the range starting at @a p
+inline const uint8_t *extend_match(const uint8_t *p, const uint8_t *q, const uint8_t *limit) noexcept
+{
+    while (p + 8 <= limit)
+    {
+        const uint64_t difference = read64_little_endian(p) ^ read64_little_endian(q);
+        if (0 != difference)
+        {
+            return p + count_trailing_zeros(difference) / 8;
+        }
+        p += 8;
+        q += 8;
+    }
+    while (p < limit && *p == *q)
+    {
+        ++p;
+        ++q;
+    }
+    return p;
+}
+
+inline uint8_t *write_length(uint8_t *target, size_t length) noexcept
+{
+    for (; length >= 255; length -= 255)
+    {
+        *target++ = 255;
+    }
+    *target++ = (uint8_t)length;
+    return target;
+}
+
+/// @brief Write the literals and the token of a sequence.
+inline uint8_t *write_literals(uint8_t *target, uint8_t *& token, const uint8_t *literals, size_t length) noexcept
+{
+    token = target++;
+    if (length >= 15)
+    {
+        *token = 15 << 4;
+        target = write_length(target, length - 15);
+    }
+    else
+    {
+        *token = (uint8_t)(length << 4);
+    }
+    if (0 != length)
+    {
+        memcpy(target, literals, length);
+    }
+    return target + length;
+}
+
+inline bool read_length(const uint8_t *& source, const uint8_t *end, size_t& length) noexcept
+{
+    uint8_t byte;
+    do
+    {
+        if (source == end)
+        {
+            return false;
+        }
+        byte = *source++;
+        length += byte;
+    } while (255 == byte);
+    return true;
+}
+
+/// @brief The process-wide registry of block codecs.
+struct block_codec_registry
+{
+    std::mutex mutex;
+    std::unordered_map<uint32_t, std::shared_ptr<const block_codec>> codecs;
+
+    block_codec_registry() :
+        mutex(), codecs()
+    {
+        codecs.emplace(stored_block_codec::identifier, std::make_shared<stored_block_codec>());
+        codecs.emplace(lz4_block_codec::identifier, std::make_shared<lz4_block_codec>());
+    }
+};
+
+block_codec_registry& get_block_codec_registry()
+{
+    static block_codec_registry registry;
+    return registry;
+}
+
+} // namespace
+
+block_codec::~block_codec()
+{}
+
+uint32_t stored_block_codec::id() const noexcept
+{
+    return identifier;
+}
+
+const char *stored_block_codec::name() const noexcept
+{
+    return "stored";
+}
+
+size_t stored_block_codec::max_compressed_size(size_t size) const noexcept
+{
+    return size;
+}
+
+size_t stored_block_codec::compress(const char *source, size_t source_size, char *target) const
+{
+    if (0 != source_size)
+    {
+        memcpy(target, source, source_size);
+    }
+    return source_size;
+}
+
+bool stored_block_codec::decompress(const char *source, size_t source_size, char *target, size_t target_size) const
+{
+    if (source_size != target_size)
+    {
+        return false;
+    }
+    if (0 != source_size)
+    {
+        memcpy(target, source, source_size);
+    }
+    return true;
+}
+
+uint32_t lz4_block_codec::id() const noexcept
+{
+    return identifier;
+}
+
+const char *lz4_block_codec::name() const noexcept
+{
+    return "lz4";
+}
+
+size_t lz4_block_codec::max_compressed_size(size_t size) const noexcept
+{
+    return size + size / 255 + 16;
+}
+
+size_t lz4_block_codec::compress(const char *source, size_t source_size, char *target) const
+{
+    if (source_size > std::numeric_limits<uint32_t>::max())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to compress block: block too large");
+    }
+    const uint8_t *const begin = reinterpret_cast<const uint8_t *>(source), *const end = begin + source_size;
+    uint8_t *output = reinterpret_cast<uint8_t *>(target), *token;
+    const uint8_t *anchor = begin;
+    // Blocks too small to contain a match consist of literals only.
+    if (source_size > match_start_limit)
+    {
+        uint32_t table[1 << hash_log] = {};
+        const uint8_t *const match_limit = end - last_literals;
+        const uint8_t *const search_limit = end - match_start_limit;
+        const uint8_t *current = begin + 1;
+        while (current <= search_limit)
+        {
+            const uint32_t hash = hash4(read32(current));
+            const uint8_t *match = begin + table[hash];
+            table[hash] = (uint32_t)(current - begin);
+            if ((size_t)(current - match) > max_distance || read32(match) != read32(current))
+            {
+                current += 1 + ((current - anchor) >> skip_trigger);
+                continue;
+            }
+            while (current > anchor && match > begin && current[-1] == match[-1])
+            {
+                --current;
+                --match;
+            }
+            const uint8_t *const match_end = extend_match(current + min_match, match + min_match, match_limit);
+            output = write_literals(output, token, anchor, (size_t)(current - anchor));
+            const size_t offset = (size_t)(current - match);
+            *output++ = (uint8_t)(offset & 0xFF);
+            *output++ = (uint8_t)(offset >> 8);
+            const size_t length = (size_t)(match_end - current) - min_match;
+            if (length >= 15)
+            {
+                *token |= 15;
+                output = write_length(output, length - 15);
+            }
+            else
+            {
+                *token |= (uint8_t)length;
+            }
+            current = anchor = match_end;
+            if (current <= search_limit)
+            {
+                table[hash4(read32(current - 2))] = (uint32_t)(current - 2 - begin);
+            }
+        }
+    }
+    output = write_literals(output, token, anchor, (size_t)(end - anchor));
+    return (size_t)(output - reinterpret_cast<uint8_t *>(target));
+}
+
+bool lz4_block_codec::decompress(const char *source, size_t source_size, char *target, size_t target_size) const
+{
+    const uint8_t *input = reinterpret_cast<const uint8_t *>(source), *const input_end = input + source_size;
+    uint8_t *const output_begin = reinterpret_cast<uint8_t *>(target), *const output_end = output_begin + target_size;
+    uint8_t *output = output_begin;
+    while (true)
+    {
+        if (input == input_end)
+        {
+            return false;
+        }
+        const uint8_t token = *input++;
+        size_t length = token >> 4;
+        // Fast path for a sequence of less than 15 literals followed by a short match at a distance of at least 8
+        // Bytes if the block and the target extend far enough beyond the sequence.
+        if (15 != length && (token & 15) < 15 && (size_t)(input_end - input) >= 2 * wild_copy_margin
+         && (size_t)(output_end - output) >= 2 * wild_copy_margin)
+        {
+            const size_t offset = (size_t)input[length] | ((size_t)input[length + 1] << 8);
+            if (offset >= 8 && offset <= (size_t)(output - output_begin) + length && input + length + 2 < input_end)
+            {
+                memcpy(output, input, 16);
+                input += length + 2;
+                output += length;
+                const uint8_t *match = output - offset;
+                memcpy(output, match, 8);
+                memcpy(output + 8, match + 8, 8);
+                memcpy(output + 16, match + 16, 2);
+                output += (token & 15) + min_match;
+                continue;
+            }
+        }
+        if (15 == length && !read_length(input, input_end, length))
+        {
+            return false;
+        }
+        if ((size_t)(input_end - input) < length || (size_t)(output_end - output) < length)
+        {
+            return false;
+        }
+        if ((size_t)(input_end - input) >= length + wild_copy_margin && (size_t)(output_end - output) >= length + wild_copy_margin)
+        {
+            // Copy 16 Bytes at a time, the Bytes copied beyond the literals are overwritten later.
+            for (size_t i = 0; i < length; i += 16)
+            {
+                memcpy(output + i, input + i, 16);
+            }
+        }
+        else if (0 != length)
+        {
+            memcpy(output, input, length);
+        }
+        input += length;
+        output += length;
+        // The last sequence consists of literals only.
+        if (input == input_end)
+        {
+            break;
+        }
+        if (input_end - input < 2)
+        {
+            return false;
+        }
+        const size_t offset = (size_t)input[0] | ((size_t)input[1] << 8);
+        input += 2;
+        if (0 == offset || offset > (size_t)(output - output_begin))
+        {
+            return false;
+        }
+        length = token & 15;
+        if (15 == length && !read_length(input, input_end, length))
+        {
+            return false;
+        }
+        length += min_match;
+        const size_t available = (size_t)(output_end - output);
+        if (available < length)
+        {
+            return false;
+        }
+        const uint8_t *match = output - offset;
+        if (available >= length + wild_copy_margin)
+        {
+            // Copy 8 Bytes at a time, the Bytes copied beyond the match are overwritten later.
+            size_t i = 0;
+            if (offset < 8)
+            {
+                // Copy the first 8 Bytes one at a time. The remaining Bytes repeat the Bytes at the smallest
+                // multiple of the offset which is at least 8 Bytes before them.
+                for (; i < 8; ++i)
+                {
+                    output[i] = match[i];
+                }
+                match = output - (8 + offset - 1) / offset * offset;
+            }
+            for (; i < length; i += 8)
+            {
+                memcpy(output + i, match + i, 8);
+            }
+        }
+        else if (offset >= length)
+        {
+            memcpy(output, match, length);
+        }
+        else
+        {
+            // The match overlaps the Bytes it produces.
+            for (size_t i = 0; i < length; ++i)
+            {
+                output[i] = match[i];
+            }
+        }
+        output += length;
+    }
+    return output == output_end;
+}
+
+void register_block_codec(std::shared_ptr<const block_codec> codec)
+{
+    if (!codec)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to register block codec: codec is null");
+    }
+    auto& registry = get_block_codec_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const uint32_t id = codec->id();
+    if (!registry.codecs.emplace(id, std::move(codec)).second)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to register block codec: a codec with identifier " + std::to_string(id) + " is registered");
+    }
+}
+
+std::shared_ptr<const block_codec> find_block_codec(uint32_t id)
+{
+    auto& registry = get_block_codec_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.codecs.find(id);
+    return registry.codecs.end() != it ? it->second : nullptr;
+}
+
+#include "idlib/file_system/footer.in"
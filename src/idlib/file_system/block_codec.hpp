@@ -0,0 +1,121 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/block_codec.hpp
+/// @brief Codecs compressing blocks of Bytes.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A codec compressing and decompressing blocks of Bytes.
+/// @detail
+/// A codec is identified by its identifier which is stored in the files it compressed. Codecs are looked up by their
+/// identifiers in a process-wide registry (see id::file_system::register_block_codec). The codecs
+/// id::file_system::stored_block_codec and id::file_system::lz4_block_codec are built in, further codecs (e.g. a codec
+/// wrapping an external library) are provided by registering them.
+/// @remark A codec must be safe to use concurrently by several threads.
+class block_codec
+{
+public:
+    /// @brief Destruct this block codec.
+    virtual ~block_codec();
+
+public:
+    /// @brief Get the identifier of this codec.
+    /// @return the identifier of this codec
+    virtual uint32_t id() const noexcept = 0;
+
+    /// @brief Get the name of this codec.
+    /// @return the name of this codec
+    virtual const char *name() const noexcept = 0;
+
+    /// @brief Get the maximum size, in Bytes, of a compressed block.
+    /// @param size the size, in Bytes, of the uncompressed block
+    /// @return the maximum size, in Bytes, of the compressed block
+    virtual size_t max_compressed_size(size_t size) const noexcept = 0;
+
+    /// @brief Compress a block.
+    /// @param source a pointer to an array of @a source_size Bytes
+    /// @param source_size the size, in Bytes, of the uncompressed block
+    /// @param target a pointer to an array of at least max_compressed_size(@a source_size) Bytes
+    /// @return the size, in Bytes, of the compressed block
+    virtual size_t compress(const char *source, size_t source_size, char *target) const = 0;
+
+    /// @brief Decompress a block.
+    /// @param source a pointer to an array of @a source_size Bytes
+    /// @param source_size the size, in Bytes, of the compressed block
+    /// @param target a pointer to an array of @a target_size Bytes
+    /// @param target_size the size, in Bytes, of the uncompressed block
+    /// @return @a true if the block was decompressed, @a false if the compressed block is invalid
+    /// @remark Invalid compressed blocks must be detected, that is, must neither cause reads beyond the source nor
+    /// writes beyond the target.
+    virtual bool decompress(const char *source, size_t source_size, char *target, size_t target_size) const = 0;
+
+}; // class block_codec
+
+/// @brief A codec storing blocks without compression.
+class stored_block_codec : public block_codec
+{
+public:
+    /// @brief The identifier of this codec.
+    static constexpr uint32_t identifier = 0;
+
+public:
+    uint32_t id() const noexcept override;
+    const char *name() const noexcept override;
+    size_t max_compressed_size(size_t size) const noexcept override;
+    size_t compress(const char *source, size_t source_size, char *target) const override;
+    bool decompress(const char *source, size_t source_size, char *target, size_t target_size) const override;
+
+}; // class stored_block_codec
+
+/// @brief A codec compressing blocks in the LZ4 block format.
+/// @detail
+/// The compressor is a greedy single-pass matcher with a hash table of 4096 entries and skips ahead faster in
+/// incompressible data. Its output is decompressed by any LZ4 block decompressor and any LZ4 block is decompressed
+/// by this codec.
+class lz4_block_codec : public block_codec
+{
+public:
+    /// @brief The identifier of this codec.
+    static constexpr uint32_t identifier = 1;
+
+public:
+    uint32_t id() const noexcept override;
+    const char *name() const noexcept override;
+    size_t max_compressed_size(size_t size) const noexcept override;
+    size_t compress(const char *source, size_t source_size, char *target) const override;
+    bool decompress(const char *source, size_t source_size, char *target, size_t target_size) const override;
+
+}; // class lz4_block_codec
+
+/// @brief Register a block codec.
+/// @param codec the codec
+/// @throw id::file_system::error the codec is a null pointer or a codec with the same identifier is registered
+void register_block_codec(std::shared_ptr<const block_codec> codec);
+
+/// @brief Find a registered block codec.
+/// @param id the identifier of the codec
+/// @return the codec if a codec of the specified identifier is registered, a null pointer otherwise
+std::shared_ptr<const block_codec> find_block_codec(uint32_t id);
+
+#include "idlib/file_system/footer.in"
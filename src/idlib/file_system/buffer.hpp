@@ -0,0 +1,46 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/buffer.hpp
+/// @brief Buffers for scatter/gather input and output.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A buffer to read into.
+struct mutable_buffer
+{
+    /// @brief A pointer to the Bytes of the buffer.
+    void *data;
+    /// @brief The size, in Bytes, of the buffer.
+    size_t size;
+};
+
+/// @brief A buffer to write from.
+struct const_buffer
+{
+    /// @brief A pointer to the Bytes of the buffer.
+    const void *data;
+    /// @brief The size, in Bytes, of the buffer.
+    size_t size;
+};
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,266 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/buffered_reader.cpp
+/// @brief Buffered sequential reading of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/buffered_reader.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+buffered_reader::buffered_reader() :
+    m_file(), m_mapped_file(), m_mapped(false), m_mapping(nullptr), m_mapping_size(0), m_chunk_size(0), m_buffer(), m_begin(0), m_end(0), m_file_offset(0),
+    m_end_of_file(false), m_position(0)
+{}
+
+buffered_reader::~buffered_reader() noexcept
+{
+    close();
+}
+
+void buffered_reader::open(const std::string& pathname, size_t chunk_size, size_t mapping_threshold) noexcept
+{
+    close();
+    if (0 == chunk_size)
+    {
+        return;
+    }
+    m_file.open(pathname, access_mode::read, create_mode::open_existing);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    size_t size;
+    try
+    {
+        size = m_file.size();
+    }
+    catch (...)
+    {
+        m_file.close();
+        return;
+    }
+    if (size >= mapping_threshold && size > 0)
+    {
+        m_mapped_file.open_read(pathname, create_mode::open_existing);
+        if (m_mapped_file.is_open())
+        {
+            m_file.close();
+            m_mapped = true;
+            m_mapping = m_mapped_file.data();
+            m_mapping_size = m_mapped_file.size();
+            try
+            {
+                m_mapped_file.advise(access_advice::sequential);
+            }
+            catch (...)
+            {}
+            return;
+        }
+        // Fall back to reading the file.
+    }
+    try
+    {
+        m_buffer.resize(2 * chunk_size);
+    }
+    catch (...)
+    {
+        m_file.close();
+        return;
+    }
+    m_chunk_size = chunk_size;
+}
+
+bool buffered_reader::is_open() const noexcept
+{
+    // The chunk size is non-zero if and only if the file is read.
+    return m_mapped || 0 != m_chunk_size;
+}
+
+bool buffered_reader::is_mapped() const noexcept
+{
+    return m_mapped;
+}
+
+void buffered_reader::close() noexcept
+{
+    m_mapped_file.close();
+    m_mapped = false;
+    m_mapping = nullptr;
+    m_mapping_size = 0;
+    m_file.close();
+    m_buffer = std::vector<char>();
+    m_chunk_size = 0;
+    m_begin = m_end = 0;
+    m_file_offset = 0;
+    m_end_of_file = false;
+    m_position = 0;
+}
+
+size_t buffered_reader::position() const noexcept
+{
+    return m_position;
+}
+
+void buffered_reader::fill(size_t length)
+{
+    if (m_end - m_begin >= length || m_end_of_file)
+    {
+        return;
+    }
+    // Move the unconsumed Bytes to the front.
+    if (0 != m_begin)
+    {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+    // Ensure there is room for the Bytes and at least one chunk.
+    size_t capacity = ((length + m_chunk_size - 1) / m_chunk_size + 1) * m_chunk_size;
+    if (m_buffer.size() < capacity)
+    {
+        m_buffer.resize(capacity);
+    }
+    while (m_end < length && !m_end_of_file)
+    {
+        // Read whole chunks only such that the file offsets remain multiples of the chunk size.
+        size_t count = (m_buffer.size() - m_end) / m_chunk_size * m_chunk_size;
+        size_t result = m_file.read_some(m_file_offset, m_buffer.data() + m_end, count);
+        m_end += result;
+        m_file_offset += result;
+        if (result < count)
+        {
+            m_end_of_file = true;
+        }
+    }
+}
+
+std::string_view buffered_reader::peek(size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    if (m_mapped)
+    {
+        return std::string_view(m_mapping + m_position, std::min(length, m_mapping_size - m_position));
+    }
+    fill(length);
+    return std::string_view(m_buffer.data() + m_begin, std::min(length, m_end - m_begin));
+}
+
+size_t buffered_reader::skip(size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    if (m_mapped)
+    {
+        size_t count = std::min(length, m_mapping_size - m_position);
+        m_position += count;
+        return count;
+    }
+    size_t count = std::min(length, m_end - m_begin);
+    m_begin += count;
+    m_position += count;
+    if (count < length && !m_end_of_file)
+    {
+        // Skip the remaining Bytes without reading them but keep the file offsets multiples of the chunk size.
+        size_t target = std::min(m_position + (length - count), m_file.size());
+        m_begin = m_end = 0;
+        m_file_offset = target - target % m_chunk_size;
+        fill(target - m_file_offset);
+        m_begin = std::min(target - (m_file_offset - m_end), m_end);
+        count += target - m_position;
+        m_position = target;
+    }
+    return count;
+}
+
+std::string_view buffered_reader::read(size_t length)
+{
+    if (m_mapped && m_mapping_size - m_position >= length)
+    {
+        std::string_view slice(m_mapping + m_position, length);
+        m_position += length;
+        return slice;
+    }
+    if (!m_mapped && m_end - m_begin >= length)
+    {
+        // The Bytes are buffered.
+        std::string_view slice(m_buffer.data() + m_begin, length);
+        m_begin += length;
+        m_position += length;
+        return slice;
+    }
+    std::string_view slice = peek(length);
+    skip(slice.size());
+    return slice;
+}
+
+bool buffered_reader::read_line(std::string_view& line)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    size_t scanned = 0;
+    while (true)
+    {
+        // Search the buffered Bytes first and refill only if the line is incomplete.
+        std::string_view available = m_mapped
+                                   ? std::string_view(m_mapping + m_position, m_mapping_size - m_position)
+                                   : std::string_view(m_buffer.data() + m_begin, m_end - m_begin);
+        size_t index = available.find('\n', scanned);
+        if (std::string_view::npos != index)
+        {
+            line = available.substr(0, index);
+            if (m_mapped)
+            {
+                m_position += index + 1;
+            }
+            else
+            {
+                m_begin += index + 1;
+                m_position += index + 1;
+            }
+            return true;
+        }
+        if (m_mapped || m_end_of_file)
+        {
+            if (available.empty())
+            {
+                return false;
+            }
+            line = available;
+            skip(available.size());
+            return true;
+        }
+        scanned = available.size();
+        fill(available.size() + 1);
+    }
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,142 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/buffered_reader.hpp
+/// @brief Buffered sequential reading of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/file.hpp"
+#include "idlib/file_system/mapped_file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Reads a file sequentially and hands out slices of its contents without copying.
+/// @detail
+/// The reader reads whole chunks into a reusable buffer. Before the buffer is refilled, the unconsumed Bytes are moved
+/// to its front such that slices are contiguous. Reads are issued at offsets which are multiples of the chunk size.
+/// If the file is at least as large as the mapping threshold, then the file is mapped instead and slices point into
+/// the mapping.
+/// @code
+/// id::file_system::buffered_reader reader;
+/// reader.open(pathname);
+/// std::string_view line;
+/// while (reader.read_line(line))
+/// {
+///     ...
+/// }
+/// @endcode
+/// @remark A slice remains valid until the next call of a non-const member function.
+class buffered_reader
+{
+private:
+    /// @brief The file descriptor if the file is read.
+    file_descriptor m_file;
+    /// @brief The mapped file descriptor if the file is mapped.
+    mapped_file_descriptor m_mapped_file;
+    /// @brief @a true if the file is mapped, @a false otherwise.
+    bool m_mapped;
+    /// @brief A pointer to the mapping if the file is mapped.
+    const char *m_mapping;
+    /// @brief The size, in Bytes, of the mapping if the file is mapped.
+    size_t m_mapping_size;
+    /// @brief The size, in Bytes, of a chunk.
+    size_t m_chunk_size;
+    /// @brief The buffer.
+    std::vector<char> m_buffer;
+    /// @brief The offset, in Bytes, in the buffer of the first unconsumed Byte.
+    size_t m_begin;
+    /// @brief The offset, in Bytes, in the buffer of the Byte following the last buffered Byte.
+    size_t m_end;
+    /// @brief The offset, in Bytes, in the file of the Byte following the last buffered Byte.
+    size_t m_file_offset;
+    /// @brief @a true if the end of the file was reached, @a false otherwise.
+    bool m_end_of_file;
+    /// @brief The offset, in Bytes, in the file of the first unconsumed Byte.
+    size_t m_position;
+
+public:
+    /// @brief Construct this buffered reader.
+    /// @post The buffered reader is closed.
+    buffered_reader();
+
+    /// @brief Destruct this buffered reader.
+    /// @post The buffered reader is closed.
+    ~buffered_reader() noexcept;
+
+    // Delete copy constructor.
+    buffered_reader(const buffered_reader&) = delete;
+
+    // Delete copy assignment operator.
+    buffered_reader& operator=(const buffered_reader&) = delete;
+
+public:
+    /// @brief Ensure the buffered reader is open.
+    /// @param pathname the pathname of the file
+    /// @param chunk_size the size, in Bytes, of a chunk. Must be positive.
+    /// @param mapping_threshold the size, in Bytes, from which on the file is mapped
+    void open(const std::string& pathname, size_t chunk_size = 256 * 1024, size_t mapping_threshold = 64 * 1024 * 1024) noexcept;
+
+    /// @brief Get if the buffered reader is open.
+    /// @return @a true if the buffered reader is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Get if the file is mapped.
+    /// @return @a true if the buffered reader is open and the file is mapped, @a false otherwise
+    bool is_mapped() const noexcept;
+
+    /// @brief Ensure the buffered reader is closed.
+    void close() noexcept;
+
+    /// @brief Get the offset, in Bytes, in the file of the next Byte to be read.
+    /// @return the offset, in Bytes, in the file of the next Byte to be read
+    size_t position() const noexcept;
+
+    /// @brief Get Bytes without consuming them.
+    /// @param length the number of Bytes
+    /// @return a slice of @a length Bytes. Less Bytes only if the end of the file was reached.
+    /// @throw id::file_system::error the buffered reader is not open or the environment fails
+    std::string_view peek(size_t length);
+
+    /// @brief Consume Bytes.
+    /// @param length the number of Bytes
+    /// @return the number of Bytes consumed. Less than @a length only if the end of the file was reached.
+    /// @throw id::file_system::error the buffered reader is not open or the environment fails
+    size_t skip(size_t length);
+
+    /// @brief Get and consume Bytes.
+    /// @param length the number of Bytes
+    /// @return a slice of @a length Bytes. Less Bytes only if the end of the file was reached.
+    /// @throw id::file_system::error the buffered reader is not open or the environment fails
+    std::string_view read(size_t length);
+
+    /// @brief Get and consume a line.
+    /// @param [out] line a slice of the line excluding the line feed
+    /// @return @a true if a line was read, @a false if the end of the file was reached
+    /// @throw id::file_system::error the buffered reader is not open or the environment fails
+    /// @remark The last line need not be terminated by a line feed.
+    bool read_line(std::string_view& line);
+
+private:
+    /// @brief Ensure a number of Bytes is buffered unless the end of the file is reached.
+    /// @param length the number of Bytes
+    void fill(size_t length);
+
+}; // class buffered_reader
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,160 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/buffered_writer.cpp
+/// @brief Buffered sequential writing of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/buffered_writer.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+buffered_writer::buffered_writer() :
+    m_file(), m_buffer(), m_size(0), m_file_offset(0)
+{}
+
+buffered_writer::~buffered_writer() noexcept
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {}
+}
+
+void buffered_writer::open(const std::string& pathname, create_mode create_mode, size_t buffer_size) noexcept
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {}
+    if (0 == buffer_size)
+    {
+        return;
+    }
+    m_file.open(pathname, access_mode::write, create_mode);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    try
+    {
+        m_file_offset = m_file.size();
+        m_buffer.resize(buffer_size);
+    }
+    catch (...)
+    {
+        m_file.close();
+    }
+}
+
+bool buffered_writer::is_open() const noexcept
+{
+    return m_file.is_open();
+}
+
+void buffered_writer::close()
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        m_file.close();
+        m_buffer = std::vector<char>();
+        m_size = 0;
+        throw;
+    }
+    m_file.close();
+    m_buffer = std::vector<char>();
+    m_size = 0;
+}
+
+size_t buffered_writer::position() const noexcept
+{
+    return m_file_offset + m_size;
+}
+
+void buffered_writer::write(const void *bytes, size_t length)
+{
+    if (!m_file.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    if (0 == length)
+    {
+        return;
+    }
+    if (length <= m_buffer.size() - m_size)
+    {
+        std::memcpy(m_buffer.data() + m_size, bytes, length);
+        m_size += length;
+        return;
+    }
+    if (length < m_buffer.size())
+    {
+        // Fill the buffer, write it, and buffer the remaining Bytes.
+        size_t count = m_buffer.size() - m_size;
+        std::memcpy(m_buffer.data() + m_size, bytes, count);
+        m_size += count;
+        flush();
+        std::memcpy(m_buffer.data(), static_cast<const char *>(bytes) + count, length - count);
+        m_size = length - count;
+        return;
+    }
+    // Write the buffered Bytes and the Bytes by a single gathering write.
+    const_buffer buffers[] = { { m_buffer.data(), m_size }, { bytes, length } };
+    m_file.write(m_file_offset, buffers, 2);
+    m_file_offset += m_size + length;
+    m_size = 0;
+}
+
+void buffered_writer::write(std::string_view bytes)
+{
+    write(bytes.data(), bytes.size());
+}
+
+void buffered_writer::flush()
+{
+    if (!m_file.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    if (0 == m_size)
+    {
+        return;
+    }
+    m_file.write(m_file_offset, m_buffer.data(), m_size);
+    m_file_offset += m_size;
+    m_size = 0;
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,98 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/buffered_writer.hpp
+/// @brief Buffered sequential writing of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Writes a file sequentially and coalesces small writes into large writes.
+/// @detail
+/// Bytes are appended to a buffer which is written when it is full. A write larger than the buffer is written
+/// together with the buffered Bytes by a single gathering write.
+/// @remark Writing starts at the end of the file, hence an existing file is appended to.
+class buffered_writer
+{
+private:
+    /// @brief The file descriptor.
+    file_descriptor m_file;
+    /// @brief The buffer.
+    std::vector<char> m_buffer;
+    /// @brief The number of buffered Bytes.
+    size_t m_size;
+    /// @brief The offset, in Bytes, in the file of the first buffered Byte.
+    size_t m_file_offset;
+
+public:
+    /// @brief Construct this buffered writer.
+    /// @post The buffered writer is closed.
+    buffered_writer();
+
+    /// @brief Destruct this buffered writer.
+    /// @post The buffered writer is closed.
+    /// @remark Buffered Bytes are written, failures are ignored. Invoke close() to observe failures.
+    ~buffered_writer() noexcept;
+
+    // Delete copy constructor.
+    buffered_writer(const buffered_writer&) = delete;
+
+    // Delete copy assignment operator.
+    buffered_writer& operator=(const buffered_writer&) = delete;
+
+public:
+    /// @brief Ensure the buffered writer is open.
+    /// @param pathname the pathname of the file
+    /// @param create_mode the create mode
+    /// @param buffer_size the size, in Bytes, of the buffer. Must be positive.
+    void open(const std::string& pathname, create_mode create_mode = create_mode::create_not_existing,
+              size_t buffer_size = 256 * 1024) noexcept;
+
+    /// @brief Get if the buffered writer is open.
+    /// @return @a true if the buffered writer is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Write the buffered Bytes and ensure the buffered writer is closed.
+    /// @throw id::file_system::error the environment fails. The buffered writer is closed nevertheless.
+    void close();
+
+    /// @brief Get the offset, in Bytes, in the file of the next Byte to be written.
+    /// @return the offset, in Bytes, in the file of the next Byte to be written
+    size_t position() const noexcept;
+
+    /// @brief Write Bytes.
+    /// @param bytes a pointer to an array of @a length Bytes
+    /// @param length the number of Bytes
+    /// @throw id::file_system::error the buffered writer is not open or the environment fails
+    void write(const void *bytes, size_t length);
+
+    /// @brief Write Bytes.
+    /// @param bytes the Bytes
+    /// @throw id::file_system::error the buffered writer is not open or the environment fails
+    void write(std::string_view bytes);
+
+    /// @brief Write the buffered Bytes.
+    /// @throw id::file_system::error the buffered writer is not open or the environment fails
+    void flush();
+
+}; // class buffered_writer
+
+#include "idlib/file_system/footer.in"
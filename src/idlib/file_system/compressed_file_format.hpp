@@ -0,0 +1,62 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/utility/little_endian.hpp"
+
+#include "idlib/file_system/header.in"
+
+namespace internal {
+
+/// @brief The layout of a compressed file shared by id::file_system::compressed_file_reader and
+/// id::file_system::compressed_file_writer.
+namespace compressed_file_format {
+
+/// @brief The magic number.
+constexpr char magic[4] = { 'I', 'D', 'C', 'F' };
+/// @brief The version.
+constexpr uint32_t version = 1;
+
+/// @brief The size, in Bytes, of the header.
+/// The header consists of the magic number, the version, the identifier of the codec, the size of a block, and
+/// reserved Bytes.
+constexpr size_t header_size = 32;
+constexpr size_t version_offset = 4;
+constexpr size_t codec_offset = 8;
+constexpr size_t block_size_offset = 12;
+
+/// @brief The size, in Bytes, of an entry of the index.
+/// An entry consists of the offset and the size of the compressed block, the flags, and the checksum of the
+/// compressed block.
+constexpr size_t entry_size = 24;
+
+/// @brief The flags of a block compressed by the codec of the file.
+constexpr uint32_t compressed = 0;
+/// @brief The flags of a block stored without compression because compression did not reduce its size.
+constexpr uint32_t stored = 1;
+
+/// @brief The size, in Bytes, of the trailer.
+/// The trailer consists of the offset of the index, the number of blocks, the uncompressed size, the checksum of
+/// the index and the trailer, the magic number, and the version.
+constexpr size_t trailer_size = 40;
+constexpr size_t number_of_blocks_offset = 8;
+constexpr size_t uncompressed_size_offset = 16;
+constexpr size_t checksum_offset = 24;
+constexpr size_t trailer_magic_offset = 32;
+constexpr size_t trailer_version_offset = 36;
+
+using id::internal::read_u64;
+using id::internal::read_u32;
+using id::internal::write_u64;
+using id::internal::write_u32;
+
+} // namespace compressed_file_format
+
+} // namespace internal
+
+#include "idlib/file_system/footer.in"
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
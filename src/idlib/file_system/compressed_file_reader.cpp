@@ -0,0 +1,356 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/compressed_file_reader.cpp
+/// @brief Random access to seekable block-compressed files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/compressed_file_reader.hpp"
+#include "idlib/file_system/compressed_file_format.hpp"
+#include "idlib/file_system/content_hash.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+using namespace internal::compressed_file_format;
+
+compressed_file_reader::compressed_file_reader(thread_pool& pool, size_t capacity, size_t read_ahead) :
+    m_pool(&pool), m_file(), m_data(nullptr), m_codec(), m_block_size(0), m_number_of_blocks(0), m_size(0),
+    m_index(nullptr), m_cache(), m_cache_map(), m_capacity(capacity), m_read_ahead(std::min(read_ahead, capacity)),
+    m_next_offset(0), m_hits(0), m_misses(0)
+{
+    if (0 == capacity)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "capacity is zero");
+    }
+}
+
+compressed_file_reader::~compressed_file_reader() noexcept
+{
+    close();
+}
+
+void compressed_file_reader::open(const std::string& pathname) noexcept
+{
+    close();
+    m_file.open_read(pathname, create_mode::open_existing);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    const char *data = m_file.data();
+    const uint64_t file_size = m_file.size();
+    if (file_size < header_size + trailer_size || 0 != memcmp(data, magic, sizeof(magic)) || version != read_u32(data + version_offset))
+    {
+        close();
+        return;
+    }
+    const char *trailer = data + file_size - trailer_size;
+    if (0 != memcmp(trailer + trailer_magic_offset, magic, sizeof(magic)) || version != read_u32(trailer + trailer_version_offset))
+    {
+        close();
+        return;
+    }
+    const uint64_t block_size = read_u32(data + block_size_offset),
+                   index_offset = read_u64(trailer),
+                   number_of_blocks = read_u64(trailer + number_of_blocks_offset),
+                   size = read_u64(trailer + uncompressed_size_offset);
+    // The index must end where the trailer starts and there must be exactly as many blocks as the size requires.
+    if (0 == block_size || index_offset < header_size || index_offset > file_size - trailer_size
+     || number_of_blocks != (file_size - trailer_size - index_offset) / entry_size
+     || number_of_blocks * entry_size != file_size - trailer_size - index_offset
+     || number_of_blocks != size / block_size + (0 != size % block_size ? 1 : 0))
+    {
+        close();
+        return;
+    }
+    const char *index = data + index_offset;
+    if (read_u64(trailer + checksum_offset) != hash_bytes(index, (size_t)(number_of_blocks * entry_size), hash_bytes(trailer, checksum_offset)))
+    {
+        close();
+        return;
+    }
+    try
+    {
+        m_codec = find_block_codec(read_u32(data + codec_offset));
+    }
+    catch (...)
+    {}
+    if (!m_codec)
+    {
+        close();
+        return;
+    }
+    for (uint64_t i = 0; i < number_of_blocks; ++i)
+    {
+        const char *entry = index + i * entry_size;
+        const uint64_t offset = read_u64(entry);
+        const uint32_t compressed_size = read_u32(entry + 8), flags = read_u32(entry + 12);
+        const uint64_t uncompressed_size = std::min(block_size, size - i * block_size);
+        if (offset < header_size || offset > index_offset || compressed_size > index_offset - offset
+         || (stored == flags && compressed_size != uncompressed_size)
+         || (compressed == flags && compressed_size > m_codec->max_compressed_size((size_t)uncompressed_size))
+         || (stored != flags && compressed != flags))
+        {
+            close();
+            return;
+        }
+    }
+    m_data = data;
+    m_block_size = (size_t)block_size;
+    m_number_of_blocks = (size_t)number_of_blocks;
+    m_size = size;
+    m_index = index;
+}
+
+bool compressed_file_reader::is_open() const noexcept
+{
+    return nullptr != m_index;
+}
+
+void compressed_file_reader::close() noexcept
+{
+    clear();
+    m_file.close();
+    m_data = nullptr;
+    m_codec = nullptr;
+    m_block_size = 0;
+    m_number_of_blocks = 0;
+    m_size = 0;
+    m_index = nullptr;
+    m_next_offset = 0;
+}
+
+uint64_t compressed_file_reader::size() const noexcept
+{
+    return m_size;
+}
+
+size_t compressed_file_reader::block_size() const noexcept
+{
+    return m_block_size;
+}
+
+size_t compressed_file_reader::number_of_blocks() const noexcept
+{
+    return m_number_of_blocks;
+}
+
+size_t compressed_file_reader::read(uint64_t offset, void *buffer, size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read compressed file: file is not open");
+    }
+    if (offset >= m_size || 0 == length)
+    {
+        return 0;
+    }
+    length = (size_t)std::min<uint64_t>(length, m_size - offset);
+    const size_t first = (size_t)(offset / m_block_size), last = (size_t)((offset + length - 1) / m_block_size);
+    const bool sequential = offset == m_next_offset;
+    m_next_offset = offset + length;
+    // A block to decompress either into the buffer of the read or into a new cached block.
+    struct job
+    {
+        size_t index;
+        char *target;
+        std::shared_ptr<block> decompressed;
+    };
+    std::vector<job> jobs;
+    std::vector<std::shared_ptr<const block>> sources(last - first + 1);
+    char *target = static_cast<char *>(buffer);
+    for (size_t i = first; i <= last; ++i)
+    {
+        const uint64_t block_offset = (uint64_t)i * m_block_size;
+        const size_t block_size = get_block_size(i);
+        if (auto cached = find(i))
+        {
+            sources[i - first] = std::move(cached);
+            m_hits++;
+        }
+        else if (offset <= block_offset && block_offset + block_size <= offset + length)
+        {
+            jobs.push_back({ i, target + (block_offset - offset), nullptr });
+        }
+        else
+        {
+            auto decompressed = std::make_shared<block>(block_size);
+            jobs.push_back({ i, decompressed->data(), decompressed });
+            sources[i - first] = std::move(decompressed);
+        }
+    }
+    // Blocks are decompressed ahead only if the read misses, hence the blocks ahead are decompressed in batches.
+    if (sequential && !jobs.empty())
+    {
+        for (size_t i = last + 1, n = std::min(m_number_of_blocks, last + 1 + m_read_ahead); i < n; ++i)
+        {
+            if (0 == m_cache_map.count(i))
+            {
+                auto decompressed = std::make_shared<block>(get_block_size(i));
+                jobs.push_back({ i, decompressed->data(), std::move(decompressed) });
+            }
+        }
+    }
+    m_misses += jobs.size();
+    // Decompressing the blocks on the pool from a worker thread could deadlock.
+    if (jobs.size() <= 1 || m_pool->is_worker())
+    {
+        for (const auto& job : jobs)
+        {
+            decompress(job.index, job.target);
+        }
+    }
+    else
+    {
+        // The calling thread decompresses the first block.
+        task_group group;
+        for (size_t i = 1; i < jobs.size(); ++i)
+        {
+            m_pool->post(group, [this, &job = jobs[i]]()
+            {
+                decompress(job.index, job.target);
+            });
+        }
+        try
+        {
+            decompress(jobs[0].index, jobs[0].target);
+        }
+        catch (...)
+        {
+            group.wait();
+            throw;
+        }
+        group.wait();
+    }
+    for (auto& job : jobs)
+    {
+        if (job.decompressed)
+        {
+            insert(job.index, std::move(job.decompressed));
+        }
+    }
+    for (size_t i = first; i <= last; ++i)
+    {
+        const auto& source = sources[i - first];
+        if (!source)
+        {
+            continue;
+        }
+        const uint64_t block_offset = (uint64_t)i * m_block_size;
+        const uint64_t begin = std::max(offset, block_offset), end = std::min(offset + length, block_offset + source->size());
+        memcpy(target + (begin - offset), source->data() + (begin - block_offset), (size_t)(end - begin));
+    }
+    return length;
+}
+
+std::shared_ptr<const compressed_file_reader::block> compressed_file_reader::get_block(size_t index)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read compressed file: file is not open");
+    }
+    if (index >= m_number_of_blocks)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read compressed file: block index out of bounds");
+    }
+    if (auto cached = find(index))
+    {
+        m_hits++;
+        return cached;
+    }
+    m_misses++;
+    auto decompressed = std::make_shared<block>(get_block_size(index));
+    decompress(index, decompressed->data());
+    insert(index, decompressed);
+    return decompressed;
+}
+
+void compressed_file_reader::clear() noexcept
+{
+    m_cache.clear();
+    m_cache_map.clear();
+}
+
+size_t compressed_file_reader::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+size_t compressed_file_reader::hits() const noexcept
+{
+    return m_hits;
+}
+
+size_t compressed_file_reader::misses() const noexcept
+{
+    return m_misses;
+}
+
+size_t compressed_file_reader::get_block_size(size_t index) const noexcept
+{
+    return (size_t)std::min<uint64_t>(m_block_size, m_size - (uint64_t)index * m_block_size);
+}
+
+void compressed_file_reader::decompress(size_t index, char *target) const
+{
+    const char *entry = m_index + index * entry_size;
+    const char *source = m_data + read_u64(entry);
+    const size_t source_size = read_u32(entry + 8), target_size = get_block_size(index);
+    if (read_u64(entry + 16) != hash_bytes(source, source_size))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read compressed file: block " + std::to_string(index) + " is corrupted");
+    }
+    if (stored == read_u32(entry + 12))
+    {
+        memcpy(target, source, target_size);
+    }
+    else if (!m_codec->decompress(source, source_size, target, target_size))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read compressed file: block " + std::to_string(index) + " is corrupted");
+    }
+}
+
+std::shared_ptr<const compressed_file_reader::block> compressed_file_reader::find(size_t index) noexcept
+{
+    auto it = m_cache_map.find(index);
+    if (m_cache_map.end() == it)
+    {
+        return nullptr;
+    }
+    m_cache.splice(m_cache.begin(), m_cache, it->second);
+    return it->second->data;
+}
+
+void compressed_file_reader::insert(size_t index, std::shared_ptr<const block> block)
+{
+    m_cache.push_front({ index, std::move(block) });
+    m_cache_map[index] = m_cache.begin();
+    if (m_cache.size() > m_capacity)
+    {
+        m_cache_map.erase(m_cache.back().index);
+        m_cache.pop_back();
+    }
+}
+
+#include "idlib/file_system/footer.in"
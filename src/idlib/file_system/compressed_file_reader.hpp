@@ -0,0 +1,183 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/compressed_file_reader.hpp
+/// @brief Random access to seekable block-compressed files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/concurrency/thread_pool.hpp"
+#include "idlib/file_system/block_codec.hpp"
+#include "idlib/file_system/mapped_file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Reads ranges of a seekable block-compressed file.
+/// @detail
+/// A compressed file is created by id::file_system::compressed_file_writer. The compressed file is mapped and only the
+/// blocks touched by a read are decompressed:
+/// - blocks which are covered by the read are decompressed into the buffer of the read,
+/// - blocks which are partially covered by the read are decompressed into a cache of the most recently used blocks.
+/// If a read which starts where the preceding read ended misses the cache, then the next blocks are decompressed into
+/// the cache ahead of time (read-ahead). All blocks required by a read are decompressed in parallel by the tasks of a
+/// thread pool.
+/// The checksum of a compressed block is verified before the block is decompressed.
+/// @remark Concurrent invocations of member functions must be synchronized by the caller.
+class compressed_file_reader
+{
+public:
+    /// @brief A decompressed block.
+    using block = std::vector<char>;
+
+private:
+    /// @brief A cached block.
+    struct cache_entry
+    {
+        /// @brief The index of the block.
+        size_t index;
+        /// @brief The decompressed block.
+        std::shared_ptr<const block> data;
+    };
+
+    /// @brief The thread pool.
+    thread_pool *m_pool;
+    /// @brief The mapped file descriptor.
+    mapped_file_descriptor m_file;
+    /// @brief A pointer to the mapping of the file.
+    const char *m_data;
+    /// @brief The codec.
+    std::shared_ptr<const block_codec> m_codec;
+    /// @brief The size, in Bytes, of a block.
+    size_t m_block_size;
+    /// @brief The number of blocks.
+    size_t m_number_of_blocks;
+    /// @brief The uncompressed size, in Bytes, of the file.
+    uint64_t m_size;
+    /// @brief A pointer to the index.
+    const char *m_index;
+    /// @brief The cached blocks, the most recently used block first.
+    std::list<cache_entry> m_cache;
+    /// @brief Map from the indices of the cached blocks to the cached blocks.
+    std::unordered_map<size_t, std::list<cache_entry>::iterator> m_cache_map;
+    /// @brief The maximum number of cached blocks.
+    size_t m_capacity;
+    /// @brief The number of blocks decompressed ahead of a sequential read.
+    size_t m_read_ahead;
+    /// @brief The offset, in Bytes, at which the last read ended.
+    uint64_t m_next_offset;
+    /// @brief The number of blocks served by the cache.
+    size_t m_hits;
+    /// @brief The number of blocks which were decompressed.
+    size_t m_misses;
+
+public:
+    /// @brief Construct this compressed file reader.
+    /// @param pool the thread pool decompressing the blocks
+    /// @param capacity the maximum number of cached blocks
+    /// @param read_ahead the number of blocks decompressed ahead of a sequential read. Limited to @a capacity.
+    /// @throw id::file_system::error the capacity is zero
+    /// @post The compressed file reader is closed.
+    explicit compressed_file_reader(thread_pool& pool = thread_pool::shared(), size_t capacity = 32, size_t read_ahead = 8);
+
+    /// @brief Destruct this compressed file reader.
+    /// @post The compressed file reader is closed.
+    ~compressed_file_reader() noexcept;
+
+    // Delete copy constructor.
+    compressed_file_reader(const compressed_file_reader&) = delete;
+
+    // Delete copy assignment operator.
+    compressed_file_reader& operator=(const compressed_file_reader&) = delete;
+
+public:
+    /// @brief Ensure the compressed file reader is open.
+    /// @param pathname the pathname of the file
+    /// @remark If the file can not be opened, is not a valid compressed file, or its codec is not registered, then
+    /// the compressed file reader is closed.
+    void open(const std::string& pathname) noexcept;
+
+    /// @brief Get if the compressed file reader is open.
+    /// @return @a true if the compressed file reader is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Ensure the compressed file reader is closed.
+    void close() noexcept;
+
+    /// @brief Get the uncompressed size, in Bytes, of the file.
+    /// @return the uncompressed size, in Bytes, of the file if the compressed file reader is open, @a 0 otherwise
+    uint64_t size() const noexcept;
+
+    /// @brief Get the size, in Bytes, of a block.
+    /// @return the size, in Bytes, of a block if the compressed file reader is open, @a 0 otherwise
+    size_t block_size() const noexcept;
+
+    /// @brief Get the number of blocks.
+    /// @return the number of blocks if the compressed file reader is open, @a 0 otherwise
+    size_t number_of_blocks() const noexcept;
+
+    /// @brief Read Bytes.
+    /// @param offset the offset, in Bytes, in the uncompressed file of the first Byte to read
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @return the number of Bytes read. Less than @a length if the end of the file was reached.
+    /// @throw id::file_system::error the compressed file reader is not open or a block is corrupted
+    size_t read(uint64_t offset, void *buffer, size_t length);
+
+    /// @brief Get a decompressed block.
+    /// @param index the index of the block
+    /// @return the decompressed block. The block remains valid as long as it is referenced.
+    /// @throw id::file_system::error the compressed file reader is not open, the index is out of bounds, or the
+    /// block is corrupted
+    std::shared_ptr<const block> get_block(size_t index);
+
+    /// @brief Evict all blocks.
+    void clear() noexcept;
+
+    /// @brief Get the maximum number of cached blocks.
+    /// @return the maximum number of cached blocks
+    size_t capacity() const noexcept;
+
+    /// @brief Get the number of blocks served by the cache.
+    /// @return the number of blocks served by the cache
+    size_t hits() const noexcept;
+
+    /// @brief Get the number of blocks which were decompressed.
+    /// @return the number of blocks which were decompressed
+    size_t misses() const noexcept;
+
+private:
+    /// @brief Get the uncompressed size, in Bytes, of a block.
+    size_t get_block_size(size_t index) const noexcept;
+
+    /// @brief Decompress a block.
+    /// @param index the index of the block
+    /// @param target a pointer to a buffer of get_block_size(@a index) Bytes
+    /// @throw id::file_system::error the block is corrupted
+    void decompress(size_t index, char *target) const;
+
+    /// @brief Get a cached block and mark it as the most recently used block.
+    /// @return the cached block or a null pointer
+    std::shared_ptr<const block> find(size_t index) noexcept;
+
+    /// @brief Add a block to the cache and evict the least recently used block if the capacity is exceeded.
+    void insert(size_t index, std::shared_ptr<const block> block);
+
+}; // class compressed_file_reader
+
+#include "idlib/file_system/footer.in"
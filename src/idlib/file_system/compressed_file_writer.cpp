@@ -0,0 +1,234 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/compressed_file_writer.cpp
+/// @brief Creation of seekable block-compressed files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/compressed_file_writer.hpp"
+#include "idlib/file_system/buffer.hpp"
+#include "idlib/file_system/compressed_file_format.hpp"
+#include "idlib/file_system/content_hash.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+using namespace internal::compressed_file_format;
+
+compressed_file_writer::compressed_file_writer(thread_pool& pool) :
+    m_pool(&pool), m_codec(), m_file(), m_block_size(0), m_buffer(), m_size(0), m_compressed(), m_position(0), m_index()
+{}
+
+compressed_file_writer::~compressed_file_writer() noexcept
+{
+    discard();
+}
+
+void compressed_file_writer::open(const std::string& pathname, uint32_t codec, size_t block_size, durability durability) noexcept
+{
+    discard();
+    if (0 == block_size || block_size >= ((size_t)1 << 31))
+    {
+        return;
+    }
+    try
+    {
+        m_codec = find_block_codec(codec);
+        if (!m_codec)
+        {
+            return;
+        }
+        m_file.open(pathname, durability);
+        if (!m_file.is_open())
+        {
+            discard();
+            return;
+        }
+        // Buffer one block per thread of the pool and one block for the calling thread.
+        const size_t number_of_blocks = m_pool->size() + 1;
+        m_block_size = block_size;
+        m_buffer.resize(number_of_blocks * block_size);
+        m_compressed.resize(number_of_blocks);
+        char header[header_size] = {};
+        memcpy(header, magic, sizeof(magic));
+        write_u32(header + version_offset, version);
+        write_u32(header + codec_offset, codec);
+        write_u32(header + block_size_offset, (uint32_t)block_size);
+        m_file.write(header, header_size);
+    }
+    catch (...)
+    {
+        discard();
+    }
+}
+
+bool compressed_file_writer::is_open() const noexcept
+{
+    return m_file.is_open();
+}
+
+void compressed_file_writer::close()
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    try
+    {
+        write_blocks();
+        char trailer[trailer_size];
+        write_u64(trailer, m_file.position());
+        write_u64(trailer + number_of_blocks_offset, m_index.size() / entry_size);
+        write_u64(trailer + uncompressed_size_offset, m_position);
+        write_u64(trailer + checksum_offset, hash_bytes(m_index.data(), m_index.size(), hash_bytes(trailer, checksum_offset)));
+        memcpy(trailer + trailer_magic_offset, magic, sizeof(magic));
+        write_u32(trailer + trailer_version_offset, version);
+        m_file.write(m_index.data(), m_index.size());
+        m_file.write(trailer, trailer_size);
+        m_file.commit();
+    }
+    catch (...)
+    {
+        discard();
+        throw;
+    }
+    discard();
+}
+
+uint64_t compressed_file_writer::position() const noexcept
+{
+    return m_position;
+}
+
+void compressed_file_writer::write(const void *bytes, size_t length)
+{
+    if (!m_file.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write compressed file: file is not open");
+    }
+    const char *p = static_cast<const char *>(bytes);
+    while (length > 0)
+    {
+        const size_t n = std::min(length, m_buffer.size() - m_size);
+        memcpy(m_buffer.data() + m_size, p, n);
+        m_size += n;
+        m_position += n;
+        p += n;
+        length -= n;
+        if (m_size == m_buffer.size())
+        {
+            write_blocks();
+        }
+    }
+}
+
+void compressed_file_writer::write(std::string_view bytes)
+{
+    write(bytes.data(), bytes.size());
+}
+
+void compressed_file_writer::write_blocks()
+{
+    if (0 == m_size)
+    {
+        return;
+    }
+    const size_t number_of_blocks = (m_size + m_block_size - 1) / m_block_size;
+    std::vector<const_buffer> blocks(number_of_blocks);
+    std::vector<uint32_t> flags(number_of_blocks);
+    std::vector<uint64_t> checksums(number_of_blocks);
+    auto compress_blocks = [this, &blocks, &flags, &checksums](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            const char *source = m_buffer.data() + i * m_block_size;
+            const size_t source_size = std::min(m_block_size, m_size - i * m_block_size);
+            std::vector<char>& target = m_compressed[i];
+            target.resize(m_codec->max_compressed_size(source_size));
+            const size_t target_size = m_codec->compress(source, source_size, target.data());
+            if (target_size < source_size)
+            {
+                blocks[i] = { target.data(), target_size };
+                flags[i] = compressed;
+            }
+            else
+            {
+                blocks[i] = { source, source_size };
+                flags[i] = stored;
+            }
+            checksums[i] = hash_bytes(blocks[i].data, blocks[i].size);
+        }
+    };
+    // Compressing the blocks on the pool from a worker thread could deadlock.
+    if (1 == number_of_blocks || m_pool->is_worker())
+    {
+        compress_blocks(0, number_of_blocks);
+    }
+    else
+    {
+        // The calling thread compresses the first block.
+        task_group group;
+        for (size_t i = 1; i < number_of_blocks; ++i)
+        {
+            m_pool->post(group, [&compress_blocks, i]()
+            {
+                compress_blocks(i, i + 1);
+            });
+        }
+        try
+        {
+            compress_blocks(0, 1);
+        }
+        catch (...)
+        {
+            group.wait();
+            throw;
+        }
+        group.wait();
+    }
+    for (size_t i = 0; i < number_of_blocks; ++i)
+    {
+        char entry[entry_size];
+        write_u64(entry, m_file.position());
+        write_u32(entry + 8, (uint32_t)blocks[i].size);
+        write_u32(entry + 12, flags[i]);
+        write_u64(entry + 16, checksums[i]);
+        m_index.insert(m_index.end(), entry, entry + entry_size);
+        m_file.write(blocks[i].data, blocks[i].size);
+    }
+    m_size = 0;
+}
+
+void compressed_file_writer::discard() noexcept
+{
+    m_file.discard();
+    m_codec = nullptr;
+    m_block_size = 0;
+    m_buffer = std::vector<char>();
+    m_size = 0;
+    m_compressed = std::vector<std::vector<char>>();
+    m_position = 0;
+    m_index = std::vector<char>();
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,135 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/compressed_file_writer.hpp
+/// @brief Creation of seekable block-compressed files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/concurrency/thread_pool.hpp"
+#include "idlib/file_system/block_codec.hpp"
+#include "idlib/file_system/atomic_file_writer.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Writes a seekable block-compressed file.
+/// @detail
+/// The Bytes written are split into blocks of the block size which are compressed independently by a block codec.
+/// The blocks are followed by an index of the offsets, the sizes, and the checksums of the compressed blocks, hence
+/// any range of the file can be decompressed without decompressing the preceding blocks
+/// (see id::file_system::compressed_file_reader). A block which is not reduced in size by compression is stored
+/// without compression.
+/// The writer buffers one block per thread of the thread pool and compresses the buffered blocks in parallel.
+/// The file is written by an id::file_system::atomic_file_writer, hence it is replaced when the writer is closed and
+/// readers never observe an incomplete file.
+/// @code
+/// id::file_system::compressed_file_writer writer;
+/// writer.open("level.bin.idcf");
+/// writer.write(data, size);
+/// writer.close();
+/// @endcode
+class compressed_file_writer
+{
+public:
+    /// @brief The default size, in Bytes, of a block.
+    static constexpr size_t default_block_size = 64 * 1024;
+
+private:
+    /// @brief The thread pool.
+    thread_pool *m_pool;
+    /// @brief The codec.
+    std::shared_ptr<const block_codec> m_codec;
+    /// @brief The atomic file writer.
+    atomic_file_writer m_file;
+    /// @brief The size, in Bytes, of a block.
+    size_t m_block_size;
+    /// @brief The buffered blocks.
+    std::vector<char> m_buffer;
+    /// @brief The number of buffered Bytes.
+    size_t m_size;
+    /// @brief The compressed blocks.
+    std::vector<std::vector<char>> m_compressed;
+    /// @brief The number of Bytes written.
+    uint64_t m_position;
+    /// @brief The entries of the index.
+    std::vector<char> m_index;
+
+public:
+    /// @brief Construct this compressed file writer.
+    /// @param pool the thread pool compressing the blocks
+    /// @post The compressed file writer is closed.
+    explicit compressed_file_writer(thread_pool& pool = thread_pool::shared());
+
+    /// @brief Destruct this compressed file writer.
+    /// @post The compressed file writer is closed.
+    /// @remark If the compressed file writer is open, then the temporary file is removed and the file is not changed.
+    ~compressed_file_writer() noexcept;
+
+    // Delete copy constructor.
+    compressed_file_writer(const compressed_file_writer&) = delete;
+
+    // Delete copy assignment operator.
+    compressed_file_writer& operator=(const compressed_file_writer&) = delete;
+
+public:
+    /// @brief Ensure the compressed file writer is open.
+    /// @param pathname the pathname of the file
+    /// @param codec the identifier of a registered block codec
+    /// @param block_size the size, in Bytes, of a block. Must be positive and less than 2^31.
+    /// @param durability the durability
+    /// @remark If the codec is not registered, the block size is invalid, or the temporary file can not be created,
+    /// then the compressed file writer is closed.
+    void open(const std::string& pathname, uint32_t codec = lz4_block_codec::identifier,
+              size_t block_size = default_block_size, durability durability = durability::full) noexcept;
+
+    /// @brief Get if the compressed file writer is open.
+    /// @return @a true if the compressed file writer is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Write the buffered blocks and the index, replace the file by the temporary file, and ensure the
+    /// compressed file writer is closed.
+    /// @throw id::file_system::error the environment fails. The compressed file writer is closed nevertheless
+    /// and the file is not changed.
+    void close();
+
+    /// @brief Get the number of Bytes written.
+    /// @return the number of Bytes written
+    uint64_t position() const noexcept;
+
+    /// @brief Write Bytes.
+    /// @param bytes a pointer to an array of @a length Bytes
+    /// @param length the number of Bytes
+    /// @throw id::file_system::error the compressed file writer is not open or the environment fails
+    void write(const void *bytes, size_t length);
+
+    /// @brief Write Bytes.
+    /// @param bytes the Bytes
+    /// @throw id::file_system::error the compressed file writer is not open or the environment fails
+    void write(std::string_view bytes);
+
+private:
+    /// @brief Compress and write the buffered blocks.
+    void write_blocks();
+
+    /// @brief Discard the temporary file and reset the state.
+    void discard() noexcept;
+
+}; // class compressed_file_writer
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,358 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/content_hash.cpp
+/// @brief Fast non-cryptographic hashing of the contents of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/content_hash.hpp"
+#include "idlib/file_system/error.hpp"
+#include "idlib/utility/byte_order.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IDLIB_SSE2 1
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+constexpr uint64_t prime32_1 = 0x9E3779B1ULL;
+constexpr uint64_t prime32_2 = 0x85EBCA77ULL;
+constexpr uint64_t prime32_3 = 0xC2B2AE3DULL;
+constexpr uint64_t prime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t prime64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t prime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t prime64_5 = 0x27D4EB2F165667C5ULL;
+
+/// @brief The size, in Bytes, of the secret.
+constexpr size_t secret_size = 192;
+/// @brief The size, in Bytes, of a stripe.
+constexpr size_t stripe_size = 64;
+/// @brief The number of stripes of a block. The secret is advanced by 8 Bytes per stripe.
+constexpr size_t stripes_per_block = (secret_size - stripe_size) / 8;
+/// @brief The size, in Bytes, of a block.
+constexpr size_t block_size = stripe_size * stripes_per_block;
+/// @brief Inputs of at most this size, in Bytes, are hashed without accumulators.
+constexpr size_t short_size = 240;
+
+/// @brief The pseudo-random Bytes mixed into the input.
+struct secret_bytes
+{
+    alignas(64) uint8_t bytes[secret_size];
+};
+
+/// @brief Generate the secret by SplitMix64.
+constexpr secret_bytes make_secret()
+{
+    secret_bytes secret{};
+    uint64_t state = prime64_1;
+    for (size_t i = 0; i < secret_size / 8; ++i)
+    {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z = z ^ (z >> 31);
+        for (size_t j = 0; j < 8; ++j)
+        {
+            secret.bytes[i * 8 + j] = (uint8_t)(z >> (8 * j));
+        }
+    }
+    return secret;
+}
+
+constexpr secret_bytes secret = make_secret();
+
+inline uint64_t read64(const uint8_t *p) noexcept
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return convert_byte_order(v, get_byte_order(), byte_order::little_endian);
+}
+
+inline uint32_t read32(const uint8_t *p) noexcept
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return convert_byte_order(v, get_byte_order(), byte_order::little_endian);
+}
+
+/// @brief Multiply two 64 bit values and fold the 128 bit product into 64 bits.
+inline uint64_t multiply_fold(uint64_t a, uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    uint64_t low_low = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    uint64_t high_low = (a >> 32) * (b & 0xFFFFFFFF);
+    uint64_t low_high = (a & 0xFFFFFFFF) * (b >> 32);
+    uint64_t high_high = (a >> 32) * (b >> 32);
+    uint64_t cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+    uint64_t high = (high_low >> 32) + (cross >> 32) + high_high;
+    uint64_t low = (cross << 32) | (low_low & 0xFFFFFFFF);
+    return low ^ high;
+#endif
+}
+
+inline uint64_t avalanche(uint64_t h) noexcept
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t mix16(const uint8_t *p, const uint8_t *s, uint64_t seed) noexcept
+{
+    return multiply_fold(read64(p) ^ (read64(s) + seed), read64(p + 8) ^ (read64(s + 8) - seed));
+}
+
+uint64_t hash_short(const uint8_t *p, size_t size, uint64_t seed) noexcept
+{
+    const uint8_t *s = secret.bytes;
+    if (0 == size)
+    {
+        return avalanche(seed ^ read64(s + 56) ^ read64(s + 64));
+    }
+    if (size < 4)
+    {
+        uint32_t combined = ((uint32_t)p[0] << 16) | ((uint32_t)p[size >> 1] << 24) | (uint32_t)p[size - 1] | ((uint32_t)size << 8);
+        uint64_t keyed = (uint64_t)combined ^ ((uint64_t)(read32(s) ^ read32(s + 4)) + seed);
+        return avalanche(keyed * prime64_1);
+    }
+    if (size <= 8)
+    {
+        uint64_t input = (uint64_t)read32(p + size - 4) + ((uint64_t)read32(p) << 32);
+        uint64_t keyed = input ^ ((read64(s + 8) ^ read64(s + 16)) - seed);
+        return avalanche(multiply_fold(keyed, prime64_1 + (size << 2)));
+    }
+    if (size <= 16)
+    {
+        uint64_t low = read64(p) ^ ((read64(s + 24) ^ read64(s + 32)) + seed);
+        uint64_t high = read64(p + size - 8) ^ ((read64(s + 40) ^ read64(s + 48)) - seed);
+        uint64_t accumulator = size + ((low << 32) | (low >> 32)) + high + multiply_fold(low, high);
+        return avalanche(accumulator);
+    }
+    uint64_t accumulator = size * prime64_1;
+    // All 16 Byte blocks but the last one, the last one ends at the end of the input.
+    for (size_t i = 0, n = (size - 1) / 16; i < n; ++i)
+    {
+        accumulator += mix16(p + 16 * i, s + (16 * i) % (secret_size - 16), seed);
+    }
+    accumulator += mix16(p + size - 16, s + secret_size - 16 - 3, seed);
+    return avalanche(accumulator);
+}
+
+/// @brief Mix a stripe into the accumulators.
+inline void accumulate(uint64_t *accumulators, const uint8_t *p, const uint8_t *s) noexcept
+{
+#if defined(__AVX2__)
+    __m256i *a = reinterpret_cast<__m256i *>(accumulators);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p) + i);
+        __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s) + i));
+        __m256i product = _mm256_mul_epu32(key, _mm256_shuffle_epi32(key, 0x31));
+        __m256i swapped = _mm256_shuffle_epi32(data, 0x4E);
+        a[i] = _mm256_add_epi64(_mm256_add_epi64(a[i], swapped), product);
+    }
+#elif defined(IDLIB_SSE2)
+    __m128i *a = reinterpret_cast<__m128i *>(accumulators);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p) + i);
+        __m128i key = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s) + i));
+        __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, 0x31));
+        __m128i swapped = _mm_shuffle_epi32(data, 0x4E);
+        a[i] = _mm_add_epi64(_mm_add_epi64(a[i], swapped), product);
+    }
+#else
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t data = read64(p + 8 * i);
+        uint64_t key = data ^ read64(s + 8 * i);
+        accumulators[i ^ 1] += data;
+        accumulators[i] += (key & 0xFFFFFFFF) * (key >> 32);
+    }
+#endif
+}
+
+/// @brief Scramble the accumulators at the end of a block.
+inline void scramble(uint64_t *accumulators, const uint8_t *s) noexcept
+{
+#if defined(__AVX2__)
+    __m256i *a = reinterpret_cast<__m256i *>(accumulators);
+    const __m256i prime = _mm256_set1_epi32((int)prime32_1);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        __m256i value = _mm256_xor_si256(a[i], _mm256_srli_epi64(a[i], 47));
+        value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s) + i));
+        __m256i low = _mm256_mul_epu32(value, prime);
+        __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(value, 0x31), prime);
+        a[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+    }
+#elif defined(IDLIB_SSE2)
+    __m128i *a = reinterpret_cast<__m128i *>(accumulators);
+    const __m128i prime = _mm_set1_epi32((int)prime32_1);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        __m128i value = _mm_xor_si128(a[i], _mm_srli_epi64(a[i], 47));
+        value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i *>(s) + i));
+        __m128i low = _mm_mul_epu32(value, prime);
+        __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, 0x31), prime);
+        a[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+    }
+#else
+    for (size_t i = 0; i < 8; ++i)
+    {
+        uint64_t value = accumulators[i];
+        value ^= value >> 47;
+        value ^= read64(s + 8 * i);
+        accumulators[i] = value * prime32_1;
+    }
+#endif
+}
+
+uint64_t hash_long(const uint8_t *p, size_t size, uint64_t seed) noexcept
+{
+    const uint8_t *s = secret.bytes;
+    alignas(32) uint64_t accumulators[8] =
+    {
+        prime32_3 + seed, prime64_1 - seed, prime64_2 + seed, prime64_3 - seed,
+        prime64_4 + seed, prime32_2 - seed, prime64_5 + seed, prime32_1 - seed,
+    };
+    const size_t number_of_blocks = (size - 1) / block_size;
+    for (size_t i = 0; i < number_of_blocks; ++i)
+    {
+        const uint8_t *block = p + i * block_size;
+        for (size_t j = 0; j < stripes_per_block; ++j)
+        {
+            accumulate(accumulators, block + j * stripe_size, s + j * 8);
+        }
+        scramble(accumulators, s + secret_size - stripe_size);
+    }
+    // The stripes of the last block but the last stripe, the last stripe ends at the end of the input.
+    const uint8_t *block = p + number_of_blocks * block_size;
+    const size_t number_of_stripes = ((size - 1) - number_of_blocks * block_size) / stripe_size;
+    for (size_t j = 0; j < number_of_stripes; ++j)
+    {
+        accumulate(accumulators, block + j * stripe_size, s + j * 8);
+    }
+    accumulate(accumulators, p + size - stripe_size, s + secret_size - stripe_size - 7);
+    uint64_t result = size * prime64_1;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        result += multiply_fold(accumulators[2 * i] ^ read64(s + 11 + 16 * i), accumulators[2 * i + 1] ^ read64(s + 19 + 16 * i));
+    }
+    return avalanche(result);
+}
+
+} // namespace
+
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) noexcept
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    return size <= short_size ? hash_short(p, size, seed) : hash_long(p, size, seed);
+}
+
+content_hasher::content_hasher(thread_pool& pool) noexcept :
+    m_pool(&pool)
+{}
+
+uint64_t content_hasher::hash(const void *data, size_t size) const
+{
+    if (size <= chunk_size)
+    {
+        return hash_bytes(data, size, 0);
+    }
+    const char *p = static_cast<const char *>(data);
+    const size_t number_of_chunks = (size + chunk_size - 1) / chunk_size;
+    std::vector<uint64_t> hashes(number_of_chunks);
+    auto hash_chunks = [p, size, &hashes](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            uint64_t hash = hash_bytes(p + i * chunk_size, std::min(chunk_size, size - i * chunk_size), 0);
+            hashes[i] = convert_byte_order(hash, byte_order::little_endian, get_byte_order());
+        }
+    };
+    // Hashing the chunks on the pool from a worker thread could deadlock.
+    const size_t number_of_tasks = m_pool->is_worker() ? 1 : std::min(number_of_chunks, m_pool->size() + 1);
+    if (1 == number_of_tasks)
+    {
+        hash_chunks(0, number_of_chunks);
+    }
+    else
+    {
+        // The calling thread hashes the first range of chunks.
+        task_group group;
+        for (size_t i = 1; i < number_of_tasks; ++i)
+        {
+            m_pool->post(group, [&hash_chunks, i, number_of_chunks, number_of_tasks]()
+            {
+                hash_chunks(i * number_of_chunks / number_of_tasks, (i + 1) * number_of_chunks / number_of_tasks);
+            });
+        }
+        hash_chunks(0, number_of_chunks / number_of_tasks);
+        group.wait();
+    }
+    return hash_bytes(hashes.data(), hashes.size() * sizeof(uint64_t), size);
+}
+
+uint64_t content_hasher::hash(mapped_file_descriptor& file) const
+{
+    if (!file.is_opened_for_reading())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to hash file: file is not open for reading");
+    }
+    return hash(file.data(), file.size());
+}
+
+uint64_t content_hasher::hash(const std::string& pathname) const
+{
+    mapped_file_descriptor file;
+    file.open_read(pathname, create_mode::open_existing);
+    if (!file.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to hash file `" + pathname + "`: unable to open file");
+    }
+    if (0 != file.size())
+    {
+        file.advise(access_advice::sequential, 0, file.size());
+    }
+    return hash(file);
+}
+
+#include "idlib/file_system/footer.in"
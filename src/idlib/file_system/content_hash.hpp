@@ -0,0 +1,83 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/content_hash.hpp
+/// @brief Fast non-cryptographic hashing of the contents of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/concurrency/thread_pool.hpp"
+#include "idlib/file_system/mapped_file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Compute the 64 bit hash of an array of Bytes.
+/// @param data a pointer to an array of @a size Bytes
+/// @param size the size, in Bytes, of the array
+/// @param seed the seed
+/// @return the hash
+/// @remark The hash follows the design of XXH3: the input is processed in stripes of 64 Bytes which are mixed into
+/// eight accumulators by 32 x 32 bit multiplications, which are vectorized using SSE2 or AVX2 if available.
+/// The hash is not cryptographic and its values are not compatible with XXH3. Its values do not depend on the
+/// platform or on the instruction set.
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 0) noexcept;
+
+/// @brief Computes hashes of the contents of files.
+/// @detail
+/// The contents are split into chunks of id::file_system::content_hasher::chunk_size Bytes which are hashed in parallel
+/// by the tasks of a thread pool. The hash of the contents is the hash of the hashes of the chunks, hence it depends
+/// neither on the thread pool nor on the number of its threads.
+class content_hasher
+{
+public:
+    /// @brief The size, in Bytes, of a chunk.
+    static constexpr size_t chunk_size = 1024 * 1024;
+
+private:
+    /// @brief The thread pool.
+    thread_pool *m_pool;
+
+public:
+    /// @brief Construct this content hasher.
+    /// @param pool the thread pool
+    explicit content_hasher(thread_pool& pool = thread_pool::shared()) noexcept;
+
+public:
+    /// @brief Compute the hash of an array of Bytes.
+    /// @param data a pointer to an array of @a size Bytes
+    /// @param size the size, in Bytes, of the array
+    /// @return the hash
+    /// @remark Arrays of at most id::file_system::content_hasher::chunk_size Bytes are hashed by the calling thread.
+    /// If the calling thread is a worker thread of the thread pool, then all chunks are hashed by the calling thread.
+    uint64_t hash(const void *data, size_t size) const;
+
+    /// @brief Compute the hash of the contents of a mapped file.
+    /// @param file the mapped file descriptor
+    /// @return the hash
+    /// @throw id::file_system::error the mapped file descriptor is not open for reading
+    uint64_t hash(mapped_file_descriptor& file) const;
+
+    /// @brief Compute the hash of the contents of a file.
+    /// @param pathname the pathname of the file
+    /// @return the hash
+    /// @throw id::file_system::error the file can not be opened
+    uint64_t hash(const std::string& pathname) const;
+
+}; // class content_hasher
+
+#include "idlib/file_system/footer.in"
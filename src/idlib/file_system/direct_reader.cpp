@@ -0,0 +1,92 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/direct_reader.cpp
+/// @brief Reading of files opened for direct input and output.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/direct_reader.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+direct_reader::direct_reader(file_descriptor& file_descriptor, size_t buffer_size, size_t alignment) :
+    m_file_descriptor(&file_descriptor), m_buffer()
+{
+    if (0 == alignment || 0 != (alignment & (alignment - 1)))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid alignment: alignment is not a power of two");
+    }
+    buffer_size = std::max(alignment, (buffer_size + alignment - 1) & ~(alignment - 1));
+    m_buffer = aligned_buffer(buffer_size, alignment);
+}
+
+size_t direct_reader::alignment() const noexcept
+{
+    return m_buffer.alignment();
+}
+
+size_t direct_reader::read_some(size_t offset, void *buffer, size_t length)
+{
+    const size_t mask = m_buffer.alignment() - 1;
+    if (0 == (offset & mask) && 0 == (length & mask) && 0 == (reinterpret_cast<uintptr_t>(buffer) & mask))
+    {
+        return m_file_descriptor->read_some(offset, buffer, length);
+    }
+    char *target = static_cast<char *>(buffer);
+    size_t total = 0;
+    while (total < length)
+    {
+        // Read the aligned range enclosing the remaining Bytes, at most one buffer.
+        size_t begin = offset + total;
+        size_t aligned_begin = begin & ~mask;
+        size_t aligned_end = (offset + length + mask) & ~mask;
+        size_t count = std::min(aligned_end - aligned_begin, m_buffer.size());
+        size_t result = m_file_descriptor->read_some(aligned_begin, m_buffer.data(), count);
+        size_t skip = begin - aligned_begin;
+        if (result <= skip)
+        {
+            break;
+        }
+        size_t available = std::min(result - skip, length - total);
+        std::memcpy(target + total, m_buffer.data() + skip, available);
+        total += available;
+        if (result < count)
+        {
+            // The end of the file was reached.
+            break;
+        }
+    }
+    return total;
+}
+
+void direct_reader::read(size_t offset, void *buffer, size_t length)
+{
+    size_t result = read_some(offset, buffer, length);
+    if (result != length)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: end of file reached after " +
+                                     std::to_string(result) + " of " + std::to_string(length) + " Bytes");
+    }
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,81 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/direct_reader.hpp
+/// @brief Reading of files opened for direct input and output.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/aligned_buffer.hpp"
+#include "idlib/file_system/file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Reads arbitrary ranges of a file opened with id::file_system::open_flags::direct.
+/// @detail
+/// If the offset, the length, and the buffer of a read are aligned, then the Bytes are read directly into the buffer.
+/// Otherwise the aligned range enclosing the range is read into an aligned buffer and the Bytes are copied from it.
+/// @remark The file descriptor must remain open while the direct reader is used.
+/// Non-copyable.
+class direct_reader
+{
+private:
+    /// @brief The file descriptor.
+    file_descriptor *m_file_descriptor;
+    /// @brief The aligned buffer.
+    aligned_buffer m_buffer;
+
+public:
+    /// @brief Construct this direct reader.
+    /// @param file_descriptor the file descriptor
+    /// @param buffer_size the size, in Bytes, of the aligned buffer. Rounded up to a multiple of the alignment.
+    /// @param alignment the alignment, in Bytes. Must be a power of two.
+    /// @throw id::file_system::error the alignment is not a power of two
+    explicit direct_reader(file_descriptor& file_descriptor, size_t buffer_size = 1024 * 1024,
+                           size_t alignment = aligned_buffer::default_alignment);
+
+    // Delete copy constructor.
+    direct_reader(const direct_reader&) = delete;
+
+    // Delete copy assignment operator.
+    direct_reader& operator=(const direct_reader&) = delete;
+
+public:
+    /// @brief Get the alignment, in Bytes.
+    /// @return the alignment, in Bytes
+    size_t alignment() const noexcept;
+
+    /// @brief Read Bytes at an offset.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @return the number of Bytes read. Less than @a length only if the end of the file was reached.
+    /// @throw id::file_system::error the file is not open or the environment fails
+    size_t read_some(size_t offset, void *buffer, size_t length);
+
+    /// @brief Read Bytes at an offset.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @throw id::file_system::error the file is not open, the end of the file was reached before @a length Bytes were read,
+    /// or the environment fails
+    void read(size_t offset, void *buffer, size_t length);
+
+}; // class direct_reader
+
+#include "idlib/file_system/footer.in"
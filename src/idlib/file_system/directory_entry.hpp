@@ -0,0 +1,51 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/directory_entry.hpp
+/// @brief An entry of a directory.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief The type of an entry of a directory.
+enum class entry_type : uint8_t
+{
+    unknown, ///< The type could not be determined.
+    regular, ///< A regular file.
+    directory, ///< A directory.
+    symbolic_link, ///< A symbolic link. Symbolic links are not followed.
+    other, ///< A device, a pipe, a socket, etc.
+};
+
+/// @brief An entry of a directory.
+struct directory_entry
+{
+    /// @brief The pathname of the entry relative to the scanned directory.
+    std::string pathname;
+    /// @brief The type of the entry.
+    entry_type type;
+    /// @brief The size, in Bytes, of the entry or @a 0 if attributes were not requested.
+    uint64_t size;
+    /// @brief The modification time, in nanoseconds since the Unix epoch, of the entry or @a 0 if attributes were not requested.
+    int64_t modification_time;
+};
+
+#include "idlib/file_system/footer.in"
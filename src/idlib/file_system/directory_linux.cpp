@@ -0,0 +1,144 @@
+#include "idlib/file_system/directory_linux.hpp"
+
+#if defined(ID_LINUX)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The layout of an entry returned by getdents64.
+struct linux_dirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+entry_type to_entry_type(unsigned char type) noexcept
+{
+    switch (type)
+    {
+        case DT_REG:
+            return entry_type::regular;
+        case DT_DIR:
+            return entry_type::directory;
+        case DT_LNK:
+            return entry_type::symbolic_link;
+        case DT_UNKNOWN:
+            return entry_type::unknown;
+        default:
+            return entry_type::other;
+    };
+}
+
+entry_type to_entry_type(mode_t mode) noexcept
+{
+    if (S_ISREG(mode)) return entry_type::regular;
+    if (S_ISDIR(mode)) return entry_type::directory;
+    if (S_ISLNK(mode)) return entry_type::symbolic_link;
+    return entry_type::other;
+}
+
+} // namespace
+
+directory_impl::directory_impl() noexcept :
+    m_handle(-1)
+{}
+
+directory_impl::~directory_impl() noexcept
+{
+    close();
+}
+
+bool directory_impl::open(const std::string& pathname) noexcept
+{
+    close();
+    m_handle = ::open(pathname.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    return -1 != m_handle;
+}
+
+bool directory_impl::open(const directory_impl& parent, const std::string& name) noexcept
+{
+    close();
+    m_handle = ::openat(parent.m_handle, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+    return -1 != m_handle;
+}
+
+void directory_impl::close() noexcept
+{
+    if (-1 != m_handle)
+    {
+        ::close(m_handle);
+        m_handle = -1;
+    }
+}
+
+void directory_impl::enumerate(bool with_attributes, const entry_function& function)
+{
+    if (-1 == m_handle)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to enumerate directory: directory is not open");
+    }
+    // Large enough for a few hundred entries per system call.
+    alignas(linux_dirent64) char buffer[32 * 1024];
+    while (true)
+    {
+        long result = syscall(SYS_getdents64, m_handle, buffer, sizeof(buffer));
+        if (-1 == result)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            throw id::file_system::error(__FILE__, __LINE__, std::string("unable to enumerate directory: ") + strerror(errno));
+        }
+        if (0 == result)
+        {
+            break;
+        }
+        for (long offset = 0; offset < result;)
+        {
+            const linux_dirent64 *entry = reinterpret_cast<const linux_dirent64 *>(buffer + offset);
+            offset += entry->d_reclen;
+            const char *name = entry->d_name;
+            if ('.' == name[0] && ('\0' == name[1] || ('.' == name[1] && '\0' == name[2])))
+            {
+                continue;
+            }
+            entry_type type = to_entry_type(entry->d_type);
+            uint64_t size = 0;
+            int64_t modification_time = 0;
+            if (with_attributes || entry_type::unknown == type)
+            {
+                struct stat attributes;
+                if (0 == fstatat(m_handle, name, &attributes, AT_SYMLINK_NOFOLLOW))
+                {
+                    type = to_entry_type(attributes.st_mode);
+                    if (with_attributes)
+                    {
+                        size = (uint64_t)attributes.st_size;
+                        modification_time = (int64_t)attributes.st_mtim.tv_sec * 1000000000 + attributes.st_mtim.tv_nsec;
+                    }
+                }
+            }
+            function(name, type, size, modification_time);
+        }
+    }
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/file_system/directory_entry.hpp"
+
+#if defined(ID_LINUX)
+#include "idlib/file_system/header.in"
+
+/// @brief A Linux directory opened for enumeration.
+/// @detail Directories are opened relative to their parent directory and enumerated by getdents64. Attributes are
+/// determined by fstatat relative to the directory, hence no pathnames are resolved.
+class directory_impl
+{
+private:
+    /// @brief The Linux file handle.
+    int m_handle;
+
+public:
+    /// @brief A function invoked for an entry.
+    /// The arguments are the name, the type, the size, and the modification time of the entry.
+    using entry_function = std::function<void(const char *, entry_type, uint64_t, int64_t)>;
+
+    /// @brief Construct this directory.
+    /// @post The directory is closed.
+    directory_impl() noexcept;
+
+    /// @brief Destruct this directory.
+    /// @post The directory is closed.
+    ~directory_impl() noexcept;
+
+    // Delete copy constructor.
+    directory_impl(const directory_impl&) = delete;
+
+    // Delete copy assignment operator.
+    directory_impl& operator=(const directory_impl&) = delete;
+
+public:
+    /// @brief Ensure the directory is open.
+    /// @param pathname the pathname of the directory
+    /// @return @a true on success, @a false otherwise
+    bool open(const std::string& pathname) noexcept;
+
+    /// @brief Ensure the directory is open.
+    /// @param parent the parent directory
+    /// @param name the name of the directory in the parent directory
+    /// @return @a true on success, @a false otherwise
+    bool open(const directory_impl& parent, const std::string& name) noexcept;
+
+    /// @brief Ensure the directory is closed.
+    void close() noexcept;
+
+    /// @brief Enumerate the entries of this directory except of "." and "..".
+    /// @param with_attributes if @a true, then the size and the modification time of the entries are determined
+    /// @param function the function invoked for each entry
+    /// @throw id::file_system::error the environment fails
+    void enumerate(bool with_attributes, const entry_function& function);
+
+}; // class directory_impl
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
@@ -0,0 +1,135 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/directory_scanner.cpp
+/// @brief Parallel recursive enumeration of directories.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/directory_scanner.hpp"
+#include "idlib/file_system/directory_separator.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/directory_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/directory_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The state of an enumeration shared by its tasks.
+struct scan_state
+{
+    thread_pool& pool;
+    const directory_scanner::entry_handler& handler;
+    bool with_attributes;
+    std::string separator;
+    task_group group;
+    std::atomic<bool> stopped;
+
+    scan_state(thread_pool& pool, const directory_scanner::entry_handler& handler, bool with_attributes) :
+        pool(pool), handler(handler), with_attributes(with_attributes), separator(get_directory_separator()),
+        group(), stopped(false)
+    {}
+};
+
+void scan_directory(scan_state& state, const std::shared_ptr<directory_impl>& directory, const std::string& prefix);
+
+/// @brief Post a task entering a subdirectory.
+void post_subdirectory(scan_state& state, const std::shared_ptr<directory_impl>& parent, const std::string& name,
+                       const std::string& pathname)
+{
+    state.pool.post(state.group, [&state, parent = std::shared_ptr<directory_impl>(parent), name, pathname]() mutable
+    {
+        if (state.stopped)
+        {
+            return;
+        }
+        auto directory = std::make_shared<directory_impl>();
+        bool opened = directory->open(*parent, name);
+        // Release the parent directory as soon as possible to bound the number of open directories.
+        parent.reset();
+        if (opened)
+        {
+            scan_directory(state, directory, pathname + state.separator);
+        }
+    });
+}
+
+/// @brief Enumerate a directory and post tasks entering its subdirectories.
+void scan_directory(scan_state& state, const std::shared_ptr<directory_impl>& directory, const std::string& prefix)
+{
+    try
+    {
+        directory_entry entry;
+        directory->enumerate(state.with_attributes, [&](const char *name, entry_type type, uint64_t size, int64_t modification_time)
+        {
+            if (state.stopped)
+            {
+                return;
+            }
+            entry.pathname.assign(prefix).append(name);
+            entry.type = type;
+            entry.size = size;
+            entry.modification_time = modification_time;
+            state.handler(entry);
+            if (entry_type::directory == type)
+            {
+                post_subdirectory(state, directory, name, entry.pathname);
+            }
+        });
+    }
+    catch (...)
+    {
+        state.stopped = true;
+        throw;
+    }
+}
+
+} // namespace
+
+directory_scanner::directory_scanner(thread_pool& pool, bool with_attributes) :
+    m_pool(&pool), m_with_attributes(with_attributes)
+{}
+
+void directory_scanner::scan(const std::string& pathname, const entry_handler& handler) const
+{
+    auto directory = std::make_shared<directory_impl>();
+    if (!directory->open(pathname))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to open directory `" + pathname + "`");
+    }
+    scan_state state(*m_pool, handler, m_with_attributes);
+    m_pool->post(state.group, [&state, directory]()
+    {
+        scan_directory(state, directory, std::string());
+    });
+    state.group.wait();
+}
+
+#include "idlib/file_system/footer.in"
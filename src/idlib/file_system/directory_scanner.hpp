@@ -0,0 +1,71 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/directory_scanner.hpp
+/// @brief Parallel recursive enumeration of directories.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/concurrency/thread_pool.hpp"
+#include "idlib/file_system/directory_entry.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Enumerates a directory and its subdirectories in parallel.
+/// @detail
+/// Each directory is enumerated by a task of a thread pool. Subdirectories are opened relative to their parent
+/// directory and attributes are determined relative to the directory, hence no pathnames are resolved.
+/// @code
+/// std::atomic<uint64_t> size(0);
+/// id::file_system::directory_scanner().scan("assets", [&size](const id::file_system::directory_entry& entry)
+/// {
+///     size += entry.size;
+/// });
+/// @endcode
+class directory_scanner
+{
+public:
+    /// @brief A handler invoked for an entry.
+    using entry_handler = std::function<void(const directory_entry&)>;
+
+private:
+    /// @brief The thread pool.
+    thread_pool *m_pool;
+    /// @brief If @a true, then the size and the modification time of the entries are determined.
+    bool m_with_attributes;
+
+public:
+    /// @brief Construct this directory scanner.
+    /// @param pool the thread pool
+    /// @param with_attributes if @a true, then the size and the modification time of the entries are determined
+    explicit directory_scanner(thread_pool& pool = thread_pool::shared(), bool with_attributes = true);
+
+public:
+    /// @brief Enumerate a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    /// @param handler the handler invoked for each entry. Invoked concurrently by the threads of the thread pool.
+    /// @throw id::file_system::error the directory can not be opened
+    /// @throw an exception raised by the handler. The enumeration is stopped.
+    /// @remark Blocks until the enumeration is complete, hence must not be invoked by a thread of the thread pool.
+    /// Symbolic links are reported but not followed. Subdirectories which can not be opened are reported but not
+    /// entered.
+    void scan(const std::string& pathname, const entry_handler& handler) const;
+
+}; // class directory_scanner
+
+#include "idlib/file_system/footer.in"
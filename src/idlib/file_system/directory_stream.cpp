@@ -0,0 +1,141 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/directory_stream.cpp
+/// @brief Streaming of the entries of a directory and its subdirectories.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/directory_stream.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief Raised by the handler to stop the enumeration.
+struct stopped
+{};
+
+} // namespace
+
+struct directory_stream::state
+{
+    size_t capacity;
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<directory_entry> entries;
+    /// @brief The entries taken by the consumer. Not guarded by the mutex.
+    std::deque<directory_entry> taken;
+    bool complete;
+    bool cancelled;
+    std::exception_ptr exception;
+    /// @brief The thread pool enumerating the directories. Its tasks block while the queue is full.
+    thread_pool pool;
+    std::thread thread;
+
+    state(size_t capacity, size_t number_of_threads) :
+        capacity(capacity), mutex(), not_empty(), not_full(), entries(), taken(), complete(false), cancelled(false),
+        exception(), pool(number_of_threads), thread()
+    {}
+};
+
+directory_stream::directory_stream(const std::string& pathname, size_t capacity, size_t number_of_threads, bool with_attributes) :
+    m_state()
+{
+    if (0 == capacity)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid capacity: capacity is zero");
+    }
+    m_state = std::make_unique<state>(capacity, number_of_threads);
+    state *state = m_state.get();
+    // The enumeration is awaited by a dedicated thread such that the constructor does not block.
+    state->thread = std::thread([state, pathname, with_attributes]()
+    {
+        std::exception_ptr exception;
+        try
+        {
+            directory_scanner(state->pool, with_attributes).scan(pathname, [state](const directory_entry& entry)
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->not_full.wait(lock, [state]() { return state->cancelled || state->entries.size() < state->capacity; });
+                if (state->cancelled)
+                {
+                    throw stopped();
+                }
+                state->entries.push_back(entry);
+                // Only the transition from empty to non-empty can unblock the consumer.
+                if (1 == state->entries.size())
+                {
+                    state->not_empty.notify_one();
+                }
+            });
+        }
+        catch (const stopped&)
+        {}
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->exception = exception;
+        state->complete = true;
+        state->not_empty.notify_all();
+    });
+}
+
+directory_stream::~directory_stream() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->cancelled = true;
+        m_state->not_full.notify_all();
+    }
+    m_state->thread.join();
+}
+
+bool directory_stream::next(directory_entry& entry)
+{
+    if (m_state->taken.empty())
+    {
+        // Take all entries at once to acquire the mutex once per batch rather than once per entry.
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->not_empty.wait(lock, [this]() { return m_state->complete || !m_state->entries.empty(); });
+        if (m_state->entries.empty())
+        {
+            if (m_state->exception)
+            {
+                auto exception = m_state->exception;
+                m_state->exception = nullptr;
+                std::rethrow_exception(exception);
+            }
+            return false;
+        }
+        m_state->taken.swap(m_state->entries);
+        m_state->not_full.notify_all();
+    }
+    entry = std::move(m_state->taken.front());
+    m_state->taken.pop_front();
+    return true;
+}
+
+#include "idlib/file_system/footer.in"
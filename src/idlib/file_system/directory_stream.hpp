@@ -0,0 +1,81 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/directory_stream.hpp
+/// @brief Streaming of the entries of a directory and its subdirectories.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/directory_scanner.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Streams the entries of a directory and its subdirectories through a bounded queue.
+/// @detail
+/// The directory is enumerated by an id::file_system::directory_scanner in the background. The tasks enumerating the
+/// directories block while the queue is full, hence memory consumption is bounded regardless of the number of entries.
+/// As these tasks block, they are run by a thread pool owned by the stream rather than by id::thread_pool::shared.
+/// @code
+/// id::file_system::directory_stream stream("assets");
+/// id::file_system::directory_entry entry;
+/// while (stream.next(entry))
+/// {
+///     ...
+/// }
+/// @endcode
+/// Non-copyable.
+class directory_stream
+{
+private:
+    /// @brief The state shared with the enumeration.
+    struct state;
+
+    /// @brief A pointer to the state.
+    std::unique_ptr<state> m_state;
+
+public:
+    /// @brief Construct this directory stream and start the enumeration.
+    /// @param pathname the pathname of the directory
+    /// @param capacity the maximum number of entries in the queue. Must be positive.
+    /// @param number_of_threads the number of threads enumerating the directories. If @a 0, the number of hardware threads is used.
+    /// @param with_attributes if @a true, then the size and the modification time of the entries are determined
+    /// @throw id::file_system::error the capacity is zero
+    explicit directory_stream(const std::string& pathname, size_t capacity = 1024, size_t number_of_threads = 0,
+                              bool with_attributes = true);
+
+    /// @brief Destruct this directory stream.
+    /// @remark Stops the enumeration and waits for it to terminate.
+    ~directory_stream() noexcept;
+
+    // Delete copy constructor.
+    directory_stream(const directory_stream&) = delete;
+
+    // Delete copy assignment operator.
+    directory_stream& operator=(const directory_stream&) = delete;
+
+public:
+    /// @brief Get the next entry.
+    /// @param [out] entry the entry
+    /// @return @a true if an entry was stored, @a false if the enumeration is complete
+    /// @throw id::file_system::error the directory can not be opened
+    /// @remark Blocks until an entry is available or the enumeration is complete.
+    bool next(directory_entry& entry);
+
+}; // class directory_stream
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,121 @@
+#include "idlib/file_system/directory_windows.hpp"
+
+#if defined(ID_WINDOWS)
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+directory_impl::directory_impl() noexcept :
+    m_pathname()
+{}
+
+directory_impl::~directory_impl() noexcept
+{
+    close();
+}
+
+bool directory_impl::open(const std::string& pathname) noexcept
+{
+    close();
+    DWORD attributes = GetFileAttributesA(pathname.c_str());
+    if (INVALID_FILE_ATTRIBUTES == attributes || 0 == (attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        return false;
+    }
+    try
+    {
+        m_pathname = pathname;
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool directory_impl::open(const directory_impl& parent, const std::string& name) noexcept
+{
+    try
+    {
+        return open(parent.m_pathname + "\\" + name);
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+void directory_impl::close() noexcept
+{
+    m_pathname.clear();
+}
+
+void directory_impl::enumerate(bool with_attributes, const entry_function& function)
+{
+    if (m_pathname.empty())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to enumerate directory: directory is not open");
+    }
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileExA((m_pathname + "\\*").c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr,
+                                     FIND_FIRST_EX_LARGE_FETCH);
+    if (INVALID_HANDLE_VALUE == handle)
+    {
+        if (ERROR_FILE_NOT_FOUND == GetLastError())
+        {
+            return;
+        }
+        throw id::file_system::error(__FILE__, __LINE__, "unable to enumerate directory: error " + std::to_string(GetLastError()));
+    }
+    try
+    {
+        do
+        {
+            const char *name = data.cFileName;
+            if ('.' == name[0] && ('\0' == name[1] || ('.' == name[1] && '\0' == name[2])))
+            {
+                continue;
+            }
+            entry_type type;
+            if (0 != (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+            {
+                type = entry_type::symbolic_link;
+            }
+            else if (0 != (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                type = entry_type::directory;
+            }
+            else if (0 != (data.dwFileAttributes & FILE_ATTRIBUTE_DEVICE))
+            {
+                type = entry_type::other;
+            }
+            else
+            {
+                type = entry_type::regular;
+            }
+            uint64_t size = 0;
+            int64_t modification_time = 0;
+            if (with_attributes)
+            {
+                size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+                // File times are in 100 nanosecond intervals since 1601-01-01.
+                int64_t time = (int64_t)(((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime);
+                modification_time = (time - 116444736000000000LL) * 100;
+            }
+            function(name, type, size, modification_time);
+        } while (FindNextFileA(handle, &data));
+    }
+    catch (...)
+    {
+        FindClose(handle);
+        throw;
+    }
+    FindClose(handle);
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
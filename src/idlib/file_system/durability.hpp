@@ -0,0 +1,38 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/durability.hpp
+/// @brief Durability of replaced files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief The guarantees given when a file is replaced by a new file.
+/// @remark In any case, readers observe either the old or the new file but never an incomplete new file.
+enum class durability
+{
+    none, ///< Nothing is synchronized. After a crash, the file may be incomplete or empty.
+    contents, ///< The contents are synchronized before the file is replaced. After a crash, the file is either the old or the new file.
+    full, ///< The contents and the directory are synchronized. After a crash, the file is the new file.
+};
+
+#include "idlib/file_system/footer.in"
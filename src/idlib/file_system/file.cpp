@@ -2,6 +2,7 @@
 #undef IDLIB_PRIVATE
 #define IDLIB_PRIVATE 1
 #include "idlib/file_system/file.hpp"
+#include "idlib/file_system/error.hpp"
 #undef IDLIB_PRIVATE
 #pragma pop_macro("IDLIB_PRIVATE")
 
@@ -24,9 +25,9 @@ file_descriptor::file_descriptor() :
 file_descriptor::~file_descriptor() noexcept
 {}
 
-void file_descriptor::open(const std::string& pathname, access_mode access_mode, create_mode create_mode) noexcept
+void file_descriptor::open(const std::string& pathname, access_mode access_mode, create_mode create_mode, open_flags open_flags) noexcept
 {
-	m_pimpl->open(pathname, access_mode, create_mode);
+	m_pimpl->open(pathname, access_mode, create_mode, open_flags);
 }
 
 bool file_descriptor::is_open() const noexcept
@@ -44,6 +45,49 @@ size_t file_descriptor::size() const
 	return m_pimpl->size();
 }
 
+size_t file_descriptor::read_some(size_t offset, void *buffer, size_t length)
+{
+	mutable_buffer buffers[] = { { buffer, length } };
+	return m_pimpl->read_some(offset, buffers, 1);
+}
+
+size_t file_descriptor::read_some(size_t offset, const mutable_buffer *buffers, size_t number_of_buffers)
+{
+	return m_pimpl->read_some(offset, buffers, number_of_buffers);
+}
+
+void file_descriptor::read(size_t offset, void *buffer, size_t length)
+{
+	mutable_buffer buffers[] = { { buffer, length } };
+	read(offset, buffers, 1);
+}
+
+void file_descriptor::read(size_t offset, const mutable_buffer *buffers, size_t number_of_buffers)
+{
+	size_t length = 0;
+	for (size_t i = 0; i < number_of_buffers; ++i)
+	{
+		length += buffers[i].size;
+	}
+	size_t result = m_pimpl->read_some(offset, buffers, number_of_buffers);
+	if (result != length)
+	{
+		throw id::file_system::error(__FILE__, __LINE__, "unable to read file: end of file reached after " +
+		                             std::to_string(result) + " of " + std::to_string(length) + " Bytes");
+	}
+}
+
+void file_descriptor::write(size_t offset, const void *buffer, size_t length)
+{
+	const_buffer buffers[] = { { buffer, length } };
+	m_pimpl->write(offset, buffers, 1);
+}
+
+void file_descriptor::write(size_t offset, const const_buffer *buffers, size_t number_of_buffers)
+{
+	m_pimpl->write(offset, buffers, number_of_buffers);
+}
+
 void *file_descriptor::handle()
 {
 	return m_pimpl->handle();
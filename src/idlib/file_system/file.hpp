@@ -3,7 +3,9 @@
 #include "idlib/utility/platform.hpp"
 
 #include "idlib/file_system/access_mode.hpp"
+#include "idlib/file_system/buffer.hpp"
 #include "idlib/file_system/create_mode.hpp"
+#include "idlib/file_system/open_flags.hpp"
 
 #include "idlib/file_system/header.in"
 
@@ -36,7 +38,8 @@ public:
     /// @param pathname the pathname of the file
     /// @param access_mode the access mode
     /// @param create_mode the create mode
-    void open(const std::string& pathname, access_mode access_mode, create_mode create_mode) noexcept;
+    /// @param open_flags the open flags
+    void open(const std::string& pathname, access_mode access_mode, create_mode create_mode, open_flags open_flags = open_flags::none) noexcept;
 
     /// @brief Get if the file descriptor is open.
     /// @return @a true if the descriptor is open, @a false otherwise
@@ -51,6 +54,60 @@ public:
     /// @throw id::file_system::read_write_error the file is not open or the environment fails
     size_t size() const;
 	
+    /// @brief Read Bytes at an offset.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @return the number of Bytes read. Less than @a length only if the end of the file was reached.
+    /// @throw id::file_system::error the file is not open or the environment fails
+    /// @remark Does not use or modify the file offset, hence reads and writes of different threads do not interfere.
+    size_t read_some(size_t offset, void *buffer, size_t length);
+
+    /// @brief Read Bytes at an offset into a sequence of buffers.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffers a pointer to an array of @a number_of_buffers buffers
+    /// @param number_of_buffers the number of buffers
+    /// @return the number of Bytes read. Less than the total size of the buffers only if the end of the file was reached.
+    /// @throw id::file_system::error the file is not open or the environment fails
+    /// @remark Does not use or modify the file offset, hence reads and writes of different threads do not interfere.
+    size_t read_some(size_t offset, const mutable_buffer *buffers, size_t number_of_buffers);
+
+    /// @brief Read Bytes at an offset.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to read
+    /// @throw id::file_system::error the file is not open, the end of the file was reached before @a length Bytes were read,
+    /// or the environment fails
+    /// @remark Does not use or modify the file offset, hence reads and writes of different threads do not interfere.
+    void read(size_t offset, void *buffer, size_t length);
+
+    /// @brief Read Bytes at an offset into a sequence of buffers.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffers a pointer to an array of @a number_of_buffers buffers
+    /// @param number_of_buffers the number of buffers
+    /// @throw id::file_system::error the file is not open, the end of the file was reached before the buffers were filled,
+    /// or the environment fails
+    /// @remark Does not use or modify the file offset, hence reads and writes of different threads do not interfere.
+    void read(size_t offset, const mutable_buffer *buffers, size_t number_of_buffers);
+
+    /// @brief Write Bytes at an offset.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the number of Bytes to write
+    /// @throw id::file_system::error the file is not open or the environment fails
+    /// @remark Does not use or modify the file offset, hence reads and writes of different threads do not interfere.
+    /// The file is extended if the Bytes are written beyond its end.
+    void write(size_t offset, const void *buffer, size_t length);
+
+    /// @brief Write Bytes at an offset from a sequence of buffers.
+    /// @param offset the offset, in Bytes, in the file
+    /// @param buffers a pointer to an array of @a number_of_buffers buffers
+    /// @param number_of_buffers the number of buffers
+    /// @throw id::file_system::error the file is not open or the environment fails
+    /// @remark Does not use or modify the file offset, hence reads and writes of different threads do not interfere.
+    /// The file is extended if the Bytes are written beyond its end.
+    void write(size_t offset, const const_buffer *buffers, size_t number_of_buffers);
+
     /// @brief Get the internal handle.
 	/// @return an opaque pointer
 	void *handle();
@@ -0,0 +1,47 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/file_change.hpp
+/// @brief A change of a file observed by an id::file_system::file_watcher.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief The type of a change of a file.
+enum class change_type : uint8_t
+{
+    created, ///< The file was created or moved into a watched directory.
+    modified, ///< The file was modified.
+    removed, ///< The file was removed or moved out of a watched directory.
+    overflowed, ///< Changes were lost. The pathname is the pathname of a watched directory which must be rescanned.
+};
+
+/// @brief A change of a file.
+struct file_change
+{
+    /// @brief The pathname of the file.
+    /// The pathname of the watched directory followed by the pathname of the file relative to that directory.
+    std::string pathname;
+    /// @brief The type of the change.
+    change_type type;
+};
+
+#include "idlib/file_system/footer.in"
@@ -5,6 +5,9 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <unistd.h>
 
 #define IDLIB_PRIVATE 1
 #include "idlib/file_system/error.hpp"
@@ -12,7 +15,30 @@
 
 #include "idlib/file_system/header.in"
 
-void file_descriptor_impl::open(const std::string& pathname, access_mode access_mode, create_mode create_mode) noexcept
+namespace {
+
+/// @brief Advance a sequence of vectors by a number of Bytes and skip empty vectors.
+void advance(struct iovec *& vectors, size_t& number_of_vectors, size_t length) noexcept
+{
+    while (number_of_vectors > 0 && length >= vectors->iov_len)
+    {
+        length -= vectors->iov_len;
+        vectors++;
+        number_of_vectors--;
+    }
+    if (number_of_vectors > 0)
+    {
+        vectors->iov_base = static_cast<char *>(vectors->iov_base) + length;
+        vectors->iov_len -= length;
+    }
+}
+
+/// @brief The maximum number of buffers of a scatter/gather operation without dynamic allocation.
+const size_t number_of_local_vectors = 8;
+
+} // namespace
+
+void file_descriptor_impl::open(const std::string& pathname, access_mode access_mode, create_mode create_mode, open_flags open_flags) noexcept
 {
     close();
 	m_access_mode = access_mode;
@@ -45,7 +71,26 @@ void file_descriptor_impl::open(const std::string& pathname, access_mode access_
     default:
         return;
     };
-    m_handle = ::open(pathname.c_str(), flags, 0);
+    //
+    if (open_flags::none != (open_flags & open_flags::direct))
+    {
+        flags |= O_DIRECT;
+    }
+    if (open_flags::none != (open_flags & open_flags::no_access_time))
+    {
+        flags |= O_NOATIME;
+    }
+    if (open_flags::none != (open_flags & open_flags::close_on_exec))
+    {
+        flags |= O_CLOEXEC;
+    }
+    // Files are created with read and write permissions for everyone (subject to the umask).
+    m_handle = ::open(pathname.c_str(), flags, 0666);
+    if (-1 == m_handle && EPERM == errno && 0 != (flags & O_NOATIME))
+    {
+        // Only the owner of a file may not update its access time.
+        m_handle = ::open(pathname.c_str(), flags & ~O_NOATIME, 0666);
+    }
 }
 
 bool file_descriptor_impl::is_open() const noexcept
@@ -86,6 +131,90 @@ size_t file_descriptor_impl::size() const
     return buf.st_size;
 }
 
+size_t file_descriptor_impl::read_some(size_t offset, const mutable_buffer *buffers, size_t number_of_buffers)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    struct iovec local_vectors[number_of_local_vectors];
+    std::vector<struct iovec> dynamic_vectors;
+    if (number_of_buffers > number_of_local_vectors)
+    {
+        dynamic_vectors.resize(number_of_buffers);
+    }
+    struct iovec *vectors = number_of_buffers > number_of_local_vectors ? dynamic_vectors.data() : local_vectors;
+    for (size_t i = 0; i < number_of_buffers; ++i)
+    {
+        vectors[i].iov_base = buffers[i].data;
+        vectors[i].iov_len = buffers[i].size;
+    }
+    size_t number_of_vectors = number_of_buffers;
+    advance(vectors, number_of_vectors, 0);
+    size_t total = 0;
+    while (number_of_vectors > 0)
+    {
+        ssize_t result = ::preadv(m_handle, vectors, (int)std::min<size_t>(number_of_vectors, IOV_MAX), (off_t)(offset + total));
+        if (-1 == result)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            throw id::file_system::error(__FILE__, __LINE__, std::string("unable to read file: ") + strerror(errno));
+        }
+        if (0 == result)
+        {
+            // The end of the file was reached.
+            break;
+        }
+        total += (size_t)result;
+        advance(vectors, number_of_vectors, (size_t)result);
+    }
+    return total;
+}
+
+void file_descriptor_impl::write(size_t offset, const const_buffer *buffers, size_t number_of_buffers)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    struct iovec local_vectors[number_of_local_vectors];
+    std::vector<struct iovec> dynamic_vectors;
+    if (number_of_buffers > number_of_local_vectors)
+    {
+        dynamic_vectors.resize(number_of_buffers);
+    }
+    struct iovec *vectors = number_of_buffers > number_of_local_vectors ? dynamic_vectors.data() : local_vectors;
+    for (size_t i = 0; i < number_of_buffers; ++i)
+    {
+        vectors[i].iov_base = const_cast<void *>(buffers[i].data);
+        vectors[i].iov_len = buffers[i].size;
+    }
+    size_t number_of_vectors = number_of_buffers;
+    advance(vectors, number_of_vectors, 0);
+    size_t total = 0;
+    while (number_of_vectors > 0)
+    {
+        ssize_t result = ::pwritev(m_handle, vectors, (int)std::min<size_t>(number_of_vectors, IOV_MAX), (off_t)(offset + total));
+        if (-1 == result)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            throw id::file_system::error(__FILE__, __LINE__, std::string("unable to write file: ") + strerror(errno));
+        }
+        if (0 == result)
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to write file: no Bytes written");
+        }
+        total += (size_t)result;
+        advance(vectors, number_of_vectors, (size_t)result);
+    }
+}
+
 #include "idlib/file_system/footer.in"
 
 #endif
@@ -0,0 +1,38 @@
+#include "idlib/file_system/file_operations_linux.hpp"
+
+#if defined(ID_LINUX)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+
+#include "idlib/file_system/header.in"
+
+bool get_file_identity(const std::string& pathname, file_identity& identity) noexcept
+{
+    struct stat attributes;
+    if (0 != stat(pathname.c_str(), &attributes))
+    {
+        return false;
+    }
+    identity.device = (uint64_t)attributes.st_dev;
+    identity.inode = (uint64_t)attributes.st_ino;
+    identity.size = (uint64_t)attributes.st_size;
+    identity.modification_time = (int64_t)attributes.st_mtim.tv_sec * 1000000000 + attributes.st_mtim.tv_nsec;
+    return true;
+}
+
+bool is_regular_file(const std::string& pathname) noexcept
+{
+    struct stat attributes;
+    return 0 == stat(pathname.c_str(), &attributes) && S_ISREG(attributes.st_mode);
+}
+
+bool replace_file(const std::string& source, const std::string& target) noexcept
+{
+    return 0 == rename(source.c_str(), target.c_str());
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+
+#if defined(ID_LINUX)
+#include "idlib/file_system/header.in"
+
+/// @brief The identity and the attributes of a file used to detect changes of the file.
+struct file_identity
+{
+    /// @brief The device of the file.
+    uint64_t device;
+    /// @brief The inode of the file.
+    uint64_t inode;
+    /// @brief The size, in Bytes, of the file.
+    uint64_t size;
+    /// @brief The modification time, in nanoseconds since the epoch, of the file.
+    int64_t modification_time;
+};
+
+/// @brief Get the identity of a file.
+/// @param pathname the pathname of the file
+/// @param [out] identity the identity of the file
+/// @return @a true on success, @a false on failure
+bool get_file_identity(const std::string& pathname, file_identity& identity) noexcept;
+
+/// @brief Get if a file exists and is a regular file.
+/// @param pathname the pathname of the file
+/// @return @a true if the file exists and is a regular file, @a false otherwise
+bool is_regular_file(const std::string& pathname) noexcept;
+
+/// @brief Replace a file by another file.
+/// @param source the pathname of the file replacing the target file
+/// @param target the pathname of the file to replace
+/// @return @a true on success, @a false on failure
+bool replace_file(const std::string& source, const std::string& target) noexcept;
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
@@ -0,0 +1,44 @@
+#include "idlib/file_system/file_operations_windows.hpp"
+
+#if defined(ID_WINDOWS)
+
+#include "idlib/file_system/header.in"
+
+bool get_file_identity(const std::string& pathname, file_identity& identity) noexcept
+{
+    HANDLE handle = CreateFileA(pathname.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == handle)
+    {
+        return false;
+    }
+    BY_HANDLE_FILE_INFORMATION information;
+    BOOL result = GetFileInformationByHandle(handle, &information);
+    CloseHandle(handle);
+    if (!result)
+    {
+        return false;
+    }
+    identity.device = information.dwVolumeSerialNumber;
+    identity.inode = ((uint64_t)information.nFileIndexHigh << 32) | information.nFileIndexLow;
+    identity.size = ((uint64_t)information.nFileSizeHigh << 32) | information.nFileSizeLow;
+    // Convert from 100 nanosecond intervals since 1601-01-01 to nanoseconds since 1970-01-01.
+    int64_t time = (int64_t)(((uint64_t)information.ftLastWriteTime.dwHighDateTime << 32) | information.ftLastWriteTime.dwLowDateTime);
+    identity.modification_time = (time - 116444736000000000LL) * 100;
+    return true;
+}
+
+bool is_regular_file(const std::string& pathname) noexcept
+{
+    DWORD attributes = GetFileAttributesA(pathname.c_str());
+    return INVALID_FILE_ATTRIBUTES != attributes && 0 == (attributes & (FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE));
+}
+
+bool replace_file(const std::string& source, const std::string& target) noexcept
+{
+    return FALSE != MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING);
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
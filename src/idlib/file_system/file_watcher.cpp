@@ -0,0 +1,174 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/file_watcher.cpp
+/// @brief Notification about changes of files in directory trees.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/file_watcher.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/file_watcher_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/file_watcher_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief Coalesce two successive changes of a file.
+/// @param first the first change
+/// @param second the second change
+/// @param [out] cancelled @a true if the changes cancel out, @a false otherwise
+/// @return the coalesced change
+change_type coalesce(change_type first, change_type second, bool& cancelled) noexcept
+{
+    cancelled = false;
+    if (change_type::overflowed == first || change_type::overflowed == second)
+    {
+        return change_type::overflowed;
+    }
+    switch (first)
+    {
+        case change_type::created:
+            // A file which was created and removed within a batch was never observed.
+            cancelled = (change_type::removed == second);
+            return change_type::created;
+        case change_type::modified:
+            return change_type::removed == second ? change_type::removed : change_type::modified;
+        case change_type::removed:
+            // A file which was removed and created within a batch was replaced.
+            return change_type::removed == second ? change_type::removed : change_type::modified;
+        default:
+            return second;
+    };
+}
+
+} // namespace
+
+file_watcher::file_watcher(std::chrono::milliseconds coalescing_window) :
+    m_pimpl(std::make_unique<file_watcher_impl>()), m_coalescing_window(coalescing_window), m_deadline(),
+    m_pending(), m_index(), changed()
+{}
+
+file_watcher::~file_watcher() noexcept
+{}
+
+void file_watcher::add(const std::string& pathname)
+{
+    m_pimpl->add(pathname);
+}
+
+void file_watcher::remove(const std::string& pathname)
+{
+    m_pimpl->remove(pathname);
+}
+
+size_t file_watcher::poll(std::chrono::milliseconds timeout)
+{
+    using clock = std::chrono::steady_clock;
+    const auto end = clock::now() + timeout;
+    auto record = [this](const std::string& pathname, change_type type) { this->record(pathname, type); };
+    while (true)
+    {
+        m_pimpl->read(record);
+        const auto now = clock::now();
+        if (!m_pending.empty() && now >= m_deadline)
+        {
+            size_t count = publish();
+            if (0 != count)
+            {
+                return count;
+            }
+        }
+        if (now >= end)
+        {
+            return 0;
+        }
+        // Wake up at the end of the coalescing window at the latest.
+        auto until = m_pending.empty() ? end : std::min(end, m_deadline);
+        m_pimpl->wait(std::chrono::ceil<std::chrono::milliseconds>(until - now).count());
+    }
+}
+
+size_t file_watcher::pending() const noexcept
+{
+    return m_pending.size();
+}
+
+std::chrono::milliseconds file_watcher::coalescing_window() const noexcept
+{
+    return m_coalescing_window;
+}
+
+void file_watcher::record(const std::string& pathname, change_type type)
+{
+    if (m_pending.empty())
+    {
+        m_deadline = std::chrono::steady_clock::now() + m_coalescing_window;
+    }
+    auto it = m_index.find(pathname);
+    if (m_index.end() == it)
+    {
+        m_index.emplace(pathname, m_pending.size());
+        m_pending.push_back({ { pathname, type }, false });
+        return;
+    }
+    auto& pending = m_pending[it->second];
+    if (pending.cancelled)
+    {
+        pending.change.type = type;
+        pending.cancelled = false;
+    }
+    else
+    {
+        pending.change.type = coalesce(pending.change.type, type, pending.cancelled);
+    }
+}
+
+size_t file_watcher::publish()
+{
+    std::vector<file_change> changes;
+    changes.reserve(m_pending.size());
+    for (auto& pending : m_pending)
+    {
+        if (!pending.cancelled)
+        {
+            changes.push_back(std::move(pending.change));
+        }
+    }
+    m_pending.clear();
+    m_index.clear();
+    if (!changes.empty())
+    {
+        changed(changes);
+    }
+    return changes.size();
+}
+
+#include "idlib/file_system/footer.in"
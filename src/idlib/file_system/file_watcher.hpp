@@ -0,0 +1,133 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/file_watcher.hpp
+/// @brief Notification about changes of files in directory trees.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/signal/signal.hpp"
+#include "idlib/file_system/file_change.hpp"
+
+#include "idlib/file_system/header.in"
+
+// Forward declaration.
+class file_watcher_impl;
+
+/// @brief Watches directory trees and publishes coalesced batches of changes.
+/// @detail
+/// Changes are reported by the operating system (inotify under Linux, ReadDirectoryChangesW under Windows), hence the
+/// cost of watching is proportional to the number of changes rather than to the number of watched files.
+/// Changes are collected by id::file_system::file_watcher::poll. A batch is published by the signal
+/// id::file_system::file_watcher::changed once the coalescing window has elapsed since the first change of the batch.
+/// Within a batch, the changes of a file are coalesced into a single change e.g. a file which was created and modified
+/// is reported as created and a file which was created and removed is not reported.
+/// @code
+/// id::file_system::file_watcher watcher(std::chrono::milliseconds(100));
+/// watcher.add("assets");
+/// watcher.changed.subscribe([](const std::vector<id::file_system::file_change>& changes) { ... });
+/// while (running)
+/// {
+///     watcher.poll();
+///     ...
+/// }
+/// @endcode
+/// Non-copyable.
+class file_watcher
+{
+private:
+    /// @brief A pending change.
+    struct pending_change
+    {
+        /// @brief The change.
+        file_change change;
+        /// @brief If @a true, then the changes of the file cancel out and the change is not published.
+        bool cancelled;
+    };
+
+    /// @brief The pointer to the implementation.
+    std::unique_ptr<file_watcher_impl> m_pimpl;
+    /// @brief The coalescing window.
+    std::chrono::milliseconds m_coalescing_window;
+    /// @brief The point in time at which the pending changes are published.
+    std::chrono::steady_clock::time_point m_deadline;
+    /// @brief The pending changes in the order of their first occurrence.
+    std::vector<pending_change> m_pending;
+    /// @brief Maps pathnames to indices into the pending changes.
+    std::unordered_map<std::string, size_t> m_index;
+
+public:
+    /// @brief Invoked with a batch of changes.
+    /// @remark Invoked by the thread calling id::file_system::file_watcher::poll.
+    id::signal<void(const std::vector<file_change>&)> changed;
+
+    /// @brief Construct this file watcher.
+    /// @param coalescing_window the duration for which changes are collected before they are published
+    /// @throw id::file_system::error the environment fails
+    explicit file_watcher(std::chrono::milliseconds coalescing_window = std::chrono::milliseconds(50));
+
+    /// @brief Destruct this file watcher.
+    ~file_watcher() noexcept;
+
+    // Delete copy constructor.
+    file_watcher(const file_watcher&) = delete;
+
+    // Delete copy assignment operator.
+    file_watcher& operator=(const file_watcher&) = delete;
+
+public:
+    /// @brief Watch a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    /// @throw id::file_system::error the directory can not be watched
+    /// @remark Subdirectories created later are watched as well.
+    void add(const std::string& pathname);
+
+    /// @brief Stop watching a directory and its subdirectories.
+    /// @param pathname the pathname of the directory as passed to id::file_system::file_watcher::add
+    /// @remark If the directory is not watched, then this function has no effect.
+    void remove(const std::string& pathname);
+
+    /// @brief Collect changes and publish them if the coalescing window has elapsed.
+    /// @param timeout the maximum duration to wait for a batch to be published
+    /// @return the number of changes published
+    /// @throw id::file_system::error the environment fails
+    /// @remark Returns as soon as a batch was published or the timeout has elapsed.
+    /// If the timeout is zero, then this function does not block.
+    size_t poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /// @brief Get the number of pending changes.
+    /// @return the number of pending changes
+    size_t pending() const noexcept;
+
+    /// @brief Get the coalescing window.
+    /// @return the coalescing window
+    std::chrono::milliseconds coalescing_window() const noexcept;
+
+private:
+    /// @brief Add a change to the pending changes.
+    /// @param pathname the pathname of the file
+    /// @param type the type of the change
+    void record(const std::string& pathname, change_type type);
+
+    /// @brief Publish the pending changes.
+    /// @return the number of changes published
+    size_t publish();
+
+}; // class file_watcher
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,215 @@
+#include "idlib/file_system/file_watcher_linux.hpp"
+
+#if defined(ID_LINUX)
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/directory_linux.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The events watched for.
+constexpr uint32_t watch_mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE
+                              | IN_ATTRIB | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+/// @brief Get if a pathname is the pathname of a directory or of an entry of its tree.
+bool is_in_tree(const std::string& pathname, const std::string& root) noexcept
+{
+    return 0 == pathname.compare(0, root.size(), root)
+        && (pathname.size() == root.size() || '/' == pathname[root.size()]);
+}
+
+} // namespace
+
+file_watcher_impl::file_watcher_impl() :
+    m_handle(-1), m_watches(), m_roots()
+{
+    m_handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (-1 == m_handle)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, std::string("unable to create file watcher: ") + strerror(errno));
+    }
+}
+
+file_watcher_impl::~file_watcher_impl() noexcept
+{
+    ::close(m_handle);
+}
+
+void file_watcher_impl::add(const std::string& pathname)
+{
+    directory_impl directory;
+    if (!directory.open(pathname) || !watch(directory, pathname, nullptr))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + pathname + "`");
+    }
+    m_roots.push_back(pathname);
+}
+
+void file_watcher_impl::remove(const std::string& pathname) noexcept
+{
+    auto it = std::find(m_roots.begin(), m_roots.end(), pathname);
+    if (m_roots.end() != it)
+    {
+        m_roots.erase(it);
+        unwatch(pathname);
+    }
+}
+
+bool file_watcher_impl::wait(int64_t timeout)
+{
+    pollfd descriptor;
+    descriptor.fd = m_handle;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    int result = ::poll(&descriptor, 1, (int)std::min<int64_t>(std::max<int64_t>(timeout, 0), std::numeric_limits<int>::max()));
+    if (-1 == result)
+    {
+        if (EINTR == errno)
+        {
+            return false;
+        }
+        throw id::file_system::error(__FILE__, __LINE__, std::string("unable to wait for changes: ") + strerror(errno));
+    }
+    return 0 != result;
+}
+
+void file_watcher_impl::read(const change_function& function)
+{
+    // Large enough for a few hundred events per system call.
+    alignas(inotify_event) char buffer[64 * 1024];
+    while (true)
+    {
+        ssize_t result = ::read(m_handle, buffer, sizeof(buffer));
+        if (-1 == result)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if (EAGAIN == errno || EWOULDBLOCK == errno)
+            {
+                break;
+            }
+            throw id::file_system::error(__FILE__, __LINE__, std::string("unable to read changes: ") + strerror(errno));
+        }
+        for (ssize_t offset = 0; offset < result;)
+        {
+            const inotify_event *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+            if (0 != (event->mask & IN_Q_OVERFLOW))
+            {
+                for (const auto& root : m_roots)
+                {
+                    function(root, change_type::overflowed);
+                }
+                continue;
+            }
+            auto it = m_watches.find(event->wd);
+            if (m_watches.end() == it)
+            {
+                continue;
+            }
+            if (0 != (event->mask & IN_IGNORED))
+            {
+                m_watches.erase(it);
+                continue;
+            }
+            // Events without a name concern the watched directory itself and are reported by its parent.
+            if (0 == event->len)
+            {
+                continue;
+            }
+            std::string pathname = it->second + "/" + event->name;
+            if (0 != (event->mask & (IN_CREATE | IN_MOVED_TO)))
+            {
+                function(pathname, change_type::created);
+                if (0 != (event->mask & IN_ISDIR))
+                {
+                    // Entries created before the watch was added are reported as created.
+                    directory_impl directory;
+                    if (directory.open(pathname))
+                    {
+                        watch(directory, pathname, &function);
+                    }
+                }
+            }
+            else if (0 != (event->mask & (IN_DELETE | IN_MOVED_FROM)))
+            {
+                if (0 != (event->mask & IN_ISDIR) && 0 != (event->mask & IN_MOVED_FROM))
+                {
+                    // The watches of a moved directory remain valid but their pathnames are stale.
+                    unwatch(pathname);
+                }
+                function(pathname, change_type::removed);
+            }
+            else if (0 == (event->mask & IN_ISDIR))
+            {
+                function(pathname, change_type::modified);
+            }
+        }
+    }
+}
+
+bool file_watcher_impl::watch(directory_impl& directory, const std::string& pathname, const change_function *function)
+{
+    int descriptor = inotify_add_watch(m_handle, pathname.c_str(), watch_mask);
+    if (-1 == descriptor)
+    {
+        if (ENOENT == errno || ENOTDIR == errno)
+        {
+            return false;
+        }
+        throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + pathname + "`: " + strerror(errno));
+    }
+    m_watches[descriptor] = pathname;
+    // The subdirectories are watched after the enumeration such that only one enumeration buffer is on the stack.
+    std::vector<std::string> subdirectories;
+    directory.enumerate(false, [&](const char *name, entry_type type, uint64_t, int64_t)
+    {
+        if (nullptr != function)
+        {
+            (*function)(pathname + "/" + name, change_type::created);
+        }
+        if (entry_type::directory == type)
+        {
+            subdirectories.emplace_back(name);
+        }
+    });
+    for (const auto& name : subdirectories)
+    {
+        directory_impl subdirectory;
+        if (subdirectory.open(directory, name))
+        {
+            watch(subdirectory, pathname + "/" + name, function);
+        }
+    }
+    return true;
+}
+
+void file_watcher_impl::unwatch(const std::string& pathname) noexcept
+{
+    for (auto it = m_watches.begin(); it != m_watches.end();)
+    {
+        if (is_in_tree(it->second, pathname))
+        {
+            inotify_rm_watch(m_handle, it->first);
+            it = m_watches.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
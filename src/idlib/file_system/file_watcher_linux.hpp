@@ -0,0 +1,87 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/file_system/file_change.hpp"
+
+#if defined(ID_LINUX)
+#include "idlib/file_system/header.in"
+
+// Forward declaration.
+class directory_impl;
+
+/// @brief Watches directory trees using inotify.
+/// @detail inotify does not watch subdirectories, hence a watch is added for each directory of a tree.
+class file_watcher_impl
+{
+public:
+    /// @brief A function invoked for a change.
+    /// The arguments are the pathname of the file and the type of the change.
+    using change_function = std::function<void(const std::string&, change_type)>;
+
+private:
+    /// @brief The inotify file descriptor.
+    int m_handle;
+    /// @brief Maps watch descriptors to the pathnames of the watched directories.
+    std::unordered_map<int, std::string> m_watches;
+    /// @brief The pathnames of the watched trees.
+    std::vector<std::string> m_roots;
+
+public:
+    /// @brief Construct this file watcher.
+    /// @throw id::file_system::error the environment fails
+    file_watcher_impl();
+
+    /// @brief Destruct this file watcher.
+    ~file_watcher_impl() noexcept;
+
+    // Delete copy constructor.
+    file_watcher_impl(const file_watcher_impl&) = delete;
+
+    // Delete copy assignment operator.
+    file_watcher_impl& operator=(const file_watcher_impl&) = delete;
+
+public:
+    /// @brief Watch a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    /// @throw id::file_system::error the directory can not be watched
+    void add(const std::string& pathname);
+
+    /// @brief Stop watching a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    void remove(const std::string& pathname) noexcept;
+
+    /// @brief Wait until changes are available.
+    /// @param timeout the timeout, in milliseconds
+    /// @return @a true if changes are available, @a false if the timeout has elapsed
+    /// @throw id::file_system::error the environment fails
+    bool wait(int64_t timeout);
+
+    /// @brief Read the available changes without blocking.
+    /// @param function the function invoked for each change
+    /// @throw id::file_system::error the environment fails
+    void read(const change_function& function);
+
+private:
+    /// @brief Watch a directory and its subdirectories.
+    /// @param directory the directory
+    /// @param pathname the pathname of the directory
+    /// @param function a function invoked for each entry of the tree or a null pointer
+    /// @return @a true on success, @a false if the directory does not exist anymore
+    /// @throw id::file_system::error the directory can not be watched
+    /// @remark The watch of a directory is added before the directory is enumerated, hence no entries are missed.
+    bool watch(directory_impl& directory, const std::string& pathname, const change_function *function);
+
+    /// @brief Stop watching the directories of a tree.
+    /// @param pathname the pathname of the root directory of the tree
+    void unwatch(const std::string& pathname) noexcept;
+
+}; // class file_watcher_impl
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
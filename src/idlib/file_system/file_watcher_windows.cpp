@@ -0,0 +1,173 @@
+#include "idlib/file_system/file_watcher_windows.hpp"
+
+#if defined(ID_WINDOWS)
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The changes watched for.
+constexpr DWORD watch_filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE
+                             | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_CREATION;
+
+/// @brief Convert a name reported by ReadDirectoryChangesW to UTF-8.
+std::string to_utf8(const WCHAR *name, DWORD length)
+{
+    int size = WideCharToMultiByte(CP_UTF8, 0, name, (int)length, nullptr, 0, nullptr, nullptr);
+    std::string result(size, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, name, (int)length, &result[0], size, nullptr, nullptr);
+    return result;
+}
+
+} // namespace
+
+file_watcher_impl::file_watcher_impl() :
+    m_watches()
+{}
+
+file_watcher_impl::~file_watcher_impl() noexcept
+{
+    for (auto& watch : m_watches)
+    {
+        close(*watch);
+    }
+}
+
+void file_watcher_impl::add(const std::string& pathname)
+{
+    if (MAXIMUM_WAIT_OBJECTS == m_watches.size())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + pathname + "`: too many watched directories");
+    }
+    auto watch = std::make_unique<file_watcher_impl::watch>();
+    watch->pathname = pathname;
+    watch->buffer = std::make_unique<DWORD[]>(buffer_size);
+    watch->handle = CreateFileA(pathname.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (INVALID_HANDLE_VALUE == watch->handle)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + pathname + "`");
+    }
+    ZeroMemory(&watch->overlapped, sizeof(OVERLAPPED));
+    watch->overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (nullptr == watch->overlapped.hEvent)
+    {
+        CloseHandle(watch->handle);
+        throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + pathname + "`");
+    }
+    if (!start(*watch))
+    {
+        CloseHandle(watch->overlapped.hEvent);
+        CloseHandle(watch->handle);
+        throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + pathname + "`");
+    }
+    m_watches.push_back(std::move(watch));
+}
+
+void file_watcher_impl::remove(const std::string& pathname) noexcept
+{
+    auto it = std::find_if(m_watches.begin(), m_watches.end(), [&pathname](const auto& watch) { return pathname == watch->pathname; });
+    if (m_watches.end() != it)
+    {
+        close(**it);
+        m_watches.erase(it);
+    }
+}
+
+bool file_watcher_impl::wait(int64_t timeout)
+{
+    if (m_watches.empty())
+    {
+        Sleep((DWORD)std::min<int64_t>(std::max<int64_t>(timeout, 0), INFINITE - 1));
+        return false;
+    }
+    HANDLE events[MAXIMUM_WAIT_OBJECTS];
+    for (size_t i = 0, n = m_watches.size(); i < n; ++i)
+    {
+        events[i] = m_watches[i]->overlapped.hEvent;
+    }
+    DWORD result = WaitForMultipleObjects((DWORD)m_watches.size(), events, FALSE,
+                                          (DWORD)std::min<int64_t>(std::max<int64_t>(timeout, 0), INFINITE - 1));
+    if (WAIT_FAILED == result)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to wait for changes");
+    }
+    return WAIT_TIMEOUT != result;
+}
+
+void file_watcher_impl::read(const change_function& function)
+{
+    for (auto& watch : m_watches)
+    {
+        DWORD transferred = 0;
+        if (!GetOverlappedResult(watch->handle, &watch->overlapped, &transferred, FALSE))
+        {
+            if (ERROR_IO_INCOMPLETE == GetLastError())
+            {
+                continue;
+            }
+            // The buffer overflowed or the directory was removed.
+            transferred = 0;
+        }
+        if (0 == transferred)
+        {
+            function(watch->pathname, change_type::overflowed);
+        }
+        else
+        {
+            const char *buffer = reinterpret_cast<const char *>(watch->buffer.get());
+            for (DWORD offset = 0;;)
+            {
+                const FILE_NOTIFY_INFORMATION *information = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(buffer + offset);
+                std::string pathname = watch->pathname + "\\" + to_utf8(information->FileName, information->FileNameLength / sizeof(WCHAR));
+                switch (information->Action)
+                {
+                    case FILE_ACTION_ADDED:
+                    case FILE_ACTION_RENAMED_NEW_NAME:
+                        function(pathname, change_type::created);
+                        break;
+                    case FILE_ACTION_REMOVED:
+                    case FILE_ACTION_RENAMED_OLD_NAME:
+                        function(pathname, change_type::removed);
+                        break;
+                    case FILE_ACTION_MODIFIED:
+                        function(pathname, change_type::modified);
+                        break;
+                };
+                if (0 == information->NextEntryOffset)
+                {
+                    break;
+                }
+                offset += information->NextEntryOffset;
+            }
+        }
+        ResetEvent(watch->overlapped.hEvent);
+        if (!start(*watch))
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to watch directory `" + watch->pathname + "`");
+        }
+    }
+}
+
+bool file_watcher_impl::start(watch& watch) noexcept
+{
+    return FALSE != ReadDirectoryChangesW(watch.handle, watch.buffer.get(), (DWORD)(buffer_size * sizeof(DWORD)), TRUE,
+                                          watch_filter, nullptr, &watch.overlapped, nullptr);
+}
+
+void file_watcher_impl::close(watch& watch) noexcept
+{
+    CancelIoEx(watch.handle, &watch.overlapped);
+    DWORD transferred;
+    GetOverlappedResult(watch.handle, &watch.overlapped, &transferred, TRUE);
+    CloseHandle(watch.overlapped.hEvent);
+    CloseHandle(watch.handle);
+}
+
+#include "idlib/file_system/footer.in"
+
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/file_system/file_change.hpp"
+
+#if defined(ID_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+#include "idlib/file_system/header.in"
+
+/// @brief Watches directory trees using ReadDirectoryChangesW.
+/// @detail Each tree is watched by an overlapped read of its root directory. At most MAXIMUM_WAIT_OBJECTS trees can be watched.
+class file_watcher_impl
+{
+public:
+    /// @brief A function invoked for a change.
+    /// The arguments are the pathname of the file and the type of the change.
+    using change_function = std::function<void(const std::string&, change_type)>;
+
+private:
+    /// @brief A watched tree.
+    struct watch
+    {
+        /// @brief The pathname of the root directory.
+        std::string pathname;
+        /// @brief The handle of the root directory.
+        HANDLE handle;
+        /// @brief The overlapped structure of the pending read.
+        OVERLAPPED overlapped;
+        /// @brief The buffer of the pending read. ReadDirectoryChangesW requires DWORD alignment.
+        std::unique_ptr<DWORD[]> buffer;
+    };
+
+    /// @brief The watched trees.
+    std::vector<std::unique_ptr<watch>> m_watches;
+
+public:
+    /// @brief Construct this file watcher.
+    file_watcher_impl();
+
+    /// @brief Destruct this file watcher.
+    ~file_watcher_impl() noexcept;
+
+    // Delete copy constructor.
+    file_watcher_impl(const file_watcher_impl&) = delete;
+
+    // Delete copy assignment operator.
+    file_watcher_impl& operator=(const file_watcher_impl&) = delete;
+
+public:
+    /// @brief Watch a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    /// @throw id::file_system::error the directory can not be watched
+    void add(const std::string& pathname);
+
+    /// @brief Stop watching a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    void remove(const std::string& pathname) noexcept;
+
+    /// @brief Wait until changes are available.
+    /// @param timeout the timeout, in milliseconds
+    /// @return @a true if changes are available, @a false if the timeout has elapsed
+    /// @throw id::file_system::error the environment fails
+    bool wait(int64_t timeout);
+
+    /// @brief Read the available changes without blocking.
+    /// @param function the function invoked for each change
+    /// @throw id::file_system::error the environment fails
+    void read(const change_function& function);
+
+private:
+    /// @brief The size, in DWORDs, of the buffer of a watch.
+    static constexpr size_t buffer_size = 16 * 1024;
+
+    /// @brief Start an overlapped read of a watch.
+    /// @param watch the watch
+    /// @return @a true on success, @a false on failure
+    static bool start(watch& watch) noexcept;
+
+    /// @brief Cancel the pending read of a watch and close it.
+    /// @param watch the watch
+    static void close(watch& watch) noexcept;
+
+}; // class file_watcher_impl
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
@@ -8,7 +8,7 @@
 
 #include "idlib/file_system/header.in"
 
-void file_descriptor_impl::open(const std::string& pathname, access_mode access_mode, create_mode create_mode) noexcept
+void file_descriptor_impl::open(const std::string& pathname, access_mode access_mode, create_mode create_mode, open_flags open_flags) noexcept
 {
     close();
 	m_access_mode = access_mode;
@@ -42,7 +42,14 @@ void file_descriptor_impl::open(const std::string& pathname, access_mode access_
     default:
         return;
     };
-    m_handle = CreateFileA(pathname.c_str(), dwAccessMode, dwShareMode, 0, dwCreateMode, FILE_ATTRIBUTE_NORMAL, 0);
+    // Handles are not inherited unless requested, hence open_flags::close_on_exec needs not be mapped.
+    // The access time is updated lazily by Windows, hence open_flags::no_access_time is ignored.
+    DWORD dwFlags = FILE_ATTRIBUTE_NORMAL;
+    if (open_flags::none != (open_flags & open_flags::direct))
+    {
+        dwFlags |= FILE_FLAG_NO_BUFFERING;
+    }
+    m_handle = CreateFileA(pathname.c_str(), dwAccessMode, dwShareMode, 0, dwCreateMode, dwFlags, 0);
 }
 
 bool file_descriptor_impl::is_open() const noexcept
@@ -90,6 +97,76 @@ size_t file_descriptor_impl::size() const
     return size;
 }
 
+size_t file_descriptor_impl::read_some(size_t offset, const mutable_buffer *buffers, size_t number_of_buffers)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to read file: file is not open");
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < number_of_buffers; ++i)
+    {
+        char *buffer = static_cast<char *>(buffers[i].data);
+        size_t length = buffers[i].size;
+        while (length > 0)
+        {
+            // A synchronous handle reads at the offset specified by the overlapped structure.
+            OVERLAPPED overlapped;
+            std::memset(&overlapped, 0, sizeof(overlapped));
+            overlapped.Offset = (DWORD)((uint64_t)(offset + total) & 0xffffffff);
+            overlapped.OffsetHigh = (DWORD)((uint64_t)(offset + total) >> 32);
+            DWORD request = (DWORD)std::min<size_t>(length, 1u << 30), result = 0;
+            if (!ReadFile(m_handle, buffer, request, &result, &overlapped))
+            {
+                if (ERROR_HANDLE_EOF == GetLastError())
+                {
+                    return total;
+                }
+                throw id::file_system::error(__FILE__, __LINE__, "unable to read file: error " + std::to_string(GetLastError()));
+            }
+            if (0 == result)
+            {
+                // The end of the file was reached.
+                return total;
+            }
+            buffer += result;
+            length -= result;
+            total += result;
+        }
+    }
+    return total;
+}
+
+void file_descriptor_impl::write(size_t offset, const const_buffer *buffers, size_t number_of_buffers)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to write file: file is not open");
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < number_of_buffers; ++i)
+    {
+        const char *buffer = static_cast<const char *>(buffers[i].data);
+        size_t length = buffers[i].size;
+        while (length > 0)
+        {
+            // A synchronous handle writes at the offset specified by the overlapped structure.
+            OVERLAPPED overlapped;
+            std::memset(&overlapped, 0, sizeof(overlapped));
+            overlapped.Offset = (DWORD)((uint64_t)(offset + total) & 0xffffffff);
+            overlapped.OffsetHigh = (DWORD)((uint64_t)(offset + total) >> 32);
+            DWORD request = (DWORD)std::min<size_t>(length, 1u << 30), result = 0;
+            if (!WriteFile(m_handle, buffer, request, &result, &overlapped) || 0 == result)
+            {
+                throw id::file_system::error(__FILE__, __LINE__, "unable to write file: error " + std::to_string(GetLastError()));
+            }
+            buffer += result;
+            length -= result;
+            total += result;
+        }
+    }
+}
+
 #include "idlib/file_system/footer.in"
 
 #endif
@@ -0,0 +1,236 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/fingerprint_cache.cpp
+/// @brief A persistent cache of the hashes of the contents of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/fingerprint_cache.hpp"
+#include "idlib/file_system/atomic_file_writer.hpp"
+#include "idlib/file_system/error.hpp"
+#include "idlib/utility/byte_order.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/file_operations_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/file_operations_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief The magic number of a cache file.
+constexpr char magic[4] = { 'I', 'D', 'F', 'C' };
+/// @brief The version of the format of a cache file.
+constexpr uint32_t version = 1;
+
+/// @brief Append an integer in little endian Byte order.
+template <class T>
+void append_integer(std::string& buffer, T value)
+{
+    value = convert_byte_order(value, byte_order::little_endian, get_byte_order());
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// @brief Read an integer in little endian Byte order.
+/// @return @a true on success, @a false if the input is exhausted
+template <class T>
+bool read_integer(const char *& current, const char *end, T& value)
+{
+    if ((size_t)(end - current) < sizeof(T))
+    {
+        return false;
+    }
+    memcpy(&value, current, sizeof(T));
+    value = convert_byte_order(value, get_byte_order(), byte_order::little_endian);
+    current += sizeof(T);
+    return true;
+}
+
+/// @brief Get the current time in nanoseconds since the epoch.
+int64_t get_current_time() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+fingerprint_cache::fingerprint_cache(const content_hasher& hasher) :
+    m_hasher(hasher), m_mutex(), m_entries(), m_hits(0), m_misses(0)
+{}
+
+uint64_t fingerprint_cache::get(const std::string& pathname)
+{
+    // The time is taken before the attributes such that later modifications have later modification times.
+    const int64_t now = get_current_time();
+    file_identity identity;
+    if (!get_file_identity(pathname, identity))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to fingerprint file `" + pathname + "`: unable to get attributes");
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(pathname);
+        if (m_entries.end() != it)
+        {
+            const entry& cached = it->second;
+            if (cached.device == identity.device && cached.inode == identity.inode && cached.size == identity.size
+             && cached.modification_time == identity.modification_time
+             && cached.modification_time + timestamp_granularity < cached.hashed_time)
+            {
+                m_hits++;
+                return cached.hash;
+            }
+        }
+        m_misses++;
+    }
+    // If the file is modified while it is hashed, then its modification time changes and it is rehashed next time.
+    const uint64_t hash = m_hasher.hash(pathname);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[pathname] = { identity.device, identity.inode, identity.size, identity.modification_time, now, hash };
+    return hash;
+}
+
+void fingerprint_cache::erase(const std::string& pathname)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(pathname);
+}
+
+void fingerprint_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+size_t fingerprint_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t fingerprint_cache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+size_t fingerprint_cache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+bool fingerprint_cache::load(const std::string& pathname)
+{
+    mapped_file_descriptor file;
+    file.open_read(pathname, create_mode::open_existing);
+    if (!file.is_open() || file.size() < sizeof(magic) + sizeof(uint32_t) + 2 * sizeof(uint64_t))
+    {
+        return false;
+    }
+    // The file is a header, the entries, and the hash of the header and the entries.
+    const char *current = file.data(), *end = file.data() + file.size() - sizeof(uint64_t);
+    const char *trailer = end;
+    uint64_t checksum;
+    if (!read_integer(trailer, trailer + sizeof(uint64_t), checksum) || checksum != hash_bytes(file.data(), file.size() - sizeof(uint64_t)))
+    {
+        return false;
+    }
+    uint32_t file_version;
+    uint64_t count;
+    if (0 != memcmp(current, magic, sizeof(magic)))
+    {
+        return false;
+    }
+    current += sizeof(magic);
+    if (!read_integer(current, end, file_version) || version != file_version || !read_integer(current, end, count))
+    {
+        return false;
+    }
+    std::unordered_map<std::string, entry> entries;
+    entries.reserve((size_t)std::min<uint64_t>(count, file.size()));
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint32_t length;
+        entry value;
+        if (!read_integer(current, end, length) || (size_t)(end - current) < length)
+        {
+            return false;
+        }
+        std::string entry_pathname(current, length);
+        current += length;
+        if (!read_integer(current, end, value.device) || !read_integer(current, end, value.inode) || !read_integer(current, end, value.size)
+         || !read_integer(current, end, value.modification_time) || !read_integer(current, end, value.hashed_time) || !read_integer(current, end, value.hash))
+        {
+            return false;
+        }
+        entries.emplace(std::move(entry_pathname), value);
+    }
+    if (current != end)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries = std::move(entries);
+    return true;
+}
+
+void fingerprint_cache::save(const std::string& pathname) const
+{
+    std::string buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer.reserve(sizeof(magic) + sizeof(uint32_t) + 2 * sizeof(uint64_t) + m_entries.size() * 64);
+        buffer.append(magic, sizeof(magic));
+        append_integer(buffer, version);
+        append_integer(buffer, (uint64_t)m_entries.size());
+        for (const auto& pair : m_entries)
+        {
+            append_integer(buffer, (uint32_t)pair.first.size());
+            buffer.append(pair.first);
+            append_integer(buffer, pair.second.device);
+            append_integer(buffer, pair.second.inode);
+            append_integer(buffer, pair.second.size);
+            append_integer(buffer, pair.second.modification_time);
+            append_integer(buffer, pair.second.hashed_time);
+            append_integer(buffer, pair.second.hash);
+        }
+    }
+    append_integer(buffer, hash_bytes(buffer.data(), buffer.size()));
+    // A crash must not leave a truncated cache file behind, however, losing the latest entries is harmless.
+    atomic_file_writer file;
+    file.open(pathname, durability::contents);
+    if (!file.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to save fingerprint cache `" + pathname + "`: unable to create temporary file");
+    }
+    file.write(buffer);
+    file.commit();
+}
+
+#include "idlib/file_system/footer.in"
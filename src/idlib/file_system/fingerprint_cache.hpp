@@ -0,0 +1,127 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/fingerprint_cache.hpp
+/// @brief A persistent cache of the hashes of the contents of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/content_hash.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A persistent cache of the hashes of the contents of files.
+/// @detail
+/// An entry stores the hash of the contents of a file together with the device, the inode, the size, and the
+/// modification time of the file at the time it was hashed. A file is rehashed only if one of these has changed.
+/// A file modified within id::file_system::fingerprint_cache::timestamp_granularity nanoseconds before it was hashed is
+/// rehashed until it is older, as a later modification within the same timestamp tick could not be detected.
+/// The cache is stored in a compact binary file by id::file_system::fingerprint_cache::save and restored by
+/// id::file_system::fingerprint_cache::load.
+/// @remark Thread-safe. Files are hashed outside of the lock of the cache.
+class fingerprint_cache
+{
+public:
+    /// @brief The granularity, in nanoseconds, assumed for modification times.
+    static constexpr int64_t timestamp_granularity = 2000000000;
+
+private:
+    /// @brief An entry.
+    struct entry
+    {
+        /// @brief The device of the file.
+        uint64_t device;
+        /// @brief The inode of the file.
+        uint64_t inode;
+        /// @brief The size, in Bytes, of the file.
+        uint64_t size;
+        /// @brief The modification time, in nanoseconds since the epoch, of the file.
+        int64_t modification_time;
+        /// @brief The time, in nanoseconds since the epoch, before the file was hashed.
+        int64_t hashed_time;
+        /// @brief The hash of the contents of the file.
+        uint64_t hash;
+    };
+
+    /// @brief The content hasher.
+    content_hasher m_hasher;
+    /// @brief The mutex.
+    mutable std::mutex m_mutex;
+    /// @brief Maps pathnames to entries.
+    std::unordered_map<std::string, entry> m_entries;
+    /// @brief The number of lookups which found a valid entry.
+    size_t m_hits;
+    /// @brief The number of lookups which hashed the file.
+    size_t m_misses;
+
+public:
+    /// @brief Construct this fingerprint cache.
+    /// @param hasher the content hasher
+    /// @post The cache is empty.
+    explicit fingerprint_cache(const content_hasher& hasher = content_hasher());
+
+    // Delete copy constructor.
+    fingerprint_cache(const fingerprint_cache&) = delete;
+
+    // Delete copy assignment operator.
+    fingerprint_cache& operator=(const fingerprint_cache&) = delete;
+
+public:
+    /// @brief Get the hash of the contents of a file.
+    /// @param pathname the pathname of the file
+    /// @return the hash of the contents of the file
+    /// @throw id::file_system::error the file can not be opened
+    /// @remark The file is hashed if the cache does not contain a valid entry for the file.
+    uint64_t get(const std::string& pathname);
+
+    /// @brief Remove the entry of a file.
+    /// @param pathname the pathname of the file
+    void erase(const std::string& pathname);
+
+    /// @brief Remove all entries.
+    void clear();
+
+    /// @brief Get the number of entries.
+    /// @return the number of entries
+    size_t size() const;
+
+    /// @brief Get the number of lookups which found a valid entry.
+    /// @return the number of lookups which found a valid entry
+    size_t hits() const;
+
+    /// @brief Get the number of lookups which hashed the file.
+    /// @return the number of lookups which hashed the file
+    size_t misses() const;
+
+    /// @brief Replace the entries by the entries stored in a file.
+    /// @param pathname the pathname of the file
+    /// @return @a true if the entries were replaced, @a false if the file does not exist or is not a valid cache file
+    /// @remark If @a false is returned, then the entries are not modified.
+    bool load(const std::string& pathname);
+
+    /// @brief Store the entries in a file.
+    /// @param pathname the pathname of the file
+    /// @throw id::file_system::error the file can not be written
+    /// @remark The entries are written by an id::file_system::atomic_file_writer with durability
+    /// id::file_system::durability::contents, hence the file is either the old or the new cache file if writing fails
+    /// or the system crashes.
+    void save(const std::string& pathname) const;
+
+}; // class fingerprint_cache
+
+#include "idlib/file_system/footer.in"
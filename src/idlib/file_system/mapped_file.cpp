@@ -2,6 +2,7 @@
 #undef IDLIB_PRIVATE
 #define IDLIB_PRIVATE 1
 #include "idlib/file_system/mapped_file.hpp"
+#include "idlib/file_system/error.hpp"
 #undef IDLIB_PRIVATE
 #pragma pop_macro("IDLIB_PRIVATE")
 
@@ -17,14 +18,14 @@
 
 #include "idlib/file_system/header.in"
 
-void mapped_file_descriptor::open_read(const std::string& pathname, create_mode create_mode) noexcept
+void mapped_file_descriptor::open_read(const std::string& pathname, create_mode create_mode, map_flags map_flags) noexcept
 {
-    m_pimpl->open_read(pathname, create_mode);
+    m_pimpl->open_read(pathname, create_mode, map_flags);
 }
 
-void mapped_file_descriptor::open_write(const std::string& pathname, create_mode create_mode, size_t size) noexcept
+void mapped_file_descriptor::open_write(const std::string& pathname, create_mode create_mode, size_t size, map_flags map_flags) noexcept
 {
-    m_pimpl->open_write(pathname, create_mode, size);
+    m_pimpl->open_write(pathname, create_mode, size, map_flags);
 }
 
 bool mapped_file_descriptor::is_open() const noexcept
@@ -32,6 +33,16 @@ bool mapped_file_descriptor::is_open() const noexcept
     return m_pimpl->is_open();
 }
 
+bool mapped_file_descriptor::is_opened_for_reading() const noexcept
+{
+    return m_pimpl->is_opened_for_reading();
+}
+
+bool mapped_file_descriptor::is_opened_for_writing() const noexcept
+{
+    return m_pimpl->is_opened_for_writing();
+}
+
 void mapped_file_descriptor::close() noexcept
 {
     m_pimpl->close();
@@ -42,11 +53,66 @@ char *mapped_file_descriptor::data()
     return m_pimpl->data();
 }
 
+const char *mapped_file_descriptor::data() const
+{
+    return m_pimpl->data();
+}
+
 size_t mapped_file_descriptor::size() const
 {
     return m_pimpl->size();
 }
 
+void mapped_file_descriptor::resize(size_t size)
+{
+    m_pimpl->resize(size);
+}
+
+void mapped_file_descriptor::flush(size_t offset, size_t length, flush_mode flush_mode)
+{
+    if (offset > size() || length > size() - offset)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to flush mapped file: range out of bounds");
+    }
+    m_pimpl->flush(offset, length, flush_mode);
+}
+
+void mapped_file_descriptor::flush(flush_mode flush_mode)
+{
+    m_pimpl->flush(0, size(), flush_mode);
+}
+
+bool mapped_file_descriptor::advise(access_advice advice, size_t offset, size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to advise mapped file: file is not open");
+    }
+    if (offset > size() || length > size() - offset)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to advise mapped file: range out of bounds");
+    }
+    return m_pimpl->advise(advice, offset, length);
+}
+
+bool mapped_file_descriptor::advise(access_advice advice)
+{
+    return advise(advice, 0, is_open() ? size() : 0);
+}
+
+void mapped_file_descriptor::prefetch(size_t offset, size_t length)
+{
+    if (!is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to prefetch mapped file: file is not open");
+    }
+    if (offset > size() || length > size() - offset)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to prefetch mapped file: range out of bounds");
+    }
+    m_pimpl->prefetch(offset, length);
+}
+
 mapped_file_descriptor::mapped_file_descriptor() :
     m_pimpl(std::make_unique<mapped_file_descriptor_impl>())
 {}
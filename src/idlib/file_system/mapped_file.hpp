@@ -1,6 +1,8 @@
 #pragma once
 
+#include "idlib/file_system/access_advice.hpp"
 #include "idlib/file_system/file.hpp"
+#include "idlib/file_system/flush_mode.hpp"
 
 #include "idlib/file_system/header.in"
 
@@ -18,11 +20,18 @@ public:
     /// @param pathname the pathname of the file
     /// @param create_mode the create mode
     /// @param size the size, in Bytes, of the memory mapped file
-    void open_write(const std::string& pathname, create_mode create_mode, size_t size) noexcept;
+    /// @remark The file is opened for reading and writing and is resized to @a size Bytes.
+    /// The storage of the file is allocated in advance where the file system supports it,
+    /// such that running out of storage is reported here and not by a fault when writing through @a data().
+    /// @param map_flags the map flags
+    void open_write(const std::string& pathname, create_mode create_mode, size_t size, map_flags map_flags = map_flags::none) noexcept;
     /// @brief Open a memory mapped file for reading.
     /// @param pathname the pathname of the file
     /// @param create_mode the create mode
-    void open_read(const std::string& pathname, create_mode create_mode) noexcept;
+    /// @param map_flags the map flags e.g. id::file_system::map_flags::populate to read the file into memory in advance
+    /// @remark With id::file_system::map_flags::private_copy, @a data() points to a read-only copy of the file in
+    /// private memory, which can be backed by huge pages and placed on NUMA nodes, rather than to the page cache.
+    void open_read(const std::string& pathname, create_mode create_mode, map_flags map_flags = map_flags::none) noexcept;
 
     /// @brief Get if the mapped file descriptor is open.
     /// @return @a true if the mapped descriptor is open, @a false otherwise
@@ -43,10 +52,61 @@ public:
     /// writing (reading) if the file is not opened for writing (reading) or an access outside of the bounds of the array is undefined behaviour.
     char *data();
 
+    /// @brief A pointer to an array of @a size() Bytes.
+    /// An access outside of the bounds of the array is undefined behaviour.
+    const char *data() const;
+
     /// @brief The size, in Bytes, of the mapped file.
     /// @return The size, in Bytes, of the mapped file
     size_t size() const;
 
+    /// @brief Resize the mapped file.
+    /// @param size the new size, in Bytes, of the mapped file
+    /// @pre The mapped file descriptor is open for writing.
+    /// @post The file and the mapping are @a size Bytes big. The contents up to the lesser of the old and
+    /// the new size are preserved. Pointers into the mapping are invalidated as the mapping might be moved.
+    /// @throw id::file_system::error the mapped file descriptor is not open for writing or the environment fails
+    void resize(size_t size);
+
+    /// @brief Flush a range of the mapped file to the file.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @param flush_mode the flush mode
+    /// @pre The mapped file descriptor is open for writing and the range is within the bounds of the mapping.
+    /// @throw id::file_system::error the mapped file descriptor is not open for writing, the range is out of bounds
+    /// or the environment fails
+    void flush(size_t offset, size_t length, flush_mode flush_mode = flush_mode::synchronous);
+
+    /// @brief Flush the mapped file to the file.
+    /// @param flush_mode the flush mode
+    /// @pre The mapped file descriptor is open for writing.
+    /// @throw id::file_system::error the mapped file descriptor is not open for writing or the environment fails
+    void flush(flush_mode flush_mode = flush_mode::synchronous);
+
+    /// @brief Advise how a range of the mapped file will be accessed.
+    /// @param advice the advice
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @return @a true if the advice was applied, @a false if it is not supported
+    /// @pre The mapped file descriptor is open and the range is within the bounds of the mapping.
+    /// @throw id::file_system::error the mapped file descriptor is not open or the range is out of bounds
+    /// @remark The advice is applied to the pages overlapping the range and, where supported, to the file.
+    /// id::file_system::access_advice::dont_need is not applied to a private copy as it would discard the copy.
+    bool advise(access_advice advice, size_t offset, size_t length);
+
+    /// @brief Advise how the mapped file will be accessed.
+    /// @param advice the advice
+    /// @return @a true if the advice was applied, @a false if it is not supported
+    /// @throw id::file_system::error the mapped file descriptor is not open
+    bool advise(access_advice advice);
+
+    /// @brief Start reading a range of the mapped file into memory.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @throw id::file_system::error the mapped file descriptor is not open or the range is out of bounds
+    /// @remark Returns without waiting for the reads to complete.
+    void prefetch(size_t offset, size_t length);
+
     /// @brief Construct this mapped file descriptor.
     /// @post The mapped file descriptor is closed.
     mapped_file_descriptor();
@@ -3,10 +3,97 @@
 #if defined(ID_LINUX)
 
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
 
 #include "idlib/file_system/header.in"
 
-void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_mode create_mode) noexcept
+namespace {
+
+/// @brief Get the mmap flags for map flags.
+int to_mmap_flags(map_flags map_flags)
+{
+    int flags = MAP_SHARED;
+    // Pages populated by mmap are mapped before they can be advised to be huge pages: populate after advising.
+    if (map_flags::populate == (map_flags & (map_flags::populate | map_flags::huge_pages)))
+    {
+        flags |= MAP_POPULATE;
+    }
+    return flags;
+}
+
+/// @brief The size, in Bytes, of a page.
+size_t page_size()
+{
+    static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+/// @brief The size, in Bytes, of an explicit (hugetlb) huge page.
+size_t huge_page_size()
+{
+    static const size_t huge_page_size = []()
+    {
+        std::ifstream stream("/proc/meminfo");
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            size_t kilobytes;
+            if (1 == sscanf(line.c_str(), "Hugepagesize: %zu kB", &kilobytes))
+            {
+                return kilobytes * 1024;
+            }
+        }
+        return (size_t)(2 * 1024 * 1024);
+    }();
+    return huge_page_size;
+}
+
+// The memory policies of mbind and get_mempolicy: numaif.h belongs to libnuma which is not a dependency.
+const int memory_policy_interleave = 3; // MPOL_INTERLEAVE
+const int memory_policy_local = 4; // MPOL_LOCAL
+const int memory_policy_mems_allowed = (1 << 2); // MPOL_F_MEMS_ALLOWED
+
+/// @brief Apply the NUMA placement of map flags to a range of memory before its pages are allocated.
+/// @return @a true if the placement was applied or none was requested, @a false otherwise
+bool place(void *data, size_t size, map_flags map_flags) noexcept
+{
+    bool interleave = map_flags::numa_interleave == (map_flags & map_flags::numa_interleave),
+         local = map_flags::numa_local == (map_flags & map_flags::numa_local);
+    if (!interleave && !local)
+    {
+        return true;
+    }
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+    unsigned long nodes[16] = {};
+    const unsigned long maximum_node = 8 * sizeof(nodes);
+    bool applied;
+    if (interleave)
+    {
+        applied = 0 == syscall(SYS_get_mempolicy, nullptr, nodes, maximum_node, nullptr, memory_policy_mems_allowed)
+               && 0 == syscall(SYS_mbind, data, size, memory_policy_interleave, nodes, maximum_node, 0);
+    }
+    else
+    {
+        applied = 0 == syscall(SYS_mbind, data, size, memory_policy_local, nullptr, 0, 0);
+    }
+    errno = 0;
+    return applied;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_mode create_mode, map_flags map_flags) noexcept
 {
     close();
     m_file_descriptor.open(pathname, id::file_system::access_mode::read, create_mode);
@@ -14,32 +101,176 @@ void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_
     {
         return;
     }
-    m_size = m_file_descriptor.size();
-    m_data = mmap(0, m_size, PROT_READ, MAP_SHARED, *((int *)m_file_descriptor.handle()), 0);
+    try
+    {
+        m_size = m_file_descriptor.size();
+    }
+    catch (...)
+    {
+        m_file_descriptor.close();
+        return;
+    }
+    // A mapping of 0 Bytes can not be created.
+    if (0 == m_size)
+    {
+        m_data = nullptr;
+        m_reading = true;
+        return;
+    }
+    if (map_flags::private_copy == (map_flags & map_flags::private_copy))
+    {
+        if (!copy(map_flags))
+        {
+            m_file_descriptor.close();
+            return;
+        }
+        m_reading = true;
+        return;
+    }
+    m_data = mmap(0, m_size, PROT_READ, to_mmap_flags(map_flags), *((int *)m_file_descriptor.handle()), 0);
     if (MAP_FAILED == m_data)
     {
         errno = 0;
         m_file_descriptor.close();
         return;
     }
+    m_mapping_size = m_size;
+    m_reading = true;
+    if (map_flags::huge_pages == (map_flags & map_flags::huge_pages))
+    {
+        advise(access_advice::huge_page, 0, m_size);
+        if (map_flags::populate == (map_flags & map_flags::populate))
+        {
+        #if defined(MADV_POPULATE_READ)
+            madvise(m_data, m_size, MADV_POPULATE_READ);
+            errno = 0;
+        #else
+            prefetch(0, m_size);
+        #endif
+        }
+    }
 }
 
-void mapped_file_descriptor_impl::open_write(const std::string& pathname, create_mode create_mode, size_t size) noexcept
+void mapped_file_descriptor_impl::open_write(const std::string& pathname, create_mode create_mode, size_t size, map_flags map_flags) noexcept
 {
     close();
-    m_file_descriptor.open(pathname, id::file_system::access_mode::write, create_mode);
+    // A shared writable mapping requires the file to be opened for reading and writing.
+    m_file_descriptor.open(pathname, id::file_system::access_mode::read_write, create_mode);
     if (!m_file_descriptor.is_open())
     {
         return;
     }
+    if (!allocate(size))
+    {
+        m_file_descriptor.close();
+        return;
+    }
     m_size = size;
-    m_data = mmap(0, m_size, PROT_READ, MAP_SHARED, *((int *)m_file_descriptor.handle()), 0);
+    // A mapping of 0 Bytes can not be created.
+    if (0 == m_size)
+    {
+        m_data = nullptr;
+        m_writing = true;
+        return;
+    }
+    m_data = mmap(0, m_size, PROT_READ | PROT_WRITE, to_mmap_flags(map_flags), *((int *)m_file_descriptor.handle()), 0);
     if (MAP_FAILED == m_data)
     {
         errno = 0;
         m_file_descriptor.close();
         return;
     }
+    m_mapping_size = m_size;
+    m_writing = true;
+    if (map_flags::huge_pages == (map_flags & map_flags::huge_pages))
+    {
+        advise(access_advice::huge_page, 0, m_size);
+        if (map_flags::populate == (map_flags & map_flags::populate))
+        {
+        #if defined(MADV_POPULATE_WRITE)
+            madvise(m_data, m_size, MADV_POPULATE_WRITE);
+            errno = 0;
+        #else
+            prefetch(0, m_size);
+        #endif
+        }
+    }
+}
+
+bool mapped_file_descriptor_impl::copy(map_flags map_flags) noexcept
+{
+    void *data = MAP_FAILED;
+    // Explicit huge pages are only available if the administrator reserved them.
+    // Their mappings must be a multiple of the huge page size.
+#if defined(MAP_HUGETLB)
+    if (m_size >= huge_page_size())
+    {
+        size_t size = (m_size + huge_page_size() - 1) / huge_page_size() * huge_page_size();
+        data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        m_mapping_size = size;
+    }
+#endif
+    if (MAP_FAILED == data)
+    {
+        data = mmap(0, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == data)
+        {
+            errno = 0;
+            return false;
+        }
+        m_mapping_size = m_size;
+    #if defined(MADV_HUGEPAGE)
+        madvise(data, m_size, MADV_HUGEPAGE);
+    #endif
+    }
+    errno = 0;
+    // The pages are allocated by the reads below: place them first.
+    place(data, m_mapping_size, map_flags);
+    int handle = *((int *)m_file_descriptor.handle());
+    for (size_t offset = 0; offset < m_size;)
+    {
+        ssize_t count = pread(handle, (char *)data + offset, m_size - offset, (off_t)offset);
+        if (-1 == count && EINTR == errno)
+        {
+            errno = 0;
+            continue;
+        }
+        if (count <= 0)
+        {
+            errno = 0;
+            munmap(data, m_mapping_size);
+            return false;
+        }
+        offset += (size_t)count;
+    }
+    // Like a mapping opened for reading, the copy is read-only.
+    mprotect(data, m_mapping_size, PROT_READ);
+    m_data = data;
+    m_copy = true;
+    return true;
+}
+
+bool mapped_file_descriptor_impl::allocate(size_t size) noexcept
+{
+    int handle = *((int *)m_file_descriptor.handle());
+    // Allocate the storage such that writing through the mapping does not fault if the storage is exhausted.
+    // Unlike posix_fallocate, fallocate does not fall back to writing zeroes if the file system does not support it.
+    if (0 < size && -1 == fallocate(handle, 0, 0, (off_t)size))
+    {
+        if (EOPNOTSUPP != errno && ENOSYS != errno)
+        {
+            errno = 0;
+            return false;
+        }
+        errno = 0;
+    }
+    // fallocate does not shrink the file and might not be supported.
+    if (-1 == ftruncate(handle, (off_t)size))
+    {
+        errno = 0;
+        return false;
+    }
+    return true;
 }
 
 bool mapped_file_descriptor_impl::is_open() const noexcept
@@ -47,17 +278,30 @@ bool mapped_file_descriptor_impl::is_open() const noexcept
     return MAP_FAILED != m_data;
 }
 
+bool mapped_file_descriptor_impl::is_opened_for_reading() const noexcept
+{
+    return m_reading;
+}
+
+bool mapped_file_descriptor_impl::is_opened_for_writing() const noexcept
+{
+    return m_writing;
+}
+
 void mapped_file_descriptor_impl::close() noexcept
 {
     if (MAP_FAILED != m_data)
     {
-        if (-1 == munmap(m_data, m_size))
+        if (nullptr != m_data && -1 == munmap(m_data, m_mapping_size))
         {
             perror("Error un-mmapping the file");
         }
-        m_data = NULL;
+        m_data = MAP_FAILED;
     }
     m_file_descriptor.close();
+    m_reading = false;
+    m_writing = false;
+    m_copy = false;
 }
 
 char *mapped_file_descriptor_impl::data()
@@ -70,8 +314,129 @@ size_t mapped_file_descriptor_impl::size() const
     return m_size;
 }
 
+void mapped_file_descriptor_impl::resize(size_t size)
+{
+    if (!m_writing)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: file is not opened for writing");
+    }
+    if (size == m_size)
+    {
+        return;
+    }
+    // Grow the file before the mapping, shrink the mapping before the file.
+    const bool growing = size > m_size;
+    if (growing && !allocate(size))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: unable to allocate storage");
+    }
+    void *data;
+    if (0 == size)
+    {
+        munmap(m_data, m_size);
+        data = nullptr;
+    }
+    else if (nullptr == m_data)
+    {
+        data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, *((int *)m_file_descriptor.handle()), 0);
+    }
+    else
+    {
+        data = mremap(m_data, m_size, size, MREMAP_MAYMOVE);
+    }
+    if (MAP_FAILED == data)
+    {
+        errno = 0;
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: unable to remap");
+    }
+    m_data = data;
+    m_size = size;
+    m_mapping_size = size;
+    if (!growing && !allocate(size))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: unable to truncate");
+    }
+}
+
+void mapped_file_descriptor_impl::flush(size_t offset, size_t length, flush_mode flush_mode)
+{
+    if (!m_writing)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to flush mapped file: file is not opened for writing");
+    }
+    if (0 == length)
+    {
+        return;
+    }
+    // msync requires a page-aligned address.
+    size_t begin = offset - offset % page_size();
+    int flags = flush_mode::synchronous == flush_mode ? MS_SYNC : MS_ASYNC;
+    if (-1 == msync((char *)m_data + begin, offset + length - begin, flags))
+    {
+        errno = 0;
+        throw id::file_system::error(__FILE__, __LINE__, "unable to flush mapped file");
+    }
+}
+
+bool mapped_file_descriptor_impl::advise(access_advice advice, size_t offset, size_t length) noexcept
+{
+    if (0 == length || nullptr == m_data)
+    {
+        return true;
+    }
+    int memory_advice, file_advice;
+    switch (advice)
+    {
+        case access_advice::normal:
+            memory_advice = MADV_NORMAL; file_advice = POSIX_FADV_NORMAL;
+            break;
+        case access_advice::sequential:
+            memory_advice = MADV_SEQUENTIAL; file_advice = POSIX_FADV_SEQUENTIAL;
+            break;
+        case access_advice::random:
+            memory_advice = MADV_RANDOM; file_advice = POSIX_FADV_RANDOM;
+            break;
+        case access_advice::will_need:
+            memory_advice = MADV_WILLNEED; file_advice = POSIX_FADV_WILLNEED;
+            break;
+        case access_advice::dont_need:
+            // The pages of a private copy are not backed by the file: dropping them would zero the copy.
+            if (m_copy)
+            {
+                return false;
+            }
+            // The pages of a shared mapping are dropped from the mapping, modifications are retained in the page cache.
+            memory_advice = MADV_DONTNEED; file_advice = POSIX_FADV_DONTNEED;
+            break;
+        case access_advice::huge_page:
+        #if defined(MADV_HUGEPAGE)
+            memory_advice = MADV_HUGEPAGE; file_advice = -1;
+            break;
+        #else
+            return false;
+        #endif
+        default:
+            return false;
+    };
+    // madvise requires a page-aligned address.
+    size_t begin = offset - offset % page_size();
+    bool applied = (0 == madvise((char *)m_data + begin, offset + length - begin, memory_advice));
+    errno = 0;
+    if (-1 != file_advice)
+    {
+        applied = (0 == posix_fadvise(*((int *)m_file_descriptor.handle()), (off_t)offset, (off_t)length, file_advice)) && applied;
+    }
+    return applied;
+}
+
+void mapped_file_descriptor_impl::prefetch(size_t offset, size_t length) noexcept
+{
+    // Both initiate asynchronous read-ahead and return without waiting for it.
+    advise(access_advice::will_need, offset, length);
+}
+
 mapped_file_descriptor_impl::mapped_file_descriptor_impl() noexcept :
-    m_file_descriptor(), m_size((size_t)-1), m_data(MAP_FAILED)
+    m_file_descriptor(), m_size((size_t)-1), m_mapping_size(0), m_data(MAP_FAILED), m_writing(false), m_reading(false), m_copy(false)
 {}
 
 mapped_file_descriptor_impl::~mapped_file_descriptor_impl() noexcept
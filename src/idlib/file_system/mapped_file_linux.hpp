@@ -4,7 +4,9 @@
 #define IDLIB_PRIVATE 1
 
 #include "idlib/utility/platform.hpp"
+#include "idlib/file_system/access_advice.hpp"
 #include "idlib/file_system/file.hpp"
+#include "idlib/file_system/flush_mode.hpp"
 
 #if defined(ID_LINUX)
 #include "idlib/file_system/header.in"
@@ -15,24 +17,48 @@ class mapped_file_descriptor_impl
 private:
     file_descriptor m_file_descriptor;
     size_t m_size;
+    size_t m_mapping_size; ///< @brief The size, in Bytes, of the memory at @a m_data. Rounded up to huge pages for copies.
     void *m_data;
+    bool m_writing; ///< @brief Is the file opened for writing.
+    bool m_reading; ///< @brief Is the file opened for reading.
+    bool m_copy; ///< @brief Is @a m_data a private copy of the file rather than a mapping.
+
+    /// @brief Ensure the storage of the file is at least @a size Bytes and its size is exactly @a size Bytes.
+    /// @param size the size, in Bytes
+    /// @return @a true on success, @a false on failure
+    bool allocate(size_t size) noexcept;
+
+    /// @brief Read the file into private anonymous memory.
+    /// @param map_flags the map flags
+    /// @return @a true on success, @a false on failure
+    bool copy(map_flags map_flags) noexcept;
 
 public:
     /// @brief Open a memory mapped file for writing.
     /// @param pathname the pathname of the file
     /// @param create_mode the create mode
     /// @param size the size, in Bytes, of the memory mapped file
-    void open_write(const std::string& pathname, create_mode create_mode, size_t size) noexcept;
+    /// @param map_flags the map flags
+    void open_write(const std::string& pathname, create_mode create_mode, size_t size, map_flags map_flags) noexcept;
 
     /// @brief Open a memory mapped file for reading.
     /// @param pathname the pathname of the file
     /// @param create_mode the create mode
-    void open_read(const std::string& pathname, create_mode create_mode) noexcept;
+    /// @param map_flags the map flags
+    void open_read(const std::string& pathname, create_mode create_mode, map_flags map_flags) noexcept;
 
     /// @brief Get if the mapped file descriptor is open.
     /// @return @a true if the mapped descriptor is open, @a false otherwise
     bool is_open() const noexcept;
 
+    /// @brief Get if the mapped file descriptor is open for reading.
+    /// @return @a true if the mapped file descriptor is open for reading, @a false otherwise
+    bool is_opened_for_reading() const noexcept;
+
+    /// @brief Get if the mapped file descriptor is open for writing.
+    /// @return @a true if the mapped file descriptor is open for writing, @a false otherwise
+    bool is_opened_for_writing() const noexcept;
+
     /// @brief Ensure the mapped file descriptor is closed.
     void close() noexcept;
 
@@ -44,6 +70,33 @@ public:
     /// @return The size, in Bytes, of the mapped file
     size_t size() const;
 
+    /// @brief Resize the mapped file.
+    /// @param size the new size, in Bytes, of the mapped file
+    /// @throw id::file_system::error the mapped file descriptor is not open for writing or the environment fails
+    void resize(size_t size);
+
+    /// @brief Flush a range of the mapped file to the file.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @param flush_mode the flush mode
+    /// @pre The range is within the bounds of the mapping.
+    /// @throw id::file_system::error the mapped file descriptor is not open for writing or the environment fails
+    void flush(size_t offset, size_t length, flush_mode flush_mode);
+
+    /// @brief Advise how a range of the mapped file will be accessed.
+    /// @param advice the advice
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @return @a true if the advice was applied, @a false if it is not supported
+    /// @pre The range is within the bounds of the mapping.
+    bool advise(access_advice advice, size_t offset, size_t length) noexcept;
+
+    /// @brief Start reading a range of the mapped file into memory.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @pre The range is within the bounds of the mapping.
+    void prefetch(size_t offset, size_t length) noexcept;
+
     /// @brief Construct this mapped file descriptor.
     /// @post The mapped file descriptor is closed.
     mapped_file_descriptor_impl() noexcept;
@@ -0,0 +1,199 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/mapped_file_pool.cpp
+/// @brief A pool of read-only memory mapped files shared by the subsystems of a process.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/mapped_file_pool.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/file_operations_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/file_operations_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+bool mapped_file_pool::key::operator==(const key& other) const noexcept
+{
+    return device == other.device && inode == other.inode && flags == other.flags;
+}
+
+size_t mapped_file_pool::key_hash::operator()(const key& key) const noexcept
+{
+    uint64_t hash = key.inode * 0x9e3779b97f4a7c15ull;
+    hash ^= (key.device + (uint64_t)key.flags) * 0xc2b2ae3d27d4eb4full;
+    return (size_t)(hash ^ (hash >> 32));
+}
+
+mapped_file_pool::mapped_file_pool(size_t budget) :
+    m_mutex(), m_budget(budget), m_entries(), m_index(), m_mapped_size(0), m_hits(0), m_misses(0)
+{}
+
+mapped_file_pool& mapped_file_pool::get_default()
+{
+    static mapped_file_pool pool;
+    return pool;
+}
+
+void mapped_file_pool::erase(std::list<entry>::iterator it) noexcept
+{
+    m_mapped_size -= it->file->size();
+    m_index.erase(it->key);
+    m_entries.erase(it);
+}
+
+void mapped_file_pool::evict() noexcept
+{
+    // The pool holds the only reference to an unused mapping. As references are only handed out under the lock,
+    // the number of references of a mapping can not increase concurrently.
+    auto it = m_entries.end();
+    while (m_mapped_size > m_budget && it != m_entries.begin())
+    {
+        auto current = std::prev(it);
+        if (1 == current->file.use_count())
+        {
+            erase(current);
+        }
+        else
+        {
+            it = current;
+        }
+    }
+}
+
+std::shared_ptr<const mapped_file_descriptor> mapped_file_pool::get(const std::string& pathname, map_flags map_flags)
+{
+    file_identity identity;
+    if (!get_file_identity(pathname, identity))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to map file `" + pathname + "`: unable to get attributes");
+    }
+    const key key = { identity.device, identity.inode, map_flags };
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        if (m_index.end() != it)
+        {
+            if (it->second->size == identity.size && it->second->modification_time == identity.modification_time)
+            {
+                m_hits++;
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return m_entries.front().file;
+            }
+            // The file has changed. References to the old mapping remain valid.
+            erase(it->second);
+        }
+        m_misses++;
+    }
+    auto file = std::make_shared<mapped_file_descriptor>();
+    file->open_read(pathname, create_mode::open_existing, map_flags);
+    if (!file->is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to map file `" + pathname + "`");
+    }
+    // The attributes were taken from the pathname before the file was opened. If the file was replaced or modified
+    // meanwhile, then the mapping might not be of the file identified by the key: do not pool it.
+    file_identity opened;
+    if (!get_file_identity(pathname, opened) || opened.device != identity.device || opened.inode != identity.inode ||
+        opened.size != identity.size || opened.modification_time != identity.modification_time ||
+        file->size() != identity.size)
+    {
+        return file;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (m_index.end() != it)
+    {
+        // Another thread has mapped the file concurrently: use its mapping.
+        if (it->second->size == identity.size && it->second->modification_time == identity.modification_time)
+        {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return m_entries.front().file;
+        }
+        erase(it->second);
+    }
+    m_entries.push_front({ key, identity.size, identity.modification_time, file });
+    m_index[key] = m_entries.begin();
+    m_mapped_size += file->size();
+    evict();
+    return file;
+}
+
+void mapped_file_pool::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        auto current = it++;
+        if (1 == current->file.use_count())
+        {
+            erase(current);
+        }
+    }
+}
+
+size_t mapped_file_pool::budget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+void mapped_file_pool::set_budget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget;
+    evict();
+}
+
+size_t mapped_file_pool::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t mapped_file_pool::mapped_size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_mapped_size;
+}
+
+size_t mapped_file_pool::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+size_t mapped_file_pool::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+#include "idlib/file_system/footer.in"
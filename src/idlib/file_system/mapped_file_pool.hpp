@@ -0,0 +1,154 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+/// @file idlib/file_system/mapped_file_pool.hpp
+/// @brief A pool of read-only memory mapped files shared by the subsystems of a process.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/mapped_file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A pool of read-only memory mapped files shared by the subsystems of a process.
+/// @detail
+/// Requests for the same file are served by the same mapping. A mapping is identified by the device and the inode of
+/// the file, hence different pathnames of the same file share a mapping, and by the map flags. A mapping is revalidated
+/// when it is requested: if the size or the modification time of the file changed, then the file is mapped again.
+/// Mappings handed out before remain valid. The mapping of a file which was replaced by another file is unmapped like
+/// any other unused mapping.
+/// A mapping is unused if the pool holds the only reference to it. If the total size of the mappings exceeds the
+/// budget when a file is mapped, then unused mappings are unmapped, the least recently used mapping first.
+/// Mappings which are in use are never unmapped, hence the budget might be exceeded while they are referenced.
+/// id::file_system::mapped_file_pool::get_default() is the pool shared by the process.
+/// @remark Thread-safe. Files are mapped outside of the lock of the pool.
+class mapped_file_pool
+{
+private:
+    /// @brief The key of a mapping.
+    struct key
+    {
+        /// @brief The device of the file.
+        uint64_t device;
+        /// @brief The inode of the file.
+        uint64_t inode;
+        /// @brief The map flags.
+        map_flags flags;
+
+        bool operator==(const key& other) const noexcept;
+    };
+
+    /// @brief The hash function of keys.
+    struct key_hash
+    {
+        size_t operator()(const key& key) const noexcept;
+    };
+
+    /// @brief A mapping.
+    struct entry
+    {
+        /// @brief The key of the mapping.
+        struct key key;
+        /// @brief The size, in Bytes, of the file when it was mapped.
+        uint64_t size;
+        /// @brief The modification time, in nanoseconds since the epoch, of the file when it was mapped.
+        int64_t modification_time;
+        /// @brief The mapped file.
+        std::shared_ptr<const mapped_file_descriptor> file;
+    };
+
+    /// @brief The mutex.
+    mutable std::mutex m_mutex;
+    /// @brief The maximum total size, in Bytes, of the mappings.
+    size_t m_budget;
+    /// @brief The mappings, the most recently used mapping first.
+    std::list<entry> m_entries;
+    /// @brief Maps keys to mappings.
+    std::unordered_map<key, std::list<entry>::iterator, key_hash> m_index;
+    /// @brief The total size, in Bytes, of the mappings.
+    size_t m_mapped_size;
+    /// @brief The number of requests served by an existing mapping.
+    size_t m_hits;
+    /// @brief The number of requests which mapped the file.
+    size_t m_misses;
+
+    /// @brief Remove a mapping from the pool.
+    /// @param it an iterator to the mapping
+    /// @pre The mutex is locked.
+    void erase(std::list<entry>::iterator it) noexcept;
+
+    /// @brief Unmap unused mappings, the least recently used mapping first, until the budget is not exceeded.
+    /// @pre The mutex is locked.
+    void evict() noexcept;
+
+public:
+    /// @brief Construct this pool.
+    /// @param budget the maximum total size, in Bytes, of the mappings
+    /// @post The pool is empty.
+    explicit mapped_file_pool(size_t budget = sizeof(void *) < 8 ? (size_t)256 * 1024 * 1024 : (size_t)64 * 1024 * 1024 * 1024);
+
+    // Delete copy constructor.
+    mapped_file_pool(const mapped_file_pool&) = delete;
+
+    // Delete copy assignment operator.
+    mapped_file_pool& operator=(const mapped_file_pool&) = delete;
+
+public:
+    /// @brief Get the pool shared by the process.
+    /// @return the pool shared by the process
+    static mapped_file_pool& get_default();
+
+    /// @brief Get a mapping of a file.
+    /// @param pathname the pathname of the file
+    /// @param map_flags the map flags
+    /// @return the mapping of the file, open for reading. The mapping remains valid as long as it is referenced.
+    /// @throw id::file_system::error the file can not be mapped
+    std::shared_ptr<const mapped_file_descriptor> get(const std::string& pathname, map_flags map_flags = map_flags::none);
+
+    /// @brief Unmap all unused mappings.
+    void clear();
+
+    /// @brief Get the maximum total size, in Bytes, of the mappings.
+    /// @return the maximum total size, in Bytes, of the mappings
+    size_t budget() const;
+
+    /// @brief Set the maximum total size, in Bytes, of the mappings.
+    /// @param budget the maximum total size, in Bytes, of the mappings
+    /// @remark Unused mappings are unmapped until the budget is not exceeded.
+    void set_budget(size_t budget);
+
+    /// @brief Get the number of mappings.
+    /// @return the number of mappings
+    size_t size() const;
+
+    /// @brief Get the total size, in Bytes, of the mappings.
+    /// @return the total size, in Bytes, of the mappings
+    size_t mapped_size() const;
+
+    /// @brief Get the number of requests served by an existing mapping.
+    /// @return the number of requests served by an existing mapping
+    size_t hits() const;
+
+    /// @brief Get the number of requests which mapped the file.
+    /// @return the number of requests which mapped the file
+    size_t misses() const;
+
+}; // class mapped_file_pool
+
+#include "idlib/file_system/footer.in"
@@ -1,11 +1,18 @@
 #include "idlib/file_system/mapped_file_windows.hpp"
 
 #if defined(ID_WINDOWS)
+
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+
+#include <algorithm>
+
 #include "idlib/file_system/header.in"
 
 static const char dummy = 0;
 
-void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_mode create_mode) noexcept
+void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_mode create_mode, map_flags map_flags) noexcept
 {
     close();
     m_file_descriptor.open(pathname, id::file_system::access_mode::read, create_mode);
@@ -23,6 +30,15 @@ void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_
         m_file_mapping_handle = (void *)&dummy;
         m_data = (void *)&dummy;
     }
+    else if (map_flags::private_copy == (map_flags & map_flags::private_copy))
+    {
+        if (!copy(map_flags))
+        {
+            m_reading = false;
+            m_file_descriptor.close();
+            return;
+        }
+    }
     else
     {
         m_file_mapping_handle = CreateFileMapping(*((HANDLE *)m_file_descriptor.handle()), 0, PAGE_READONLY, 0, 0, 0);
@@ -41,11 +57,16 @@ void mapped_file_descriptor_impl::open_read(const std::string& pathname, create_
             CloseHandle(m_file_mapping_handle);
             m_file_mapping_handle = NULL;
             m_file_descriptor.close();
+            return;
         }
     }
+    if (map_flags::populate == (map_flags & map_flags::populate))
+    {
+        prefetch(0, m_size);
+    }
 }
 
-void mapped_file_descriptor_impl::open_write(const std::string& pathname, create_mode create_mode, size_t size) noexcept
+void mapped_file_descriptor_impl::open_write(const std::string& pathname, create_mode create_mode, size_t size, map_flags map_flags) noexcept
 {
     close();
     m_file_descriptor.open(pathname, id::file_system::access_mode::read_write, create_mode);
@@ -75,10 +96,65 @@ void mapped_file_descriptor_impl::open_write(const std::string& pathname, create
 			CloseHandle(m_file_mapping_handle);
 			m_file_mapping_handle = NULL;
 			m_file_descriptor.close();
+			return;
+		}
+		if (map_flags::populate == (map_flags & map_flags::populate))
+		{
+			prefetch(0, m_size);
 		}
 	}
 }
 
+bool mapped_file_descriptor_impl::copy(map_flags map_flags) noexcept
+{
+    // Place the pages on the NUMA node of the calling thread. Windows has no interleaving policy.
+    bool local = map_flags::numa_local == (map_flags & map_flags::numa_local);
+    USHORT node = 0;
+    if (local)
+    {
+        PROCESSOR_NUMBER processor;
+        GetCurrentProcessorNumberEx(&processor);
+        local = FALSE != GetNumaProcessorNodeEx(&processor, &node);
+    }
+    auto allocate = [local, node](size_t size, DWORD type) -> void *
+    {
+        return local ? VirtualAllocExNuma(GetCurrentProcess(), NULL, size, type, PAGE_READWRITE, node)
+                     : VirtualAlloc(NULL, size, type, PAGE_READWRITE);
+    };
+    void *data = NULL;
+    // Large pages require the SeLockMemoryPrivilege and a size which is a multiple of the large page size.
+    size_t large_page_size = GetLargePageMinimum();
+    if (0 != large_page_size && m_size >= large_page_size)
+    {
+        data = allocate((m_size + large_page_size - 1) / large_page_size * large_page_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES);
+    }
+    if (NULL == data)
+    {
+        data = allocate(m_size, MEM_RESERVE | MEM_COMMIT);
+        if (NULL == data)
+        {
+            return false;
+        }
+    }
+    HANDLE handle = *((HANDLE *)m_file_descriptor.handle());
+    for (size_t offset = 0; offset < m_size;)
+    {
+        DWORD count;
+        if (!ReadFile(handle, (char *)data + offset, (DWORD)std::min<size_t>(m_size - offset, 1 << 30), &count, NULL) || 0 == count)
+        {
+            VirtualFree(data, 0, MEM_RELEASE);
+            return false;
+        }
+        offset += count;
+    }
+    // Like a view opened for reading, the copy is read-only.
+    DWORD protection;
+    VirtualProtect(data, m_size, PAGE_READONLY, &protection);
+    m_data = data;
+    m_copy = true;
+    return true;
+}
+
 bool mapped_file_descriptor_impl::is_open() const noexcept
 {
     return NULL != m_data;
@@ -98,9 +174,17 @@ void mapped_file_descriptor_impl::close() noexcept
 {
     if (NULL != m_data)
     {
-        UnmapViewOfFile(m_data);
+        if (m_copy)
+        {
+            VirtualFree(m_data, 0, MEM_RELEASE);
+        }
+        else
+        {
+            UnmapViewOfFile(m_data);
+        }
         m_data = NULL;
     }
+    m_copy = false;
     if (NULL != m_file_mapping_handle)
     {
         CloseHandle(m_file_mapping_handle);
@@ -126,8 +210,106 @@ size_t mapped_file_descriptor_impl::size() const
     return m_size;
 }
 
+void mapped_file_descriptor_impl::resize(size_t size)
+{
+    if (!m_writing)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: file is not opened for writing");
+    }
+    if (size == m_size)
+    {
+        return;
+    }
+    // A view can not be resized: unmap the view, close the mapping, resize the file, and create a new mapping.
+    if (NULL != m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = NULL;
+    }
+    if (NULL != m_file_mapping_handle)
+    {
+        CloseHandle(m_file_mapping_handle);
+        m_file_mapping_handle = NULL;
+    }
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)size;
+    HANDLE handle = *((HANDLE *)m_file_descriptor.handle());
+    if (!SetFilePointerEx(handle, end, NULL, FILE_BEGIN) || !SetEndOfFile(handle))
+    {
+        close();
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: unable to resize file");
+    }
+    m_size = size;
+    if (0 == m_size)
+    {
+        return;
+    }
+    m_file_mapping_handle = CreateFileMapping(handle, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, 0);
+    if (NULL == m_file_mapping_handle)
+    {
+        close();
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: unable to create mapping");
+    }
+    m_data = MapViewOfFile(m_file_mapping_handle, FILE_MAP_WRITE, 0, 0, 0);
+    if (NULL == m_data)
+    {
+        close();
+        throw id::file_system::error(__FILE__, __LINE__, "unable to resize mapped file: unable to map view");
+    }
+}
+
+void mapped_file_descriptor_impl::flush(size_t offset, size_t length, flush_mode flush_mode)
+{
+    if (!m_writing)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to flush mapped file: file is not opened for writing");
+    }
+    if (0 == length)
+    {
+        return;
+    }
+    // FlushViewOfFile initiates the writing of the pages, FlushFileBuffers waits for it.
+    if (!FlushViewOfFile((char *)m_data + offset, length))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to flush mapped file");
+    }
+    if (flush_mode::synchronous == flush_mode && !FlushFileBuffers(*((HANDLE *)m_file_descriptor.handle())))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to flush mapped file");
+    }
+}
+
+bool mapped_file_descriptor_impl::advise(access_advice advice, size_t offset, size_t length) noexcept
+{
+    if (0 == length || NULL == m_data)
+    {
+        return true;
+    }
+    switch (advice)
+    {
+        case access_advice::will_need:
+        {
+            WIN32_MEMORY_RANGE_ENTRY range;
+            range.VirtualAddress = (char *)m_data + offset;
+            range.NumberOfBytes = length;
+            return FALSE != PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+        case access_advice::dont_need:
+            // Remove the pages from the working set of the process.
+            return FALSE != VirtualUnlock((char *)m_data + offset, length) || ERROR_NOT_LOCKED == GetLastError();
+        default:
+            // Windows has no equivalent of the other advices for mapped views.
+            return false;
+    };
+}
+
+void mapped_file_descriptor_impl::prefetch(size_t offset, size_t length) noexcept
+{
+    advise(access_advice::will_need, offset, length);
+}
+
 mapped_file_descriptor_impl::mapped_file_descriptor_impl() noexcept :
-    m_file_descriptor(), m_file_mapping_handle(NULL), m_data(NULL)
+    m_file_descriptor(), m_file_mapping_handle(NULL), m_data(NULL), m_copy(false)
 {}
 
 mapped_file_descriptor_impl::~mapped_file_descriptor_impl() noexcept
@@ -0,0 +1,134 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/mapped_view.cpp
+/// @brief A memory mapped window of a file.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/mapped_view.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/mapped_view_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/mapped_view_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+mapped_view::mapped_view() :
+    m_pimpl(std::make_unique<mapped_view_impl>())
+{}
+
+mapped_view::mapped_view(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode) :
+    m_pimpl(std::make_unique<mapped_view_impl>())
+{
+    open(file_descriptor, offset, length, access_mode);
+}
+
+mapped_view::~mapped_view() noexcept
+{}
+
+mapped_view::mapped_view(mapped_view&& other) noexcept :
+    m_pimpl(std::move(other.m_pimpl))
+{}
+
+mapped_view& mapped_view::operator=(mapped_view&& other) noexcept
+{
+    m_pimpl.swap(other.m_pimpl);
+    return *this;
+}
+
+size_t mapped_view::alignment() noexcept
+{
+    return mapped_view_impl::alignment();
+}
+
+void mapped_view::open(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode) noexcept
+{
+    if (!m_pimpl)
+    {
+        m_pimpl = std::unique_ptr<mapped_view_impl>(new (std::nothrow) mapped_view_impl());
+        if (!m_pimpl)
+        {
+            return;
+        }
+    }
+    m_pimpl->close();
+    // Accessing a page of a mapping beyond the end of the file raises a fault, hence the window is checked.
+    try
+    {
+        size_t file_size = file_descriptor.size();
+        if (offset > file_size || length > file_size - offset)
+        {
+            return;
+        }
+    }
+    catch (...)
+    {
+        return;
+    }
+    m_pimpl->open(file_descriptor, offset, length, access_mode);
+}
+
+bool mapped_view::is_open() const noexcept
+{
+    return m_pimpl && m_pimpl->is_open();
+}
+
+void mapped_view::close() noexcept
+{
+    if (m_pimpl)
+    {
+        m_pimpl->close();
+    }
+}
+
+char *mapped_view::data() noexcept
+{
+    return is_open() ? m_pimpl->data() : nullptr;
+}
+
+const char *mapped_view::data() const noexcept
+{
+    return is_open() ? m_pimpl->data() : nullptr;
+}
+
+size_t mapped_view::offset() const noexcept
+{
+    return is_open() ? m_pimpl->offset() : 0;
+}
+
+size_t mapped_view::size() const noexcept
+{
+    return is_open() ? m_pimpl->size() : 0;
+}
+
+bool mapped_view::contains(size_t offset, size_t length) const noexcept
+{
+    return is_open() && offset >= this->offset() && offset - this->offset() <= size() && length <= size() - (offset - this->offset());
+}
+
+#include "idlib/file_system/footer.in"
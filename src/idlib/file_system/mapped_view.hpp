@@ -0,0 +1,116 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/mapped_view.hpp
+/// @brief A memory mapped window of a file.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/access_mode.hpp"
+#include "idlib/file_system/file.hpp"
+
+#include "idlib/file_system/header.in"
+
+// Forward declaration.
+class mapped_view_impl;
+
+/// @brief A memory mapped window of a file.
+/// @detail
+/// A view maps the range [offset, offset + length) of an open file descriptor. Unlike
+/// id::file_system::mapped_file_descriptor, only the window consumes address space, hence views
+/// allow for accessing files which are larger than the available address space.
+/// The offset need not be aligned: the mapping starts at the offset rounded down to
+/// id::file_system::mapped_view::alignment() and data() points to the Byte at the offset.
+/// @remark The file descriptor must remain open while the view is open.
+class mapped_view
+{
+private:
+    /// @brief The pointer to the implementation.
+    std::unique_ptr<mapped_view_impl> m_pimpl;
+
+public:
+    /// @brief Construct this mapped view.
+    /// @post The mapped view is closed.
+    mapped_view();
+
+    /// @brief Construct this mapped view and open it.
+    /// @param file_descriptor the file descriptor
+    /// @param offset the offset, in Bytes, of the window
+    /// @param length the length, in Bytes, of the window
+    /// @param access_mode the access mode, either id::file_system::access_mode::read or id::file_system::access_mode::read_write
+    mapped_view(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode = access_mode::read);
+
+    /// @brief Destruct this mapped view.
+    /// @post The mapped view is closed.
+    ~mapped_view() noexcept;
+
+    mapped_view(mapped_view&& other) noexcept;
+    mapped_view& operator=(mapped_view&& other) noexcept;
+
+    // Delete copy constructor.
+    mapped_view(const mapped_view&) = delete;
+
+    // Delete copy assignment operator.
+    mapped_view& operator=(const mapped_view&) = delete;
+
+public:
+    /// @brief Get the alignment, in Bytes, of the start of a mapping.
+    /// @return the alignment, in Bytes, of the start of a mapping
+    static size_t alignment() noexcept;
+
+    /// @brief Ensure the mapped view is open.
+    /// @param file_descriptor the file descriptor
+    /// @param offset the offset, in Bytes, of the window
+    /// @param length the length, in Bytes, of the window
+    /// @param access_mode the access mode, either id::file_system::access_mode::read or id::file_system::access_mode::read_write
+    /// @remark The file descriptor must have been opened with a compatible access mode.
+    /// The window must be within the bounds of the file and must not be empty.
+    void open(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode = access_mode::read) noexcept;
+
+    /// @brief Get if the mapped view is open.
+    /// @return @a true if the mapped view is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Ensure the mapped view is closed.
+    void close() noexcept;
+
+    /// @brief A pointer to the Byte at the offset of the window.
+    /// @return a pointer to an array of @a size() Bytes
+    char *data() noexcept;
+
+    /// @brief A pointer to the Byte at the offset of the window.
+    /// @return a pointer to an array of @a size() Bytes
+    const char *data() const noexcept;
+
+    /// @brief Get the offset, in Bytes, of the window.
+    /// @return the offset, in Bytes, of the window
+    size_t offset() const noexcept;
+
+    /// @brief Get the length, in Bytes, of the window.
+    /// @return the length, in Bytes, of the window
+    size_t size() const noexcept;
+
+    /// @brief Get if the window contains a range.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @return @a true if the mapped view is open and the window contains the range, @a false otherwise
+    bool contains(size_t offset, size_t length) const noexcept;
+
+}; // class mapped_view
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,136 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/mapped_view_cache.cpp
+/// @brief A cache of memory mapped windows of a file.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/mapped_view_cache.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+mapped_view_cache::mapped_view_cache(file_descriptor& file_descriptor, size_t window_size, size_t capacity, access_mode access_mode) :
+    m_file_descriptor(&file_descriptor), m_access_mode(access_mode), m_window_size(window_size), m_capacity(capacity),
+    m_views(), m_hits(0), m_misses(0)
+{
+    if (0 == capacity)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid capacity: capacity is zero");
+    }
+    if (0 == window_size)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid window size: window size is zero");
+    }
+    size_t alignment = mapped_view::alignment();
+    m_window_size = (window_size + alignment - 1) / alignment * alignment;
+}
+
+std::shared_ptr<mapped_view> mapped_view_cache::get(size_t offset, size_t length)
+{
+    // Search the windows, move a window containing the range to the front.
+    for (auto it = m_views.begin(); it != m_views.end(); ++it)
+    {
+        if ((*it)->contains(offset, length))
+        {
+            m_hits++;
+            if (it != m_views.begin())
+            {
+                m_views.splice(m_views.begin(), m_views, it);
+            }
+            return m_views.front();
+        }
+    }
+    m_misses++;
+    // Map the window containing the offset, enlarge it to contain the range if necessary, and clip it to the file.
+    size_t file_size = m_file_descriptor->size();
+    if (offset > file_size || length > file_size - offset)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to map view: range out of bounds");
+    }
+    size_t begin = offset - offset % m_window_size;
+    size_t end = std::max(begin + m_window_size, offset + length);
+    end = std::min(end, file_size);
+    if (begin == end)
+    {
+        // An empty range at the end of the file: an empty view.
+        return std::make_shared<mapped_view>();
+    }
+    auto view = std::make_shared<mapped_view>(*m_file_descriptor, begin, end - begin, m_access_mode);
+    if (!view->is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to map view");
+    }
+    m_views.push_front(view);
+    if (m_views.size() > m_capacity)
+    {
+        m_views.pop_back();
+    }
+    return view;
+}
+
+void mapped_view_cache::read(size_t offset, void *buffer, size_t length)
+{
+    char *target = static_cast<char *>(buffer);
+    while (length > 0)
+    {
+        // Read at most up to the end of the window of the offset.
+        size_t chunk = std::min(length, m_window_size - offset % m_window_size);
+        auto view = get(offset, chunk);
+        std::memcpy(target, view->data() + (offset - view->offset()), chunk);
+        offset += chunk;
+        target += chunk;
+        length -= chunk;
+    }
+}
+
+void mapped_view_cache::clear() noexcept
+{
+    m_views.clear();
+}
+
+size_t mapped_view_cache::window_size() const noexcept
+{
+    return m_window_size;
+}
+
+size_t mapped_view_cache::capacity() const noexcept
+{
+    return m_capacity;
+}
+
+size_t mapped_view_cache::size() const noexcept
+{
+    return m_views.size();
+}
+
+size_t mapped_view_cache::hits() const noexcept
+{
+    return m_hits;
+}
+
+size_t mapped_view_cache::misses() const noexcept
+{
+    return m_misses;
+}
+
+#include "idlib/file_system/footer.in"
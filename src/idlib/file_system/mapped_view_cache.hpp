@@ -0,0 +1,111 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/mapped_view_cache.hpp
+/// @brief A cache of memory mapped windows of a file.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/mapped_view.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A cache of memory mapped windows of a file.
+/// @detail
+/// The cache maps windows of the file on demand and keeps the most recently used windows mapped.
+/// A window starts at a multiple of the window size, hence repeated reads to nearby regions are served
+/// by the same mapping. If the capacity is exceeded, then the least recently used window is evicted.
+/// A window is unmapped when it was evicted and is no longer referenced.
+/// @remark The file descriptor must remain open while the cache exists.
+/// Non-copyable.
+class mapped_view_cache
+{
+private:
+    /// @brief The file descriptor.
+    file_descriptor *m_file_descriptor;
+    /// @brief The access mode.
+    access_mode m_access_mode;
+    /// @brief The size, in Bytes, of a window.
+    size_t m_window_size;
+    /// @brief The maximum number of windows.
+    size_t m_capacity;
+    /// @brief The windows, the most recently used window first.
+    std::list<std::shared_ptr<mapped_view>> m_views;
+    /// @brief The number of requests served by a cached window.
+    size_t m_hits;
+    /// @brief The number of requests which required a new window.
+    size_t m_misses;
+
+public:
+    /// @brief Construct this cache.
+    /// @param file_descriptor the file descriptor
+    /// @param window_size the size, in Bytes, of a window. Rounded up to a multiple of id::file_system::mapped_view::alignment().
+    /// @param capacity the maximum number of windows. Must be positive.
+    /// @param access_mode the access mode, either id::file_system::access_mode::read or id::file_system::access_mode::read_write
+    /// @throw id::file_system::error the capacity or the window size is zero
+    explicit mapped_view_cache(file_descriptor& file_descriptor, size_t window_size = 64 * 1024 * 1024,
+                               size_t capacity = 8, access_mode access_mode = access_mode::read);
+
+    // Delete copy constructor.
+    mapped_view_cache(const mapped_view_cache&) = delete;
+
+    // Delete copy assignment operator.
+    mapped_view_cache& operator=(const mapped_view_cache&) = delete;
+
+public:
+    /// @brief Get a view containing a range of the file.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param length the length, in Bytes, of the range
+    /// @return a view containing the range. The view remains valid as long as it is referenced.
+    /// @throw id::file_system::error the range is not within the bounds of the file or the environment fails
+    /// @remark If the range crosses a window boundary, then a window spanning the range is mapped.
+    std::shared_ptr<mapped_view> get(size_t offset, size_t length);
+
+    /// @brief Copy a range of the file into a buffer.
+    /// @param offset the offset, in Bytes, of the range
+    /// @param buffer a pointer to a buffer of at least @a length Bytes
+    /// @param length the length, in Bytes, of the range
+    /// @throw id::file_system::error the range is not within the bounds of the file or the environment fails
+    void read(size_t offset, void *buffer, size_t length);
+
+    /// @brief Evict all windows.
+    void clear() noexcept;
+
+    /// @brief Get the size, in Bytes, of a window.
+    /// @return the size, in Bytes, of a window
+    size_t window_size() const noexcept;
+
+    /// @brief Get the maximum number of windows.
+    /// @return the maximum number of windows
+    size_t capacity() const noexcept;
+
+    /// @brief Get the number of cached windows.
+    /// @return the number of cached windows
+    size_t size() const noexcept;
+
+    /// @brief Get the number of requests served by a cached window.
+    /// @return the number of requests served by a cached window
+    size_t hits() const noexcept;
+
+    /// @brief Get the number of requests which required a new window.
+    /// @return the number of requests which required a new window
+    size_t misses() const noexcept;
+
+}; // class mapped_view_cache
+
+#include "idlib/file_system/footer.in"
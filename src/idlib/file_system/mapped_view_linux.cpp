@@ -0,0 +1,92 @@
+#include "idlib/file_system/mapped_view_linux.hpp"
+
+#if defined(ID_LINUX)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "idlib/file_system/header.in"
+
+size_t mapped_view_impl::alignment() noexcept
+{
+    static const size_t alignment = (size_t)sysconf(_SC_PAGESIZE);
+    return alignment;
+}
+
+void mapped_view_impl::open(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode) noexcept
+{
+    close();
+    if (!file_descriptor.is_open() || 0 == length)
+    {
+        return;
+    }
+    int protection;
+    switch (access_mode)
+    {
+        case id::file_system::access_mode::read:
+            protection = PROT_READ;
+            break;
+        case id::file_system::access_mode::read_write:
+            protection = PROT_READ | PROT_WRITE;
+            break;
+        default:
+            return;
+    };
+    // The offset of a mapping must be a multiple of the page size.
+    size_t begin = offset - offset % alignment();
+    size_t mapping_size = offset - begin + length;
+    void *mapping = mmap(0, mapping_size, protection, MAP_SHARED, *((int *)file_descriptor.handle()), (off_t)begin);
+    if (MAP_FAILED == mapping)
+    {
+        errno = 0;
+        return;
+    }
+    m_mapping = mapping;
+    m_mapping_size = mapping_size;
+    m_offset = offset;
+    m_size = length;
+}
+
+bool mapped_view_impl::is_open() const noexcept
+{
+    return nullptr != m_mapping;
+}
+
+void mapped_view_impl::close() noexcept
+{
+    if (nullptr != m_mapping)
+    {
+        munmap(m_mapping, m_mapping_size);
+        m_mapping = nullptr;
+        m_mapping_size = 0;
+        m_offset = 0;
+        m_size = 0;
+    }
+}
+
+char *mapped_view_impl::data() const noexcept
+{
+    return (char *)m_mapping + (m_offset % alignment());
+}
+
+size_t mapped_view_impl::offset() const noexcept
+{
+    return m_offset;
+}
+
+size_t mapped_view_impl::size() const noexcept
+{
+    return m_size;
+}
+
+mapped_view_impl::mapped_view_impl() noexcept :
+    m_mapping(nullptr), m_mapping_size(0), m_offset(0), m_size(0)
+{}
+
+mapped_view_impl::~mapped_view_impl() noexcept
+{
+    close();
+}
+
+#include "idlib/file_system/footer.in"
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/file_system/access_mode.hpp"
+#include "idlib/file_system/file.hpp"
+
+#if defined(ID_LINUX)
+#include "idlib/file_system/header.in"
+
+/// @brief A Linux memory mapped window of a file.
+class mapped_view_impl
+{
+private:
+    /// @brief The address of the mapping or a null pointer.
+    void *m_mapping;
+    /// @brief The length, in Bytes, of the mapping.
+    size_t m_mapping_size;
+    /// @brief The offset, in Bytes, of the window.
+    size_t m_offset;
+    /// @brief The length, in Bytes, of the window.
+    size_t m_size;
+
+public:
+    /// @brief Get the alignment, in Bytes, of the start of a mapping.
+    /// @return the alignment, in Bytes, of the start of a mapping
+    static size_t alignment() noexcept;
+
+    /// @brief Ensure the mapped view is open.
+    /// @param file_descriptor the file descriptor
+    /// @param offset the offset, in Bytes, of the window
+    /// @param length the length, in Bytes, of the window
+    /// @param access_mode the access mode
+    void open(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode) noexcept;
+
+    /// @brief Get if the mapped view is open.
+    /// @return @a true if the mapped view is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Ensure the mapped view is closed.
+    void close() noexcept;
+
+    /// @brief A pointer to the Byte at the offset of the window.
+    char *data() const noexcept;
+
+    /// @brief Get the offset, in Bytes, of the window.
+    size_t offset() const noexcept;
+
+    /// @brief Get the length, in Bytes, of the window.
+    size_t size() const noexcept;
+
+    /// @brief Construct this mapped view.
+    /// @post The mapped view is closed.
+    mapped_view_impl() noexcept;
+
+    /// @brief Destruct this mapped view.
+    /// @post The mapped view is closed.
+    ~mapped_view_impl() noexcept;
+
+public:
+    // Delete copy constructor.
+    mapped_view_impl(const mapped_view_impl&) = delete;
+
+    // Delete copy assignment operator.
+    mapped_view_impl& operator=(const mapped_view_impl&) = delete;
+
+}; // class mapped_view_impl
+
+#include "idlib/file_system/footer.in"
+#endif
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
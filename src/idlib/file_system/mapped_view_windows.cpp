@@ -0,0 +1,102 @@
+#include "idlib/file_system/mapped_view_windows.hpp"
+
+#if defined(ID_WINDOWS)
+
+#include "idlib/file_system/header.in"
+
+size_t mapped_view_impl::alignment() noexcept
+{
+    // The offset of a view must be a multiple of the allocation granularity (not of the page size).
+    static const size_t alignment = []()
+    {
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        return (size_t)system_info.dwAllocationGranularity;
+    }();
+    return alignment;
+}
+
+void mapped_view_impl::open(file_descriptor& file_descriptor, size_t offset, size_t length, access_mode access_mode) noexcept
+{
+    close();
+    if (!file_descriptor.is_open() || 0 == length)
+    {
+        return;
+    }
+    DWORD protection, desired_access;
+    switch (access_mode)
+    {
+        case id::file_system::access_mode::read:
+            protection = PAGE_READONLY;
+            desired_access = FILE_MAP_READ;
+            break;
+        case id::file_system::access_mode::read_write:
+            protection = PAGE_READWRITE;
+            desired_access = FILE_MAP_WRITE;
+            break;
+        default:
+            return;
+    };
+    HANDLE file_mapping_handle = CreateFileMapping(*((HANDLE *)file_descriptor.handle()), NULL, protection, 0, 0, NULL);
+    if (NULL == file_mapping_handle)
+    {
+        return;
+    }
+    size_t begin = offset - offset % alignment();
+    size_t mapping_size = offset - begin + length;
+    void *mapping = MapViewOfFile(file_mapping_handle, desired_access, (DWORD)((uint64_t)begin >> 32), (DWORD)begin, mapping_size);
+    // The view retains a reference to the mapping object.
+    CloseHandle(file_mapping_handle);
+    if (NULL == mapping)
+    {
+        return;
+    }
+    m_mapping = mapping;
+    m_mapping_size = mapping_size;
+    m_offset = offset;
+    m_size = length;
+}
+
+bool mapped_view_impl::is_open() const noexcept
+{
+    return nullptr != m_mapping;
+}
+
+void mapped_view_impl::close() noexcept
+{
+    if (nullptr != m_mapping)
+    {
+        UnmapViewOfFile(m_mapping);
+        m_mapping = nullptr;
+        m_mapping_size = 0;
+        m_offset = 0;
+        m_size = 0;
+    }
+}
+
+char *mapped_view_impl::data() const noexcept
+{
+    return (char *)m_mapping + (m_offset % alignment());
+}
+
+size_t mapped_view_impl::offset() const noexcept
+{
+    return m_offset;
+}
+
+size_t mapped_view_impl::size() const noexcept
+{
+    return m_size;
+}
+
+mapped_view_impl::mapped_view_impl() noexcept :
+    m_mapping(nullptr), m_mapping_size(0), m_offset(0), m_size(0)
+{}
+
+mapped_view_impl::~mapped_view_impl() noexcept
+{
+    close();
+}
+
+#include "idlib/file_system/footer.in"
+#endif
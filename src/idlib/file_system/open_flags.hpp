@@ -0,0 +1,47 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/open_flags.hpp
+/// @brief Options for opening a file.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Options for opening a file.
+enum class open_flags : uint8_t
+{
+    none = 0, ///< No options.
+    direct = (1 << 0), ///< Bypass the page cache. Offsets, lengths, and buffers of reads and writes must be aligned, see id::file_system::aligned_buffer.
+    no_access_time = (1 << 1), ///< Do not update the access time of the file when it is read. Ignored if not permitted.
+    close_on_exec = (1 << 2), ///< Do not inherit the file descriptor to executed programs.
+};
+
+#include "idlib/file_system/footer.in"
+
+inline id::file_system::open_flags operator|(id::file_system::open_flags lhs, id::file_system::open_flags rhs)
+{
+    return static_cast<id::file_system::open_flags>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+}
+
+inline id::file_system::open_flags operator&(id::file_system::open_flags lhs, id::file_system::open_flags rhs)
+{
+    return static_cast<id::file_system::open_flags>(static_cast<uint8_t>(lhs) & static_cast<uint8_t>(rhs));
+}
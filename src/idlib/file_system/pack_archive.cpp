@@ -0,0 +1,179 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/pack_archive.cpp
+/// @brief A memory mapped archive of files.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/pack_archive.hpp"
+#include "idlib/file_system/pack_format.hpp"
+#include "idlib/file_system/content_hash.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+using namespace internal::pack_format;
+
+pack_archive::pack_archive() :
+    m_file(), m_data(nullptr), m_number_of_entries(0), m_table_size(0), m_table(nullptr), m_entries(nullptr), m_names(nullptr)
+{}
+
+pack_archive::~pack_archive() noexcept
+{
+    close();
+}
+
+void pack_archive::open(const std::string& pathname) noexcept
+{
+    close();
+    m_file.open_read(pathname, create_mode::open_existing);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    const char *data = m_file.data();
+    const uint64_t file_size = m_file.size();
+    if (file_size < header_size || 0 != memcmp(data, magic, sizeof(magic)) || version != read_u32(data + version_offset))
+    {
+        close();
+        return;
+    }
+    const uint64_t number_of_entries = read_u64(data + number_of_entries_offset),
+                   table_size = read_u64(data + table_size_offset),
+                   names_size = read_u64(data + names_size_offset),
+                   data_offset = read_u64(data + data_offset_offset);
+    // The table must have at least one empty slot such that lookups terminate.
+    if (number_of_entries >= table_size || 0 != (table_size & (table_size - 1)) || number_of_entries >= empty_slot
+     || table_size > file_size / slot_size || number_of_entries > file_size / entry_size || names_size > file_size)
+    {
+        close();
+        return;
+    }
+    const uint64_t metadata_end = header_size + table_size * slot_size + number_of_entries * entry_size + names_size;
+    if (metadata_end > data_offset || data_offset > file_size
+     || read_u64(data + checksum_offset) != hash_bytes(data + header_size, metadata_end - header_size, hash_bytes(data, checksum_offset)))
+    {
+        close();
+        return;
+    }
+    const char *table = data + header_size,
+               *entries = table + table_size * slot_size,
+               *names = entries + number_of_entries * entry_size;
+    size_t occupied = 0;
+    for (uint64_t i = 0; i < table_size; ++i)
+    {
+        uint32_t index = read_u32(table + i * slot_size + 8);
+        if (empty_slot != index)
+        {
+            if (index >= number_of_entries)
+            {
+                close();
+                return;
+            }
+            occupied++;
+        }
+    }
+    if (occupied != number_of_entries)
+    {
+        close();
+        return;
+    }
+    for (uint64_t i = 0; i < number_of_entries; ++i)
+    {
+        const char *entry = entries + i * entry_size;
+        const uint64_t offset = read_u64(entry), size = read_u64(entry + 8);
+        const uint32_t name_offset = read_u32(entry + 16), name_length = read_u32(entry + 20), flags = read_u32(entry + 24);
+        if (offset < data_offset || offset > file_size || size > file_size - offset
+         || name_offset > names_size || name_length > names_size - name_offset || stored != flags)
+        {
+            close();
+            return;
+        }
+    }
+    m_data = data;
+    m_number_of_entries = (size_t)number_of_entries;
+    m_table_size = (size_t)table_size;
+    m_table = table;
+    m_entries = entries;
+    m_names = names;
+}
+
+bool pack_archive::is_open() const noexcept
+{
+    return nullptr != m_table;
+}
+
+void pack_archive::close() noexcept
+{
+    m_file.close();
+    m_data = nullptr;
+    m_number_of_entries = 0;
+    m_table_size = 0;
+    m_table = nullptr;
+    m_entries = nullptr;
+    m_names = nullptr;
+}
+
+size_t pack_archive::size() const noexcept
+{
+    return m_number_of_entries;
+}
+
+size_t pack_archive::find(std::string_view name) const noexcept
+{
+    return find(name, hash_bytes(name.data(), name.size()));
+}
+
+size_t pack_archive::find(std::string_view name, uint64_t hash) const noexcept
+{
+    if (nullptr == m_table)
+    {
+        return npos;
+    }
+    const size_t mask = m_table_size - 1;
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        const char *slot = m_table + i * slot_size;
+        const uint32_t index = read_u32(slot + 8);
+        if (empty_slot == index)
+        {
+            return npos;
+        }
+        if (hash == read_u64(slot) && name == this->name(index))
+        {
+            return index;
+        }
+    }
+}
+
+std::string_view pack_archive::name(size_t index) const noexcept
+{
+    const char *entry = m_entries + index * entry_size;
+    return std::string_view(m_names + read_u32(entry + 16), read_u32(entry + 20));
+}
+
+std::string_view pack_archive::contents(size_t index) const noexcept
+{
+    const char *entry = m_entries + index * entry_size;
+    return std::string_view(m_data + read_u64(entry), (size_t)read_u64(entry + 8));
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,123 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/pack_archive.hpp
+/// @brief A memory mapped archive of files.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/mapped_file.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief A memory mapped archive of files.
+/// @detail
+/// A pack archive is created by id::file_system::pack_builder. It consists of
+/// - a header,
+/// - an open addressing hash table mapping the hashes of the names of the entries to the entries,
+/// - the entries i.e. the offsets, the sizes, and the names of the files,
+/// - the names of the files, and
+/// - the contents of the files, each aligned to id::file_system::pack_archive::data_alignment Bytes.
+/// All integers are stored in little endian Byte order. The header, the table, the entries, and the names are protected
+/// by a checksum which is verified when the archive is opened.
+/// The names are normalized virtual pathnames (see id::file_system::normalize_virtual_path) and the contents are
+/// accessed without copying through the mapping of the archive.
+class pack_archive
+{
+public:
+    /// @brief The alignment, in Bytes, of the contents of the files.
+    static constexpr size_t data_alignment = 16;
+
+    /// @brief Returned by id::file_system::pack_archive::find if no entry was found.
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+    /// @brief The mapped file descriptor.
+    mapped_file_descriptor m_file;
+    /// @brief A pointer to the mapping of the archive.
+    const char *m_data;
+    /// @brief The number of entries.
+    size_t m_number_of_entries;
+    /// @brief The number of slots of the hash table. A power of two.
+    size_t m_table_size;
+    /// @brief A pointer to the hash table.
+    const char *m_table;
+    /// @brief A pointer to the entries.
+    const char *m_entries;
+    /// @brief A pointer to the names.
+    const char *m_names;
+
+public:
+    /// @brief Construct this pack archive.
+    /// @post The pack archive is closed.
+    pack_archive();
+
+    /// @brief Destruct this pack archive.
+    /// @post The pack archive is closed.
+    ~pack_archive() noexcept;
+
+    // Delete copy constructor.
+    pack_archive(const pack_archive&) = delete;
+
+    // Delete copy assignment operator.
+    pack_archive& operator=(const pack_archive&) = delete;
+
+public:
+    /// @brief Ensure the pack archive is open.
+    /// @param pathname the pathname of the archive
+    /// @remark If the file can not be opened or is not a valid pack archive, then the pack archive is closed.
+    void open(const std::string& pathname) noexcept;
+
+    /// @brief Get if the pack archive is open.
+    /// @return @a true if the pack archive is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Ensure the pack archive is closed.
+    void close() noexcept;
+
+    /// @brief Get the number of entries.
+    /// @return the number of entries if the pack archive is open, @a 0 otherwise
+    size_t size() const noexcept;
+
+    /// @brief Find an entry.
+    /// @param name the normalized name of the entry
+    /// @return the index of the entry if it was found, id::file_system::pack_archive::npos otherwise
+    /// @remark The entry is found by a single lookup in the hash table of the archive.
+    size_t find(std::string_view name) const noexcept;
+
+    /// @brief Find an entry.
+    /// @param name the normalized name of the entry
+    /// @param hash the hash of the name as computed by id::file_system::hash_bytes
+    /// @return the index of the entry if it was found, id::file_system::pack_archive::npos otherwise
+    size_t find(std::string_view name, uint64_t hash) const noexcept;
+
+    /// @brief Get the name of an entry.
+    /// @param index the index of the entry
+    /// @return the name of the entry
+    /// @pre The index is less than id::file_system::pack_archive::size.
+    std::string_view name(size_t index) const noexcept;
+
+    /// @brief Get the contents of an entry.
+    /// @param index the index of the entry
+    /// @return the contents of the entry. Valid as long as the pack archive is open.
+    /// @pre The index is less than id::file_system::pack_archive::size.
+    std::string_view contents(size_t index) const noexcept;
+
+}; // class pack_archive
+
+#include "idlib/file_system/footer.in"
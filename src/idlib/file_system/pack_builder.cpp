@@ -0,0 +1,216 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/pack_builder.cpp
+/// @brief Creation of pack archives.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/pack_builder.hpp"
+#include "idlib/file_system/pack_format.hpp"
+#include "idlib/file_system/atomic_file_writer.hpp"
+#include "idlib/file_system/content_hash.hpp"
+#include "idlib/file_system/directory_scanner.hpp"
+#include "idlib/file_system/directory_separator.hpp"
+#include "idlib/file_system/virtual_path.hpp"
+#include "idlib/file_system/error.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+using namespace internal::pack_format;
+
+namespace {
+
+/// @brief Normalize the name of an entry.
+std::string normalize_entry_name(const std::string& name)
+{
+    std::string normalized;
+    if (!normalize_virtual_path(name, normalized) || normalized.empty())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid pack entry name `" + name + "`");
+    }
+    return normalized;
+}
+
+uint64_t align_up(uint64_t offset, uint64_t alignment) noexcept
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+pack_builder::pack_builder() :
+    m_entries()
+{}
+
+void pack_builder::add_file(const std::string& name, const std::string& pathname)
+{
+    m_entries.push_back({ normalize_entry_name(name), pathname, std::string() });
+}
+
+void pack_builder::add(const std::string& name, const void *data, size_t size)
+{
+    m_entries.push_back({ normalize_entry_name(name), std::string(), std::string(static_cast<const char *>(data), size) });
+}
+
+void pack_builder::add_directory(const std::string& pathname, const std::string& prefix)
+{
+    const std::string separator = get_directory_separator();
+    std::mutex mutex;
+    std::vector<std::string> files;
+    directory_scanner(thread_pool::shared(), false).scan(pathname, [&](const directory_entry& entry)
+    {
+        if (entry_type::regular == entry.type)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            files.push_back(entry.pathname);
+        }
+    });
+    // Sort the files such that the archive does not depend on the order of the enumeration.
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files)
+    {
+        add_file(prefix + "/" + file, pathname + separator + file);
+    }
+}
+
+size_t pack_builder::size() const noexcept
+{
+    return m_entries.size();
+}
+
+void pack_builder::build(const std::string& pathname) const
+{
+    const size_t number_of_entries = m_entries.size();
+    if (number_of_entries >= empty_slot)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to build pack archive `" + pathname + "`: too many entries");
+    }
+    // Reject duplicate names before any file is read or written.
+    std::vector<const std::string *> sorted_names(number_of_entries);
+    for (size_t i = 0; i < number_of_entries; ++i)
+    {
+        sorted_names[i] = &m_entries[i].name;
+    }
+    std::sort(sorted_names.begin(), sorted_names.end(), [](const std::string *x, const std::string *y) { return *x < *y; });
+    auto duplicate = std::adjacent_find(sorted_names.begin(), sorted_names.end(), [](const std::string *x, const std::string *y) { return *x == *y; });
+    if (sorted_names.end() != duplicate)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to build pack archive `" + pathname + "`: duplicate entry `" + **duplicate + "`");
+    }
+    // Map the files providing the contents.
+    std::vector<std::unique_ptr<mapped_file_descriptor>> files(number_of_entries);
+    std::vector<std::string_view> contents(number_of_entries);
+    for (size_t i = 0; i < number_of_entries; ++i)
+    {
+        const entry& entry = m_entries[i];
+        if (entry.pathname.empty())
+        {
+            contents[i] = entry.contents;
+            continue;
+        }
+        files[i] = std::make_unique<mapped_file_descriptor>();
+        files[i]->open_read(entry.pathname, create_mode::open_existing);
+        if (!files[i]->is_open())
+        {
+            throw id::file_system::error(__FILE__, __LINE__, "unable to build pack archive `" + pathname + "`: unable to open file `" + entry.pathname + "`");
+        }
+        contents[i] = std::string_view(files[i]->data(), files[i]->size());
+    }
+    // Compute the layout. The table has at least twice as many slots as there are entries.
+    uint64_t table_size = 1;
+    while (table_size < 2 * (uint64_t)number_of_entries + 1)
+    {
+        table_size *= 2;
+    }
+    uint64_t names_size = 0;
+    for (const auto& entry : m_entries)
+    {
+        names_size += entry.name.size();
+    }
+    const uint64_t metadata_end = header_size + table_size * slot_size + number_of_entries * entry_size + names_size;
+    const uint64_t data_offset = align_up(metadata_end, pack_archive::data_alignment);
+    std::vector<uint64_t> offsets(number_of_entries);
+    uint64_t offset = data_offset;
+    for (size_t i = 0; i < number_of_entries; ++i)
+    {
+        offsets[i] = offset;
+        offset = align_up(offset + contents[i].size(), pack_archive::data_alignment);
+    }
+    // Compose the header, the table, the entries, and the names.
+    std::vector<char> metadata((size_t)data_offset, 0);
+    char *data = metadata.data();
+    char *table = data + header_size,
+         *entries = table + table_size * slot_size,
+         *names = entries + number_of_entries * entry_size;
+    for (uint64_t i = 0; i < table_size; ++i)
+    {
+        write_u32(table + i * slot_size + 8, empty_slot);
+    }
+    uint64_t name_offset = 0;
+    for (size_t i = 0; i < number_of_entries; ++i)
+    {
+        const std::string& name = m_entries[i].name;
+        const uint64_t hash = hash_bytes(name.data(), name.size());
+        const uint64_t mask = table_size - 1;
+        uint64_t j = hash & mask;
+        while (empty_slot != read_u32(table + j * slot_size + 8))
+        {
+            j = (j + 1) & mask;
+        }
+        write_u64(table + j * slot_size, hash);
+        write_u32(table + j * slot_size + 8, (uint32_t)i);
+        char *entry = entries + i * entry_size;
+        write_u64(entry, offsets[i]);
+        write_u64(entry + 8, contents[i].size());
+        write_u32(entry + 16, (uint32_t)name_offset);
+        write_u32(entry + 20, (uint32_t)name.size());
+        write_u32(entry + 24, stored);
+        memcpy(names + name_offset, name.data(), name.size());
+        name_offset += name.size();
+    }
+    memcpy(data, magic, sizeof(magic));
+    write_u32(data + version_offset, version);
+    write_u64(data + number_of_entries_offset, number_of_entries);
+    write_u64(data + table_size_offset, table_size);
+    write_u64(data + names_size_offset, names_size);
+    write_u64(data + data_offset_offset, data_offset);
+    write_u64(data + checksum_offset, hash_bytes(data + header_size, metadata_end - header_size, hash_bytes(data, checksum_offset)));
+    // Write the archive to a temporary file which replaces the archive when it is complete. If an error occurs, then
+    // the writer removes the temporary file.
+    atomic_file_writer file;
+    file.open(pathname);
+    if (!file.is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to build pack archive `" + pathname + "`: unable to create temporary file");
+    }
+    file.write(metadata.data(), metadata.size());
+    static const char padding[pack_archive::data_alignment] = {};
+    for (size_t i = 0; i < number_of_entries; ++i)
+    {
+        file.write(contents[i]);
+        const uint64_t end = i + 1 < number_of_entries ? offsets[i + 1] : offset;
+        file.write(padding, (size_t)(end - offsets[i] - contents[i].size()));
+    }
+    file.commit();
+}
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,91 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/pack_builder.hpp
+/// @brief Creation of pack archives.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/pack_archive.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Creates an id::file_system::pack_archive.
+/// @code
+/// id::file_system::pack_builder builder;
+/// builder.add_directory("assets");
+/// builder.build("assets.pack");
+/// @endcode
+class pack_builder
+{
+private:
+    /// @brief An entry.
+    struct entry
+    {
+        /// @brief The normalized name.
+        std::string name;
+        /// @brief The pathname of the file providing the contents or the empty string.
+        std::string pathname;
+        /// @brief The contents if the pathname is the empty string.
+        std::string contents;
+    };
+
+    /// @brief The entries.
+    std::vector<entry> m_entries;
+
+public:
+    /// @brief Construct this pack builder.
+    /// @post The pack builder has no entries.
+    pack_builder();
+
+public:
+    /// @brief Add an entry whose contents are the contents of a file.
+    /// @param name the name of the entry
+    /// @param pathname the pathname of the file
+    /// @throw id::file_system::error the name is not a valid virtual pathname
+    /// @remark The file is read by id::file_system::pack_builder::build.
+    void add_file(const std::string& name, const std::string& pathname);
+
+    /// @brief Add an entry.
+    /// @param name the name of the entry
+    /// @param data a pointer to an array of @a size Bytes
+    /// @param size the size, in Bytes, of the array
+    /// @throw id::file_system::error the name is not a valid virtual pathname
+    void add(const std::string& name, const void *data, size_t size);
+
+    /// @brief Add an entry for each regular file of a directory and its subdirectories.
+    /// @param pathname the pathname of the directory
+    /// @param prefix the virtual pathname prepended to the pathnames of the files relative to the directory
+    /// @throw id::file_system::error the directory can not be enumerated
+    void add_directory(const std::string& pathname, const std::string& prefix = std::string());
+
+    /// @brief Get the number of entries.
+    /// @return the number of entries
+    size_t size() const noexcept;
+
+    /// @brief Create a pack archive.
+    /// @param pathname the pathname of the pack archive
+    /// @throw id::file_system::error two entries have the same name, a file can not be read, or the pack archive
+    /// can not be written
+    /// @remark The pack archive is replaced by means of an id::file_system::atomic_file_writer with durability
+    /// id::file_system::durability::full.
+    void build(const std::string& pathname) const;
+
+}; // class pack_builder
+
+#include "idlib/file_system/footer.in"
@@ -0,0 +1,58 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/utility/little_endian.hpp"
+
+#include "idlib/file_system/header.in"
+
+namespace internal {
+
+/// @brief The layout of a pack archive shared by id::file_system::pack_archive and id::file_system::pack_builder.
+namespace pack_format {
+
+/// @brief The magic number.
+constexpr char magic[4] = { 'I', 'D', 'P', 'K' };
+/// @brief The version.
+constexpr uint32_t version = 1;
+
+/// @brief The size, in Bytes, of the header.
+/// The header consists of the magic number, the version, the number of entries, the number of slots of the table,
+/// the size of the names, the offset of the contents, the checksum, and reserved Bytes.
+constexpr size_t header_size = 64;
+constexpr size_t version_offset = 4;
+constexpr size_t number_of_entries_offset = 8;
+constexpr size_t table_size_offset = 16;
+constexpr size_t names_size_offset = 24;
+constexpr size_t data_offset_offset = 32;
+constexpr size_t checksum_offset = 40;
+
+/// @brief The size, in Bytes, of a slot of the table.
+/// A slot consists of the hash of the name and the index of the entry or id::file_system::internal::pack_format::empty_slot.
+constexpr size_t slot_size = 16;
+/// @brief The index of the entry of an empty slot.
+constexpr uint32_t empty_slot = 0xFFFFFFFF;
+
+/// @brief The size, in Bytes, of an entry.
+/// An entry consists of the offset and the size of the contents, the offset and the length of the name, the flags,
+/// and reserved Bytes.
+constexpr size_t entry_size = 32;
+
+/// @brief The flags of an entry whose contents are stored without compression.
+constexpr uint32_t stored = 0;
+
+using id::internal::read_u64;
+using id::internal::read_u32;
+using id::internal::write_u64;
+using id::internal::write_u32;
+
+} // namespace pack_format
+
+} // namespace internal
+
+#include "idlib/file_system/footer.in"
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
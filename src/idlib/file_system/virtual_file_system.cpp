@@ -0,0 +1,327 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/virtual_file_system.cpp
+/// @brief A file system composed of directories and pack archives mounted under virtual pathnames.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/virtual_file_system.hpp"
+#include "idlib/file_system/content_hash.hpp"
+#include "idlib/file_system/directory_separator.hpp"
+#include "idlib/file_system/error.hpp"
+#include "idlib/file_system/mapped_file_pool.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#if defined(ID_WINDOWS)
+#include "idlib/file_system/file_operations_windows.hpp"
+#elif defined(ID_OSX)
+#error("operating system not supported")
+#elif defined(ID_LINUX)
+#include "idlib/file_system/file_operations_linux.hpp"
+#else
+#error("operating system not supported")
+#endif
+
+#include "idlib/file_system/header.in"
+
+namespace {
+
+/// @brief Normalize the virtual pathname of a mount point.
+std::string normalize_mount_path(const std::string& path)
+{
+    std::string normalized;
+    if (!normalize_virtual_path(path, normalized))
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "invalid mount point `" + path + "`");
+    }
+    return normalized;
+}
+
+/// @brief Get if a virtual pathname is the concatenation of the virtual pathname of a mount point and a name.
+bool is_concatenation(const std::string& pathname, const std::string& path, std::string_view name) noexcept
+{
+    if (path.empty())
+    {
+        return pathname == name;
+    }
+    return pathname.size() == path.size() + 1 + name.size()
+        && 0 == pathname.compare(0, path.size(), path)
+        && '/' == pathname[path.size()]
+        && 0 == pathname.compare(path.size() + 1, name.size(), name.data(), name.size());
+}
+
+} // namespace
+
+virtual_file::virtual_file() noexcept :
+    m_owner(), m_data(nullptr), m_size(0)
+{}
+
+virtual_file::virtual_file(std::shared_ptr<const void> owner, const char *data, size_t size) noexcept :
+    m_owner(std::move(owner)), m_data(data), m_size(size)
+{}
+
+bool virtual_file::is_open() const noexcept
+{
+    return nullptr != m_owner;
+}
+
+void virtual_file::close() noexcept
+{
+    m_owner = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const char *virtual_file::data() const noexcept
+{
+    return m_data;
+}
+
+size_t virtual_file::size() const noexcept
+{
+    return m_size;
+}
+
+std::string_view virtual_file::contents() const noexcept
+{
+    return std::string_view(m_data, m_size);
+}
+
+virtual_file_system::virtual_file_system() :
+    m_mounts(), m_table()
+{}
+
+void virtual_file_system::mount_directory(const std::string& path, const std::string& pathname)
+{
+    m_mounts.push_back({ normalize_mount_path(path), pathname, nullptr });
+}
+
+void virtual_file_system::mount_pack(const std::string& path, const std::string& pathname)
+{
+    std::string normalized = normalize_mount_path(path);
+    auto archive = std::make_shared<pack_archive>();
+    archive->open(pathname);
+    if (!archive->is_open())
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "unable to mount pack archive `" + pathname + "`");
+    }
+    m_mounts.push_back({ std::move(normalized), std::string(), std::move(archive) });
+    try
+    {
+        rebuild();
+    }
+    catch (...)
+    {
+        m_mounts.pop_back();
+        throw;
+    }
+}
+
+bool virtual_file_system::unmount(const std::string& path)
+{
+    std::string normalized;
+    if (!normalize_virtual_path(path, normalized))
+    {
+        return false;
+    }
+    for (size_t i = m_mounts.size(); i-- > 0;)
+    {
+        if (normalized == m_mounts[i].path)
+        {
+            m_mounts.erase(m_mounts.begin() + i);
+            // The indices of the subsequent mounts have changed.
+            rebuild();
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t virtual_file_system::number_of_mounts() const noexcept
+{
+    return m_mounts.size();
+}
+
+bool virtual_file_system::exists(std::string_view pathname) const
+{
+    std::string normalized;
+    if (!normalize_virtual_path(pathname, normalized) || normalized.empty())
+    {
+        return false;
+    }
+    const slot *slot = find(normalized);
+    std::string loose;
+    for (size_t i = m_mounts.size(), first = nullptr == slot ? 0 : slot->mount + 1; i-- > first;)
+    {
+        if (nullptr == m_mounts[i].archive && get_pathname(m_mounts[i], normalized, loose) && is_regular_file(loose))
+        {
+            return true;
+        }
+    }
+    return nullptr != slot;
+}
+
+bool virtual_file_system::open(std::string_view pathname, virtual_file& file) const
+{
+    std::string normalized;
+    if (!normalize_virtual_path(pathname, normalized) || normalized.empty())
+    {
+        return false;
+    }
+    const slot *slot = find(normalized);
+    // Directories mounted after the pack archive containing the file take precedence.
+    std::string loose;
+    for (size_t i = m_mounts.size(), first = nullptr == slot ? 0 : slot->mount + 1; i-- > first;)
+    {
+        if (nullptr == m_mounts[i].archive && get_pathname(m_mounts[i], normalized, loose) && is_regular_file(loose))
+        {
+            // Loose files opened repeatedly or by other subsystems share their mappings.
+            try
+            {
+                auto mapped = mapped_file_pool::get_default().get(loose);
+                file = virtual_file(mapped, mapped->data(), mapped->size());
+                return true;
+            }
+            catch (const id::file_system::error&)
+            {}
+        }
+    }
+    if (nullptr == slot)
+    {
+        return false;
+    }
+    const auto& archive = m_mounts[slot->mount].archive;
+    std::string_view contents = archive->contents(slot->entry);
+    file = virtual_file(archive, contents.data(), contents.size());
+    return true;
+}
+
+const virtual_file_system::slot *virtual_file_system::find(const std::string& pathname) const noexcept
+{
+    if (m_table.empty())
+    {
+        return nullptr;
+    }
+    const uint64_t hash = hash_bytes(pathname.data(), pathname.size());
+    const size_t mask = m_table.size() - 1;
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        const slot& slot = m_table[i];
+        if (empty_slot == slot.mount)
+        {
+            return nullptr;
+        }
+        if (hash == slot.hash)
+        {
+            const mount& mount = m_mounts[slot.mount];
+            if (is_concatenation(pathname, mount.path, mount.archive->name(slot.entry)))
+            {
+                return &slot;
+            }
+        }
+    }
+}
+
+bool virtual_file_system::get_pathname(const mount& mount, const std::string& pathname, std::string& result)
+{
+    if (!mount.path.empty() && (pathname.size() <= mount.path.size() + 1
+                             || 0 != pathname.compare(0, mount.path.size(), mount.path)
+                             || '/' != pathname[mount.path.size()]))
+    {
+        return false;
+    }
+    static const std::string separator = get_directory_separator();
+    result.assign(mount.directory);
+    result.append(separator);
+    size_t offset = mount.path.empty() ? 0 : mount.path.size() + 1;
+    for (size_t i = offset; i < pathname.size(); ++i)
+    {
+        if ('/' == pathname[i])
+        {
+            result.append(separator);
+        }
+        else
+        {
+            result.push_back(pathname[i]);
+        }
+    }
+    return true;
+}
+
+void virtual_file_system::rebuild()
+{
+    size_t number_of_entries = 0;
+    for (const auto& mount : m_mounts)
+    {
+        if (nullptr != mount.archive)
+        {
+            number_of_entries += mount.archive->size();
+        }
+    }
+    if (m_mounts.size() >= empty_slot)
+    {
+        throw id::file_system::error(__FILE__, __LINE__, "too many mounts");
+    }
+    size_t table_size = 1;
+    while (table_size < 2 * number_of_entries + 1)
+    {
+        table_size *= 2;
+    }
+    std::vector<slot> table(table_size, slot{ 0, empty_slot, 0 });
+    const size_t mask = table_size - 1;
+    std::string pathname;
+    // The entries of more recently mounted pack archives shadow the entries of less recently mounted pack archives.
+    for (size_t i = m_mounts.size(); i-- > 0;)
+    {
+        const mount& mount = m_mounts[i];
+        if (nullptr == mount.archive)
+        {
+            continue;
+        }
+        for (size_t j = 0, n = mount.archive->size(); j < n; ++j)
+        {
+            std::string_view name = mount.archive->name(j);
+            pathname.assign(mount.path);
+            if (!pathname.empty())
+            {
+                pathname.push_back('/');
+            }
+            pathname.append(name.data(), name.size());
+            const uint64_t hash = hash_bytes(pathname.data(), pathname.size());
+            size_t k = (size_t)hash & mask;
+            for (; empty_slot != table[k].mount; k = (k + 1) & mask)
+            {
+                const auto& other = m_mounts[table[k].mount];
+                if (hash == table[k].hash && is_concatenation(pathname, other.path, other.archive->name(table[k].entry)))
+                {
+                    break;
+                }
+            }
+            if (empty_slot == table[k].mount)
+            {
+                table[k] = slot{ hash, (uint32_t)i, (uint32_t)j };
+            }
+        }
+    }
+    m_table.swap(table);
+}
+
+#include "idlib/file_system/footer.in"
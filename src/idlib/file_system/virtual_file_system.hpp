@@ -0,0 +1,185 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/virtual_file_system.hpp
+/// @brief A file system composed of directories and pack archives mounted under virtual pathnames.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/file_system/pack_archive.hpp"
+#include "idlib/file_system/virtual_path.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief The contents of a file of an id::file_system::virtual_file_system.
+/// @detail The contents are not copied: they are either in the mapping of a pack archive or in a mapping of a file.
+/// The file keeps the storage of its contents alive, even if the storage is unmounted.
+class virtual_file
+{
+private:
+    /// @brief The owner of the storage of the contents or a null pointer.
+    std::shared_ptr<const void> m_owner;
+    /// @brief A pointer to the contents.
+    const char *m_data;
+    /// @brief The size, in Bytes, of the contents.
+    size_t m_size;
+
+public:
+    /// @brief Construct this virtual file.
+    /// @post The virtual file is closed.
+    virtual_file() noexcept;
+
+    /// @brief Construct this virtual file.
+    /// @param owner the owner of the storage of the contents
+    /// @param data a pointer to the contents
+    /// @param size the size, in Bytes, of the contents
+    virtual_file(std::shared_ptr<const void> owner, const char *data, size_t size) noexcept;
+
+public:
+    /// @brief Get if this virtual file is open.
+    /// @return @a true if this virtual file is open, @a false otherwise
+    bool is_open() const noexcept;
+
+    /// @brief Ensure this virtual file is closed.
+    void close() noexcept;
+
+    /// @brief Get a pointer to the contents.
+    /// @return a pointer to an array of @a size() Bytes
+    const char *data() const noexcept;
+
+    /// @brief Get the size, in Bytes, of the contents.
+    /// @return the size, in Bytes, of the contents
+    size_t size() const noexcept;
+
+    /// @brief Get the contents.
+    /// @return the contents
+    std::string_view contents() const noexcept;
+
+}; // class virtual_file
+
+/// @brief A file system composed of directories and pack archives mounted under virtual pathnames.
+/// @detail
+/// A virtual pathname is resolved by the most recently mounted directory or pack archive which contains it.
+/// The entries of all mounted pack archives are kept in a hash table indexed by their virtual pathnames, hence a
+/// lookup in the pack archives is a single hash table lookup. Directories mounted after the pack archive containing the
+/// pathname (or all directories if no pack archive contains the pathname) are probed by the operating system.
+/// @code
+/// id::file_system::virtual_file_system vfs;
+/// vfs.mount_pack("", "assets.pack");
+/// vfs.mount_directory("textures", "mods/textures");
+/// id::file_system::virtual_file file;
+/// if (vfs.open("textures/wood.png", file)) { ... file.data() ... }
+/// @endcode
+/// @remark Lookups may be performed concurrently. Mounting and unmounting must not be performed concurrently with
+/// other operations.
+class virtual_file_system
+{
+private:
+    /// @brief A mounted directory or pack archive.
+    struct mount
+    {
+        /// @brief The normalized virtual pathname of the mount point.
+        std::string path;
+        /// @brief The pathname of the directory if this is a mounted directory.
+        std::string directory;
+        /// @brief The pack archive if this is a mounted pack archive, a null pointer otherwise.
+        std::shared_ptr<pack_archive> archive;
+    };
+
+    /// @brief A slot of the hash table of the entries of the pack archives.
+    struct slot
+    {
+        /// @brief The hash of the virtual pathname of the entry.
+        uint64_t hash;
+        /// @brief The index of the mount or id::file_system::virtual_file_system::empty_slot.
+        uint32_t mount;
+        /// @brief The index of the entry in the pack archive.
+        uint32_t entry;
+    };
+
+    /// @brief The index of the mount of an empty slot.
+    static constexpr uint32_t empty_slot = 0xFFFFFFFF;
+
+    /// @brief The mounts in the order in which they were mounted.
+    std::vector<mount> m_mounts;
+    /// @brief The hash table of the entries of the pack archives. The number of slots is a power of two.
+    std::vector<slot> m_table;
+
+public:
+    /// @brief Construct this virtual file system.
+    /// @post Nothing is mounted.
+    virtual_file_system();
+
+    // Delete copy constructor.
+    virtual_file_system(const virtual_file_system&) = delete;
+
+    // Delete copy assignment operator.
+    virtual_file_system& operator=(const virtual_file_system&) = delete;
+
+public:
+    /// @brief Mount a directory.
+    /// @param path the virtual pathname of the mount point
+    /// @param pathname the pathname of the directory
+    /// @throw id::file_system::error the virtual pathname is not valid
+    void mount_directory(const std::string& path, const std::string& pathname);
+
+    /// @brief Mount a pack archive.
+    /// @param path the virtual pathname of the mount point
+    /// @param pathname the pathname of the pack archive
+    /// @throw id::file_system::error the virtual pathname is not valid or the pack archive can not be opened
+    void mount_pack(const std::string& path, const std::string& pathname);
+
+    /// @brief Unmount the most recently mounted directory or pack archive at a mount point.
+    /// @param path the virtual pathname of the mount point
+    /// @return @a true if a directory or pack archive was unmounted, @a false otherwise
+    bool unmount(const std::string& path);
+
+    /// @brief Get the number of mounted directories and pack archives.
+    /// @return the number of mounted directories and pack archives
+    size_t number_of_mounts() const noexcept;
+
+    /// @brief Get if a file exists.
+    /// @param pathname the virtual pathname of the file
+    /// @return @a true if the file exists, @a false otherwise
+    bool exists(std::string_view pathname) const;
+
+    /// @brief Open a file.
+    /// @param pathname the virtual pathname of the file
+    /// @param [out] file the file
+    /// @return @a true if the file was opened, @a false if it does not exist
+    bool open(std::string_view pathname, virtual_file& file) const;
+
+private:
+    /// @brief Find a file in the mounted pack archives.
+    /// @param pathname the normalized virtual pathname of the file
+    /// @return a pointer to the slot of the file or a null pointer
+    const slot *find(const std::string& pathname) const noexcept;
+
+    /// @brief Get the pathname of a file in a mounted directory.
+    /// @param mount the mounted directory
+    /// @param pathname the normalized virtual pathname of the file
+    /// @param [out] result the pathname of the file in the directory
+    /// @return @a true if the mount point contains the virtual pathname, @a false otherwise
+    static bool get_pathname(const mount& mount, const std::string& pathname, std::string& result);
+
+    /// @brief Rebuild the hash table of the entries of the pack archives.
+    void rebuild();
+
+}; // class virtual_file_system
+
+#include "idlib/file_system/footer.in"
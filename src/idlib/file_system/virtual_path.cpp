@@ -0,0 +1,65 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/virtual_path.cpp
+/// @brief Pathnames of an id::file_system::virtual_file_system.
+/// @author Michael Heilmann
+
+#pragma push_macro("IDLIB_PRIVATE")
+#undef IDLIB_PRIVATE
+#define IDLIB_PRIVATE 1
+#include "idlib/file_system/virtual_path.hpp"
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
+
+#include "idlib/file_system/header.in"
+
+bool normalize_virtual_path(std::string_view pathname, std::string& normalized)
+{
+    normalized.clear();
+    size_t begin = 0;
+    while (begin <= pathname.size())
+    {
+        size_t end = pathname.find_first_of("/\\", begin);
+        if (std::string_view::npos == end)
+        {
+            end = pathname.size();
+        }
+        std::string_view component = pathname.substr(begin, end - begin);
+        if (component == "..")
+        {
+            if (normalized.empty())
+            {
+                return false;
+            }
+            size_t separator = normalized.rfind('/');
+            normalized.erase(std::string::npos == separator ? 0 : separator);
+        }
+        else if (!component.empty() && component != ".")
+        {
+            if (!normalized.empty())
+            {
+                normalized.push_back('/');
+            }
+            normalized.append(component.data(), component.size());
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+#include "idlib/file_system/footer.in"
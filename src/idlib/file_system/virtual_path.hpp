@@ -0,0 +1,37 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/file_system/virtual_path.hpp
+/// @brief Pathnames of an id::file_system::virtual_file_system.
+/// @author Michael Heilmann
+
+#pragma once
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/file_system/header.in"
+
+/// @brief Normalize a virtual pathname.
+/// @param pathname the virtual pathname
+/// @param [out] normalized the normalized virtual pathname
+/// @return @a true on success, @a false if the pathname refers to a location above its root
+/// @remark Virtual pathnames are relative pathnames with components separated by @a '/'.
+/// @a '\\' is accepted as a separator, empty components and @a "." components are removed, and @a ".." components
+/// remove the preceding component. For example, @a "/textures//wood/../stone.png" is normalized to @a "textures/stone.png".
+bool normalize_virtual_path(std::string_view pathname, std::string& normalized);
+
+#include "idlib/file_system/footer.in"
@@ -42,6 +42,9 @@
 // event library.
 #include "idlib/event.hpp"
 
+// concurrency library.
+#include "idlib/concurrency.hpp"
+
 // signal library.
 #include "idlib/signal.hpp"
 
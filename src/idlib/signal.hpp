@@ -25,6 +25,19 @@
 #error(do not include directly, include `idlib/idlib.hpp` instead)
 #endif
 
+#include "idlib/signal/inline_function.hpp"
+#include "idlib/signal/node_allocator.hpp"
+#include "idlib/signal/signal_statistics.hpp"
+#include "idlib/signal/combiners.hpp"
+#include "idlib/signal/slot_group.hpp"
 #include "idlib/signal/signal.hpp"
 #include "idlib/signal/connection.hpp"
 #include "idlib/signal/scoped_connection.hpp"
+#include "idlib/signal/shared_connection_block.hpp"
+#include "idlib/signal/connection_group.hpp"
+#include "idlib/signal/concurrent_signal.hpp"
+#include "idlib/signal/concurrent_connection.hpp"
+#include "idlib/signal/dense_signal.hpp"
+#include "idlib/signal/dense_connection.hpp"
+#include "idlib/signal/dispatcher.hpp"
+#include "idlib/signal/queued_signal.hpp"
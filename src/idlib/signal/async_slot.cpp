@@ -0,0 +1,38 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/async_slot.cpp
+/// @brief A slot which is executed asynchronously on a thread pool.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/async_slot.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+task_group *& current_task_group() noexcept
+{
+    static thread_local task_group *group = nullptr;
+    return group;
+}
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
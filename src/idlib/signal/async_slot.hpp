@@ -0,0 +1,110 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/async_slot.hpp
+/// @brief A slot which is executed asynchronously on a thread pool.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/concurrency/task_group.hpp"
+#include "idlib/concurrency/thread_pool.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+/// @brief Get the task group of the emission running on the calling thread.
+/// @return a reference to a pointer to the task group or a null pointer
+task_group *& current_task_group() noexcept;
+
+/// @brief Sets the task group of the emissions running on the calling thread during its lifetime.
+struct task_group_scope
+{
+    task_group *previous;
+
+    explicit task_group_scope(task_group& group) noexcept
+        : previous(current_task_group())
+    {
+        current_task_group() = &group;
+    }
+
+    ~task_group_scope()
+    {
+        current_task_group() = previous;
+    }
+
+    task_group_scope(const task_group_scope&) = delete; // Do not allow copying.
+    const task_group_scope& operator=(const task_group_scope&) = delete; // Do not allow copying.
+
+}; // struct task_group_scope
+
+/// @brief A slot which posts the invocation of a function to a thread pool.
+/// @detail
+/// The arguments are decay-copied (or moved from rvalues) into the task, hence no reference to the
+/// arguments of the emission is retained. The function is shared by the slot and the pending tasks,
+/// hence it remains alive until all pending tasks have run, even if the slot is disconnected.
+/// @tparam Function the function type
+/// @tparam ... ParameterTypes the parameter types of the signal
+template <class Function, class ... ParameterTypes>
+struct async_slot
+{
+    thread_pool *pool;
+    std::shared_ptr<Function> function;
+
+    template <class Argument>
+    async_slot(thread_pool& pool, Argument&& argument)
+        : pool(&pool), function(std::make_shared<Function>(std::forward<Argument>(argument)))
+    {}
+
+    template <class ... ArgumentTypes>
+    void operator()(ArgumentTypes&& ... arguments) const
+    {
+        auto task = [function = function,
+                     arguments = std::tuple<std::decay_t<ParameterTypes> ...>(std::forward<ArgumentTypes>(arguments) ...)]() mutable
+        {
+            std::apply(*function, std::move(arguments));
+        };
+        task_group *group = current_task_group();
+        if (nullptr != group)
+        {
+            pool->post(*group, std::move(task));
+        }
+        else
+        {
+            pool->post([task = std::move(task)]() mutable noexcept
+            {
+                try
+                {
+                    task();
+                }
+                catch (...)
+                { /* Intentionally empty: there is nobody to report the exception to. */ }
+            });
+        }
+    }
+
+}; // struct async_slot
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,187 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/combiners.hpp
+/// @brief Combiners for the return values of the subscribers of a signal.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+/// @ingroup signal
+/// @brief Combiners for id::signal::collect.
+/// @detail
+/// A combiner is fed the return value of each invoked subscriber in the order of invocation.
+/// It provides
+/// - a function call operator accepting a return value and returning @a true if the emission should continue
+///   and @a false if the emission should stop (short-circuit) and
+/// - a member function @a result returning the combined result.
+/// The combiners are evaluated within the single pass over the subscribers of an emission.
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace combiners {
+
+/// @brief A combiner returning the first return value which converts to @a true.
+/// The emission stops at that value. If there is no such value, a value-initialized value is returned.
+/// @tparam ValueType the value type e.g. a pointer type or std::optional
+template <class ValueType>
+struct first_non_empty
+{
+    using result_type = ValueType;
+    ValueType value{};
+
+    template <class ArgumentType>
+    bool operator()(ArgumentType&& argument)
+    {
+        if (static_cast<bool>(argument))
+        {
+            value = std::forward<ArgumentType>(argument);
+            return false;
+        }
+        return true;
+    }
+
+    result_type result()
+    {
+        return std::move(value);
+    }
+
+}; // struct first_non_empty
+
+/// @brief A combiner returning the last return value.
+/// If there is no return value, a value-initialized value is returned.
+/// @tparam ValueType the value type
+template <class ValueType>
+struct last_value
+{
+    using result_type = ValueType;
+    ValueType value{};
+
+    template <class ArgumentType>
+    bool operator()(ArgumentType&& argument)
+    {
+        value = std::forward<ArgumentType>(argument);
+        return true;
+    }
+
+    result_type result()
+    {
+        return std::move(value);
+    }
+
+}; // struct last_value
+
+/// @brief A combiner returning @a true if all return values are @a true.
+/// The emission stops at the first return value that is @a false.
+struct all_of
+{
+    using result_type = bool;
+    bool value = true;
+
+    bool operator()(bool argument) noexcept
+    {
+        value = argument;
+        return argument;
+    }
+
+    result_type result() const noexcept
+    {
+        return value;
+    }
+
+}; // struct all_of
+
+/// @brief A combiner returning @a true if any return value is @a true.
+/// The emission stops at the first return value that is @a true i.e. the first subscriber consuming
+/// the emission stops its propagation.
+struct until_true
+{
+    using result_type = bool;
+    bool value = false;
+
+    bool operator()(bool argument) noexcept
+    {
+        value = argument;
+        return !argument;
+    }
+
+    result_type result() const noexcept
+    {
+        return value;
+    }
+
+}; // struct until_true
+
+/// @brief A combiner returning the sum of the return values.
+/// @tparam ValueType the value type
+template <class ValueType>
+struct sum
+{
+    using result_type = ValueType;
+    ValueType value;
+
+    /// @brief Construct this combiner.
+    /// @param initial the initial value of the sum
+    explicit sum(ValueType initial = ValueType())
+        : value(std::move(initial))
+    {}
+
+    template <class ArgumentType>
+    bool operator()(ArgumentType&& argument)
+    {
+        value += std::forward<ArgumentType>(argument);
+        return true;
+    }
+
+    result_type result()
+    {
+        return std::move(value);
+    }
+
+}; // struct sum
+
+/// @brief A combiner returning a vector of the return values.
+/// @tparam ValueType the value type
+template <class ValueType>
+struct vector_collector
+{
+    using result_type = std::vector<ValueType>;
+    std::vector<ValueType> values;
+
+    template <class ArgumentType>
+    bool operator()(ArgumentType&& argument)
+    {
+        values.push_back(std::forward<ArgumentType>(argument));
+        return true;
+    }
+
+    result_type result()
+    {
+        return std::move(values);
+    }
+
+}; // struct vector_collector
+
+} // namespace combiners
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,116 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_connection.cpp
+/// @brief A connection of a concurrent signal.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/concurrent_connection.hpp"
+#include "idlib/signal/concurrent_signal_base.hpp"
+#include "idlib/signal/concurrent_node_base.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+concurrent_connection::concurrent_connection()
+    : node(nullptr)
+{}
+
+concurrent_connection::concurrent_connection(internal::concurrent_node_base *node)
+    : node(node)
+{
+    if (node)
+    {
+        node->add_reference();
+    }
+}
+
+concurrent_connection::concurrent_connection(const concurrent_connection& other)
+    : node(other.node)
+{
+    if (node)
+    {
+        node->add_reference();
+    }
+}
+
+concurrent_connection::~concurrent_connection()
+{
+    reset();
+}
+
+const concurrent_connection& concurrent_connection::operator=(const concurrent_connection& other)
+{
+    if (&other != this)
+    {
+        if (other.node)
+        {
+            other.node->add_reference();
+        }
+        reset();
+        node = other.node;
+    }
+    return *this;
+}
+
+bool concurrent_connection::operator==(const concurrent_connection& other) const
+{
+    return node == other.node;
+}
+
+bool concurrent_connection::operator!=(const concurrent_connection& other) const
+{
+    return node != other.node;
+}
+
+bool concurrent_connection::is_connected() const
+{
+    if (node)
+    {
+        return node->is_connected();
+    }
+    return false;
+}
+
+void concurrent_connection::reset()
+{
+    if (node)
+    {
+        node->remove_reference();
+        node = nullptr;
+    }
+}
+
+void concurrent_connection::disconnect()
+{
+    if (node)
+    {
+        // Only the thread flipping the state removes the node from the signal.
+        if (node->connected.exchange(false, std::memory_order_acq_rel))
+        {
+            internal::concurrent_signal_base *signal = node->signal.load(std::memory_order_acquire);
+            if (signal)
+            {
+                signal->erase(node);
+            }
+        }
+        reset();
+    }
+}
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,82 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_connection.hpp
+/// @brief A connection of a concurrent signal.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+// Forward declaration.
+struct concurrent_node_base;
+} // namespace internal
+
+/// @ingroup signal
+/// @brief A connection of a concurrent signal.
+/// @remark A connection object itself must not be used from multiple threads at the same time,
+/// however, different connection objects referring to the same slot may be used concurrently.
+struct concurrent_connection
+{
+private:
+    /// @brief A pointer to the node.
+    internal::concurrent_node_base *node;
+
+public:
+    /// @brief Default construct this connection.
+    /// @post This connection is not connected.
+    concurrent_connection();
+
+    /// @brief Construct this connection with the specified arguments.
+    /// @param node a pointer to a node of the signal
+    explicit concurrent_connection(internal::concurrent_node_base *node);
+
+    /// @brief Copy construct this connection with the values of another connection.
+    /// @param other the other connection
+    concurrent_connection(const concurrent_connection& other);
+
+    /// @brief Destruct this connection.
+    ~concurrent_connection();
+
+    const concurrent_connection& operator=(const concurrent_connection& other);
+
+    bool operator==(const concurrent_connection& other) const;
+
+    bool operator!=(const concurrent_connection& other) const;
+
+    /// @brief Get if the connection is connected.
+    /// @return @a true if this connection is connected, @a false otherwise
+    bool is_connected() const;
+
+    /// @brief Disconnect this connection.
+    /// @remark Slots already being invoked by other threads may still run to completion.
+    void disconnect();
+
+private:
+    void reset();
+
+}; // struct concurrent_connection
+
+#include "idlib/signal/internal/footer.hpp"
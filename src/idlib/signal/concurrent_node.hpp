@@ -0,0 +1,81 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_node.hpp
+/// @brief Nodes of concurrent signals.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/concurrent_node_base.hpp"
+#include "idlib/signal/inline_function.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+// Forward declaration.
+template <class>
+struct concurrent_node;
+
+/// @ingroup signal
+/// @brief A generic node of a concurrent signal.
+template <class ReturnType, class ... ParameterTypes>
+struct concurrent_node<ReturnType(ParameterTypes ...)> : internal::concurrent_node_base
+{
+public:
+    /// The node type.
+    using node_type = concurrent_node<ReturnType(ParameterTypes ...)>;
+    /// The function type.
+    using function_type = inline_function<ReturnType(ParameterTypes ...)>;
+
+public:
+    /// The function.
+    const function_type function;
+
+public:
+    concurrent_node(const node_type&) = delete; // Do not allow copying.
+    const node_type& operator=(const node_type&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this node.
+    /// @param number_of_references the initial number of references
+    /// @param arguments the arguments to construct the function from
+    template <class ... ArgumentTypes>
+    explicit concurrent_node(int number_of_references, ArgumentTypes&& ... arguments)
+        : internal::concurrent_node_base(number_of_references), function(std::forward<ArgumentTypes>(arguments) ...) {}
+
+public:
+    /// @brief Invoke this node.
+    /// @param arguments (implied)
+    /// @return (implied)
+    /// @remark See id::internal::emission_argument_t for how an emission passes its arguments to the nodes.
+    template <class ... ArgumentTypes>
+    ReturnType operator()(ArgumentTypes&& ... arguments) const
+    {
+        return function(std::forward<ArgumentTypes>(arguments) ...);
+    }
+
+}; // struct concurrent_node
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
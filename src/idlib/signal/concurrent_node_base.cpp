@@ -0,0 +1,51 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_node_base.cpp
+/// @brief Non-generic base class of all nodes of concurrent signals.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/concurrent_node_base.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+concurrent_node_base::concurrent_node_base(int number_of_references)
+    : signal(nullptr), connected(false), number_of_references(number_of_references)
+{}
+
+concurrent_node_base::~concurrent_node_base() {}
+
+void concurrent_node_base::add_reference() noexcept
+{
+    number_of_references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void concurrent_node_base::remove_reference() noexcept
+{
+    if (1 == number_of_references.fetch_sub(1, std::memory_order_acq_rel))
+    {
+        delete this;
+    }
+}
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,81 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_node_base.hpp
+/// @brief Non-generic base class of all nodes of concurrent signals.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+// Forward declarations.
+struct concurrent_signal_base;
+
+/// @internal
+/// @ingroup signal
+/// @brief Non-generic base class of any node of a concurrent signal.
+/// @remark In contrast to id::internal::node_base, the members of this node are atomic
+/// as a node might be referenced, emitted, and disconnected from multiple threads at once.
+struct concurrent_node_base
+{
+    /// @brief A pointer to the signal if this node has a signal, a null pointer otherwise.
+    std::atomic<concurrent_signal_base *> signal;
+    /// @brief @a true if the signal and the slot are connected, @a false otherwise.
+    std::atomic<bool> connected;
+    /// @brief The number of references to this node.
+    std::atomic<int> number_of_references;
+
+    concurrent_node_base(const concurrent_node_base&) = delete; // Do not allow copying.
+    const concurrent_node_base& operator=(const concurrent_node_base&) = delete; // Do not allow copying.
+
+    /// @brief Construct this node.
+    /// @param number_of_references the initial number of references of this node
+    /// @post signal = nullptr, connected = false
+    concurrent_node_base(int number_of_references);
+
+    /// @brief Virtual destructor.
+    virtual ~concurrent_node_base();
+
+public:
+    /// @brief Get if the signal and the slot are connected.
+    /// @return @a true if the signal and the slot are connected, @a false otherwise
+    bool is_connected() const noexcept
+    {
+        return connected.load(std::memory_order_acquire);
+    }
+
+    /// @brief Add a reference to this node.
+    void add_reference() noexcept;
+
+    /// @brief Remove a reference from this node.
+    /// If this was the last reference, then the node is deleted.
+    void remove_reference() noexcept;
+
+}; // struct concurrent_node_base
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
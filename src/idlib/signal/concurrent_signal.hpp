@@ -0,0 +1,133 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_signal.hpp
+/// @detail Thread-safe signal-slot implementation.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/concurrent_connection.hpp"
+#include "idlib/signal/concurrent_node.hpp"
+#include "idlib/signal/concurrent_signal_base.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+// Forward declarations.
+template <class> struct concurrent_signal;
+
+/// @ingroup signal
+/// @brief Generic thread-safe signal.
+/// @detail
+/// In contrast to id::signal, a concurrent signal may be emitted, subscribed to, and disconnected from
+/// by any number of threads at the same time. Emission does not lock: each emission iterates over an
+/// immutable snapshot of the slots taken at the start of the emission. Consequently a slot
+/// disconnected during an emission might still be invoked by that emission if that emission had
+/// already passed the check of the connection state, and a slot subscribed during an emission is
+/// first invoked by the next emission.
+/// @tparam ReturnType the return type
+/// @tparam ... ParameterTypes the parameter types
+/// @remark Non-copyable.
+template <class ReturnType, class ... ParameterTypes>
+struct concurrent_signal<ReturnType(ParameterTypes ...)> : internal::concurrent_signal_base
+{
+public:
+    /// @brief The node type.
+    using node_type = internal::concurrent_node<ReturnType(ParameterTypes ...)>;
+    /// @brief The function type.
+    using function_type = inline_function<ReturnType(ParameterTypes ...)>;
+
+public:
+    concurrent_signal(const concurrent_signal&) = delete; // Do not allow copying.
+    const concurrent_signal& operator=(const concurrent_signal&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this concurrent signal.
+    concurrent_signal() : concurrent_signal_base() {}
+
+    /// @brief Destruct this concurrent signal.
+    /// Disconnects all subscribers.
+    /// @pre No emission, subscription or disconnection is in progress.
+    ~concurrent_signal() noexcept {}
+
+public:
+    /// @brief Subscribe to this concurrent signal.
+    /// @param function a non-empty function
+    /// @return the connection
+    template <class Function>
+    concurrent_connection subscribe(Function&& function)
+    {
+        return add(new node_type(1, std::forward<Function>(function)));
+    }
+
+    /// @brief Subscribe a member function of an object to this concurrent signal.
+    /// @param object a pointer to the object
+    /// @param method the member function
+    /// @return the connection
+    template <class Object, class Method>
+    concurrent_connection subscribe(Object *object, Method method)
+    {
+        return add(new node_type(1, object, method));
+    }
+
+private:
+    /// @brief Add a node to this concurrent signal.
+    /// @param node the node. The initial reference of the node is the reference of the signal.
+    /// @return the connection
+    concurrent_connection add(node_type *node)
+    {
+        node->signal.store(this, std::memory_order_relaxed);
+        node->connected.store(true, std::memory_order_relaxed);
+        // Create the connection before the node is published.
+        concurrent_connection connection(node);
+        try
+        {
+            insert(node);
+        }
+        catch (...)
+        {
+            node->connected.store(false);
+            node->remove_reference();
+            std::rethrow_exception(std::current_exception());
+        }
+        return connection;
+    }
+
+public:
+    /// @brief Notify all subscribers.
+    /// @param arguments the arguments
+    /// @remark
+    /// Iterate over the nodes of the current snapshot. If a node is connected, then it is invoked.
+    void operator()(ParameterTypes ... arguments)
+    {
+        read_guard guard(*this);
+        for (internal::concurrent_node_base *cur : guard->nodes)
+        {
+            if (cur->is_connected())
+            {
+                (*static_cast<const node_type *>(cur))(static_cast<internal::emission_argument_t<ParameterTypes>>(arguments) ...);
+            }
+        }
+    }
+
+}; // struct concurrent_signal
+
+#include "idlib/signal/internal/footer.hpp"
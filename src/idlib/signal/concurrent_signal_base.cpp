@@ -0,0 +1,202 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_signal_base.cpp
+/// @brief Non-generic base class of all concurrent signals.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/concurrent_signal_base.hpp"
+#include "idlib/signal/concurrent_node_base.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+concurrent_signal_base::concurrent_signal_base()
+    : m_epoch(0), m_snapshot(new snapshot()), m_mutex(), m_retired()
+{
+    for (auto& stripe : m_stripes)
+    {
+        stripe.readers[0].store(0);
+        stripe.readers[1].store(0);
+    }
+}
+
+concurrent_signal_base::~concurrent_signal_base() noexcept
+{
+    std::vector<concurrent_node_base *> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const snapshot *current = m_snapshot.load();
+        for (auto node : current->nodes)
+        {
+            node->connected.store(false);
+            node->signal.store(nullptr);
+        }
+        released = publish(new snapshot(), current->nodes);
+        auto rest = reclaim(true);
+        released.insert(released.end(), rest.begin(), rest.end());
+        delete m_snapshot.load();
+    }
+    release(released);
+}
+
+size_t concurrent_signal_base::stripe_index() noexcept
+{
+    static std::atomic<size_t> next(0);
+    thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % number_of_stripes;
+    return index;
+}
+
+std::atomic<size_t> *concurrent_signal_base::enter() noexcept
+{
+    stripe& stripe = m_stripes[stripe_index()];
+    while (true)
+    {
+        uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        std::atomic<size_t> *readers = &stripe.readers[epoch & 1];
+        readers->fetch_add(1, std::memory_order_seq_cst);
+        // If the epoch advanced in the meantime, then a writer might not have seen us.
+        if (epoch == m_epoch.load(std::memory_order_seq_cst))
+        {
+            return readers;
+        }
+        readers->fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+size_t concurrent_signal_base::readers(size_t parity) const noexcept
+{
+    size_t count = 0;
+    for (const auto& stripe : m_stripes)
+    {
+        count += stripe.readers[parity].load(std::memory_order_seq_cst);
+    }
+    return count;
+}
+
+void concurrent_signal_base::insert(concurrent_node_base *node)
+{
+    std::vector<concurrent_node_base *> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const snapshot *current = m_snapshot.load();
+        std::unique_ptr<snapshot> next = std::make_unique<snapshot>();
+        next->nodes.reserve(current->nodes.size() + 1);
+        next->nodes.insert(next->nodes.end(), current->nodes.cbegin(), current->nodes.cend());
+        next->nodes.push_back(node);
+        released = publish(next.release(), {});
+    }
+    release(released);
+}
+
+void concurrent_signal_base::erase(concurrent_node_base *node) noexcept
+{
+    std::vector<concurrent_node_base *> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const snapshot *current = m_snapshot.load();
+        auto it = std::find(current->nodes.cbegin(), current->nodes.cend(), node);
+        if (it == current->nodes.cend())
+        {
+            return;
+        }
+        snapshot *next = new snapshot();
+        next->nodes.reserve(current->nodes.size() - 1);
+        next->nodes.insert(next->nodes.end(), current->nodes.cbegin(), it);
+        next->nodes.insert(next->nodes.end(), it + 1, current->nodes.cend());
+        released = publish(next, { node });
+    }
+    release(released);
+}
+
+void concurrent_signal_base::disconnect_all() noexcept
+{
+    std::vector<concurrent_node_base *> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const snapshot *current = m_snapshot.load();
+        if (current->nodes.empty())
+        {
+            return;
+        }
+        for (auto node : current->nodes)
+        {
+            node->connected.store(false);
+        }
+        released = publish(new snapshot(), current->nodes);
+    }
+    release(released);
+}
+
+std::vector<concurrent_node_base *> concurrent_signal_base::publish(const snapshot *new_snapshot, std::vector<concurrent_node_base *> released)
+{
+    const snapshot *old_snapshot = m_snapshot.exchange(new_snapshot, std::memory_order_seq_cst);
+    m_retired.push_back({ old_snapshot, std::move(released), m_epoch.load() });
+    return reclaim(false);
+}
+
+std::vector<concurrent_node_base *> concurrent_signal_base::reclaim(bool force)
+{
+    // A snapshot retired in epoch e might be in use by readers of epoch e - 1 and e.
+    // Each advance of the epoch requires the readers of the previous epoch to be gone,
+    // hence a snapshot retired in epoch e is not in use anymore if the epoch is e + 2.
+    for (size_t i = 0; i < 2; ++i)
+    {
+        uint64_t epoch = m_epoch.load();
+        if (0 != readers((epoch + 1) & 1))
+        {
+            break;
+        }
+        m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+    }
+    uint64_t epoch = m_epoch.load();
+    std::vector<concurrent_node_base *> released;
+    size_t kept = 0;
+    for (size_t i = 0; i < m_retired.size(); ++i)
+    {
+        if (force || m_retired[i].epoch + 2 <= epoch)
+        {
+            delete m_retired[i].old_snapshot;
+            released.insert(released.end(), m_retired[i].released.begin(), m_retired[i].released.end());
+        }
+        else
+        {
+            if (kept != i)
+            {
+                m_retired[kept] = std::move(m_retired[i]);
+            }
+            kept++;
+        }
+    }
+    m_retired.erase(m_retired.begin() + kept, m_retired.end());
+    return released;
+}
+
+void concurrent_signal_base::release(const std::vector<concurrent_node_base *>& nodes) noexcept
+{
+    for (auto node : nodes)
+    {
+        node->remove_reference();
+    }
+}
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
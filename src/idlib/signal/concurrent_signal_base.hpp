@@ -0,0 +1,166 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/concurrent_signal_base.hpp
+/// @brief Non-generic base class of all concurrent signals.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+// Forward declarations.
+struct concurrent_node_base;
+
+/// @internal
+/// @ingroup signal
+/// @brief Non-generic base class of any concurrent signal.
+/// @detail
+/// The nodes of a concurrent signal are kept in an immutable snapshot.
+/// Emitters (readers) never lock: they announce themselves in a reader counter of the current epoch,
+/// load the current snapshot, and iterate over it. Subscribers and disconnectors (writers) are
+/// serialized by a mutex: they publish a new snapshot and retire the old one.
+/// A retired snapshot is deleted (and the references it holds are released) once two epochs have
+/// passed, an epoch only advancing if no reader of the previous epoch is left. Writers never wait
+/// for readers hence slots may subscribe to and disconnect from the signal emitting them.
+struct concurrent_signal_base
+{
+protected:
+    /// @brief An immutable snapshot of the nodes of a signal.
+    struct snapshot
+    {
+        std::vector<concurrent_node_base *> nodes;
+    };
+
+    /// @brief Scoped read-side access to the current snapshot.
+    struct read_guard
+    {
+    private:
+        std::atomic<size_t> *m_readers;
+        const snapshot *m_snapshot;
+    public:
+        read_guard(const read_guard&) = delete; // Do not allow copying.
+        const read_guard& operator=(const read_guard&) = delete; // Do not allow copying.
+        explicit read_guard(concurrent_signal_base& signal) noexcept
+            : m_readers(signal.enter()), m_snapshot(signal.m_snapshot.load(std::memory_order_seq_cst))
+        {}
+        ~read_guard() noexcept
+        {
+            m_readers->fetch_sub(1, std::memory_order_seq_cst);
+        }
+        const snapshot *operator->() const noexcept
+        {
+            return m_snapshot;
+        }
+    }; // struct read_guard
+
+    /// @brief Add a node to this signal.
+    /// @param node the node
+    /// @pre The node is connected, its signal is this signal, and one reference of the node is owned by the caller.
+    /// @post The reference is owned by this signal.
+    void insert(concurrent_node_base *node);
+
+public:
+    concurrent_signal_base(const concurrent_signal_base&) = delete; // Do not allow copying.
+    const concurrent_signal_base& operator=(const concurrent_signal_base&) = delete; // Do not allow copying.
+
+    /// @brief Default construct this concurrent signal base.
+    concurrent_signal_base();
+
+    /// @brief Destruct this concurrent signal base.
+    /// Disconnects all nodes.
+    /// @pre No emission, subscription or disconnection is in progress.
+    virtual ~concurrent_signal_base() noexcept;
+
+    /// @brief Remove a node from this signal.
+    /// @param node the node
+    /// @remark If the node is not a node of this signal, then this call is a no-op.
+    void erase(concurrent_node_base *node) noexcept;
+
+    /// @brief Disconnect all nodes.
+    void disconnect_all() noexcept;
+
+private:
+    /// @brief A retired snapshot and the references released with it.
+    struct retired
+    {
+        const snapshot *old_snapshot;
+        std::vector<concurrent_node_base *> released;
+        uint64_t epoch;
+    };
+
+    /// @brief The number of reader stripes.
+    /// Readers are spread over stripes (on separate cache lines) to avoid contention on a single counter.
+    static constexpr size_t number_of_stripes = 16;
+
+    /// @brief A stripe of reader counters, one for each epoch parity.
+    struct alignas(64) stripe
+    {
+        std::atomic<size_t> readers[2];
+    };
+
+    /// @brief The reader counters.
+    stripe m_stripes[number_of_stripes];
+    /// @brief The epoch.
+    std::atomic<uint64_t> m_epoch;
+    /// @brief The current snapshot. Never a null pointer.
+    std::atomic<const snapshot *> m_snapshot;
+    /// @brief Serializes writers.
+    std::mutex m_mutex;
+    /// @brief The retired snapshots.
+    std::vector<retired> m_retired;
+
+    /// @brief Get the stripe index of the calling thread.
+    static size_t stripe_index() noexcept;
+
+    /// @brief Register a reader in the current epoch.
+    /// @return the reader counter the reader was registered in
+    std::atomic<size_t> *enter() noexcept;
+
+    /// @brief Get the number of readers registered in epochs of the given parity.
+    size_t readers(size_t parity) const noexcept;
+
+    /// @brief Publish a new snapshot and retire the current snapshot.
+    /// @param new_snapshot the new snapshot
+    /// @param released the references released when the current snapshot is deleted
+    /// @return the references which can be released now
+    /// @pre The mutex is locked.
+    std::vector<concurrent_node_base *> publish(const snapshot *new_snapshot, std::vector<concurrent_node_base *> released);
+
+    /// @brief Advance the epoch and delete retired snapshots if possible.
+    /// @param force if @a true, all retired snapshots are deleted regardless of readers
+    /// @return the references which can be released now
+    /// @pre The mutex is locked.
+    std::vector<concurrent_node_base *> reclaim(bool force);
+
+    /// @brief Release references.
+    /// @pre The mutex is not locked.
+    static void release(const std::vector<concurrent_node_base *>& nodes) noexcept;
+
+}; // struct concurrent_signal_base
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
@@ -126,6 +126,11 @@ void connection_base::reset()
     node = nullptr;
 }
 
+bool connection_base::is_blocked() const
+{
+    return is_connected() && 0 != node->number_of_blocks;
+}
+
 void connection_base::disconnect()
 {
     if (node)
@@ -150,7 +155,8 @@ void connection_base::disconnect()
                 }
             }
         }
-        node = nullptr;
+        // Release our reference to the node.
+        reset();
     }
 }
 
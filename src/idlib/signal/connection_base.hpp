@@ -72,6 +72,10 @@ struct connection_base
     /// @brief Disconnect this connection.
     void disconnect();
 
+    /// @brief Get if this connection is blocked.
+    /// @return @a true if this connection is connected and blocked, @a false otherwise
+    bool is_blocked() const;
+
 private:
     void reset();
 
@@ -0,0 +1,128 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/connection_group.cpp
+/// @brief A group of connections.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/connection_group.hpp"
+#include "idlib/signal/node_base.hpp"
+#include "idlib/signal/signal_base.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+connection_group::connection_group() noexcept
+    : m_connections(), m_blocked(false)
+{}
+
+connection_group::~connection_group()
+{
+    disconnect_all();
+}
+
+void connection_group::add(const connection& connection)
+{
+    m_connections.push_back(connection);
+    if (m_blocked && nullptr != connection.node)
+    {
+        connection.node->number_of_blocks++;
+    }
+}
+
+size_t connection_group::size() const noexcept
+{
+    return m_connections.size();
+}
+
+bool connection_group::empty() const noexcept
+{
+    return m_connections.empty();
+}
+
+void connection_group::disconnect_all() noexcept
+{
+    unblock_all();
+    // (1) Disconnect the nodes. Mark the signals, which are not running, as running such that they are not swept.
+    std::vector<internal::signal_base *> signals;
+    for (auto& connection : m_connections)
+    {
+        internal::node_base *node = connection.node;
+        if (nullptr == node || node->is_disconnected())
+        {
+            continue;
+        }
+        node->disconnect();
+        internal::signal_base *signal = node->signal;
+        if (nullptr != signal)
+        {
+            signal->connected_count--;
+            signal->disconnected_count++;
+            if (!signal->running)
+            {
+                signal->running = true;
+                signals.push_back(signal);
+            }
+        }
+    }
+    // (2) Release the references to the nodes.
+    m_connections.clear();
+    // (3) Sweep each signal once.
+    for (auto *signal : signals)
+    {
+        signal->sweep();
+        signal->running = false;
+    }
+}
+
+void connection_group::block_all() noexcept
+{
+    if (!m_blocked)
+    {
+        for (auto& connection : m_connections)
+        {
+            if (nullptr != connection.node)
+            {
+                connection.node->number_of_blocks++;
+            }
+        }
+        m_blocked = true;
+    }
+}
+
+void connection_group::unblock_all() noexcept
+{
+    if (m_blocked)
+    {
+        for (auto& connection : m_connections)
+        {
+            if (nullptr != connection.node)
+            {
+                connection.node->number_of_blocks--;
+            }
+        }
+        m_blocked = false;
+    }
+}
+
+bool connection_group::is_blocked() const noexcept
+{
+    return m_blocked;
+}
+
+#include "idlib/signal/internal/footer.hpp"
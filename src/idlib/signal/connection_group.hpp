@@ -0,0 +1,102 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/connection_group.hpp
+/// @brief A group of connections.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/connection.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+/// @ingroup signal
+/// @brief A group of connections.
+/// @detail
+/// A connection group owns connections (to slots of possibly different signals) and manages them in bulk.
+/// Disconnecting all connections of the group sweeps each affected signal once, after all connections were
+/// disconnected, rather than once per connection. Blocking all connections of the group does not sweep at all.
+/// The connections are disconnected when the group is destroyed.
+/// @remark Non-copyable.
+class connection_group
+{
+private:
+    /// @brief The connections.
+    std::vector<connection> m_connections;
+    /// @brief If the connections of this group are blocked by this group.
+    bool m_blocked;
+
+public:
+    connection_group(const connection_group&) = delete; // Do not allow copying.
+    const connection_group& operator=(const connection_group&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this connection group.
+    /// @post The group is empty and not blocked.
+    connection_group() noexcept;
+
+    /// @brief Destruct this connection group.
+    /// Disconnects all connections of this group.
+    ~connection_group();
+
+public:
+    /// @brief Add a connection to this group.
+    /// @param connection the connection
+    /// @remark If this group is blocked, then the connection is blocked.
+    void add(const connection& connection);
+
+    /// @brief Add a connection to this group.
+    /// @param connection the connection
+    /// @return this group
+    connection_group& operator+=(const connection& connection)
+    {
+        add(connection);
+        return *this;
+    }
+
+    /// @brief Get the number of connections of this group.
+    /// @return the number of connections of this group
+    size_t size() const noexcept;
+
+    /// @brief Get if this group is empty.
+    /// @return @a true if this group is empty, @a false otherwise
+    bool empty() const noexcept;
+
+    /// @brief Disconnect all connections of this group and remove them from this group.
+    /// @post The group is empty and not blocked.
+    void disconnect_all() noexcept;
+
+    /// @brief Block all connections of this group.
+    /// @remark If this group is already blocked, then this function is a no-op.
+    void block_all() noexcept;
+
+    /// @brief Unblock all connections of this group.
+    /// @remark If this group is not blocked, then this function is a no-op.
+    void unblock_all() noexcept;
+
+    /// @brief Get if the connections of this group are blocked by this group.
+    /// @return @a true if the connections of this group are blocked by this group, @a false otherwise
+    bool is_blocked() const noexcept;
+
+}; // class connection_group
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,112 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dense_connection.cpp
+/// @brief A connection of a dense signal.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/dense_connection.hpp"
+#include "idlib/signal/dense_signal_base.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+dense_connection::dense_connection()
+    : control(nullptr), index(0), generation(0)
+{}
+
+dense_connection::dense_connection(internal::dense_signal_control *control, uint32_t index, uint32_t generation)
+    : control(control), index(index), generation(generation)
+{
+    if (control)
+    {
+        control->add_reference();
+    }
+}
+
+dense_connection::dense_connection(const dense_connection& other)
+    : control(other.control), index(other.index), generation(other.generation)
+{
+    if (control)
+    {
+        control->add_reference();
+    }
+}
+
+dense_connection::~dense_connection()
+{
+    reset();
+}
+
+const dense_connection& dense_connection::operator=(const dense_connection& other)
+{
+    if (&other != this)
+    {
+        reset();
+        control = other.control;
+        index = other.index;
+        generation = other.generation;
+        if (control)
+        {
+            control->add_reference();
+        }
+    }
+    return *this;
+}
+
+bool dense_connection::operator==(const dense_connection& other) const
+{
+    return control == other.control && index == other.index && generation == other.generation;
+}
+
+bool dense_connection::operator!=(const dense_connection& other) const
+{
+    return !(*this == other);
+}
+
+bool dense_connection::is_connected() const
+{
+    if (control && control->signal)
+    {
+        return control->signal->is_connected(index, generation);
+    }
+    return false;
+}
+
+void dense_connection::reset()
+{
+    if (control)
+    {
+        control->remove_reference();
+        control = nullptr;
+    }
+}
+
+void dense_connection::disconnect()
+{
+    if (control)
+    {
+        if (control->signal)
+        {
+            control->signal->disconnect(index, generation);
+        }
+        reset();
+    }
+}
+
+#include "idlib/signal/internal/footer.hpp"
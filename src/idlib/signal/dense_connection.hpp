@@ -0,0 +1,87 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dense_connection.hpp
+/// @brief A connection of a dense signal.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+// Forward declaration.
+struct dense_signal_control;
+} // namespace internal
+
+/// @ingroup signal
+/// @brief A connection of a dense signal.
+/// @remark A dense connection refers to its slot by an index and a generation.
+/// If the slot is removed, then the generation of the index changes and the connection becomes disconnected.
+struct dense_connection
+{
+private:
+    /// @brief A pointer to the control block of the signal.
+    internal::dense_signal_control *control;
+    /// @brief The index of the entry of the slot.
+    uint32_t index;
+    /// @brief The generation of the slot.
+    uint32_t generation;
+
+public:
+    /// @brief Default construct this connection.
+    /// @post This connection is not connected.
+    dense_connection();
+
+    /// @brief Construct this connection with the specified arguments.
+    /// @param control a pointer to the control block of the signal
+    /// @param index the index of the entry of the slot
+    /// @param generation the generation of the slot
+    dense_connection(internal::dense_signal_control *control, uint32_t index, uint32_t generation);
+
+    /// @brief Copy construct this connection with the values of another connection.
+    /// @param other the other connection
+    dense_connection(const dense_connection& other);
+
+    /// @brief Destruct this connection.
+    ~dense_connection();
+
+    const dense_connection& operator=(const dense_connection& other);
+
+    bool operator==(const dense_connection& other) const;
+
+    bool operator!=(const dense_connection& other) const;
+
+    /// @brief Get if the connection is connected.
+    /// @return @a true if this connection is connected, @a false otherwise
+    bool is_connected() const;
+
+    /// @brief Disconnect this connection.
+    void disconnect();
+
+private:
+    void reset();
+
+}; // struct dense_connection
+
+#include "idlib/signal/internal/footer.hpp"
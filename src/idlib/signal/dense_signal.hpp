@@ -0,0 +1,187 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dense_signal.hpp
+/// @detail Signal-slot implementation with contiguous slot storage.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/dense_connection.hpp"
+#include "idlib/signal/dense_signal_base.hpp"
+#include "idlib/signal/inline_function.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+// Forward declarations.
+template <class> struct dense_signal;
+
+/// @ingroup signal
+/// @brief Generic signal storing its slots in contiguous memory.
+/// @detail
+/// In contrast to id::signal, which allocates a node per slot and walks a linked list of nodes,
+/// a dense signal keeps its slots in a slot map such that an emission is a linear scan over an array.
+/// The order in which slots are invoked is unspecified.
+/// Like id::signal, a dense signal provides single-thread re-entrancy: slots may subscribe to,
+/// disconnect from, and emit the signal emitting them. Slots subscribed during an emission are
+/// first invoked by the next emission.
+/// @tparam ReturnType the return type
+/// @tparam ... ParameterTypes the parameter types
+/// @remark Non-copyable.
+template <class ReturnType, class ... ParameterTypes>
+struct dense_signal<ReturnType(ParameterTypes ...)> : internal::dense_signal_base
+{
+public:
+    /// @brief The function type.
+    using function_type = inline_function<ReturnType(ParameterTypes ...)>;
+
+private:
+    /// @brief Dense array: the functions of the slots.
+    std::vector<function_type> m_functions;
+    /// @brief The functions of the slots subscribed during an emission.
+    /// Those are appended to the dense array once no emission is in progress.
+    std::vector<function_type> m_pending_functions;
+
+public:
+    dense_signal(const dense_signal&) = delete; // Do not allow copying.
+    const dense_signal& operator=(const dense_signal&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this dense signal.
+    dense_signal() noexcept : dense_signal_base() {}
+
+    /// @brief Destruct this dense signal.
+    /// Disconnects all subscribers.
+    ~dense_signal() noexcept
+    {
+        disconnect_all();
+    }
+
+public:
+    /// @brief Subscribe to this dense signal.
+    /// @param function a non-empty function
+    /// @return the connection
+    template <class Function>
+    dense_connection subscribe(Function&& function)
+    {
+        return add(function_type(std::forward<Function>(function)));
+    }
+
+    /// @brief Subscribe a member function of an object to this dense signal.
+    /// @param object a pointer to the object
+    /// @param method the member function
+    /// @return the connection
+    template <class Object, class Method>
+    dense_connection subscribe(Object *object, Method method)
+    {
+        return add(function_type(object, method));
+    }
+
+    /// @brief Get the number of slots (including disconnected slots not swept yet).
+    /// @return the number of slots
+    size_t size() const noexcept
+    {
+        return m_indices.size();
+    }
+
+public:
+    /// @brief Notify all subscribers.
+    /// @param arguments the arguments
+    /// @remark
+    /// Iterate over the dense array of slots. If a slot is connected, then it is invoked.
+    void operator()(ParameterTypes ... arguments)
+    {
+        m_running++;
+        try
+        {
+            for (size_t i = 0, n = m_functions.size(); i < n; ++i)
+            {
+                if (m_connected[i])
+                {
+                    m_functions[i](static_cast<internal::emission_argument_t<ParameterTypes>>(arguments) ...);
+                }
+            }
+        }
+        catch (...)
+        {
+            finish_emission();
+            std::rethrow_exception(std::current_exception());
+        }
+        finish_emission();
+    }
+
+protected:
+    void move_slot(size_t from, size_t to) noexcept override
+    {
+        m_functions[to] = std::move(m_functions[from]);
+    }
+
+    void pop_slot() noexcept override
+    {
+        m_functions.pop_back();
+    }
+
+private:
+    /// @brief Add a slot to this dense signal.
+    /// @param function the function of the slot
+    /// @return the connection
+    dense_connection add(function_type&& function)
+    {
+        internal::dense_signal_control *control = this->control();
+        // Reserve space for the function first: if this fails, then nothing is modified.
+        std::vector<function_type>& functions = (0 == m_running) ? m_functions : m_pending_functions;
+        grow(functions, functions.size() + 1);
+        uint32_t index = allocate();
+        functions.push_back(std::move(function));
+        return dense_connection(control, index, m_entries[index].generation);
+    }
+
+    /// @brief Ensure the capacity of a vector of functions is at least the specified size.
+    /// The capacity grows geometrically such that adding slots one at a time takes amortized constant time.
+    /// @param functions the vector of functions
+    /// @param size the size
+    static void grow(std::vector<function_type>& functions, size_t size)
+    {
+        if (functions.capacity() < size)
+        {
+            functions.reserve(std::max(2 * functions.capacity(), size));
+        }
+    }
+
+    /// @brief Finish an emission.
+    /// If this was the outermost emission, then append pending slots and sweep.
+    void finish_emission()
+    {
+        if (0 == --m_running)
+        {
+            grow(m_functions, m_functions.size() + m_pending_functions.size());
+            for (auto& function : m_pending_functions)
+            {
+                m_functions.push_back(std::move(function));
+            }
+            m_pending_functions.clear();
+            maybe_sweep();
+        }
+    }
+
+}; // struct dense_signal
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,159 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dense_signal_base.cpp
+/// @brief Non-generic base class of all dense signals.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/dense_signal_base.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+void dense_signal_control::add_reference()
+{
+    number_of_references++;
+}
+
+void dense_signal_control::remove_reference()
+{
+    if (0 == --number_of_references)
+    {
+        delete this;
+    }
+}
+
+dense_signal_base::dense_signal_base() noexcept
+    : m_entries(), m_free_entries(), m_indices(), m_connected(), m_control(nullptr), m_running(0), m_disconnected_count(0)
+{}
+
+dense_signal_base::~dense_signal_base() noexcept
+{
+    // The slot data of the derived class is already destroyed.
+    if (m_control)
+    {
+        m_control->signal = nullptr;
+        m_control->remove_reference();
+        m_control = nullptr;
+    }
+}
+
+dense_signal_control *dense_signal_base::control()
+{
+    if (!m_control)
+    {
+        m_control = new dense_signal_control{ this, 1 };
+    }
+    return m_control;
+}
+
+uint32_t dense_signal_base::allocate()
+{
+    uint32_t index;
+    if (!m_free_entries.empty())
+    {
+        index = m_free_entries.back();
+        m_free_entries.pop_back();
+    }
+    else
+    {
+        m_entries.push_back({ 0, 0 });
+        index = static_cast<uint32_t>(m_entries.size() - 1);
+    }
+    m_entries[index].position = static_cast<uint32_t>(m_indices.size());
+    m_indices.push_back(index);
+    m_connected.push_back(1);
+    return index;
+}
+
+bool dense_signal_base::is_connected(uint32_t index, uint32_t generation) const noexcept
+{
+    if (index >= m_entries.size() || m_entries[index].generation != generation)
+    {
+        return false;
+    }
+    return 0 != m_connected[m_entries[index].position];
+}
+
+void dense_signal_base::disconnect(uint32_t index, uint32_t generation) noexcept
+{
+    if (!is_connected(index, generation))
+    {
+        return;
+    }
+    m_connected[m_entries[index].position] = 0;
+    m_disconnected_count++;
+    maybe_sweep();
+}
+
+void dense_signal_base::disconnect_all() noexcept
+{
+    for (size_t i = 0, n = m_connected.size(); i < n; ++i)
+    {
+        if (m_connected[i])
+        {
+            m_connected[i] = 0;
+            m_disconnected_count++;
+        }
+    }
+    maybe_sweep();
+}
+
+void dense_signal_base::maybe_sweep() noexcept
+{
+    if (0 == m_running && 0 < m_disconnected_count)
+    {
+        sweep();
+    }
+}
+
+void dense_signal_base::sweep() noexcept
+{
+    size_t position = 0;
+    while (position < m_indices.size())
+    {
+        if (m_connected[position])
+        {
+            position++;
+            continue;
+        }
+        // Invalidate the connections of the slot and free the entry.
+        uint32_t index = m_indices[position];
+        m_entries[index].generation++;
+        m_free_entries.push_back(index);
+        // Move the last slot into the gap.
+        size_t last = m_indices.size() - 1;
+        if (position != last)
+        {
+            m_indices[position] = m_indices[last];
+            m_connected[position] = m_connected[last];
+            m_entries[m_indices[position]].position = static_cast<uint32_t>(position);
+            move_slot(last, position);
+        }
+        m_indices.pop_back();
+        m_connected.pop_back();
+        pop_slot();
+        m_disconnected_count--;
+    }
+}
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
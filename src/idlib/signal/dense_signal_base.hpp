@@ -0,0 +1,149 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dense_signal_base.hpp
+/// @brief Non-generic base class of all dense signals.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+// Forward declarations.
+struct dense_signal_base;
+
+/// @internal
+/// @ingroup signal
+/// @brief The control block shared by a dense signal and its connections.
+/// @remark The control block outlives the signal if connections outlive the signal.
+struct dense_signal_control
+{
+    /// @brief A pointer to the signal if the signal exists, a null pointer otherwise.
+    dense_signal_base *signal;
+    /// @brief The number of references to this control block.
+    int number_of_references;
+
+    /// @brief Add a reference to this control block.
+    void add_reference();
+
+    /// @brief Remove a reference from this control block.
+    /// If this was the last reference, then the control block is deleted.
+    void remove_reference();
+
+}; // struct dense_signal_control
+
+/// @internal
+/// @ingroup signal
+/// @brief Non-generic base class of any dense signal.
+/// @detail
+/// A dense signal stores its slots in a slot map: the slots are kept in contiguous arrays
+/// (the "dense" arrays) such that an emission is a linear scan over them. A connection refers
+/// to a slot by an index into a table of entries (the "sparse" array) and a generation. An entry
+/// stores the position of the slot in the dense arrays and the current generation of the entry.
+/// When a slot is removed, the last slot is moved to its position, and the generation of the
+/// entry is incremented, which invalidates all connections referring to the removed slot.
+struct dense_signal_base
+{
+protected:
+    /// @brief An entry of the sparse array.
+    struct entry
+    {
+        /// @brief The position of the slot in the dense arrays.
+        uint32_t position;
+        /// @brief The generation of this entry.
+        uint32_t generation;
+    };
+
+    /// @brief The entries.
+    std::vector<entry> m_entries;
+    /// @brief The indices of the free entries.
+    std::vector<uint32_t> m_free_entries;
+    /// @brief Dense array: the entry indices of the slots.
+    std::vector<uint32_t> m_indices;
+    /// @brief Dense array: non-zero if the slot is connected, zero otherwise.
+    std::vector<uint8_t> m_connected;
+    /// @brief The control block or a null pointer.
+    dense_signal_control *m_control;
+    /// @brief The number of emissions in progress.
+    size_t m_running;
+    /// @brief The number of disconnected slots.
+    size_t m_disconnected_count;
+
+    /// @brief Allocate an entry for a new slot.
+    /// The slot is appended to the dense arrays, a derived class must append its slot data as well.
+    /// @return the index of the entry
+    uint32_t allocate();
+
+    /// @brief Get the control block, create it if necessary.
+    /// @return the control block
+    dense_signal_control *control();
+
+    /// @brief Remove all dead slots if no emission is in progress.
+    void maybe_sweep() noexcept;
+
+    /// @brief Move the slot data of a derived class.
+    /// @param from the source position
+    /// @param to the target position
+    virtual void move_slot(size_t from, size_t to) noexcept = 0;
+
+    /// @brief Remove the last slot data of a derived class.
+    virtual void pop_slot() noexcept = 0;
+
+public:
+    dense_signal_base(const dense_signal_base&) = delete; // Do not allow copying.
+    const dense_signal_base& operator=(const dense_signal_base&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Default construct this dense signal base.
+    dense_signal_base() noexcept;
+
+    /// @brief Destruct this dense signal base.
+    /// Disconnects all slots.
+    virtual ~dense_signal_base() noexcept;
+
+    /// @brief Get if a slot is connected.
+    /// @param index the index of the entry of the slot
+    /// @param generation the generation of the slot
+    /// @return @a true if the slot is connected, @a false otherwise
+    bool is_connected(uint32_t index, uint32_t generation) const noexcept;
+
+    /// @brief Disconnect a slot.
+    /// @param index the index of the entry of the slot
+    /// @param generation the generation of the slot
+    void disconnect(uint32_t index, uint32_t generation) noexcept;
+
+    /// @brief Disconnect all slots.
+    void disconnect_all() noexcept;
+
+private:
+    /// @brief Remove all disconnected slots.
+    /// @pre No emission is in progress.
+    void sweep() noexcept;
+
+}; // struct dense_signal_base
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,88 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dispatcher.cpp
+/// @brief A dispatcher executing deferred tasks e.g. queued signal emissions in batches.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/dispatcher.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+dispatcher::dispatcher() noexcept
+    : m_queue(), m_size(0)
+{}
+
+dispatcher::~dispatcher()
+{
+    // Producers may still be completing a push, wait for them.
+    while (0 != m_size.load(std::memory_order_acquire))
+    {
+        mpsc_queue_hook *hook = m_queue.pop();
+        if (nullptr == hook)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        static_cast<internal::dispatcher_task *>(hook)->release();
+    }
+}
+
+void dispatcher::post(internal::dispatcher_task *task) noexcept
+{
+    m_size.fetch_add(1, std::memory_order_relaxed);
+    m_queue.push(task);
+}
+
+size_t dispatcher::dispatch(size_t maximum)
+{
+    // Only execute the tasks pending on entry: tasks posted by executed tasks are left to the next call.
+    maximum = std::min(maximum, m_size.load(std::memory_order_acquire));
+    size_t count = 0;
+    while (count < maximum)
+    {
+        mpsc_queue_hook *hook = m_queue.pop();
+        if (nullptr == hook)
+        {
+            break;
+        }
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        auto *task = static_cast<internal::dispatcher_task *>(hook);
+        count++;
+        try
+        {
+            task->invoke();
+        }
+        catch (...)
+        {
+            task->release();
+            std::rethrow_exception(std::current_exception());
+        }
+        task->release();
+    }
+    return count;
+}
+
+size_t dispatcher::size() const noexcept
+{
+    return m_size.load(std::memory_order_relaxed);
+}
+
+#include "idlib/signal/internal/footer.hpp"
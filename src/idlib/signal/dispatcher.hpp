@@ -0,0 +1,136 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/dispatcher.hpp
+/// @brief A dispatcher executing deferred tasks e.g. queued signal emissions in batches.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/concurrency/mpsc_queue.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace internal {
+
+/// @brief A task of an id::dispatcher.
+struct dispatcher_task : mpsc_queue_hook
+{
+    dispatcher_task() noexcept
+        : mpsc_queue_hook()
+    {}
+
+    virtual ~dispatcher_task()
+    {}
+
+    /// @brief Invoke this task.
+    virtual void invoke() = 0;
+
+    /// @brief Release this task.
+    /// @remark Invoked by the dispatcher after the task was invoked or if the task was discarded.
+    /// The default implementation deletes this task.
+    virtual void release() noexcept
+    {
+        delete this;
+    }
+
+}; // struct dispatcher_task
+
+/// @brief A dispatcher task wrapping a function.
+template <class Function>
+struct function_dispatcher_task : dispatcher_task
+{
+    Function function;
+
+    template <class Argument>
+    explicit function_dispatcher_task(Argument&& argument)
+        : dispatcher_task(), function(std::forward<Argument>(argument))
+    {}
+
+    void invoke() override
+    {
+        function();
+    }
+
+}; // struct function_dispatcher_task
+
+} // namespace internal
+
+/// @ingroup signal
+/// @brief A dispatcher.
+/// @detail
+/// Any thread may post tasks to a dispatcher. The tasks are executed in the order in which they were posted
+/// when the owning thread calls id::dispatcher::dispatch. Posting a task does not acquire a lock.
+/// @remark Non-copyable.
+class dispatcher
+{
+private:
+    /// @brief The queue of pending tasks.
+    mpsc_queue m_queue;
+
+    /// @brief The number of pending tasks.
+    std::atomic<size_t> m_size;
+
+public:
+    dispatcher(const dispatcher&) = delete; // Do not allow copying.
+    const dispatcher& operator=(const dispatcher&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this dispatcher.
+    dispatcher() noexcept;
+
+    /// @brief Destruct this dispatcher.
+    /// Pending tasks are released without being invoked.
+    ~dispatcher();
+
+public:
+    /// @brief Post a function.
+    /// @param function the function
+    /// @remark May be invoked by any thread.
+    template <class Function,
+              class = std::enable_if_t<!std::is_convertible<Function, internal::dispatcher_task *>::value>>
+    void post(Function&& function)
+    {
+        post(new internal::function_dispatcher_task<std::decay_t<Function>>(std::forward<Function>(function)));
+    }
+
+    /// @brief Post a task.
+    /// @param task a pointer to the task
+    /// @remark May be invoked by any thread. The dispatcher takes ownership of the task.
+    void post(internal::dispatcher_task *task) noexcept;
+
+    /// @brief Execute pending tasks.
+    /// @param maximum the maximum number of tasks to execute
+    /// @return the number of tasks executed
+    /// @remark Must only be invoked by one thread at a time.
+    /// At most the tasks pending when this call is entered are executed, tasks posted by tasks executed by this
+    /// call are left to the next call. Hence a task re-posting itself does not keep this call from returning.
+    /// If a task raises an exception, then the task is released and the exception is propagated.
+    size_t dispatch(size_t maximum = std::numeric_limits<size_t>::max());
+
+    /// @brief Get the number of pending tasks.
+    /// @return the number of pending tasks
+    size_t size() const noexcept;
+
+}; // class dispatcher
+
+#include "idlib/signal/internal/footer.hpp"
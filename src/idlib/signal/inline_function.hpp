@@ -0,0 +1,291 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/inline_function.hpp
+/// @brief A move-only callable wrapper storing its target inline.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+// Forward declaration.
+template <class Signature, size_t Capacity = 4 * sizeof(void *)>
+class inline_function;
+
+/// @ingroup signal
+/// @brief A move-only callable wrapper storing its target inline.
+/// @detail
+/// Unlike std::function, the target is stored in a buffer of @a Capacity Bytes inside the wrapper.
+/// Only targets which do not fit into that buffer (or which can not be moved without throwing) are
+/// allocated on the heap. The default capacity holds typical captures like @code{[this]} or
+/// @code{[this, id]} as well as bound member functions. An invocation is a single indirect call.
+/// @tparam ReturnType the return type
+/// @tparam ... ParameterTypes the parameter types
+/// @tparam Capacity the capacity, in Bytes, of the inline buffer
+template <class ReturnType, class ... ParameterTypes, size_t Capacity>
+class inline_function<ReturnType(ParameterTypes ...), Capacity>
+{
+private:
+    /// @brief The type of an invoker.
+    using invoke_type = ReturnType(*)(void *, ParameterTypes&& ...);
+
+    /// @brief The operations on a target.
+    enum class operation
+    {
+        /// Move-construct the target of the destination from the target of the source and destroy the target of the source.
+        move,
+        /// Destroy the target of the destination.
+        destroy,
+    };
+
+    /// @brief The type of a manager.
+    using manage_type = void(*)(operation, void *, void *) noexcept;
+
+    /// @brief A member function bound to an object.
+    template <class Object, class Method>
+    struct bound_member
+    {
+        Object *object;
+        Method method;
+        ReturnType operator()(ParameterTypes&& ... arguments) const
+        {
+            return (object->*method)(std::forward<ParameterTypes>(arguments) ...);
+        }
+    };
+
+    /// @brief Is a target of the specified type stored inline?
+    template <class Function>
+    struct is_inline
+    {
+        static constexpr bool value = sizeof(Function) <= Capacity
+                                   && alignof(std::max_align_t) % alignof(Function) == 0
+                                   && std::is_nothrow_move_constructible<Function>::value;
+    };
+
+    /// @brief The inline buffer.
+    alignas(std::max_align_t) mutable unsigned char m_storage[Capacity < sizeof(void *) ? sizeof(void *) : Capacity];
+    /// @brief The invoker or a null pointer if this function is empty.
+    invoke_type m_invoke;
+    /// @brief The manager or a null pointer if this function is empty.
+    manage_type m_manage;
+
+public:
+    /// @brief The capacity, in Bytes, of the inline buffer.
+    static constexpr size_t capacity = Capacity;
+
+    /// @brief Get if a target of the specified type is stored inline.
+    /// @tparam Function the type of the target
+    template <class Function>
+    static constexpr bool stores_inline()
+    {
+        return is_inline<std::decay_t<Function>>::value;
+    }
+
+public:
+    /// @brief Construct this function.
+    /// @post This function is empty.
+    inline_function() noexcept
+        : m_invoke(nullptr), m_manage(nullptr)
+    {}
+
+    /// @brief Construct this function.
+    /// @post This function is empty.
+    inline_function(std::nullptr_t) noexcept
+        : inline_function()
+    {}
+
+    /// @brief Construct this function from a callable.
+    /// @param function the callable
+    template <class Function,
+              class = std::enable_if_t<!std::is_same<std::decay_t<Function>, inline_function>::value>>
+    inline_function(Function&& function)
+        : inline_function()
+    {
+        emplace(std::forward<Function>(function));
+    }
+
+    /// @brief Construct this function from a member function and an object.
+    /// @param object a pointer to the object
+    /// @param method the member function
+    /// @remark Invoking this function invokes the member function on the object.
+    template <class Object>
+    inline_function(Object *object, ReturnType(Object::*method)(ParameterTypes ...))
+        : inline_function()
+    {
+        emplace(bound_member<Object, ReturnType(Object::*)(ParameterTypes ...)>{ object, method });
+    }
+
+    /// @brief Construct this function from a const member function and an object.
+    /// @param object a pointer to the object
+    /// @param method the const member function
+    /// @remark Invoking this function invokes the member function on the object.
+    template <class Object>
+    inline_function(const Object *object, ReturnType(Object::*method)(ParameterTypes ...) const)
+        : inline_function()
+    {
+        emplace(bound_member<const Object, ReturnType(Object::*)(ParameterTypes ...) const>{ object, method });
+    }
+
+    /// @brief Move-construct this function.
+    /// @param other the other function
+    /// @post The other function is empty.
+    inline_function(inline_function&& other) noexcept
+        : m_invoke(other.m_invoke), m_manage(other.m_manage)
+    {
+        if (m_manage)
+        {
+            m_manage(operation::move, m_storage, other.m_storage);
+            other.m_invoke = nullptr;
+            other.m_manage = nullptr;
+        }
+    }
+
+    /// @brief Move-assign this function.
+    /// @param other the other function
+    /// @post The other function is empty.
+    inline_function& operator=(inline_function&& other) noexcept
+    {
+        if (&other != this)
+        {
+            reset();
+            if (other.m_manage)
+            {
+                other.m_manage(operation::move, m_storage, other.m_storage);
+                m_invoke = other.m_invoke;
+                m_manage = other.m_manage;
+                other.m_invoke = nullptr;
+                other.m_manage = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    inline_function(const inline_function&) = delete; // Do not allow copying.
+    inline_function& operator=(const inline_function&) = delete; // Do not allow copying.
+
+    /// @brief Destruct this function.
+    ~inline_function() noexcept
+    {
+        reset();
+    }
+
+public:
+    /// @brief Get if this function is not empty.
+    /// @return @a true if this function is not empty, @a false otherwise
+    explicit operator bool() const noexcept
+    {
+        return nullptr != m_invoke;
+    }
+
+    /// @brief Invoke this function.
+    /// @param arguments (implied)
+    /// @return (implied)
+    /// @throw std::bad_function_call this function is empty
+    ReturnType operator()(ParameterTypes ... arguments) const
+    {
+        if (!m_invoke)
+        {
+            throw std::bad_function_call();
+        }
+        return m_invoke(m_storage, std::forward<ParameterTypes>(arguments) ...);
+    }
+
+    /// @brief Ensure this function is empty.
+    void reset() noexcept
+    {
+        if (m_manage)
+        {
+            m_manage(operation::destroy, m_storage, nullptr);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+    }
+
+private:
+    template <class Function>
+    std::enable_if_t<is_inline<std::decay_t<Function>>::value> emplace(Function&& function)
+    {
+        using target_type = std::decay_t<Function>;
+        ::new (static_cast<void *>(m_storage)) target_type(std::forward<Function>(function));
+        m_invoke = [](void *storage, ParameterTypes&& ... arguments) -> ReturnType
+        {
+            return (*static_cast<target_type *>(storage))(std::forward<ParameterTypes>(arguments) ...);
+        };
+        m_manage = [](operation op, void *target, void *source) noexcept
+        {
+            switch (op)
+            {
+                case operation::move:
+                    ::new (target) target_type(std::move(*static_cast<target_type *>(source)));
+                    static_cast<target_type *>(source)->~target_type();
+                    break;
+                case operation::destroy:
+                    static_cast<target_type *>(target)->~target_type();
+                    break;
+            };
+        };
+    }
+
+    template <class Function>
+    std::enable_if_t<!is_inline<std::decay_t<Function>>::value> emplace(Function&& function)
+    {
+        using target_type = std::decay_t<Function>;
+        // The target does not fit: store a pointer to a heap-allocated target.
+        target_type *pointer = new target_type(std::forward<Function>(function));
+        ::new (static_cast<void *>(m_storage)) target_type *(pointer);
+        m_invoke = [](void *storage, ParameterTypes&& ... arguments) -> ReturnType
+        {
+            return (**static_cast<target_type **>(storage))(std::forward<ParameterTypes>(arguments) ...);
+        };
+        m_manage = [](operation op, void *target, void *source) noexcept
+        {
+            switch (op)
+            {
+                case operation::move:
+                    *static_cast<target_type **>(target) = *static_cast<target_type **>(source);
+                    break;
+                case operation::destroy:
+                    delete *static_cast<target_type **>(target);
+                    break;
+            };
+        };
+    }
+
+}; // class inline_function
+
+namespace internal {
+
+/// @brief The type as which an emission passes an argument to each subscriber.
+/// @detail
+/// Reference parameters and parameters of move-only types are forwarded as declared. An argument of a move-only
+/// type is hence moved to the first subscriber taking it by value. Other by-value parameters are passed as lvalues
+/// such that each subscriber receives the same value.
+/// @tparam ParameterType the parameter type of the signal
+template <class ParameterType>
+using emission_argument_t = std::conditional_t<std::is_reference<ParameterType>::value || !std::is_copy_constructible<ParameterType>::value,
+                                               ParameterType&&, ParameterType&>;
+
+} // namespace internal
+
+#include "idlib/signal/internal/footer.hpp"
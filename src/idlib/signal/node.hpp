@@ -26,30 +26,39 @@
 #endif
 
 #include "idlib/signal/node_base.hpp"
+#include "idlib/signal/inline_function.hpp"
+#include "idlib/signal/node_allocator.hpp"
+#include "idlib/signal/signal_statistics.hpp"
 
 #include "idlib/signal/internal/header.hpp"
 
 namespace internal {
 
 // Forward declaration.
-template <class ReturnType, class ... ParameterTypes>
+template <class Signature, class Allocator = default_node_allocator>
 struct node;
 
 /// @ingroup signal
 /// @brief A generic node.
-template <class ReturnType, class ... ParameterTypes>
-struct node<ReturnType(ParameterTypes ...)> : internal::node_base
+/// @tparam Allocator the allocator providing the memory of the node
+template <class ReturnType, class ... ParameterTypes, class Allocator>
+struct node<ReturnType(ParameterTypes ...), Allocator> : internal::node_base
 {
 public:
     /// The node type.
-    using node_type = node<ReturnType(ParameterTypes ...)>;
+    using node_type = node<ReturnType(ParameterTypes ...), Allocator>;
     /// The function type.
-    using function_type = std::function<ReturnType(ParameterTypes ...)>;
+    using function_type = inline_function<ReturnType(ParameterTypes ...)>;
 
 public:
     /// The function.
     function_type function;
 
+#if defined(ID_SIGNAL_PROFILING)
+    /// The statistics of this node.
+    slot_statistics statistics;
+#endif
+
 public:
     node(const node_type&) = delete; // Do not allow copying.
     const node_type& operator=(const node_type&) = delete; // Do not allow copying.
@@ -57,17 +66,33 @@ public:
 public:
     /// @brief Construct this node.
     /// @param number_of_references the initial number of references
-    /// @param function the function
-    explicit node(int number_of_references, const function_type& function)
-        : internal::node_base(number_of_references), function(function) {}
+    /// @param arguments the arguments to construct the function from
+    template <class ... ArgumentTypes>
+    explicit node(int number_of_references, ArgumentTypes&& ... arguments)
+        : internal::node_base(number_of_references), function(std::forward<ArgumentTypes>(arguments) ...) {}
+
+public:
+    // Nodes are deleted through pointers to node_base (which has a virtual destructor),
+    // hence the deallocation function of the dynamic type is invoked.
+    static void *operator new(size_t size)
+    {
+        return Allocator::allocate(size);
+    }
+
+    static void operator delete(void *pointer, size_t size) noexcept
+    {
+        Allocator::deallocate(pointer, size);
+    }
 
 public:
     /// @brief Invoke this node
     /// @param arguments (implied)
     /// @return (implied)
-    ReturnType operator()(ParameterTypes&& ... arguments)
+    /// @remark See id::internal::emission_argument_t for how an emission passes its arguments to the nodes.
+    template <class ... ArgumentTypes>
+    ReturnType operator()(ArgumentTypes&& ... arguments)
     {
-        return function(std::forward<ParameterTypes>(arguments) ...);
+        return function(std::forward<ArgumentTypes>(arguments) ...);
     }
 
 }; // struct node
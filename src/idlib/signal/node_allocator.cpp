@@ -0,0 +1,179 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/node_allocator.cpp
+/// @brief Allocators for the nodes of signals.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/node_allocator.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+namespace {
+
+/// @brief The granularity, in Bytes, of the size classes.
+constexpr size_t granularity = 16;
+/// @brief The number of size classes.
+constexpr size_t number_of_size_classes = 16;
+/// @brief The maximum number of blocks cached per size class and thread.
+constexpr size_t maximum_number_of_blocks = 4096;
+
+/// @brief A free block.
+struct free_block
+{
+    free_block *next;
+};
+
+/// @brief The free lists of a thread.
+struct thread_cache
+{
+    free_block *heads[number_of_size_classes];
+    size_t counts[number_of_size_classes];
+    thread_cache();
+    ~thread_cache();
+    void trim() noexcept;
+};
+
+std::atomic<size_t> g_live_nodes(0);
+std::atomic<size_t> g_pooled_nodes(0);
+std::atomic<size_t> g_allocations_avoided(0);
+
+/// @brief The state of the cache of a thread.
+/// 0 if not constructed, 1 if constructed, 2 if destructed.
+/// Trivially destructible, hence it can be queried while thread-local objects are destroyed.
+thread_local int t_cache_state = 0;
+
+thread_cache::thread_cache()
+{
+    for (size_t i = 0; i < number_of_size_classes; ++i)
+    {
+        heads[i] = nullptr;
+        counts[i] = 0;
+    }
+    t_cache_state = 1;
+}
+
+thread_cache::~thread_cache()
+{
+    trim();
+    t_cache_state = 2;
+}
+
+void thread_cache::trim() noexcept
+{
+    for (size_t i = 0; i < number_of_size_classes; ++i)
+    {
+        while (heads[i])
+        {
+            free_block *block = heads[i];
+            heads[i] = block->next;
+            ::operator delete(block);
+        }
+        g_pooled_nodes.fetch_sub(counts[i], std::memory_order_relaxed);
+        counts[i] = 0;
+    }
+}
+
+/// @brief Get the cache of the calling thread.
+/// @return a pointer to the cache of the calling thread, a null pointer if it was already destroyed
+thread_cache *get_thread_cache()
+{
+    if (2 == t_cache_state)
+    {
+        return nullptr;
+    }
+    thread_local thread_cache cache;
+    return &cache;
+}
+
+/// @brief Get the size class of a size.
+/// @return the size class, number_of_size_classes if the size exceeds the largest size class
+size_t get_size_class(size_t size)
+{
+    size_t size_class = (size + granularity - 1) / granularity;
+    return (0 == size_class) ? 0 : std::min(size_class - 1, number_of_size_classes);
+}
+
+} // namespace
+
+void *pooled_node_allocator::allocate(size_t size)
+{
+    size_t size_class = get_size_class(size);
+    if (size_class < number_of_size_classes)
+    {
+        thread_cache *cache = get_thread_cache();
+        if (cache && cache->heads[size_class])
+        {
+            free_block *block = cache->heads[size_class];
+            cache->heads[size_class] = block->next;
+            cache->counts[size_class]--;
+            g_pooled_nodes.fetch_sub(1, std::memory_order_relaxed);
+            g_allocations_avoided.fetch_add(1, std::memory_order_relaxed);
+            g_live_nodes.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+        // Allocate the full size class such that the block can be reused for any size of that class.
+        size = (size_class + 1) * granularity;
+    }
+    void *pointer = ::operator new(size);
+    g_live_nodes.fetch_add(1, std::memory_order_relaxed);
+    return pointer;
+}
+
+void pooled_node_allocator::deallocate(void *pointer, size_t size) noexcept
+{
+    if (!pointer)
+    {
+        return;
+    }
+    g_live_nodes.fetch_sub(1, std::memory_order_relaxed);
+    size_t size_class = get_size_class(size);
+    if (size_class < number_of_size_classes)
+    {
+        thread_cache *cache = get_thread_cache();
+        if (cache && cache->counts[size_class] < maximum_number_of_blocks)
+        {
+            free_block *block = static_cast<free_block *>(pointer);
+            block->next = cache->heads[size_class];
+            cache->heads[size_class] = block;
+            cache->counts[size_class]++;
+            g_pooled_nodes.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    ::operator delete(pointer);
+}
+
+node_pool_statistics pooled_node_allocator::statistics() noexcept
+{
+    return node_pool_statistics{ g_live_nodes.load(std::memory_order_relaxed),
+                                 g_pooled_nodes.load(std::memory_order_relaxed),
+                                 g_allocations_avoided.load(std::memory_order_relaxed) };
+}
+
+void pooled_node_allocator::trim() noexcept
+{
+    thread_cache *cache = get_thread_cache();
+    if (cache)
+    {
+        cache->trim();
+    }
+}
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,101 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/node_allocator.hpp
+/// @brief Allocators for the nodes of signals.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/utility/platform.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+/// @ingroup signal
+/// @brief The default node allocator.
+/// Nodes are allocated by the global operator new and deallocated by the global sized operator delete.
+struct default_node_allocator
+{
+    /// @brief Allocate memory for a node.
+    /// @param size the size, in Bytes, of the node
+    /// @return a pointer to the memory
+    /// @throw std::bad_alloc an out of memory situation occurred
+    static void *allocate(size_t size)
+    {
+        return ::operator new(size);
+    }
+
+    /// @brief Deallocate memory of a node.
+    /// @param pointer a pointer to the memory
+    /// @param size the size, in Bytes, of the node
+    static void deallocate(void *pointer, size_t size) noexcept
+    {
+        ::operator delete(pointer, size);
+    }
+
+}; // struct default_node_allocator
+
+/// @ingroup signal
+/// @brief Statistics of the pooled node allocator.
+struct node_pool_statistics
+{
+    /// @brief The number of nodes currently allocated.
+    size_t live_nodes;
+    /// @brief The number of free node blocks currently cached by the pools of all threads.
+    size_t pooled_nodes;
+    /// @brief The number of allocations served from a pool instead of the global operator new.
+    size_t allocations_avoided;
+};
+
+/// @ingroup signal
+/// @brief A node allocator caching freed nodes in per-thread free lists.
+/// @detail
+/// Node memory is rounded up to size classes of 16 Bytes. A freed node is put on the free list of its size class
+/// of the deallocating thread, and an allocation first tries the free list of the allocating thread. The free lists
+/// are bounded, excess blocks and blocks larger than the largest size class go to the global operator delete.
+/// Use it as in
+/// @code
+/// id::signal<void(int), id::pooled_node_allocator> signal;
+/// @endcode
+/// if connections churn at a high rate.
+struct pooled_node_allocator
+{
+    /// @brief Allocate memory for a node.
+    /// @param size the size, in Bytes, of the node
+    /// @return a pointer to the memory
+    /// @throw std::bad_alloc an out of memory situation occurred
+    static void *allocate(size_t size);
+
+    /// @brief Deallocate memory of a node.
+    /// @param pointer a pointer to the memory
+    /// @param size the size, in Bytes, of the node
+    static void deallocate(void *pointer, size_t size) noexcept;
+
+    /// @brief Get the statistics of this allocator.
+    /// @return the statistics of this allocator (accumulated over all threads)
+    static node_pool_statistics statistics() noexcept;
+
+    /// @brief Release the free node blocks cached by the calling thread.
+    static void trim() noexcept;
+
+}; // struct pooled_node_allocator
+
+#include "idlib/signal/internal/footer.hpp"
@@ -28,7 +28,8 @@
 namespace internal {
 
 node_base::node_base(int number_of_references)
-    : state(state::disconnected), signal(nullptr), number_of_references(number_of_references), next(nullptr)
+    : signal(nullptr), next(nullptr), state(state::disconnected), group(0), group_state(nullptr), number_of_blocks(0),
+      number_of_references(number_of_references)
 {}
 
 node_base::~node_base() {}
@@ -35,6 +35,18 @@ namespace internal {
 struct node_base;
 struct signal_base;
 
+/// @internal
+/// @ingroup signal
+/// @brief The state of a group of nodes of a signal.
+/// Enabling or disabling a group does not touch its nodes.
+struct slot_group_state
+{
+    /// The group.
+    int group;
+    /// @a true if the nodes of the group are invoked, @a false otherwise.
+    bool enabled;
+};
+
 /// @internal
 /// @ingroup signal
 /// Non-generic base class of any node.
@@ -55,13 +67,20 @@ struct node_base
     node_base *next;
     /// The state of the relation of the signal and the slot.
     state state;
+    /// The group of this node. Nodes are ordered by ascending group.
+    int group;
+    /// A pointer to the state of the group if this node is added to a signal, a null pointer otherwise.
+    slot_group_state *group_state;
+    /// The number of blocks of this node. The node is not invoked if this is not @a 0.
+    int number_of_blocks;
 
     node_base(const node_base&) = delete; // Do not allow copying.
     const node_base& operator=(const node_base&) = delete; // Do not allow copying.
 
     /// @brief Construct this node.
     /// @param numberOfReferences the initial number of references of this node
-    /// @post signal = nullptr, next = nullptr, state = State::Disconnected
+    /// @post signal = nullptr, next = nullptr, state = State::Disconnected, group = 0, group_state = nullptr,
+    /// number_of_blocks = 0
     node_base(int numberOfReferences);
 
     /// @brief Virtual destructor.
@@ -91,6 +110,12 @@ public:
     {
         return !is_connected();
     }
+    /// @brief Get if this node is connected, not blocked, and its group is enabled.
+    /// @return @a true if this node is connected, not blocked, and its group is enabled, @a false otherwise
+    bool is_active() const
+    {
+        return is_connected() && 0 == number_of_blocks && (nullptr == group_state || group_state->enabled);
+    }
 public:
     int number_of_references;
 
@@ -0,0 +1,253 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/queued_signal.hpp
+/// @brief A signal whose emissions are queued and delivered by an id::dispatcher.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/dispatcher.hpp"
+#include "idlib/signal/signal.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+// Forward declarations.
+template <class Signature> struct queued_signal;
+
+namespace internal {
+
+/// @brief The state of an id::queued_signal shared with its pending emissions.
+/// @detail
+/// The state is reference counted. The queued signal holds one reference and each pending task holds one reference.
+/// The pointer to the signal is only accessed by the dispatching thread.
+template <class ... ParameterTypes>
+struct queued_signal_state
+{
+    using signal_type = id::signal<void(ParameterTypes ...)>;
+
+    /// @brief A pending emission.
+    struct emission_task : dispatcher_task
+    {
+        queued_signal_state *state;
+        std::tuple<std::decay_t<ParameterTypes> ...> arguments;
+
+        template <class ... ArgumentTypes>
+        emission_task(queued_signal_state *state, ArgumentTypes&& ... arguments)
+            : dispatcher_task(), state(state), arguments(std::forward<ArgumentTypes>(arguments) ...)
+        {
+            state->add_reference();
+        }
+
+        ~emission_task()
+        {
+            state->remove_reference();
+        }
+
+        void invoke() override
+        {
+            if (nullptr != state->signal)
+            {
+                std::apply(*state->signal, std::move(arguments));
+            }
+        }
+
+    }; // struct emission_task
+
+    /// @brief The task delivering the latest coalesced emission.
+    struct drain_task : dispatcher_task
+    {
+        queued_signal_state *state;
+
+        drain_task(queued_signal_state *state) noexcept
+            : dispatcher_task(), state(state)
+        {}
+
+        void invoke() override
+        {
+            std::unique_ptr<emission_task> task(state->latest.exchange(nullptr, std::memory_order_acq_rel));
+            if (task)
+            {
+                task->invoke();
+            }
+        }
+
+        void release() noexcept override
+        {
+            state->remove_reference();
+        }
+
+    }; // struct drain_task
+
+    /// @brief The reference count.
+    std::atomic<size_t> references;
+    /// @brief The dispatcher.
+    dispatcher *target;
+    /// @brief A pointer to the signal or a null pointer if the queued signal was destroyed.
+    signal_type *signal;
+    /// @brief The latest coalesced emission or a null pointer.
+    std::atomic<emission_task *> latest;
+    /// @brief The drain task.
+    drain_task drain;
+
+    queued_signal_state(dispatcher *target, signal_type *signal) noexcept
+        : references(1), target(target), signal(signal), latest(nullptr), drain(this)
+    {}
+
+    ~queued_signal_state()
+    {
+        delete latest.load(std::memory_order_acquire);
+    }
+
+    void add_reference() noexcept
+    {
+        references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void remove_reference() noexcept
+    {
+        if (1 == references.fetch_sub(1, std::memory_order_acq_rel))
+        {
+            delete this;
+        }
+    }
+
+    /// @brief Enqueue an emission.
+    template <class ... ArgumentTypes>
+    void enqueue(bool coalesce, ArgumentTypes&& ... arguments)
+    {
+        auto *task = new emission_task(this, std::forward<ArgumentTypes>(arguments) ...);
+        if (!coalesce)
+        {
+            target->post(task);
+            return;
+        }
+        // Replace the latest emission. If there was none, then the drain task is not pending.
+        emission_task *replaced = latest.exchange(task, std::memory_order_acq_rel);
+        if (nullptr != replaced)
+        {
+            delete replaced;
+        }
+        else
+        {
+            add_reference();
+            target->post(&drain);
+        }
+    }
+
+}; // struct queued_signal_state
+
+} // namespace internal
+
+/// @ingroup signal
+/// @brief A queued signal.
+/// @detail
+/// Any thread may emit a queued signal. An emission copies (or moves) its arguments into a task which is
+/// posted to the dispatcher of the signal. The subscribers are invoked by the thread dispatching the tasks
+/// of that dispatcher. Emissions from within a subscriber are queued as well, they are never dropped.
+///
+/// If the signal is coalescing, then pending emissions are replaced by more recent emissions:
+/// at most one emission (the most recent one) is pending at any time.
+///
+/// Subscribing, disconnecting, and destroying the queued signal must be performed by the dispatching thread.
+/// Emissions pending when the queued signal is destroyed are discarded.
+/// @tparam ... ParameterTypes the parameter types
+/// @remark Non-copyable.
+template <class ... ParameterTypes>
+struct queued_signal<void(ParameterTypes ...)>
+{
+private:
+    using state_type = internal::queued_signal_state<ParameterTypes ...>;
+
+    /// @brief The signal.
+    id::signal<void(ParameterTypes ...)> m_signal;
+    /// @brief The state shared with pending emissions.
+    state_type *m_state;
+    /// @brief If pending emissions are coalesced.
+    bool m_coalesce;
+
+public:
+    queued_signal(const queued_signal&) = delete; // Do not allow copying.
+    const queued_signal& operator=(const queued_signal&) = delete; // Do not allow copying.
+
+public:
+    /// @brief Construct this queued signal.
+    /// @param target the dispatcher
+    /// @param coalesce if pending emissions are coalesced
+    explicit queued_signal(dispatcher& target, bool coalesce = false)
+        : m_signal(), m_state(new state_type(&target, &m_signal)), m_coalesce(coalesce)
+    {}
+
+    /// @brief Destruct this queued signal.
+    /// Disconnects all subscribers and discards pending emissions.
+    ~queued_signal()
+    {
+        m_state->signal = nullptr;
+        m_state->remove_reference();
+    }
+
+public:
+    /// @brief Subscribe to this signal.
+    /// @param function a non-empty function
+    /// @return the connection
+    template <class Function>
+    connection subscribe(Function&& function)
+    {
+        return m_signal.subscribe(std::forward<Function>(function));
+    }
+
+    /// @brief Subscribe a member function of an object to this signal.
+    /// @param object a pointer to the object
+    /// @param method the member function
+    /// @return the connection
+    template <class Object, class Method>
+    connection subscribe(Object *object, Method method)
+    {
+        return m_signal.subscribe(object, method);
+    }
+
+    /// @brief Disconnect all subscribers.
+    void disconnect_all() noexcept
+    {
+        m_signal.disconnect_all();
+    }
+
+    /// @brief Get if this signal is coalescing.
+    /// @return @a true if this signal is coalescing, @a false otherwise
+    bool coalescing() const noexcept
+    {
+        return m_coalesce;
+    }
+
+public:
+    /// @brief Enqueue an emission.
+    /// @param arguments the arguments
+    /// @remark May be invoked by any thread.
+    template <class ... ArgumentTypes>
+    void operator()(ArgumentTypes&& ... arguments)
+    {
+        static_assert(sizeof ... (ArgumentTypes) == sizeof ... (ParameterTypes), "invalid number of arguments");
+        m_state->enqueue(m_coalesce, std::forward<ArgumentTypes>(arguments) ...);
+    }
+
+}; // struct queued_signal
+
+#include "idlib/signal/internal/footer.hpp"
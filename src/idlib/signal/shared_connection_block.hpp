@@ -0,0 +1,136 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/shared_connection_block.hpp
+/// @brief A block of a connection.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/connection.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+/// @ingroup signal
+/// @brief A block of a connection.
+/// @detail
+/// While a connection is blocked by at least one block, its slot is not invoked by emissions.
+/// Blocking and unblocking only modify a counter of the node: the node remains connected and in place,
+/// no node is allocated or deallocated and the signal is not swept.
+/// A block unblocks the connection when it is destroyed.
+struct shared_connection_block
+{
+private:
+    /// @brief The connection.
+    id::connection m_connection;
+    /// @brief If this block is blocking.
+    bool m_blocking;
+
+public:
+    /// @brief Construct this block.
+    /// @param connection the connection
+    /// @param initially_blocking if this block is initially blocking
+    explicit shared_connection_block(const id::connection& connection = id::connection(), bool initially_blocking = true)
+        : m_connection(connection), m_blocking(false)
+    {
+        if (initially_blocking)
+        {
+            block();
+        }
+    }
+
+    /// @brief Construct this block with the values of another block.
+    /// @param other the other block
+    /// @remark This block is blocking if the other block is blocking.
+    shared_connection_block(const shared_connection_block& other)
+        : m_connection(other.m_connection), m_blocking(false)
+    {
+        if (other.m_blocking)
+        {
+            block();
+        }
+    }
+
+    /// @brief Assign this block the values of another block.
+    /// @param other the other block
+    /// @return this block
+    const shared_connection_block& operator=(const shared_connection_block& other)
+    {
+        if (&other != this)
+        {
+            unblock();
+            m_connection = other.m_connection;
+            if (other.m_blocking)
+            {
+                block();
+            }
+        }
+        return *this;
+    }
+
+    /// @brief Destruct this block.
+    /// Unblocks the connection if this block is blocking.
+    ~shared_connection_block()
+    {
+        unblock();
+    }
+
+public:
+    /// @brief Block the connection.
+    /// @remark If this block is already blocking, then this function is a no-op.
+    void block() noexcept
+    {
+        if (!m_blocking && nullptr != m_connection.node)
+        {
+            m_connection.node->number_of_blocks++;
+            m_blocking = true;
+        }
+    }
+
+    /// @brief Unblock the connection.
+    /// @remark If this block is not blocking, then this function is a no-op.
+    /// The connection remains blocked if other blocks are blocking it.
+    void unblock() noexcept
+    {
+        if (m_blocking)
+        {
+            m_connection.node->number_of_blocks--;
+            m_blocking = false;
+        }
+    }
+
+    /// @brief Get if this block is blocking.
+    /// @return @a true if this block is blocking, @a false otherwise
+    bool blocking() const noexcept
+    {
+        return m_blocking;
+    }
+
+    /// @brief Get the connection.
+    /// @return the connection
+    const id::connection& connection() const noexcept
+    {
+        return m_connection;
+    }
+
+}; // struct shared_connection_block
+
+#include "idlib/signal/internal/footer.hpp"
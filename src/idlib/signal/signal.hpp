@@ -25,9 +25,11 @@
 #error(do not include directly, include `idlib/idlib.hpp` instead)
 #endif
 
+#include "idlib/signal/async_slot.hpp"
 #include "idlib/signal/connection.hpp"
 #include "idlib/signal/node.hpp"
 #include "idlib/signal/signal_base.hpp"
+#include "idlib/signal/slot_group.hpp"
 
 /// @defgroup signal
 /// @brief C++ 11 signal-slot library.
@@ -39,26 +41,35 @@
 /// - a signal member in a user-defined type has moderate impact
 /// -- on the cost of a call to a constructor/destructor of that type and
 ///   -- on the size of an object of that type.
+/// - subscribers can be ordered by groups and groups can be enabled/disabled in constant time
+/// - subscribers can be executed asynchronously on a thread pool
 
 #include "idlib/signal/internal/header.hpp"
 
 // Forward declarations.
 struct connection;
-template <class> struct signal;
+template <class Signature, class Allocator = default_node_allocator> struct signal;
 
 /// @ingroup signal
 /// @brief Generic signal.
 /// @tparam ReturnType the return type
 /// @tparam ... ParameterTypes the parameter types
+/// @tparam Allocator the allocator of the nodes e.g. id::default_node_allocator or id::pooled_node_allocator
 /// @remark Non-copyable.
-template <class ReturnType, class ... ParameterTypes>
-struct signal<ReturnType(ParameterTypes ...)> : internal::signal_base
+template <class ReturnType, class ... ParameterTypes, class Allocator>
+struct signal<ReturnType(ParameterTypes ...), Allocator> : internal::signal_base
 {
 public:
     /// @brief The node type.
-    using node_type = internal::node<ReturnType(ParameterTypes ...)>;
+    using node_type = internal::node<ReturnType(ParameterTypes ...), Allocator>;
     /// @brief The function type.
-    using function_type = std::function<ReturnType(ParameterTypes ...)>;
+    using function_type = inline_function<ReturnType(ParameterTypes ...)>;
+
+#if defined(ID_SIGNAL_PROFILING)
+private:
+    /// @brief The number of emissions of this signal.
+    uint64_t m_emissions = 0;
+#endif
 
 public:
     signal(const signal&) = delete; // Do not allow copying.
@@ -76,16 +87,100 @@ public:
     /// @brief Subscribe to this signal.
     /// @param function a non-empty function
     /// @return the connection
-    connection subscribe(const function_type& function)
+    /// @remark The function is stored in the node. No further allocation is performed unless
+    /// the function does not fit into the inline buffer of id::inline_function.
+    template <class Function>
+    connection subscribe(Function&& function)
+    {
+        return add(new node_type(1, std::forward<Function>(function)), 0, get_group_state(0));
+    }
+
+    /// @brief Subscribe a member function of an object to this signal.
+    /// @param object a pointer to the object
+    /// @param method the member function
+    /// @return the connection
+    template <class Object, class Method>
+    connection subscribe(Object *object, Method method)
+    {
+        return add(new node_type(1, object, method), 0, get_group_state(0));
+    }
+
+    /// @brief Subscribe to this signal in a group.
+    /// @param group the group. Subscribers are invoked in ascending order of their groups.
+    /// Subscribers subscribed without a group are in group @a 0.
+    /// @param function a non-empty function
+    /// @return the connection
+    /// @remark Within a group, subscribers are invoked in reverse order of subscription.
+    /// A subscriber added by a running emission is invoked by that emission if it is ordered after
+    /// the currently invoked subscriber.
+    template <class Function>
+    connection subscribe(int group, Function&& function)
+    {
+        return add(new node_type(1, std::forward<Function>(function)), group, get_group_state(group));
+    }
+
+    /// @brief Subscribe a member function of an object to this signal in a group.
+    /// @param group the group
+    /// @param object a pointer to the object
+    /// @param method the member function
+    /// @return the connection
+    template <class Object, class Method>
+    connection subscribe(int group, Object *object, Method method)
+    {
+        return add(new node_type(1, object, method), group, get_group_state(group));
+    }
+
+    /// @brief Subscribe a function to this signal which is executed asynchronously.
+    /// @param pool the thread pool executing the function
+    /// @param function the function
+    /// @return the connection
+    /// @remark An emission copies (or moves) the arguments and posts the invocation of the function to the pool.
+    /// Hence reference and pointer arguments must remain valid until the function has run.
+    /// The function may be invoked concurrently by multiple workers of the pool.
+    /// Exceptions raised by the function are passed to the task group of the emission (see id::signal::emit),
+    /// they are discarded if there is no such task group.
+    template <class Function>
+    connection subscribe_async(thread_pool& pool, Function&& function)
+    {
+        static_assert(std::is_void<ReturnType>::value, "only signals with void return type support asynchronous subscribers");
+        using slot_type = internal::async_slot<std::decay_t<Function>, ParameterTypes ...>;
+        return add(new node_type(1, slot_type(pool, std::forward<Function>(function))), 0, get_group_state(0));
+    }
+
+    /// @brief Subscribe a function to this signal which is executed asynchronously on the shared thread pool.
+    /// @param function the function
+    /// @return the connection
+    /// @see id::thread_pool::shared
+    template <class Function>
+    connection subscribe_async(Function&& function)
+    {
+        return subscribe_async(thread_pool::shared(), std::forward<Function>(function));
+    }
+
+    /// @brief Get a group of this signal.
+    /// @param group the group
+    /// @return the group
+    /// @remark The group remains valid as long as this signal exists.
+    /// Subscribers subscribed without a group are in group @a 0, hence id::slot_group::disable on group @a 0
+    /// also disables them.
+    slot_group group(int group)
+    {
+        return slot_group(get_group_state(group));
+    }
+
+private:
+    /// @brief Add a node to this signal.
+    /// @param node the node
+    /// @param group the group of the node
+    /// @param group_state a pointer to the state of the group
+    /// @return the connection
+    connection add(internal::node_base *node, int group, internal::slot_group_state *group_state)
     {
-        // Create the node.
-        internal::node_base *node = new node_type(1, function);
         // Configure and add the node.
         node->state = internal::node_base::state::connected;
-        node->next = head; head = node;
-        node->signal = this;
-        // Increment the connected count.
-        connected_count++;
+        node->group = group;
+        node->group_state = group_state;
+        insert(node);
         // Return the connection.
         return connection(node);
     }
@@ -95,20 +190,104 @@ public:
     /// @brief Notify all subscribers.
     /// @param arguments the arguments
     /// @remark
-    /// Iterate over the nodes. If a node is connected, then it is invoked.
+    /// Iterate over the nodes. If a node is connected and its group is enabled, then it is invoked.
+    /// The return values of the subscribers (if any) are discarded.
     void operator()(ParameterTypes ... arguments)
+    {
+        visit([&](node_type *node) { (*node)(static_cast<internal::emission_argument_t<ParameterTypes>>(arguments) ...); return true; });
+    }
+
+    /// @brief Notify all subscribers and add the asynchronous subscribers to a task group.
+    /// @param group the task group. id::task_group::wait waits for the asynchronous subscribers invoked by this emission.
+    /// @param arguments the arguments
+    void emit(task_group& group, ParameterTypes ... arguments)
+    {
+        internal::task_group_scope scope(group);
+        (*this)(std::forward<ParameterTypes>(arguments) ...);
+    }
+
+    /// @brief Notify all subscribers and combine their return values.
+    /// @param combiner the combiner e.g. id::combiners::sum or id::combiners::until_true
+    /// @param arguments the arguments
+    /// @return the result of the combiner
+    /// @remark
+    /// The return value of each invoked subscriber is passed to the combiner in the same pass over the nodes.
+    /// If the combiner returns @a false, then the remaining subscribers are not invoked.
+    /// If the signal is already running, then no subscriber is invoked.
+    template <class Combiner>
+    auto collect(Combiner&& combiner, ParameterTypes ... arguments) -> decltype(combiner.result())
+    {
+        static_assert(!std::is_void<ReturnType>::value, "signals with void return type can not be combined");
+        visit([&](node_type *node)
+        {
+            return static_cast<bool>(combiner((*node)(static_cast<internal::emission_argument_t<ParameterTypes>>(arguments) ...)));
+        });
+        return combiner.result();
+    }
+
+#if defined(ID_SIGNAL_PROFILING)
+public:
+    /// @brief Get the statistics of this signal.
+    /// @param name the name of the signal in the statistics
+    /// @return the statistics of this signal and its connected subscribers
+    /// @remark Only available if ID_SIGNAL_PROFILING is defined.
+    signal_statistics statistics(const std::string& name = std::string()) const
+    {
+        signal_statistics statistics;
+        statistics.name = name;
+        statistics.emissions = m_emissions;
+        size_t position = 0;
+        for (internal::node_base *cur = head; nullptr != cur; cur = cur->next)
+        {
+            if (cur->is_connected())
+            {
+                slot_statistics slot = static_cast<node_type *>(cur)->statistics;
+                slot.position = position++;
+                slot.group = cur->group;
+                statistics.slots.push_back(slot);
+            }
+        }
+        return statistics;
+    }
+
+    /// @brief Reset the statistics of this signal.
+    /// @remark Only available if ID_SIGNAL_PROFILING is defined.
+    void reset_statistics() noexcept
+    {
+        m_emissions = 0;
+        for (internal::node_base *cur = head; nullptr != cur; cur = cur->next)
+        {
+            static_cast<node_type *>(cur)->statistics = slot_statistics();
+        }
+    }
+#endif
+
+private:
+    /// @brief Visit the connected nodes.
+    /// @param visitor the visitor. Returns @a false if visiting should stop.
+    template <class Visitor>
+    void visit(Visitor&& visitor)
     {
         if (!running)
         { 
             /// @todo Use ReentrantBarrier (not committed yet).
             running = true;
+#if defined(ID_SIGNAL_PROFILING)
+            m_emissions++;
+#endif
             try
             {
                 for (internal::node_base *cur = head; nullptr != cur; cur = cur->next)
                 {
-                    if (cur->state == internal::node_base::state::connected)
+                    if (cur->is_active())
                     {
-                        (*static_cast<node_type *>(cur))(std::forward<ParameterTypes>(arguments) ...);
+#if defined(ID_SIGNAL_PROFILING)
+                        internal::slot_timer timer(static_cast<node_type *>(cur)->statistics);
+#endif
+                        if (!visitor(static_cast<node_type *>(cur)))
+                        {
+                            break;
+                        }
                     }
                 }
             }
@@ -29,7 +29,40 @@
 
 namespace internal {
 
-signal_base::signal_base() noexcept : head(nullptr), disconnected_count(0), connected_count(0), running(false) {}
+signal_base::signal_base() noexcept :
+    head(nullptr), running(false), connected_count(0), disconnected_count(0), groups(), default_group{ 0, true }
+{}
+
+void signal_base::insert(node_base *node) noexcept
+{
+    // Skip the nodes with lesser groups.
+    node_base **predecessor = &head;
+    while (nullptr != *predecessor && (*predecessor)->group < node->group)
+    {
+        predecessor = &(*predecessor)->next;
+    }
+    node->next = *predecessor;
+    *predecessor = node;
+    node->signal = this;
+    connected_count++;
+}
+
+slot_group_state *signal_base::get_group_state(int group)
+{
+    if (0 == group)
+    {
+        return &default_group;
+    }
+    for (auto& state : groups)
+    {
+        if (state->group == group)
+        {
+            return state.get();
+        }
+    }
+    groups.push_back(std::unique_ptr<slot_group_state>(new slot_group_state{ group, true }));
+    return groups.back().get();
+}
 
 void signal_base::sweep() noexcept
 {
@@ -46,6 +79,8 @@ void signal_base::sweep() noexcept
             // Decrement the number of disconnected nodes.
             disconnected_count--;
             // Remove the reference from this signal.
+            node->signal = nullptr;
+            node->group_state = nullptr;
             node->remove_reference();
             // If the number of references to the node is @a 0, then the signal was the sole owner of the node.
             // The signal shall delete the node.
@@ -26,14 +26,17 @@
 #endif
 
 #include "idlib/utility/platform.hpp"
+#include "idlib/signal/node_base.hpp"
 
 #include "idlib/signal/internal/header.hpp"
 
+// Forward declarations.
+class connection_group;
+
 namespace internal {
 
 // Forward declarations.
 struct connection_base;
-struct node_base;
 struct signal_base;
 
 /// @internal
@@ -42,11 +45,26 @@ struct signal_base;
 struct signal_base
 {
     friend struct connection_base;
+    friend class id::connection_group;
 protected:
     node_base *head; ///< @brief The head of the nodes.
     bool running; ///< @brief @a true if the signal is currently running, @a false otherwise.
     size_t connected_count; ///< @brief The number of connected nodes.
     size_t disconnected_count; ///< @brief The number of disconnected nodes.
+    std::vector<std::unique_ptr<slot_group_state>> groups; ///< @brief The states of the groups other than group @a 0.
+    /// @brief The state of group @a 0. Embedded such that subscribing without a group does not allocate.
+    slot_group_state default_group;
+
+    /// @brief Insert a node.
+    /// @param node the node
+    /// @remark The node is inserted in front of the first node with a greater or equal group.
+    /// The nodes remain ordered by ascending group such that an emission is a single pass without sorting.
+    void insert(node_base *node) noexcept;
+
+    /// @brief Get the state of a group, create it if it does not exist.
+    /// @param group the group
+    /// @return a pointer to the state of the group
+    slot_group_state *get_group_state(int group);
 
     /// @brief Remove all dead subscriptions if the number of dead nodes exceeds the number of live nodes.
     /// @precondition The signal is not currently running.
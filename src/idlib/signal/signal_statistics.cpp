@@ -0,0 +1,145 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/signal_statistics.cpp
+/// @brief Profiling statistics of signals.
+/// @author Michael Heilmann
+
+#define IDLIB_PRIVATE 1
+#include "idlib/signal/signal_statistics.hpp"
+#undef IDLIB_PRIVATE
+
+#include "idlib/signal/internal/header.hpp"
+
+uint64_t latency_histogram::count() const noexcept
+{
+    uint64_t count = 0;
+    for (auto bucket : buckets)
+    {
+        count += bucket;
+    }
+    return count;
+}
+
+uint64_t latency_histogram::percentile(double percentile) const noexcept
+{
+    uint64_t count = this->count();
+    if (0 == count)
+    {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::min(std::max(percentile, 0.0), 1.0) * count));
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < number_of_buckets; ++i)
+    {
+        accumulated += buckets[i];
+        if (accumulated >= rank && 0 != accumulated)
+        {
+            return i == number_of_buckets - 1 ? maximum : uint64_t(2) << i;
+        }
+    }
+    return maximum;
+}
+
+namespace {
+
+void write_json_string(std::ostream& target, const std::string& string)
+{
+    target << '"';
+    for (char c : string)
+    {
+        switch (c)
+        {
+            case '"': target << "\\\""; break;
+            case '\\': target << "\\\\"; break;
+            case '\n': target << "\\n"; break;
+            case '\t': target << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    target << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                }
+                else
+                {
+                    target << c;
+                }
+                break;
+        };
+    }
+    target << '"';
+}
+
+} // namespace
+
+void write_json(std::ostream& target, const signal_statistics& statistics)
+{
+    target << "{\"name\":";
+    write_json_string(target, statistics.name);
+    target << ",\"emissions\":" << statistics.emissions << ",\"slots\":[";
+    bool first = true;
+    for (const auto& slot : statistics.slots)
+    {
+        if (!first)
+        {
+            target << ',';
+        }
+        first = false;
+        target << "{\"position\":" << slot.position
+               << ",\"group\":" << slot.group
+               << ",\"calls\":" << slot.calls
+               << ",\"samples\":" << slot.latency.count()
+               << ",\"total_ns\":" << slot.latency.total
+               << ",\"maximum_ns\":" << slot.latency.maximum
+               << ",\"histogram\":[";
+        for (size_t i = 0; i < latency_histogram::number_of_buckets; ++i)
+        {
+            target << (i > 0 ? "," : "") << slot.latency.buckets[i];
+        }
+        target << "]}";
+    }
+    target << "]}";
+}
+
+void write_csv(std::ostream& target, const signal_statistics& statistics, bool header)
+{
+    if (header)
+    {
+        target << "signal,emissions,position,group,calls,samples,total_ns,mean_ns,maximum_ns,p50_ns,p99_ns\n";
+    }
+    for (const auto& slot : statistics.slots)
+    {
+        // Quote the name as it might contain separators.
+        std::string name = statistics.name;
+        for (size_t i = name.find('"'); std::string::npos != i; i = name.find('"', i + 2))
+        {
+            name.insert(i, 1, '"');
+        }
+        target << '"' << name << '"' << ','
+               << statistics.emissions << ','
+               << slot.position << ','
+               << slot.group << ','
+               << slot.calls << ','
+               << slot.latency.count() << ','
+               << slot.latency.total << ','
+               << (0 == slot.latency.count() ? 0 : slot.latency.total / slot.latency.count()) << ','
+               << slot.latency.maximum << ','
+               << slot.latency.percentile(0.5) << ','
+               << slot.latency.percentile(0.99) << '\n';
+    }
+}
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,79 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file idlib/signal/slot_group.hpp
+/// @brief A group of subscribers of an id::signal.
+/// @author Michael Heilmann
+
+#pragma once
+
+#if !defined(IDLIB_PRIVATE) || IDLIB_PRIVATE != 1
+#error(do not include directly, include `idlib/idlib.hpp` instead)
+#endif
+
+#include "idlib/signal/node_base.hpp"
+
+#include "idlib/signal/internal/header.hpp"
+
+/// @ingroup signal
+/// @brief A group of subscribers of an id::signal.
+/// @detail
+/// Enabling or disabling a group is a constant time operation: an emission skips the subscribers
+/// of a disabled group, the subscribers themselves are not modified and remain connected.
+/// @remark A group refers to its signal and must not be used after the signal was destroyed.
+class slot_group
+{
+private:
+    /// @brief A pointer to the state of the group.
+    internal::slot_group_state *m_state;
+
+public:
+    /// @brief Construct this group.
+    /// @param state a pointer to the state of the group
+    explicit slot_group(internal::slot_group_state *state) noexcept
+        : m_state(state)
+    {}
+
+    /// @brief Get the group.
+    /// @return the group
+    int get() const noexcept
+    {
+        return m_state->group;
+    }
+
+    /// @brief Enable the subscribers of this group.
+    void enable() noexcept
+    {
+        m_state->enabled = true;
+    }
+
+    /// @brief Disable the subscribers of this group.
+    void disable() noexcept
+    {
+        m_state->enabled = false;
+    }
+
+    /// @brief Get if the subscribers of this group are enabled.
+    /// @return @a true if the subscribers of this group are enabled, @a false otherwise
+    bool is_enabled() const noexcept
+    {
+        return m_state->enabled;
+    }
+
+}; // class slot_group
+
+#include "idlib/signal/internal/footer.hpp"
@@ -0,0 +1,56 @@
+#pragma once
+
+#pragma push_macro("IDLIB_PRIVATE")
+#define IDLIB_PRIVATE 1
+
+#include "idlib/utility/platform.hpp"
+#include "idlib/utility/byte_order.hpp"
+
+#include "idlib/utility/header.in"
+
+namespace internal {
+
+/// @brief Read an unsigned 64 bit integer stored in little endian Byte order.
+/// @param p a pointer to an array of 8 Bytes, not necessarily aligned
+/// @return the integer
+inline uint64_t read_u64(const char *p) noexcept
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return convert_byte_order(v, get_byte_order(), byte_order::little_endian);
+}
+
+/// @brief Read an unsigned 32 bit integer stored in little endian Byte order.
+/// @param p a pointer to an array of 4 Bytes, not necessarily aligned
+/// @return the integer
+inline uint32_t read_u32(const char *p) noexcept
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return convert_byte_order(v, get_byte_order(), byte_order::little_endian);
+}
+
+/// @brief Store an unsigned 64 bit integer in little endian Byte order.
+/// @param p a pointer to an array of 8 Bytes, not necessarily aligned
+/// @param v the integer
+inline void write_u64(char *p, uint64_t v) noexcept
+{
+    v = convert_byte_order(v, byte_order::little_endian, get_byte_order());
+    memcpy(p, &v, sizeof(v));
+}
+
+/// @brief Store an unsigned 32 bit integer in little endian Byte order.
+/// @param p a pointer to an array of 4 Bytes, not necessarily aligned
+/// @param v the integer
+inline void write_u32(char *p, uint32_t v) noexcept
+{
+    v = convert_byte_order(v, byte_order::little_endian, get_byte_order());
+    memcpy(p, &v, sizeof(v));
+}
+
+} // namespace internal
+
+#include "idlib/utility/footer.in"
+
+#undef IDLIB_PRIVATE
+#pragma pop_macro("IDLIB_PRIVATE")
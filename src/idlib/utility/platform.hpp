@@ -140,12 +140,14 @@
 #include <algorithm>
 #include <atomic>
 #include <bitset>
+#include <deque>
 #include <exception>
 #include <forward_list>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <locale>
 #include <list>
 #include <map>
@@ -158,7 +160,9 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
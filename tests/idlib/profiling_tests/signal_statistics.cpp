@@ -0,0 +1,111 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+// ID_SIGNAL_PROFILING changes the signal classes, hence it must be defined for all translation units of a program.
+// These tests are built into a separate executable with the macro defined for the library and the tests.
+#if !defined(ID_SIGNAL_PROFILING)
+#error(ID_SIGNAL_PROFILING must be defined for all translation units of the profiling tests)
+#endif
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Emission and call counts.
+TEST(signal_statistics_testing, test_signal_statistics_0)
+{
+    id::signal<void(int)> signal;
+    auto c1 = signal.subscribe(1, [](int) {});
+    auto c2 = signal.subscribe(0, [](int x) { std::this_thread::sleep_for(std::chrono::microseconds(x)); });
+    signal(10);
+    signal(10);
+    signal.group(1).disable();
+    signal(10);
+    auto statistics = signal.statistics("s");
+    ASSERT_EQ("s", statistics.name);
+    ASSERT_EQ(3, statistics.emissions);
+    ASSERT_EQ(2, statistics.slots.size());
+    ASSERT_EQ(0, statistics.slots[0].group);
+    ASSERT_EQ(3, statistics.slots[0].calls);
+    // Only the first call is sampled.
+    ASSERT_EQ(1, statistics.slots[0].latency.count());
+    ASSERT_LE(10000, statistics.slots[0].latency.maximum);
+    ASSERT_LE(10000, statistics.slots[0].latency.percentile(0.5));
+    ASSERT_EQ(1, statistics.slots[1].group);
+    ASSERT_EQ(2, statistics.slots[1].calls);
+    signal.reset_statistics();
+    statistics = signal.statistics();
+    ASSERT_EQ(0, statistics.emissions);
+    ASSERT_EQ(0, statistics.slots[0].calls);
+}
+
+// Histogram buckets.
+TEST(signal_statistics_testing, test_signal_statistics_1)
+{
+    id::latency_histogram histogram;
+    ASSERT_EQ(0, histogram.percentile(0.5));
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(2);
+    histogram.record(1000);
+    ASSERT_EQ(2, histogram.buckets[0]);
+    ASSERT_EQ(1, histogram.buckets[1]);
+    ASSERT_EQ(1, histogram.buckets[9]);
+    ASSERT_EQ(4, histogram.count());
+    ASSERT_EQ(1003, histogram.total);
+    ASSERT_EQ(1000, histogram.maximum);
+    ASSERT_EQ(2, histogram.percentile(0.5));
+    ASSERT_EQ(1024, histogram.percentile(1.0));
+    histogram.record(std::numeric_limits<uint64_t>::max());
+    ASSERT_EQ(1, histogram.buckets[id::latency_histogram::number_of_buckets - 1]);
+}
+
+// JSON and CSV output.
+TEST(signal_statistics_testing, test_signal_statistics_2)
+{
+    id::signal<void()> signal;
+    auto c1 = signal.subscribe([]() {});
+    signal();
+    std::ostringstream json;
+    id::write_json(json, signal.statistics("a \"quoted\" name"));
+    ASSERT_EQ(0, json.str().find("{\"name\":\"a \\\"quoted\\\" name\",\"emissions\":1,\"slots\":[{\"position\":0,\"group\":0,\"calls\":1,\"samples\":1,"));
+    std::ostringstream csv;
+    id::write_csv(csv, signal.statistics("b"));
+    std::string line;
+    std::istringstream lines(csv.str());
+    std::getline(lines, line);
+    ASSERT_EQ("signal,emissions,position,group,calls,samples,total_ns,mean_ns,maximum_ns,p50_ns,p99_ns", line);
+    std::getline(lines, line);
+    ASSERT_EQ(0, line.find("\"b\",1,0,0,1,1,"));
+}
+
+// Latencies are sampled.
+TEST(signal_statistics_testing, test_signal_statistics_3)
+{
+    id::signal<void()> signal;
+    auto c1 = signal.subscribe([]() {});
+    for (uint64_t i = 0; i < 2 * id::slot_statistics::sampling_interval + 1; ++i)
+    {
+        signal();
+    }
+    auto statistics = signal.statistics();
+    ASSERT_EQ(2 * id::slot_statistics::sampling_interval + 1, statistics.slots[0].calls);
+    ASSERT_EQ(3, statistics.slots[0].latency.count());
+}
+
+} } } // namespace id::tests::signal
@@ -0,0 +1,92 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace concurrency {
+
+// Posting from non-worker threads and joining via a task group.
+TEST(thread_pool_testing, test_thread_pool_0)
+{
+    id::thread_pool pool(4);
+    ASSERT_EQ(4, pool.size());
+    ASSERT_EQ(false, pool.is_worker());
+    std::atomic<int> counter(0);
+    id::task_group group;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.post(group, [&counter]() { counter++; });
+    }
+    group.wait();
+    ASSERT_EQ(true, group.is_done());
+    ASSERT_EQ(1000, counter.load());
+}
+
+// Tasks posting tasks (recursive fork/join).
+TEST(thread_pool_testing, test_thread_pool_1)
+{
+    id::thread_pool pool(3);
+    id::task_group group;
+    std::atomic<int> leaves(0);
+    std::function<void(int)> fork = [&](int depth)
+    {
+        if (0 == depth)
+        {
+            leaves++;
+            return;
+        }
+        EXPECT_EQ(true, pool.is_worker());
+        pool.post(group, [&fork, depth]() { fork(depth - 1); });
+        pool.post(group, [&fork, depth]() { fork(depth - 1); });
+    };
+    pool.post(group, [&fork]() { fork(10); });
+    group.wait();
+    ASSERT_EQ(1024, leaves.load());
+}
+
+// Futures and exceptions.
+TEST(thread_pool_testing, test_thread_pool_2)
+{
+    id::thread_pool pool(2);
+    auto future = pool.submit([]() { return 42; });
+    ASSERT_EQ(42, future.get());
+    auto failure = pool.submit([]() -> int { throw std::runtime_error("failure"); });
+    ASSERT_THROW(failure.get(), std::runtime_error);
+    id::task_group group;
+    pool.post(group, []() { throw std::runtime_error("failure"); });
+    pool.post(group, []() {});
+    ASSERT_THROW(group.wait(), std::runtime_error);
+    // The exception is cleared.
+    group.wait();
+}
+
+// Queued tasks are run before the pool is destroyed.
+TEST(thread_pool_testing, test_thread_pool_3)
+{
+    std::atomic<int> counter(0);
+    {
+        id::thread_pool pool(1);
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.post([&counter]() noexcept { counter++; });
+        }
+    }
+    ASSERT_EQ(100, counter.load());
+}
+
+} } } // namespace id::tests::concurrency
@@ -0,0 +1,229 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Create a file of the specified size, the Byte at offset i is (i + seed) % 251.
+void write_async_pattern(const std::string& pathname, size_t size, size_t seed = 0)
+{
+    std::ofstream stream(pathname, std::ios::binary);
+    for (size_t i = 0; i < size; ++i)
+    {
+        stream.put(static_cast<char>((i + seed) % 251));
+    }
+}
+
+std::vector<id::file_system::async_backend> available_backends()
+{
+    using namespace id::file_system;
+    std::vector<async_backend> backends{ async_backend::thread_pool };
+    if (async_backend::io_uring == async_reader(8).backend())
+    {
+        backends.push_back(async_backend::io_uring);
+    }
+    return backends;
+}
+
+} // namespace
+
+// Reading many files with handlers.
+TEST(async_reader_testing, test_async_reader_0)
+{
+    using namespace id::file_system;
+    const size_t number_of_files = 300;
+    std::vector<std::string> pathnames;
+    for (size_t i = 0; i < number_of_files; ++i)
+    {
+        pathnames.push_back(temporary_pathname("async_reader_0_" + std::to_string(i)));
+        write_async_pattern(pathnames.back(), 100 + i, i);
+    }
+    for (auto backend : available_backends())
+    {
+        // A queue depth smaller than the number of files.
+        async_reader reader(64, backend);
+        ASSERT_EQ(backend, reader.backend());
+        std::vector<file_descriptor> files(number_of_files);
+        std::vector<std::vector<char>> buffers(number_of_files);
+        std::vector<size_t> results(number_of_files, 0);
+        for (size_t i = 0; i < number_of_files; ++i)
+        {
+            files[i].open(pathnames[i], access_mode::read, create_mode::open_existing);
+            ASSERT_EQ(true, files[i].is_open());
+            // Request more Bytes than the file contains.
+            buffers[i].resize(200 + i);
+            reader.read(files[i], 0, buffers[i].data(), buffers[i].size(), [&results, i](size_t n, std::exception_ptr e)
+            {
+                ASSERT_EQ(nullptr, e);
+                results[i] = n;
+            });
+        }
+        ASSERT_EQ(number_of_files, reader.pending());
+        ASSERT_EQ(number_of_files, reader.wait());
+        ASSERT_EQ(0, reader.pending());
+        for (size_t i = 0; i < number_of_files; ++i)
+        {
+            ASSERT_EQ(100 + i, results[i]);
+            for (size_t j = 0; j < results[i]; ++j)
+            {
+                ASSERT_EQ(static_cast<char>((i + j) % 251), buffers[i][j]);
+            }
+        }
+    }
+    for (auto& pathname : pathnames)
+    {
+        std::remove(pathname.c_str());
+    }
+}
+
+// Reading with futures, submit and poll.
+TEST(async_reader_testing, test_async_reader_1)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("async_reader_1");
+    write_async_pattern(pathname, 1024 * 1024 + 3);
+    for (auto backend : available_backends())
+    {
+        async_reader reader(16, backend);
+        file_descriptor file;
+        file.open(pathname, access_mode::read, create_mode::open_existing);
+        std::vector<char> buffer(1024 * 1024 + 3);
+        std::vector<std::future<size_t>> futures;
+        const size_t chunk = 64 * 1024;
+        for (size_t offset = 0; offset < buffer.size(); offset += chunk)
+        {
+            futures.push_back(reader.read(file, offset, buffer.data() + offset, std::min(chunk, buffer.size() - offset)));
+        }
+        ASSERT_EQ(16, reader.submit());
+        while (0 != reader.pending())
+        {
+            reader.submit();
+            reader.poll();
+        }
+        for (size_t i = 0; i < futures.size(); ++i)
+        {
+            ASSERT_EQ(std::min(chunk, buffer.size() - i * chunk), futures[i].get());
+        }
+        for (size_t i = 0; i < buffer.size(); ++i)
+        {
+            ASSERT_EQ(static_cast<char>(i % 251), buffer[i]);
+        }
+    }
+    std::remove(pathname.c_str());
+}
+
+// Reading into registered buffers.
+TEST(async_reader_testing, test_async_reader_2)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("async_reader_2");
+    write_async_pattern(pathname, 8192);
+    for (auto backend : available_backends())
+    {
+        async_reader reader(8, backend);
+        file_descriptor file;
+        file.open(pathname, access_mode::read, create_mode::open_existing);
+        std::vector<char> first(4096), second(4096);
+        reader.register_buffers({ { first.data(), first.size() }, { second.data(), second.size() } });
+        size_t total = 0;
+        auto handler = [&total](size_t n, std::exception_ptr e)
+        {
+            ASSERT_EQ(nullptr, e);
+            total += n;
+        };
+        reader.read_fixed(file, 0, 0, 0, 4096, handler);
+        reader.read_fixed(file, 4096, 1, 96, 4000, handler);
+        ASSERT_THROW(reader.read_fixed(file, 0, 1, 97, 4000, handler), id::file_system::error);
+        ASSERT_THROW(reader.read_fixed(file, 0, 2, 0, 1, handler), id::file_system::error);
+        ASSERT_THROW(reader.unregister_buffers(), id::file_system::error);
+        ASSERT_EQ(2, reader.wait());
+        ASSERT_EQ(8096, total);
+        for (size_t i = 0; i < 4096; ++i)
+        {
+            ASSERT_EQ(static_cast<char>(i % 251), first[i]);
+        }
+        for (size_t i = 0; i < 4000; ++i)
+        {
+            ASSERT_EQ(static_cast<char>((4096 + i) % 251), second[96 + i]);
+        }
+        reader.unregister_buffers();
+    }
+    std::remove(pathname.c_str());
+}
+
+// Failures.
+TEST(async_reader_testing, test_async_reader_3)
+{
+    using namespace id::file_system;
+    ASSERT_THROW(async_reader(0), id::file_system::error);
+    auto pathname = temporary_pathname("async_reader_3");
+    write_async_pattern(pathname, 16);
+    for (auto backend : available_backends())
+    {
+        // The file descriptor must outlive the reader.
+        file_descriptor file;
+        async_reader reader(8, backend);
+        char buffer[16];
+        ASSERT_THROW(reader.read(file, 0, buffer, 16), id::file_system::error);
+        // A file opened for writing only can not be read.
+        file.open(pathname, access_mode::write, create_mode::open_existing);
+        ASSERT_EQ(true, file.is_open());
+        auto future = reader.read(file, 0, buffer, 16);
+        reader.wait();
+        ASSERT_THROW(future.get(), id::file_system::error);
+        // Reads pending on destruction are not completed.
+        auto other = reader.read(file, 0, buffer, 16);
+        reader.submit();
+    }
+    std::remove(pathname.c_str());
+}
+
+// Reading from the workers of the shared thread pool.
+TEST(async_reader_testing, test_async_reader_4)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("async_reader_4");
+    write_async_pattern(pathname, 4096);
+    std::atomic<size_t> total(0);
+    id::task_group group;
+    // Each worker waits for its reads, hence they must not be performed by the workers of the pool.
+    for (size_t i = 0; i < id::thread_pool::shared().size(); ++i)
+    {
+        id::thread_pool::shared().post(group, [&pathname, &total]()
+        {
+            async_reader reader(8, async_backend::thread_pool);
+            file_descriptor file;
+            file.open(pathname, access_mode::read, create_mode::open_existing);
+            std::vector<char> buffer(4096);
+            for (size_t offset = 0; offset < buffer.size(); offset += 1024)
+            {
+                reader.read(file, offset, buffer.data() + offset, 1024, [&total](size_t n, std::exception_ptr) { total += n; });
+            }
+            reader.wait();
+        });
+    }
+    group.wait();
+    ASSERT_EQ(4096 * id::thread_pool::shared().size(), total);
+    std::remove(pathname.c_str());
+}
+
+} } } // namespace id::tests::file_system
@@ -0,0 +1,167 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+#include <filesystem>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Get the contents of a file or "<missing>".
+std::string read_atomic_file(const std::string& pathname)
+{
+    std::ifstream stream(pathname, std::ios::binary);
+    if (!stream)
+    {
+        return "<missing>";
+    }
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+// Get the number of entries of a directory.
+size_t count_atomic_file_entries(const std::string& pathname)
+{
+    return (size_t)std::distance(std::filesystem::directory_iterator(pathname), std::filesystem::directory_iterator());
+}
+
+} // namespace
+
+// Writing and replacing a file.
+TEST(atomic_file_writer_testing, test_atomic_file_writer_0)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("atomic_file_writer_0");
+    std::string pathname = root + get_directory_separator() + "file";
+    std::string large(100000, 'x');
+    for (auto durability : { durability::none, durability::contents, durability::full })
+    {
+        std::string previous = read_atomic_file(pathname);
+        atomic_file_writer writer;
+        writer.open(pathname, durability, 16);
+        ASSERT_TRUE(writer.is_open());
+        writer.write("0123456789");
+        writer.write("abcdefghij");
+        writer.write(large);
+        writer.write("!");
+        writer.write(std::string_view());
+        ASSERT_EQ(20 + large.size() + 1, writer.position());
+        // The file is not changed before the writing is committed.
+        ASSERT_EQ(previous, read_atomic_file(pathname));
+        writer.commit();
+        ASSERT_FALSE(writer.is_open());
+        ASSERT_EQ("0123456789abcdefghij" + large + "!", read_atomic_file(pathname));
+        ASSERT_EQ(1, count_atomic_file_entries(root));
+    }
+    ASSERT_ANY_THROW(atomic_file_writer().commit());
+}
+
+// Discarding the writing does not change the file.
+TEST(atomic_file_writer_testing, test_atomic_file_writer_1)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("atomic_file_writer_1");
+    std::string pathname = root + get_directory_separator() + "file";
+    std::ofstream(pathname, std::ios::binary) << "old";
+    {
+        atomic_file_writer writer;
+        writer.open(pathname);
+        ASSERT_TRUE(writer.is_open());
+        writer.write("new");
+        ASSERT_EQ(2, count_atomic_file_entries(root));
+    }
+    ASSERT_EQ("old", read_atomic_file(pathname));
+    ASSERT_EQ(1, count_atomic_file_entries(root));
+    atomic_file_writer writer;
+    writer.open(pathname);
+    writer.write("new");
+    writer.discard();
+    ASSERT_FALSE(writer.is_open());
+    ASSERT_ANY_THROW(writer.write("new"));
+    ASSERT_EQ("old", read_atomic_file(pathname));
+    ASSERT_EQ(1, count_atomic_file_entries(root));
+    // The temporary file can not be created in a directory which does not exist.
+    writer.open(root + get_directory_separator() + "missing" + get_directory_separator() + "file");
+    ASSERT_FALSE(writer.is_open());
+#if defined(ID_LINUX)
+    // The permissions of a replaced file are retained.
+    std::filesystem::permissions(pathname, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+    writer.open(pathname);
+    writer.write("new");
+    writer.commit();
+    ASSERT_EQ("new", read_atomic_file(pathname));
+    ASSERT_EQ(std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, std::filesystem::status(pathname).permissions());
+#endif
+}
+
+// Writing many files in a batch.
+TEST(atomic_file_writer_testing, test_atomic_file_writer_2)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("atomic_file_writer_2");
+    std::string separator = get_directory_separator();
+    std::filesystem::create_directories(root + separator + "a");
+    std::filesystem::create_directories(root + separator + "b");
+    for (auto durability : { durability::none, durability::contents, durability::full })
+    {
+        atomic_write_batch batch(durability);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            batch.write(root + separator + (i % 2 ? "a" : "b") + separator + std::to_string(i), "contents " + std::to_string(i));
+        }
+        batch.write(root + separator + "a" + separator + "1", std::string("replaced"));
+        ASSERT_EQ(201, batch.size());
+        batch.commit();
+        ASSERT_EQ(0, batch.size());
+        ASSERT_EQ(100, count_atomic_file_entries(root + separator + "a"));
+        ASSERT_EQ(100, count_atomic_file_entries(root + separator + "b"));
+        for (size_t i = 2; i < 200; ++i)
+        {
+            ASSERT_EQ("contents " + std::to_string(i), read_atomic_file(root + separator + (i % 2 ? "a" : "b") + separator + std::to_string(i)));
+        }
+        ASSERT_EQ("replaced", read_atomic_file(root + separator + "a" + separator + "1"));
+    }
+}
+
+// Discarding a batch and failing to commit a batch.
+TEST(atomic_file_writer_testing, test_atomic_file_writer_3)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("atomic_file_writer_3");
+    std::string separator = get_directory_separator();
+    {
+        atomic_write_batch batch;
+        batch.write(root + separator + "discarded", std::string("discarded"));
+        ASSERT_EQ(1, count_atomic_file_entries(root));
+    }
+    ASSERT_EQ(0, count_atomic_file_entries(root));
+    ASSERT_ANY_THROW(atomic_write_batch().write(root + separator + "missing" + separator + "file", std::string("x")));
+    // A directory can not be replaced by a file.
+    std::filesystem::create_directories(root + separator + "directory" + separator + "child");
+    atomic_write_batch batch;
+    batch.write(root + separator + "directory", std::string("x"));
+    batch.write(root + separator + "file", std::string("x"));
+    ASSERT_ANY_THROW(batch.commit());
+    ASSERT_EQ(0, batch.size());
+    ASSERT_TRUE(std::filesystem::is_directory(root + separator + "directory"));
+    ASSERT_EQ(1, count_atomic_file_entries(root));
+}
+
+} } } // namespace id::tests::file_system
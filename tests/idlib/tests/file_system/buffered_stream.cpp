@@ -0,0 +1,153 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Lines of varying length, some longer than a chunk.
+std::string make_lines(size_t number_of_lines)
+{
+    std::string contents;
+    for (size_t i = 0; i < number_of_lines; ++i)
+    {
+        contents += std::to_string(i) + ":" + std::string((i * 37) % 300, static_cast<char>('a' + i % 26)) + "\n";
+    }
+    return contents;
+}
+
+} // namespace
+
+// Reading lines, buffered and mapped.
+TEST(buffered_stream_testing, test_buffered_stream_0)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("buffered_stream_0");
+    std::string contents = make_lines(1000) + "last line without line feed";
+    {
+        std::ofstream stream(pathname, std::ios::binary);
+        stream << contents;
+    }
+    for (size_t mapping_threshold : { std::numeric_limits<size_t>::max(), size_t(0) })
+    {
+        buffered_reader reader;
+        reader.open(pathname, 64, mapping_threshold);
+        ASSERT_EQ(true, reader.is_open());
+        ASSERT_EQ(0 == mapping_threshold, reader.is_mapped());
+        std::istringstream expected(contents);
+        std::string expected_line;
+        std::string_view line;
+        size_t number_of_lines = 0;
+        while (std::getline(expected, expected_line))
+        {
+            ASSERT_EQ(true, reader.read_line(line));
+            ASSERT_EQ(expected_line, line);
+            number_of_lines++;
+        }
+        ASSERT_EQ(1001, number_of_lines);
+        ASSERT_EQ(false, reader.read_line(line));
+        ASSERT_EQ(contents.size(), reader.position());
+        reader.close();
+        ASSERT_EQ(false, reader.is_open());
+        ASSERT_THROW(reader.read(1), id::file_system::error);
+    }
+    std::remove(pathname.c_str());
+}
+
+// Reading records, peeking and skipping.
+TEST(buffered_stream_testing, test_buffered_stream_1)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("buffered_stream_1");
+    std::string contents;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        contents += static_cast<char>(i % 251);
+    }
+    {
+        std::ofstream stream(pathname, std::ios::binary);
+        stream << contents;
+    }
+    for (size_t mapping_threshold : { std::numeric_limits<size_t>::max(), size_t(0) })
+    {
+        buffered_reader reader;
+        reader.open(pathname, 128, mapping_threshold);
+        ASSERT_EQ(true, reader.is_open());
+        // Records larger than a chunk.
+        ASSERT_EQ(contents.substr(0, 300), reader.peek(300));
+        ASSERT_EQ(contents.substr(0, 300), reader.read(300));
+        ASSERT_EQ(300, reader.position());
+        ASSERT_EQ(contents.substr(300, 17), reader.read(17));
+        // Skipping beyond the buffered Bytes.
+        ASSERT_EQ(1000, reader.skip(1000));
+        ASSERT_EQ(1317, reader.position());
+        ASSERT_EQ(contents.substr(1317, 5), reader.read(5));
+        size_t position = reader.position();
+        while (position < contents.size())
+        {
+            auto record = reader.read(33);
+            ASSERT_EQ(contents.substr(position, 33), record);
+            position += record.size();
+        }
+        ASSERT_EQ(0, reader.read(1).size());
+        ASSERT_EQ(0, reader.skip(1));
+    }
+    std::remove(pathname.c_str());
+}
+
+// Writing, coalescing small writes and gathering large writes.
+TEST(buffered_stream_testing, test_buffered_stream_2)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("buffered_stream_2");
+    std::string expected;
+    {
+        buffered_writer writer;
+        writer.open(pathname, create_mode::create_not_existing, 64);
+        ASSERT_EQ(true, writer.is_open());
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            std::string part(i % 150, static_cast<char>('a' + i % 26));
+            writer.write(part);
+            expected += part;
+            ASSERT_EQ(expected.size(), writer.position());
+        }
+        writer.flush();
+        ASSERT_EQ(expected, read_file(pathname));
+        writer.write("tail", 4);
+        expected += "tail";
+        // The destructor writes the buffered Bytes.
+    }
+    ASSERT_EQ(expected, read_file(pathname));
+    // An existing file is appended to.
+    buffered_writer writer;
+    writer.open(pathname, create_mode::open_existing);
+    ASSERT_EQ(expected.size(), writer.position());
+    writer.write(std::string_view("!"));
+    writer.write(std::string_view());
+    writer.close();
+    ASSERT_EQ(false, writer.is_open());
+    ASSERT_EQ(expected + "!", read_file(pathname));
+    ASSERT_THROW(writer.write("?", 1), id::file_system::error);
+    std::remove(pathname.c_str());
+}
+
+} } } // namespace id::tests::file_system
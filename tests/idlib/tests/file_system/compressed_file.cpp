@@ -0,0 +1,326 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+#include <filesystem>
+#include <random>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Create contents which are partially compressible.
+std::string make_compressed_file_contents(size_t size, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::string contents;
+    contents.reserve(size);
+    while (contents.size() < size)
+    {
+        if (generator() % 2)
+        {
+            std::string word = "word" + std::to_string(generator() % 64) + " ";
+            contents.append(word);
+        }
+        else
+        {
+            contents.push_back((char)generator());
+        }
+    }
+    contents.resize(size);
+    return contents;
+}
+
+// Write a compressed file.
+void write_compressed_file(const std::string& pathname, const std::string& contents, uint32_t codec, size_t block_size)
+{
+    id::file_system::compressed_file_writer writer;
+    writer.open(pathname, codec, block_size);
+    ASSERT_TRUE(writer.is_open());
+    // Write in pieces of varying sizes.
+    for (size_t offset = 0, i = 0; offset < contents.size(); ++i)
+    {
+        size_t n = std::min(contents.size() - offset, (size_t)1 + (i * 7919) % (3 * block_size));
+        writer.write(contents.data() + offset, n);
+        offset += n;
+    }
+    ASSERT_EQ(contents.size(), writer.position());
+    writer.close();
+}
+
+// A codec inverting the Bytes of a block.
+class inverting_block_codec : public id::file_system::block_codec
+{
+public:
+    uint32_t id() const noexcept override { return 0x7E57; }
+    const char *name() const noexcept override { return "inverting"; }
+    size_t max_compressed_size(size_t size) const noexcept override { return size; }
+    size_t compress(const char *source, size_t source_size, char *target) const override
+    {
+        // Pretend that compression removes the last Byte of blocks ending with a zero Byte.
+        size_t size = source_size > 0 && 0 == source[source_size - 1] ? source_size - 1 : source_size;
+        for (size_t i = 0; i < size; ++i)
+        {
+            target[i] = ~source[i];
+        }
+        return size;
+    }
+    bool decompress(const char *source, size_t source_size, char *target, size_t target_size) const override
+    {
+        if (source_size + 1 != target_size)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < source_size; ++i)
+        {
+            target[i] = ~source[i];
+        }
+        target[source_size] = 0;
+        return true;
+    }
+};
+
+} // namespace
+
+// Compressing and decompressing blocks in the LZ4 block format.
+TEST(compressed_file_testing, test_compressed_file_0)
+{
+    using namespace id::file_system;
+    auto codec = find_block_codec(lz4_block_codec::identifier);
+    ASSERT_NE(nullptr, codec);
+    ASSERT_STREQ("lz4", codec->name());
+    std::vector<std::string> inputs = { std::string(), "a", "abcdefghijkl", "abcdefghijklm", std::string(100000, 'x'),
+                                        make_compressed_file_contents(200000, 1), make_compressed_file_contents(3, 2) };
+    std::mt19937 generator(3);
+    std::string random(70000, 0);
+    for (auto& c : random)
+    {
+        c = (char)generator();
+    }
+    inputs.push_back(random);
+    for (const auto& input : inputs)
+    {
+        std::vector<char> compressed(codec->max_compressed_size(input.size()));
+        size_t size = codec->compress(input.data(), input.size(), compressed.data());
+        ASSERT_LE(size, compressed.size());
+        std::string output(input.size(), 0);
+        ASSERT_TRUE(codec->decompress(compressed.data(), size, &output[0], output.size()));
+        ASSERT_EQ(input, output);
+        // A wrong size, a truncated block, or a corrupted block must be rejected or decompressed without
+        // accessing memory out of bounds.
+        std::string larger(input.size() + 1, 0);
+        ASSERT_FALSE(codec->decompress(compressed.data(), size, &larger[0], larger.size()));
+        if (size > 1)
+        {
+            ASSERT_FALSE(codec->decompress(compressed.data(), size - 1, &output[0], output.size()));
+        }
+        for (size_t i = 0; i < size; i += 1 + size / 64)
+        {
+            compressed[i] ^= 0x5A;
+            codec->decompress(compressed.data(), size, &output[0], output.size());
+            compressed[i] ^= 0x5A;
+        }
+    }
+    ASSERT_EQ(100000 + 100000 / 255 + 16, codec->max_compressed_size(100000));
+    ASSERT_LT(codec->compress(inputs[4].data(), inputs[4].size(), std::vector<char>(codec->max_compressed_size(100000)).data()), 1000);
+}
+
+// Decompressing a block created by the reference LZ4 implementation.
+TEST(compressed_file_testing, test_compressed_file_1)
+{
+    using namespace id::file_system;
+    const unsigned char block[] =
+    {
+        0xff, 0x1e, 0x54, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69, 0x63, 0x6b, 0x20, 0x62, 0x72, 0x6f, 0x77,
+        0x6e, 0x20, 0x66, 0x6f, 0x78, 0x20, 0x6a, 0x75, 0x6d, 0x70, 0x73, 0x20, 0x6f, 0x76, 0x65, 0x72,
+        0x20, 0x74, 0x68, 0x65, 0x20, 0x6c, 0x61, 0x7a, 0x79, 0x20, 0x64, 0x6f, 0x67, 0x2e, 0x20, 0x2d,
+        0x00, 0x29, 0x50, 0x20, 0x66, 0x6f, 0x78, 0x21,
+    };
+    const std::string expected = "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. The quick brown fox!";
+    std::string output(expected.size(), 0);
+    ASSERT_TRUE(lz4_block_codec().decompress(reinterpret_cast<const char *>(block), sizeof(block), &output[0], output.size()));
+    ASSERT_EQ(expected, output);
+}
+
+// Writing and reading compressed files at random offsets.
+TEST(compressed_file_testing, test_compressed_file_2)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("compressed_file_2");
+    std::string pathname = root + get_directory_separator() + "file.idcf";
+    const size_t block_size = 4096;
+    std::string contents = make_compressed_file_contents(100 * block_size + 123, 4);
+    write_compressed_file(pathname, contents, lz4_block_codec::identifier, block_size);
+    ASSERT_EQ(1, std::distance(std::filesystem::directory_iterator(root), std::filesystem::directory_iterator()));
+    ASSERT_LT(std::filesystem::file_size(pathname), contents.size());
+    compressed_file_reader reader(thread_pool::shared(), 4, 2);
+    reader.open(pathname);
+    ASSERT_TRUE(reader.is_open());
+    ASSERT_EQ(contents.size(), reader.size());
+    ASSERT_EQ(block_size, reader.block_size());
+    ASSERT_EQ(101, reader.number_of_blocks());
+    std::mt19937 generator(5);
+    for (size_t i = 0; i < 500; ++i)
+    {
+        size_t offset = generator() % (contents.size() + 10);
+        size_t length = generator() % (3 * block_size);
+        std::string buffer(length, 0);
+        size_t expected = offset < contents.size() ? std::min(length, contents.size() - offset) : 0;
+        ASSERT_EQ(expected, reader.read(offset, &buffer[0], length));
+        ASSERT_EQ(contents.substr(std::min(offset, contents.size()), expected), buffer.substr(0, expected));
+    }
+    auto block = reader.get_block(100);
+    ASSERT_EQ(contents.substr(100 * block_size), std::string(block->data(), block->size()));
+    ASSERT_ANY_THROW(reader.get_block(101));
+    reader.close();
+    ASSERT_FALSE(reader.is_open());
+    ASSERT_ANY_THROW(reader.read(0, &contents[0], 1));
+}
+
+// Sequential reads are served by the blocks decompressed ahead.
+TEST(compressed_file_testing, test_compressed_file_3)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("compressed_file_3");
+    std::string pathname = root + get_directory_separator() + "file.idcf";
+    const size_t block_size = 1024;
+    std::string contents = make_compressed_file_contents(64 * block_size, 6);
+    write_compressed_file(pathname, contents, lz4_block_codec::identifier, block_size);
+    compressed_file_reader reader(thread_pool::shared(), 16, 7);
+    reader.open(pathname);
+    ASSERT_TRUE(reader.is_open());
+    std::string buffer(contents.size(), 0);
+    // Reads of half a block: each eighth block is a miss, the following blocks were decompressed ahead.
+    for (size_t offset = 0; offset < contents.size(); offset += block_size / 2)
+    {
+        ASSERT_EQ(block_size / 2, reader.read(offset, &buffer[offset], block_size / 2));
+    }
+    ASSERT_EQ(contents, buffer);
+    ASSERT_EQ(64, reader.misses());
+    ASSERT_EQ(64 * 2 - 64 / 8, reader.hits());
+    // A read covering whole blocks decompresses into the buffer and does not fill the cache.
+    reader.clear();
+    std::string whole(contents.size(), 0);
+    ASSERT_EQ(contents.size(), reader.read(0, &whole[0], whole.size()));
+    ASSERT_EQ(contents, whole);
+    ASSERT_EQ(64 + 64, reader.misses());
+    ASSERT_ANY_THROW(compressed_file_reader(thread_pool::shared(), 0));
+}
+
+// Empty files, unregistered codecs, and abandoned writers.
+TEST(compressed_file_testing, test_compressed_file_4)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("compressed_file_4");
+    std::string separator = get_directory_separator();
+    std::string pathname = root + separator + "empty.idcf";
+    write_compressed_file(pathname, std::string(), stored_block_codec::identifier, 16);
+    compressed_file_reader reader;
+    reader.open(pathname);
+    ASSERT_TRUE(reader.is_open());
+    ASSERT_EQ(0, reader.size());
+    ASSERT_EQ(0, reader.number_of_blocks());
+    char byte;
+    ASSERT_EQ(0, reader.read(0, &byte, 1));
+    compressed_file_writer writer;
+    writer.open(root + separator + "unknown.idcf", 0xDEAD);
+    ASSERT_FALSE(writer.is_open());
+    writer.open(root + separator + "zero.idcf", lz4_block_codec::identifier, 0);
+    ASSERT_FALSE(writer.is_open());
+    ASSERT_ANY_THROW(writer.write("x", 1));
+    {
+        compressed_file_writer abandoned;
+        abandoned.open(root + separator + "abandoned.idcf");
+        ASSERT_TRUE(abandoned.is_open());
+        abandoned.write("abandoned");
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(root))
+    {
+        ASSERT_EQ(std::string::npos, entry.path().filename().string().find("abandoned"));
+    }
+}
+
+// Corrupted files are detected.
+TEST(compressed_file_testing, test_compressed_file_5)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("compressed_file_5");
+    std::string pathname = root + get_directory_separator() + "file.idcf";
+    std::string contents = make_compressed_file_contents(10000, 7);
+    write_compressed_file(pathname, contents, lz4_block_codec::identifier, 1000);
+    std::string bytes;
+    {
+        std::ifstream stream(pathname, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+    // A corrupted block is detected when it is read.
+    std::string corrupted = bytes;
+    corrupted[40] ^= 1;
+    std::ofstream(pathname, std::ios::binary | std::ios::trunc) << corrupted;
+    compressed_file_reader reader;
+    reader.open(pathname);
+    ASSERT_TRUE(reader.is_open());
+    std::string buffer(1000, 0);
+    ASSERT_ANY_THROW(reader.read(0, &buffer[0], buffer.size()));
+    ASSERT_EQ(1000, reader.read(5000, &buffer[0], buffer.size()));
+    ASSERT_EQ(contents.substr(5000, 1000), buffer);
+    reader.close();
+    // A corrupted index is detected when the file is opened.
+    corrupted = bytes;
+    corrupted[corrupted.size() - 50] ^= 1;
+    std::ofstream(pathname, std::ios::binary | std::ios::trunc) << corrupted;
+    reader.open(pathname);
+    ASSERT_FALSE(reader.is_open());
+    // A truncated file is not a valid compressed file.
+    std::ofstream(pathname, std::ios::binary | std::ios::trunc) << bytes.substr(0, bytes.size() - 1);
+    reader.open(pathname);
+    ASSERT_FALSE(reader.is_open());
+}
+
+// Registering a codec.
+TEST(compressed_file_testing, test_compressed_file_6)
+{
+    using namespace id::file_system;
+    if (!find_block_codec(0x7E57))
+    {
+        register_block_codec(std::make_shared<inverting_block_codec>());
+    }
+    ASSERT_ANY_THROW(register_block_codec(std::make_shared<inverting_block_codec>()));
+    ASSERT_ANY_THROW(register_block_codec(nullptr));
+    std::string root = make_temporary_directory("compressed_file_6");
+    std::string pathname = root + get_directory_separator() + "file.idcf";
+    // The first block ends with a zero Byte and is compressed, the second block is stored.
+    std::string contents = std::string("abc") + '\0' + "defg";
+    write_compressed_file(pathname, contents, 0x7E57, 4);
+    std::string bytes;
+    {
+        std::ifstream stream(pathname, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+    ASSERT_EQ(std::string("\x9e\x9d\x9c") + "defg", bytes.substr(32, 7));
+    compressed_file_reader reader;
+    reader.open(pathname);
+    ASSERT_TRUE(reader.is_open());
+    std::string buffer(contents.size(), 0);
+    ASSERT_EQ(contents.size(), reader.read(0, &buffer[0], buffer.size()));
+    ASSERT_EQ(contents, buffer);
+}
+
+} } } // namespace id::tests::file_system
@@ -0,0 +1,101 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Create a string of the given size with a repeating pattern.
+std::string make_hash_input(size_t size)
+{
+    std::string input;
+    for (size_t i = 0; i < size; ++i)
+    {
+        input.push_back(char('a' + i % 26));
+    }
+    return input;
+}
+
+} // namespace
+
+// The values of the hash must not change as they are stored in fingerprint cache files.
+TEST(content_hash_testing, test_content_hash_0)
+{
+    using namespace id::file_system;
+    const std::vector<std::pair<size_t, uint64_t>> expected =
+    {
+        { 0, 0x82ed2b6946f4b8a5ULL }, { 1, 0x0f80723a9ede6b2eULL }, { 3, 0x6c63cef433ec2b6eULL },
+        { 4, 0x95f69f7783eba12cULL }, { 8, 0xae913e56c1aceb3cULL }, { 9, 0x92013c1c67fbe592ULL },
+        { 16, 0xe111ab94ec45365dULL }, { 17, 0x5dd473eaf1fb8cefULL }, { 100, 0xbe1b1339511de460ULL },
+        { 240, 0x0970df7d951f1917ULL }, { 241, 0x1b0280e069db825bULL }, { 1000, 0xc62209aaae444f21ULL },
+        { 5000, 0x6a3dffc39e5fbf42ULL },
+    };
+    for (const auto& pair : expected)
+    {
+        std::string input = make_hash_input(pair.first);
+        ASSERT_EQ(pair.second, hash_bytes(input.data(), input.size()));
+    }
+}
+
+// The hash depends on every Byte, on the size, and on the seed.
+TEST(content_hash_testing, test_content_hash_1)
+{
+    using namespace id::file_system;
+    std::string input = make_hash_input(3000);
+    std::set<uint64_t> hashes;
+    for (size_t size = 0; size <= input.size(); size += 7)
+    {
+        ASSERT_TRUE(hashes.insert(hash_bytes(input.data(), size)).second);
+    }
+    uint64_t hash = hash_bytes(input.data(), input.size());
+    for (size_t i = 0; i < input.size(); i += 13)
+    {
+        input[i] ^= 1;
+        ASSERT_NE(hash, hash_bytes(input.data(), input.size()));
+        input[i] ^= 1;
+    }
+    ASSERT_NE(hash, hash_bytes(input.data(), input.size(), 1));
+    // The hash does not depend on the alignment of the input.
+    std::string shifted = " " + input;
+    ASSERT_EQ(hash, hash_bytes(shifted.data() + 1, input.size()));
+}
+
+// Hashing in parallel chunks does not depend on the thread pool.
+TEST(content_hash_testing, test_content_hash_2)
+{
+    using namespace id::file_system;
+    std::string input = make_hash_input(5 * content_hasher::chunk_size + 12345);
+    thread_pool pool(3);
+    uint64_t hash = content_hasher(pool).hash(input.data(), input.size());
+    ASSERT_EQ(hash, content_hasher(thread_pool::shared()).hash(input.data(), input.size()));
+    ASSERT_EQ(hash, pool.submit([&input]() { return content_hasher(thread_pool::shared()).hash(input.data(), input.size()); }).get());
+    ASSERT_NE(hash, hash_bytes(input.data(), input.size()));
+    // Inputs of at most one chunk are hashed by id::file_system::hash_bytes.
+    ASSERT_EQ(hash_bytes(input.data(), 1000), content_hasher(pool).hash(input.data(), 1000));
+    // Hashing a file.
+    std::string pathname = temporary_pathname("content_hash_2");
+    std::ofstream(pathname, std::ios::binary) << input;
+    ASSERT_EQ(hash, content_hasher(pool).hash(pathname));
+    ASSERT_THROW(content_hasher(pool).hash(pathname + "-missing"), id::file_system::error);
+}
+
+} } } // namespace id::tests::file_system
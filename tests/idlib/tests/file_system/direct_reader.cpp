@@ -0,0 +1,96 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+// Aligned buffers and allocators.
+TEST(direct_reader_testing, test_direct_reader_0)
+{
+    using namespace id::file_system;
+    aligned_buffer empty;
+    ASSERT_EQ(nullptr, empty.data());
+    ASSERT_EQ(0, empty.size());
+    aligned_buffer buffer(10000, 512);
+    ASSERT_EQ(10000, buffer.size());
+    ASSERT_EQ(512, buffer.alignment());
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(buffer.data()) % 512);
+    aligned_buffer other(std::move(buffer));
+    ASSERT_EQ(nullptr, buffer.data());
+    ASSERT_EQ(10000, other.size());
+    ASSERT_THROW(aligned_buffer(16, 3), id::file_system::error);
+    std::vector<char, aligned_allocator<char>> vector(12345);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(vector.data()) % aligned_buffer::default_alignment);
+}
+
+// Reading unaligned ranges of a file opened for direct input and output.
+TEST(direct_reader_testing, test_direct_reader_1)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("direct_reader_1");
+    const size_t size = 5 * aligned_buffer::default_alignment + 1234;
+    {
+        std::ofstream stream(pathname, std::ios::binary);
+        for (size_t i = 0; i < size; ++i)
+        {
+            stream.put(static_cast<char>(i % 251));
+        }
+    }
+    file_descriptor file;
+    file.open(pathname, access_mode::read, create_mode::open_existing,
+              open_flags::direct | open_flags::no_access_time | open_flags::close_on_exec);
+    if (!file.is_open())
+    {
+        // The file system does not support direct input and output.
+        file.open(pathname, access_mode::read, create_mode::open_existing);
+    }
+    ASSERT_EQ(true, file.is_open());
+    // A buffer smaller than the ranges to read.
+    direct_reader reader(file, 3 * aligned_buffer::default_alignment);
+    std::vector<char> buffer(size + 1);
+    for (size_t offset : { size_t(0), size_t(1), size_t(4095), size_t(4096), size_t(10000) })
+    {
+        for (size_t length : { size_t(1), size_t(100), size_t(4096), size_t(3 * 4096 + 17), size - offset })
+        {
+            if (offset + length > size)
+            {
+                continue;
+            }
+            reader.read(offset, buffer.data() + 1, length);
+            for (size_t i = 0; i < length; ++i)
+            {
+                ASSERT_EQ(static_cast<char>((offset + i) % 251), buffer[1 + i]);
+            }
+        }
+    }
+    // Aligned reads bypass the buffer.
+    aligned_buffer aligned(2 * aligned_buffer::default_alignment);
+    ASSERT_EQ(aligned.size(), reader.read_some(4096, aligned.data(), aligned.size()));
+    ASSERT_EQ(static_cast<char>(4096 % 251), aligned.data()[0]);
+    // Reading beyond the end of the file.
+    ASSERT_EQ(34, reader.read_some(size - 34, buffer.data(), 100));
+    ASSERT_EQ(static_cast<char>((size - 1) % 251), buffer[33]);
+    ASSERT_EQ(0, reader.read_some(size + 10, buffer.data(), 100));
+    ASSERT_THROW(reader.read(size - 34, buffer.data(), 100), id::file_system::error);
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+} } } // namespace id::tests::file_system
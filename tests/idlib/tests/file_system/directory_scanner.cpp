@@ -0,0 +1,137 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include <filesystem>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Create a tree of directories and files, return the pathnames relative to the root and the sizes of the files.
+std::map<std::string, uint64_t> make_tree(const std::string& root)
+{
+    std::filesystem::remove_all(root);
+    std::map<std::string, uint64_t> entries;
+    std::string separator = id::file_system::get_directory_separator();
+    std::filesystem::create_directories(root);
+    for (size_t i = 0; i < 5; ++i)
+    {
+        std::string directory = "d" + std::to_string(i);
+        std::filesystem::create_directories(root + separator + directory);
+        entries[directory] = 0;
+        for (size_t j = 0; j < 3; ++j)
+        {
+            std::string subdirectory = directory + separator + "e" + std::to_string(j);
+            std::filesystem::create_directories(root + separator + subdirectory);
+            entries[subdirectory] = 0;
+            for (size_t k = 0; k < 10; ++k)
+            {
+                std::string file = subdirectory + separator + "f" + std::to_string(k);
+                std::ofstream(root + separator + file) << std::string(i + j + k, 'x');
+                entries[file] = i + j + k;
+            }
+        }
+    }
+    std::ofstream(root + separator + "top") << "top";
+    entries["top"] = 3;
+    return entries;
+}
+
+} // namespace
+
+// Enumerating a tree with a handler.
+TEST(directory_scanner_testing, test_directory_scanner_0)
+{
+    using namespace id::file_system;
+    std::string root = ::testing::TempDir() + "idlib-directory_scanner_0";
+    auto expected = make_tree(root);
+    std::mutex mutex;
+    std::map<std::string, uint64_t> actual;
+    directory_scanner().scan(root, [&](const directory_entry& entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(0, actual.count(entry.pathname));
+        ASSERT_NE(0, entry.modification_time);
+        if (entry_type::directory == entry.type)
+        {
+            actual[entry.pathname] = 0;
+        }
+        else
+        {
+            ASSERT_EQ(entry_type::regular, entry.type);
+            actual[entry.pathname] = entry.size;
+        }
+    });
+    ASSERT_EQ(expected, actual);
+    // Without attributes.
+    thread_pool pool(3);
+    std::atomic<size_t> count(0);
+    directory_scanner(pool, false).scan(root, [&](const directory_entry& entry)
+    {
+        count++;
+        ASSERT_EQ(0, entry.size);
+        ASSERT_EQ(0, entry.modification_time);
+        ASSERT_NE(entry_type::unknown, entry.type);
+    });
+    ASSERT_EQ(expected.size(), count);
+    // Failures.
+    ASSERT_THROW(directory_scanner().scan(root + "-does-not-exist", [](const directory_entry&) {}), id::file_system::error);
+    ASSERT_THROW(directory_scanner().scan(root, [](const directory_entry&) { throw std::runtime_error("stop"); }), std::runtime_error);
+    std::filesystem::remove_all(root);
+}
+
+// Streaming a tree through a bounded queue.
+TEST(directory_scanner_testing, test_directory_scanner_1)
+{
+    using namespace id::file_system;
+    std::string root = ::testing::TempDir() + "idlib-directory_scanner_1";
+    auto expected = make_tree(root);
+    {
+        std::map<std::string, uint64_t> actual;
+        directory_stream stream(root, 2);
+        directory_entry entry;
+        while (stream.next(entry))
+        {
+            actual[entry.pathname] = entry_type::directory == entry.type ? 0 : entry.size;
+        }
+        ASSERT_EQ(expected, actual);
+        ASSERT_EQ(false, stream.next(entry));
+    }
+    {
+        // Stop streaming early.
+        directory_stream stream(root, 1);
+        directory_entry entry;
+        ASSERT_EQ(true, stream.next(entry));
+        // The blocked enumeration does not block the shared thread pool.
+        std::atomic<bool> invoked(false);
+        id::task_group group;
+        id::thread_pool::shared().post(group, [&invoked]() { invoked = true; });
+        group.wait();
+        ASSERT_EQ(true, invoked.load());
+    }
+    {
+        directory_stream stream(root + "-does-not-exist");
+        directory_entry entry;
+        ASSERT_THROW(stream.next(entry), id::file_system::error);
+        ASSERT_EQ(false, stream.next(entry));
+    }
+    std::filesystem::remove_all(root);
+}
+
+} } } // namespace id::tests::file_system
@@ -0,0 +1,145 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+// Positional reads and writes.
+TEST(file_descriptor_testing, test_file_descriptor_0)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("file_descriptor_0");
+    file_descriptor file;
+    file.open(pathname, access_mode::read_write, create_mode::create_not_existing);
+    ASSERT_EQ(true, file.is_open());
+    file.write(0, "Hello, World!", 13);
+    file.write(7, "there", 5);
+    ASSERT_EQ(13, file.size());
+    // Writing beyond the end of the file extends the file.
+    file.write(20, "!", 1);
+    ASSERT_EQ(21, file.size());
+    char buffer[32];
+    ASSERT_EQ(13, file.read_some(0, buffer, 13));
+    ASSERT_EQ("Hello, there!", std::string(buffer, 13));
+    // Short reads at the end of the file.
+    ASSERT_EQ(1, file.read_some(20, buffer, 32));
+    ASSERT_EQ(0, file.read_some(21, buffer, 32));
+    ASSERT_THROW(file.read(20, buffer, 2), id::file_system::error);
+    file.read(7, buffer, 5);
+    ASSERT_EQ("there", std::string(buffer, 5));
+    file.close();
+    ASSERT_THROW(file.read_some(0, buffer, 1), id::file_system::error);
+    ASSERT_THROW(file.write(0, buffer, 1), id::file_system::error);
+    std::remove(pathname.c_str());
+}
+
+// Scatter/gather reads and writes.
+TEST(file_descriptor_testing, test_file_descriptor_1)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("file_descriptor_1");
+    file_descriptor file;
+    file.open(pathname, access_mode::read_write, create_mode::create_not_existing);
+    ASSERT_EQ(true, file.is_open());
+    // More buffers than fit into the local vectors, including empty buffers.
+    std::vector<std::string> parts;
+    std::vector<const_buffer> gather;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        parts.push_back(std::string(i % 7, static_cast<char>('a' + i % 26)));
+    }
+    std::string expected;
+    for (const auto& part : parts)
+    {
+        gather.push_back({ part.data(), part.size() });
+        expected += part;
+    }
+    file.write(3, gather.data(), gather.size());
+    ASSERT_EQ(3 + expected.size(), file.size());
+    std::vector<std::string> targets;
+    std::vector<mutable_buffer> scatter;
+    for (const auto& part : parts)
+    {
+        targets.push_back(std::string(part.size(), ' '));
+    }
+    for (auto& target : targets)
+    {
+        scatter.push_back({ &target[0], target.size() });
+    }
+    file.read(3, scatter.data(), scatter.size());
+    std::string actual;
+    for (const auto& target : targets)
+    {
+        actual += target;
+    }
+    ASSERT_EQ(expected, actual);
+    // Scatter reads stop at the end of the file.
+    char first[4], second[8];
+    mutable_buffer buffers[] = { { first, sizeof(first) }, { second, sizeof(second) } };
+    ASSERT_EQ(6, file.read_some(3 + expected.size() - 6, buffers, 2));
+    ASSERT_EQ(expected.substr(expected.size() - 6), std::string(first, 4) + std::string(second, 2));
+    ASSERT_THROW(file.read(3 + expected.size() - 6, buffers, 2), id::file_system::error);
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+// Concurrent reads of disjoint regions.
+TEST(file_descriptor_testing, test_file_descriptor_2)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("file_descriptor_2");
+    const size_t number_of_threads = 4, region_size = 64 * 1024;
+    file_descriptor file;
+    file.open(pathname, access_mode::read_write, create_mode::create_not_existing);
+    ASSERT_EQ(true, file.is_open());
+    for (size_t i = 0; i < number_of_threads; ++i)
+    {
+        std::vector<char> region(region_size, static_cast<char>('A' + i));
+        file.write(i * region_size, region.data(), region.size());
+    }
+    std::vector<std::thread> threads;
+    std::vector<int> results(number_of_threads, 0);
+    for (size_t i = 0; i < number_of_threads; ++i)
+    {
+        threads.emplace_back([&file, &results, i, region_size]()
+        {
+            std::vector<char> region(region_size);
+            bool result = true;
+            for (size_t j = 0; j < 16; ++j)
+            {
+                file.read(i * region_size, region.data(), region.size());
+                result = result && std::all_of(region.begin(), region.end(), [i](char c) { return c == static_cast<char>('A' + i); });
+            }
+            results[i] = result ? 1 : 0;
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t i = 0; i < number_of_threads; ++i)
+    {
+        ASSERT_EQ(1, results[i]);
+    }
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+} } } // namespace id::tests::file_system
@@ -0,0 +1,151 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+#include <filesystem>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Collects the batches published by a file watcher.
+struct watcher_recorder
+{
+    std::vector<std::vector<id::file_system::file_change>> batches;
+    std::chrono::steady_clock::time_point published;
+
+    std::map<std::string, id::file_system::change_type> last() const
+    {
+        std::map<std::string, id::file_system::change_type> changes;
+        for (const auto& change : batches.back())
+        {
+            changes[change.pathname] = change.type;
+        }
+        return changes;
+    }
+};
+
+} // namespace
+
+// Creating, modifying, and removing files.
+TEST(file_watcher_testing, test_file_watcher_0)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("file_watcher_0");
+    std::string separator = get_directory_separator();
+    file_watcher watcher(std::chrono::milliseconds(20));
+    watcher.add(root);
+    watcher_recorder recorder;
+    watcher.changed.subscribe([&recorder](const std::vector<file_change>& changes) { recorder.batches.push_back(changes); });
+    // A created and modified file is reported as created.
+    std::ofstream(root + separator + "a") << "a";
+    std::ofstream(root + separator + "a", std::ios::app) << "b";
+    ASSERT_EQ(1, watcher.poll(std::chrono::seconds(5)));
+    ASSERT_EQ(1, recorder.batches.size());
+    ASSERT_EQ(change_type::created, recorder.last()[root + separator + "a"]);
+    // A modified file is reported as modified.
+    std::ofstream(root + separator + "a", std::ios::app) << "c";
+    ASSERT_EQ(1, watcher.poll(std::chrono::seconds(5)));
+    ASSERT_EQ(change_type::modified, recorder.last()[root + separator + "a"]);
+    // A modified and removed file is reported as removed.
+    std::ofstream(root + separator + "a", std::ios::app) << "d";
+    std::filesystem::remove(root + separator + "a");
+    ASSERT_EQ(1, watcher.poll(std::chrono::seconds(5)));
+    ASSERT_EQ(change_type::removed, recorder.last()[root + separator + "a"]);
+    // A created and removed file is not reported.
+    std::ofstream(root + separator + "b") << "b";
+    std::filesystem::remove(root + separator + "b");
+    ASSERT_EQ(0, watcher.poll(std::chrono::milliseconds(200)));
+    ASSERT_EQ(0, watcher.pending());
+    ASSERT_EQ(3, recorder.batches.size());
+}
+
+// Watching subdirectories including subdirectories created while watching.
+TEST(file_watcher_testing, test_file_watcher_1)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("file_watcher_1");
+    std::string separator = get_directory_separator();
+    std::filesystem::create_directories(root + separator + "x" + separator + "y");
+    file_watcher watcher(std::chrono::milliseconds(20));
+    watcher.add(root);
+    watcher_recorder recorder;
+    watcher.changed.subscribe([&recorder](const std::vector<file_change>& changes) { recorder.batches.push_back(changes); });
+    // Existing subdirectories are watched.
+    std::ofstream(root + separator + "x" + separator + "y" + separator + "a") << "a";
+    ASSERT_EQ(1, watcher.poll(std::chrono::seconds(5)));
+    ASSERT_EQ(change_type::created, recorder.last()[root + separator + "x" + separator + "y" + separator + "a"]);
+    // Files created in a new subdirectory are reported even if they are created before the subdirectory is watched.
+    std::filesystem::create_directories(root + separator + "z");
+    std::ofstream(root + separator + "z" + separator + "b") << "b";
+    while (recorder.batches.size() < 2 || 2 > recorder.last().size())
+    {
+        ASSERT_NE(0, watcher.poll(std::chrono::seconds(5)));
+    }
+    ASSERT_EQ(change_type::created, recorder.last()[root + separator + "z"]);
+    ASSERT_EQ(change_type::created, recorder.last()[root + separator + "z" + separator + "b"]);
+    // New subdirectories are watched.
+    std::ofstream(root + separator + "z" + separator + "b", std::ios::app) << "c";
+    ASSERT_EQ(1, watcher.poll(std::chrono::seconds(5)));
+    ASSERT_EQ(change_type::modified, recorder.last()[root + separator + "z" + separator + "b"]);
+    // Removed trees are not watched.
+    watcher.remove(root);
+    std::ofstream(root + separator + "c") << "c";
+    ASSERT_EQ(0, watcher.poll(std::chrono::milliseconds(200)));
+}
+
+// Measuring the latency between a change and its publication.
+TEST(file_watcher_testing, test_file_watcher_2)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("file_watcher_2");
+    std::string separator = get_directory_separator();
+    const auto window = std::chrono::milliseconds(10);
+    file_watcher watcher(window);
+    watcher.add(root);
+    watcher_recorder recorder;
+    watcher.changed.subscribe([&recorder](const std::vector<file_change>& changes)
+    {
+        recorder.published = std::chrono::steady_clock::now();
+        recorder.batches.push_back(changes);
+    });
+    std::chrono::nanoseconds total(0), maximum(0);
+    const size_t count = 20;
+    for (size_t i = 0; i < count; ++i)
+    {
+        // A burst of writes to a few files is published as one batch.
+        auto changed = std::chrono::steady_clock::now();
+        for (size_t j = 0; j < 16; ++j)
+        {
+            std::ofstream(root + separator + "f" + std::to_string(j % 4), std::ios::app) << j;
+        }
+        ASSERT_EQ(4, watcher.poll(std::chrono::seconds(5)));
+        auto latency = recorder.published - changed;
+        ASSERT_LE(window, latency);
+        total += latency;
+        maximum = std::max(maximum, std::chrono::duration_cast<std::chrono::nanoseconds>(latency));
+    }
+    ASSERT_EQ(count, recorder.batches.size());
+    ASSERT_GT(std::chrono::seconds(5), maximum);
+    ::testing::Test::RecordProperty("mean_latency_us", (int)(std::chrono::duration_cast<std::chrono::microseconds>(total).count() / count));
+    ::testing::Test::RecordProperty("maximum_latency_us", (int)std::chrono::duration_cast<std::chrono::microseconds>(maximum).count());
+}
+
+} } } // namespace id::tests::file_system
@@ -0,0 +1,111 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+#include <filesystem>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Write a file and set its modification time such that it is older than the timestamp granularity.
+void write_aged_file(const std::string& pathname, const std::string& contents, int seconds_ago)
+{
+    std::ofstream(pathname, std::ios::binary | std::ios::trunc) << contents;
+    std::filesystem::last_write_time(pathname, std::filesystem::file_time_type::clock::now() - std::chrono::seconds(seconds_ago));
+}
+
+} // namespace
+
+// Unchanged files are not rehashed.
+TEST(fingerprint_cache_testing, test_fingerprint_cache_0)
+{
+    using namespace id::file_system;
+    std::string a = temporary_pathname("fingerprint_cache_0-a"), b = temporary_pathname("fingerprint_cache_0-b");
+    write_aged_file(a, "hello", 60);
+    write_aged_file(b, "world", 60);
+    fingerprint_cache cache;
+    ASSERT_EQ(hash_bytes("hello", 5), cache.get(a));
+    ASSERT_EQ(hash_bytes("world", 5), cache.get(b));
+    ASSERT_EQ(hash_bytes("hello", 5), cache.get(a));
+    ASSERT_EQ(2, cache.size());
+    ASSERT_EQ(1, cache.hits());
+    ASSERT_EQ(2, cache.misses());
+    // A modified file is rehashed.
+    write_aged_file(a, "hallo", 30);
+    ASSERT_EQ(hash_bytes("hallo", 5), cache.get(a));
+    ASSERT_EQ(3, cache.misses());
+    // A recently modified file is rehashed until it is older than the timestamp granularity.
+    std::ofstream(b, std::ios::binary | std::ios::trunc) << "earth";
+    ASSERT_EQ(hash_bytes("earth", 5), cache.get(b));
+    ASSERT_EQ(hash_bytes("earth", 5), cache.get(b));
+    ASSERT_EQ(5, cache.misses());
+    cache.erase(a);
+    ASSERT_EQ(1, cache.size());
+    cache.clear();
+    ASSERT_EQ(0, cache.size());
+    ASSERT_THROW(cache.get(a + "-missing"), id::file_system::error);
+}
+
+// Saving and loading a cache.
+TEST(fingerprint_cache_testing, test_fingerprint_cache_1)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("fingerprint_cache_1");
+    std::string separator = get_directory_separator();
+    std::vector<std::string> pathnames;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        pathnames.push_back(root + separator + "f" + std::to_string(i));
+        write_aged_file(pathnames.back(), std::string(i, 'x'), 60);
+    }
+    std::string cache_pathname = root + separator + "cache";
+    {
+        fingerprint_cache cache;
+        ASSERT_FALSE(cache.load(cache_pathname));
+        for (const auto& pathname : pathnames)
+        {
+            cache.get(pathname);
+        }
+        cache.save(cache_pathname);
+    }
+    {
+        fingerprint_cache cache;
+        ASSERT_TRUE(cache.load(cache_pathname));
+        ASSERT_EQ(pathnames.size(), cache.size());
+        for (size_t i = 0; i < pathnames.size(); ++i)
+        {
+            ASSERT_EQ(hash_bytes(std::string(i, 'x').data(), i), cache.get(pathnames[i]));
+        }
+        ASSERT_EQ(pathnames.size(), cache.hits());
+        ASSERT_EQ(0, cache.misses());
+    }
+    // A corrupted cache file is rejected.
+    {
+        std::fstream file(cache_pathname, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(20);
+        file.put('!');
+    }
+    fingerprint_cache cache;
+    ASSERT_FALSE(cache.load(cache_pathname));
+    ASSERT_EQ(0, cache.size());
+}
+
+} } } // namespace id::tests::file_system
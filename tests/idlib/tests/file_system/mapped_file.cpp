@@ -0,0 +1,190 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+// Writing through the mapping.
+TEST(mapped_file_testing, test_mapped_file_0)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_file_0");
+    mapped_file_descriptor file;
+    file.open_write(pathname, create_mode::create_not_existing, 6);
+    ASSERT_EQ(true, file.is_open());
+    ASSERT_EQ(true, file.is_opened_for_writing());
+    ASSERT_EQ(false, file.is_opened_for_reading());
+    ASSERT_EQ(6, file.size());
+    std::memcpy(file.data(), "Hello!", 6);
+    file.flush(flush_mode::synchronous);
+    ASSERT_EQ("Hello!", read_file(pathname));
+    file.close();
+    ASSERT_EQ(false, file.is_open());
+    // Reopen for reading.
+    file.open_read(pathname, create_mode::open_existing);
+    ASSERT_EQ(true, file.is_open());
+    ASSERT_EQ(true, file.is_opened_for_reading());
+    ASSERT_EQ(6, file.size());
+    ASSERT_EQ("Hello!", std::string(file.data(), file.size()));
+    ASSERT_THROW(file.flush(), id::file_system::error);
+    ASSERT_THROW(file.resize(12), id::file_system::error);
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+// Growing and shrinking the mapping.
+TEST(mapped_file_testing, test_mapped_file_1)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_file_1");
+    mapped_file_descriptor file;
+    file.open_write(pathname, create_mode::create_not_existing, 0);
+    ASSERT_EQ(true, file.is_open());
+    ASSERT_EQ(0, file.size());
+    const size_t page = 4096;
+    for (size_t size = page; size <= 64 * page; size *= 2)
+    {
+        size_t old_size = file.size();
+        file.resize(size);
+        ASSERT_EQ(size, file.size());
+        std::memset(file.data() + old_size, 'a' + (int)(size / page % 26), size - old_size);
+    }
+    ASSERT_EQ('b', file.data()[0]);
+    ASSERT_EQ('c', file.data()[page]);
+    file.flush(page, 3 * page + 17, flush_mode::asynchronous);
+    ASSERT_THROW(file.flush(64 * page, 1), id::file_system::error);
+    file.resize(page + 1);
+    ASSERT_EQ(page + 1, file.size());
+    file.close();
+    auto contents = read_file(pathname);
+    ASSERT_EQ(page + 1, contents.size());
+    ASSERT_EQ('b', contents[0]);
+    ASSERT_EQ('c', contents[page]);
+    std::remove(pathname.c_str());
+}
+
+// An existing file is resized when opened for writing.
+TEST(mapped_file_testing, test_mapped_file_2)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_file_2");
+    {
+        std::ofstream stream(pathname, std::ios::binary);
+        stream << "0123456789";
+    }
+    mapped_file_descriptor file;
+    file.open_write(pathname, create_mode::open_existing, 4);
+    ASSERT_EQ(true, file.is_open());
+    ASSERT_EQ("0123", std::string(file.data(), file.size()));
+    file.close();
+    ASSERT_EQ("0123", read_file(pathname));
+    // Opening a non-existing file fails.
+    std::remove(pathname.c_str());
+    file.open_write(pathname, create_mode::open_existing, 4);
+    ASSERT_EQ(false, file.is_open());
+}
+
+// Access advice and prefetching.
+TEST(mapped_file_testing, test_mapped_file_3)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_file_3");
+    const size_t size = 1024 * 1024 + 123;
+    {
+        mapped_file_descriptor file;
+        file.open_write(pathname, create_mode::create_not_existing, size);
+        ASSERT_EQ(true, file.is_open());
+        for (size_t i = 0; i < size; ++i)
+        {
+            file.data()[i] = (char)(i % 251);
+        }
+    }
+    mapped_file_descriptor file;
+    file.open_read(pathname, create_mode::open_existing, map_flags::populate);
+    ASSERT_EQ(true, file.is_open());
+    ASSERT_EQ(size, file.size());
+    ASSERT_EQ(true, file.advise(access_advice::sequential));
+    ASSERT_EQ(true, file.advise(access_advice::random, 17, 4096));
+    ASSERT_EQ(true, file.advise(access_advice::dont_need, 5000, 100000));
+    file.advise(access_advice::huge_page);
+    file.prefetch(size - 10, 10);
+    ASSERT_THROW(file.prefetch(size - 10, 11), id::file_system::error);
+    ASSERT_THROW(file.advise(access_advice::normal, size + 1, 0), id::file_system::error);
+    ASSERT_EQ(true, file.advise(access_advice::normal));
+    // The advice does not change the contents.
+    for (size_t i = 0; i < size; i += 4099)
+    {
+        ASSERT_EQ((char)(i % 251), file.data()[i]);
+    }
+    file.close();
+    ASSERT_THROW(file.advise(access_advice::normal), id::file_system::error);
+    std::remove(pathname.c_str());
+}
+
+// Mapping with huge pages, private copies and NUMA placement.
+TEST(mapped_file_testing, test_mapped_file_4)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_file_4");
+    std::string contents;
+    for (size_t i = 0; i < 3 * 1024 * 1024 + 17; ++i)
+    {
+        contents.push_back((char)(i * 7 + i / 4096));
+    }
+    std::ofstream(pathname, std::ios::binary) << contents;
+    const map_flags flags[] =
+    {
+        map_flags::huge_pages,
+        map_flags::huge_pages | map_flags::populate,
+        map_flags::private_copy,
+        map_flags::private_copy | map_flags::numa_local,
+        map_flags::private_copy | map_flags::numa_interleave | map_flags::populate,
+    };
+    for (auto flag : flags)
+    {
+        mapped_file_descriptor file;
+        file.open_read(pathname, create_mode::open_existing, flag);
+        ASSERT_EQ(true, file.is_open());
+        ASSERT_EQ(true, file.is_opened_for_reading());
+        ASSERT_EQ(contents.size(), file.size());
+        ASSERT_EQ(0, std::memcmp(contents.data(), file.data(), contents.size()));
+        file.advise(access_advice::random);
+        // Advising that the pages are not needed does not discard the contents.
+        file.advise(access_advice::dont_need);
+        ASSERT_EQ(0, std::memcmp(contents.data(), file.data(), contents.size()));
+        file.close();
+        ASSERT_EQ(false, file.is_open());
+    }
+    // A private copy of an empty file.
+    std::ofstream(pathname, std::ios::binary | std::ios::trunc);
+    mapped_file_descriptor file;
+    file.open_read(pathname, create_mode::open_existing, map_flags::private_copy | map_flags::huge_pages);
+    ASSERT_EQ(true, file.is_open());
+    ASSERT_EQ(0, file.size());
+    // Huge pages when writing.
+    file.open_write(pathname, create_mode::open_existing, 4 * 1024 * 1024, map_flags::huge_pages | map_flags::populate);
+    ASSERT_EQ(true, file.is_opened_for_writing());
+    std::memcpy(file.data() + 4 * 1024 * 1024 - 6, "Hello!", 6);
+    file.resize(5 * 1024 * 1024);
+    file.close();
+    ASSERT_EQ("Hello!", read_file(pathname).substr(4 * 1024 * 1024 - 6, 6));
+}
+
+} } } // namespace id::tests::file_system
@@ -0,0 +1,171 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+#include <filesystem>
+#include <thread>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Write a file.
+void write_mapped_file_pool_file(const std::string& pathname, const std::string& contents)
+{
+    std::ofstream(pathname, std::ios::binary | std::ios::trunc) << contents;
+}
+
+} // namespace
+
+// Requests for the same file share a mapping.
+TEST(mapped_file_pool_testing, test_mapped_file_pool_0)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("mapped_file_pool_0");
+    std::string pathname = root + get_directory_separator() + "file";
+    write_mapped_file_pool_file(pathname, "Hello, World!");
+    mapped_file_pool pool;
+    auto first = pool.get(pathname);
+    ASSERT_TRUE(first->is_opened_for_reading());
+    ASSERT_EQ("Hello, World!", std::string(first->data(), first->size()));
+    auto second = pool.get(pathname);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(1, pool.hits());
+    ASSERT_EQ(1, pool.misses());
+    ASSERT_EQ(1, pool.size());
+    ASSERT_EQ(13, pool.mapped_size());
+#if defined(ID_LINUX)
+    // Another pathname of the same file.
+    std::filesystem::create_hard_link(pathname, root + get_directory_separator() + "link");
+    ASSERT_EQ(first, pool.get(root + get_directory_separator() + "link"));
+#endif
+    // Other map flags require another mapping.
+    auto copy = pool.get(pathname, map_flags::private_copy);
+    ASSERT_NE(first, copy);
+    ASSERT_EQ("Hello, World!", std::string(copy->data(), copy->size()));
+    ASSERT_EQ(2, pool.size());
+    ASSERT_ANY_THROW(pool.get(root + get_directory_separator() + "missing"));
+    ASSERT_EQ(&mapped_file_pool::get_default(), &mapped_file_pool::get_default());
+}
+
+// Changed files are mapped again.
+TEST(mapped_file_pool_testing, test_mapped_file_pool_1)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("mapped_file_pool_1");
+    std::string pathname = root + get_directory_separator() + "file";
+    write_mapped_file_pool_file(pathname, "old");
+    mapped_file_pool pool;
+    auto old_file = pool.get(pathname);
+    // Replace the file.
+    write_mapped_file_pool_file(pathname + ".new", "new contents");
+    std::filesystem::rename(pathname + ".new", pathname);
+    auto new_file = pool.get(pathname);
+    ASSERT_NE(old_file, new_file);
+    ASSERT_EQ("new contents", std::string(new_file->data(), new_file->size()));
+    // References to the old mapping remain valid.
+    ASSERT_EQ("old", std::string(old_file->data(), old_file->size()));
+    // Resize the file in place.
+    write_mapped_file_pool_file(pathname, "newer");
+    auto newer_file = pool.get(pathname);
+    ASSERT_NE(new_file, newer_file);
+    ASSERT_EQ("newer", std::string(newer_file->data(), newer_file->size()));
+    ASSERT_EQ(0, pool.hits());
+    ASSERT_EQ(3, pool.misses());
+    // The mapping of the replaced file is unmapped like any other unused mapping.
+    ASSERT_EQ(2, pool.size());
+    old_file.reset();
+    new_file.reset();
+    pool.clear();
+    ASSERT_EQ(1, pool.size());
+    ASSERT_EQ(5, pool.mapped_size());
+}
+
+// Unused mappings are evicted if the budget is exceeded.
+TEST(mapped_file_pool_testing, test_mapped_file_pool_2)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("mapped_file_pool_2");
+    std::vector<std::string> pathnames;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        pathnames.push_back(root + get_directory_separator() + std::to_string(i));
+        write_mapped_file_pool_file(pathnames.back(), std::string(1000, (char)('a' + i)));
+    }
+    mapped_file_pool pool(2500);
+    ASSERT_EQ(2500, pool.budget());
+    auto used = pool.get(pathnames[0]);
+    pool.get(pathnames[1]);
+    pool.get(pathnames[2]);
+    ASSERT_EQ(2, pool.size());
+    ASSERT_EQ(2000, pool.mapped_size());
+    // The least recently used unused mapping is evicted, the used mapping is retained.
+    pool.get(pathnames[3]);
+    ASSERT_EQ(2, pool.size());
+    ASSERT_EQ(used, pool.get(pathnames[0]));
+    // Mappings in use are retained even if the budget is exceeded.
+    pool.set_budget(0);
+    ASSERT_EQ(1, pool.size());
+    ASSERT_EQ(used, pool.get(pathnames[0]));
+    used.reset();
+    pool.clear();
+    ASSERT_EQ(0, pool.size());
+    ASSERT_EQ(0, pool.mapped_size());
+}
+
+// Concurrent requests.
+TEST(mapped_file_pool_testing, test_mapped_file_pool_3)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("mapped_file_pool_3");
+    std::vector<std::string> pathnames;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        pathnames.push_back(root + get_directory_separator() + std::to_string(i));
+        write_mapped_file_pool_file(pathnames.back(), std::string(4096 + i, (char)('a' + i)));
+    }
+    mapped_file_pool pool(4 * 4096);
+    std::atomic<size_t> failures(0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&pool, &pathnames, &failures, i]()
+        {
+            for (size_t j = 0; j < 1000; ++j)
+            {
+                size_t k = (i + j) % pathnames.size();
+                auto file = pool.get(pathnames[k]);
+                if (file->size() != 4096 + k || file->data()[k] != (char)('a' + k))
+                {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(4000, pool.hits() + pool.misses());
+    ASSERT_GE(4 * 4096, pool.mapped_size());
+}
+
+} } } // namespace id::tests::file_system
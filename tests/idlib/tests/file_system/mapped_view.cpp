@@ -0,0 +1,181 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Create a file of the specified size, the Byte at offset i is i % 251.
+void write_pattern(const std::string& pathname, size_t size)
+{
+    std::ofstream stream(pathname, std::ios::binary);
+    for (size_t i = 0; i < size; ++i)
+    {
+        stream.put(static_cast<char>(i % 251));
+    }
+}
+
+} // namespace
+
+// Views at unaligned offsets.
+TEST(mapped_view_testing, test_mapped_view_0)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_view_0");
+    const size_t size = 4 * mapped_view::alignment() + 123;
+    write_pattern(pathname, size);
+    file_descriptor file;
+    file.open(pathname, access_mode::read, create_mode::open_existing);
+    ASSERT_EQ(true, file.is_open());
+    for (size_t offset : { size_t(0), size_t(1), mapped_view::alignment() - 1, mapped_view::alignment(), size - 17 })
+    {
+        mapped_view view(file, offset, 17);
+        ASSERT_EQ(true, view.is_open());
+        ASSERT_EQ(offset, view.offset());
+        ASSERT_EQ(17, view.size());
+        for (size_t i = 0; i < 17; ++i)
+        {
+            ASSERT_EQ(static_cast<char>((offset + i) % 251), view.data()[i]);
+        }
+        ASSERT_EQ(true, view.contains(offset, 17));
+        ASSERT_EQ(true, view.contains(offset + 16, 1));
+        ASSERT_EQ(false, view.contains(offset, 18));
+        ASSERT_EQ(false, view.contains(offset + 17, 1));
+    }
+    // Out of bounds.
+    mapped_view view(file, size - 16, 17);
+    ASSERT_EQ(false, view.is_open());
+    // Move.
+    view.open(file, 3, 5);
+    mapped_view other(std::move(view));
+    ASSERT_EQ(true, other.is_open());
+    ASSERT_EQ(false, view.is_open());
+    ASSERT_EQ(3, other.offset());
+    other.close();
+    ASSERT_EQ(false, other.is_open());
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+// Writing through a view.
+TEST(mapped_view_testing, test_mapped_view_1)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_view_1");
+    const size_t size = 2 * mapped_view::alignment();
+    write_pattern(pathname, size);
+    file_descriptor file;
+    file.open(pathname, access_mode::read_write, create_mode::open_existing);
+    ASSERT_EQ(true, file.is_open());
+    {
+        mapped_view view(file, mapped_view::alignment() + 5, 6, access_mode::read_write);
+        ASSERT_EQ(true, view.is_open());
+        std::memcpy(view.data(), "Hello!", 6);
+    }
+    file.close();
+    std::ifstream stream(pathname, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(size, contents.size());
+    ASSERT_EQ("Hello!", contents.substr(mapped_view::alignment() + 5, 6));
+    ASSERT_EQ(static_cast<char>((mapped_view::alignment() + 4) % 251), contents[mapped_view::alignment() + 4]);
+    std::remove(pathname.c_str());
+}
+
+// Cache hits, misses, and eviction.
+TEST(mapped_view_testing, test_mapped_view_2)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_view_2");
+    const size_t window_size = mapped_view::alignment();
+    const size_t size = 8 * window_size + 100;
+    write_pattern(pathname, size);
+    file_descriptor file;
+    file.open(pathname, access_mode::read, create_mode::open_existing);
+    mapped_view_cache cache(file, window_size, 2);
+    ASSERT_EQ(window_size, cache.window_size());
+    ASSERT_EQ(2, cache.capacity());
+    auto view0 = cache.get(10, 10);
+    ASSERT_EQ(0, view0->offset());
+    ASSERT_EQ(window_size, view0->size());
+    ASSERT_EQ(0, cache.hits());
+    ASSERT_EQ(1, cache.misses());
+    cache.get(window_size - 10, 10);
+    ASSERT_EQ(1, cache.hits());
+    cache.get(window_size, 10);
+    ASSERT_EQ(2, cache.misses());
+    ASSERT_EQ(2, cache.size());
+    // Window 0 is the least recently used window, touch it so window 1 is evicted next.
+    cache.get(0, 1);
+    ASSERT_EQ(2, cache.hits());
+    cache.get(2 * window_size, 1);
+    ASSERT_EQ(3, cache.misses());
+    ASSERT_EQ(2, cache.size());
+    cache.get(0, 1);
+    ASSERT_EQ(3, cache.hits());
+    cache.get(window_size, 1);
+    ASSERT_EQ(4, cache.misses());
+    // A range crossing a window boundary.
+    auto view1 = cache.get(3 * window_size - 5, 10);
+    ASSERT_EQ(true, view1->contains(3 * window_size - 5, 10));
+    // The last window is clipped to the file.
+    auto view2 = cache.get(size - 1, 1);
+    ASSERT_EQ(8 * window_size, view2->offset());
+    ASSERT_EQ(100, view2->size());
+    // Evicted views remain valid while referenced.
+    cache.clear();
+    ASSERT_EQ(0, cache.size());
+    ASSERT_EQ(static_cast<char>(10 % 251), view0->data()[10]);
+    // Out of bounds.
+    ASSERT_THROW(cache.get(size - 1, 2), id::file_system::error);
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+// Reading across windows.
+TEST(mapped_view_testing, test_mapped_view_3)
+{
+    using namespace id::file_system;
+    auto pathname = temporary_pathname("mapped_view_3");
+    const size_t window_size = mapped_view::alignment();
+    const size_t size = 5 * window_size + 77;
+    write_pattern(pathname, size);
+    file_descriptor file;
+    file.open(pathname, access_mode::read, create_mode::open_existing);
+    mapped_view_cache cache(file, window_size, 3);
+    std::vector<char> buffer(size);
+    cache.read(0, buffer.data(), size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ASSERT_EQ(static_cast<char>(i % 251), buffer[i]);
+    }
+    ASSERT_EQ(3, cache.size());
+    cache.read(window_size / 2, buffer.data(), 2 * window_size);
+    for (size_t i = 0; i < 2 * window_size; ++i)
+    {
+        ASSERT_EQ(static_cast<char>((window_size / 2 + i) % 251), buffer[i]);
+    }
+    ASSERT_THROW(cache.read(size - 10, buffer.data(), 11), id::file_system::error);
+    ASSERT_THROW(mapped_view_cache(file, window_size, 0), id::file_system::error);
+    file.close();
+    std::remove(pathname.c_str());
+}
+
+} } } // namespace id::tests::file_system
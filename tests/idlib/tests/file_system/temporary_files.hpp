@@ -0,0 +1,50 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include <filesystem>
+
+namespace id { namespace tests { namespace file_system {
+
+// Get the pathname of a temporary file for a test. An existing file of that pathname is removed.
+inline std::string temporary_pathname(const std::string& name)
+{
+    std::string pathname = ::testing::TempDir() + "idlib-" + name;
+    std::remove(pathname.c_str());
+    return pathname;
+}
+
+// Create an empty temporary directory for a test. An existing directory of that pathname is removed.
+inline std::string make_temporary_directory(const std::string& name)
+{
+    std::string root = ::testing::TempDir() + "idlib-" + name;
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    return root;
+}
+
+// Get the contents of a file.
+inline std::string read_file(const std::string& pathname)
+{
+    std::ifstream stream(pathname, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+} } } // namespace id::tests::file_system
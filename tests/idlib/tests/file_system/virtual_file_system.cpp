@@ -0,0 +1,149 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+#include "idlib/tests/file_system/temporary_files.hpp"
+#include <filesystem>
+
+namespace id { namespace tests { namespace file_system {
+
+namespace {
+
+// Get the contents of a file of a virtual file system or "<missing>".
+std::string read_virtual_file(const id::file_system::virtual_file_system& vfs, const std::string& pathname)
+{
+    id::file_system::virtual_file file;
+    return vfs.open(pathname, file) ? std::string(file.contents()) : std::string("<missing>");
+}
+
+} // namespace
+
+// Normalizing virtual pathnames.
+TEST(virtual_file_system_testing, test_virtual_file_system_0)
+{
+    using namespace id::file_system;
+    std::string normalized;
+    ASSERT_TRUE(normalize_virtual_path("/textures//wood/../stone.png", normalized));
+    ASSERT_EQ("textures/stone.png", normalized);
+    ASSERT_TRUE(normalize_virtual_path("a\\b/./c/", normalized));
+    ASSERT_EQ("a/b/c", normalized);
+    ASSERT_TRUE(normalize_virtual_path("", normalized));
+    ASSERT_EQ("", normalized);
+    ASSERT_FALSE(normalize_virtual_path("a/../../b", normalized));
+}
+
+// Building and reading pack archives.
+TEST(virtual_file_system_testing, test_virtual_file_system_1)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("virtual_file_system_1");
+    std::string separator = get_directory_separator();
+    std::string pathname = root + separator + "test.pack";
+    std::ofstream(root + separator + "loose", std::ios::binary) << "loose contents";
+    pack_builder builder;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        std::string contents(i, char('a' + i % 26));
+        builder.add("dir" + std::to_string(i % 7) + "/file" + std::to_string(i), contents.data(), contents.size());
+    }
+    builder.add_file("/x/./loose", root + separator + "loose");
+    builder.build(pathname);
+    pack_archive archive;
+    archive.open(pathname);
+    ASSERT_TRUE(archive.is_open());
+    ASSERT_EQ(101, archive.size());
+    for (size_t i = 0; i < 100; ++i)
+    {
+        size_t index = archive.find("dir" + std::to_string(i % 7) + "/file" + std::to_string(i));
+        ASSERT_NE(pack_archive::npos, index);
+        ASSERT_EQ(std::string(i, char('a' + i % 26)), archive.contents(index));
+        ASSERT_EQ(0, (uintptr_t)archive.contents(index).data() % pack_archive::data_alignment);
+    }
+    ASSERT_EQ("loose contents", archive.contents(archive.find("x/loose")));
+    ASSERT_EQ(pack_archive::npos, archive.find("dir0/file1"));
+    ASSERT_EQ(pack_archive::npos, archive.find("missing"));
+    archive.close();
+    // Duplicate names are rejected and neither the archive nor a temporary file is written.
+    builder.add("dir0/file0", "", 0);
+    ASSERT_THROW(builder.build(pathname), id::file_system::error);
+    ASSERT_EQ(2, std::distance(std::filesystem::directory_iterator(root), std::filesystem::directory_iterator()));
+    archive.open(pathname);
+    ASSERT_TRUE(archive.is_open());
+    ASSERT_EQ(101, archive.size());
+    archive.close();
+    // Corrupted archives are rejected.
+    {
+        std::fstream file(pathname, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(100);
+        file.put('!');
+    }
+    archive.open(pathname);
+    ASSERT_FALSE(archive.is_open());
+    archive.open(root + separator + "loose");
+    ASSERT_FALSE(archive.is_open());
+}
+
+// Mounting directories and pack archives.
+TEST(virtual_file_system_testing, test_virtual_file_system_2)
+{
+    using namespace id::file_system;
+    std::string root = make_temporary_directory("virtual_file_system_2");
+    std::string separator = get_directory_separator();
+    std::filesystem::create_directories(root + separator + "assets" + separator + "textures");
+    std::filesystem::create_directories(root + separator + "mods");
+    std::ofstream(root + separator + "assets" + separator + "textures" + separator + "wood") << "wood (pack)";
+    std::ofstream(root + separator + "assets" + separator + "readme") << "readme (pack)";
+    std::ofstream(root + separator + "mods" + separator + "wood") << "wood (mod)";
+    std::ofstream(root + separator + "mods" + separator + "stone") << "stone (mod)";
+    pack_builder builder;
+    builder.add_directory(root + separator + "assets");
+    ASSERT_EQ(2, builder.size());
+    builder.build(root + separator + "assets.pack");
+
+    virtual_file_system vfs;
+    vfs.mount_pack("data", root + separator + "assets.pack");
+    ASSERT_EQ("wood (pack)", read_virtual_file(vfs, "data/textures/wood"));
+    ASSERT_EQ("readme (pack)", read_virtual_file(vfs, "/data/./readme"));
+    ASSERT_EQ("<missing>", read_virtual_file(vfs, "textures/wood"));
+    ASSERT_EQ("<missing>", read_virtual_file(vfs, "data"));
+    ASSERT_FALSE(vfs.exists("data/textures"));
+    // A directory mounted later shadows the pack archive.
+    vfs.mount_directory("data/textures", root + separator + "mods");
+    ASSERT_EQ("wood (mod)", read_virtual_file(vfs, "data/textures/wood"));
+    ASSERT_EQ("stone (mod)", read_virtual_file(vfs, "data/textures/stone"));
+    ASSERT_TRUE(vfs.exists("data/textures/stone"));
+    // A pack archive mounted later shadows the directory.
+    vfs.mount_pack("data", root + separator + "assets.pack");
+    ASSERT_EQ("wood (pack)", read_virtual_file(vfs, "data/textures/wood"));
+    ASSERT_EQ("stone (mod)", read_virtual_file(vfs, "data/textures/stone"));
+    ASSERT_TRUE(vfs.unmount("data"));
+    ASSERT_EQ("wood (mod)", read_virtual_file(vfs, "data/textures/wood"));
+    // Files remain valid after their storage was unmounted.
+    virtual_file file;
+    ASSERT_TRUE(vfs.open("data/readme", file));
+    ASSERT_TRUE(vfs.unmount("data"));
+    ASSERT_TRUE(vfs.unmount("data/textures"));
+    ASSERT_FALSE(vfs.unmount("data"));
+    ASSERT_EQ(0, vfs.number_of_mounts());
+    ASSERT_EQ("readme (pack)", file.contents());
+    ASSERT_FALSE(vfs.exists("data/readme"));
+    ASSERT_THROW(vfs.mount_pack("", root + separator + "missing.pack"), id::file_system::error);
+}
+
+} } } // namespace id::tests::file_system
@@ -87,4 +87,35 @@ TEST(signal_testing, test_signal_4)
     ASSERT_EQ(false, invoked);
 }
 
+// Rvalue reference, move-only, and by-value parameters.
+TEST(signal_testing, test_signal_5)
+{
+    // (1) Rvalue reference parameters are forwarded as rvalue references.
+    std::string received;
+    id::signal<void(std::string&&)> rvalue_signal;
+    auto c0 = rvalue_signal.subscribe([&received](std::string&& s) { received = std::move(s); });
+    rvalue_signal(std::string("Hello, World!"));
+    ASSERT_EQ("Hello, World!", received);
+    // (2) A move-only argument is moved to the subscriber.
+    int value = 0;
+    id::signal<void(std::unique_ptr<int>)> move_only_signal;
+    auto c1 = move_only_signal.subscribe([&value](std::unique_ptr<int> p) { value = *p; });
+    move_only_signal(std::make_unique<int>(42));
+    ASSERT_EQ(42, value);
+    id::task_group group;
+    move_only_signal.emit(group, std::make_unique<int>(43));
+    ASSERT_EQ(43, value);
+    // (3) Each subscriber taking a copyable parameter by value receives the same value.
+    std::vector<std::string> values;
+    id::signal<void(std::string)> value_signal;
+    auto c2 = value_signal.subscribe([&values](std::string s) { values.push_back(std::move(s)); });
+    auto c3 = value_signal.subscribe([&values](std::string s) { values.push_back(std::move(s)); });
+    value_signal(std::string("Hello, World!"));
+    ASSERT_EQ(std::vector<std::string>({ "Hello, World!", "Hello, World!" }), values);
+    // (4) Combining with rvalue reference parameters.
+    id::signal<size_t(std::string&&)> combined_signal;
+    auto c4 = combined_signal.subscribe([](std::string&& s) { return s.size(); });
+    ASSERT_EQ(13, combined_signal.collect(id::combiners::sum<size_t>(), std::string("Hello, World!")));
+}
+
 } } } // namespace id::tests::signal
@@ -0,0 +1,90 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Asynchronous subscribers run on the pool and can be joined by the emitter.
+TEST(async_slot_testing, test_async_slot_0)
+{
+    id::thread_pool pool(2);
+    id::signal<void(const std::string&, int)> signal;
+    std::mutex mutex;
+    std::vector<std::string> received;
+    std::thread::id emitter = std::this_thread::get_id();
+    bool on_emitter = false;
+    auto c1 = signal.subscribe_async(pool, [&](const std::string& s, int x)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        on_emitter = on_emitter || std::this_thread::get_id() == emitter;
+        received.push_back(s + std::to_string(x));
+    });
+    int synchronous = 0;
+    auto c2 = signal.subscribe([&synchronous](const std::string&, int) { synchronous++; });
+    id::task_group group;
+    for (int i = 0; i < 10; ++i)
+    {
+        // The argument is a temporary: the asynchronous subscriber must receive a copy.
+        signal.emit(group, std::string("value"), i);
+    }
+    ASSERT_EQ(10, synchronous);
+    group.wait();
+    ASSERT_EQ(10, received.size());
+    ASSERT_EQ(false, on_emitter);
+    std::sort(received.begin(), received.end());
+    ASSERT_EQ("value0", received[0]);
+}
+
+// Exceptions of asynchronous subscribers are passed to the task group of the emission.
+TEST(async_slot_testing, test_async_slot_1)
+{
+    id::thread_pool pool(1);
+    id::signal<void(int)> signal;
+    auto c = signal.subscribe_async(pool, [](int x) { if (x) throw std::runtime_error("failure"); });
+    id::task_group group;
+    signal.emit(group, 0);
+    group.wait();
+    signal.emit(group, 1);
+    ASSERT_THROW(group.wait(), std::runtime_error);
+}
+
+// The function outlives its disconnected subscription until the pending tasks have run.
+TEST(async_slot_testing, test_async_slot_2)
+{
+    id::thread_pool pool(1);
+    auto counter = std::make_shared<std::atomic<int>>(0);
+    id::task_group group;
+    {
+        id::signal<void(std::shared_ptr<int>)> signal;
+        auto c = signal.subscribe_async(pool, [counter](std::shared_ptr<int> x) { *counter += *x; });
+        signal.emit(group, std::make_shared<int>(2));
+        signal(std::make_shared<int>(3));
+        c.disconnect();
+        signal.emit(group, std::make_shared<int>(5));
+    }
+    group.wait();
+    // The task without a group might still be pending.
+    while (*counter != 5)
+    {
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(5, counter->load());
+}
+
+} } } // namespace id::tests::signal
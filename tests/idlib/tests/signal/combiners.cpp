@@ -0,0 +1,77 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Sum and vector collection.
+TEST(combiners_testing, test_combiners_0)
+{
+    id::signal<int(int)> signal;
+    // (1) No subscriber.
+    ASSERT_EQ(0, signal.collect(id::combiners::sum<int>(), 1));
+    ASSERT_EQ(0, signal.collect(id::combiners::vector_collector<int>(), 1).size());
+    // (2) Three subscribers.
+    auto c1 = signal.subscribe([](int x) { return x; });
+    auto c2 = signal.subscribe([](int x) { return x * 10; });
+    auto c3 = signal.subscribe([](int x) { return x * 100; });
+    ASSERT_EQ(111, signal.collect(id::combiners::sum<int>(), 1));
+    ASSERT_EQ(1111, signal.collect(id::combiners::sum<int>(1000), 1));
+    auto values = signal.collect(id::combiners::vector_collector<int>(), 2);
+    ASSERT_EQ(3, values.size());
+    ASSERT_EQ(222, values[0] + values[1] + values[2]);
+    // (3) Disconnected subscribers do not contribute.
+    c2.disconnect();
+    ASSERT_EQ(101, signal.collect(id::combiners::sum<int>(), 1));
+}
+
+// Short-circuiting: the first subscriber returning true stops the emission.
+TEST(combiners_testing, test_combiners_1)
+{
+    id::signal<bool(int)> signal;
+    int invoked = 0;
+    auto c1 = signal.subscribe([&invoked](int x) { invoked++; return false; });
+    auto c2 = signal.subscribe([&invoked](int x) { invoked++; return x == 1; });
+    auto c3 = signal.subscribe([&invoked](int x) { invoked++; return false; });
+    // Nodes are invoked in reverse order of subscription.
+    ASSERT_EQ(true, signal.collect(id::combiners::until_true(), 1));
+    ASSERT_EQ(2, invoked);
+    invoked = 0;
+    ASSERT_EQ(false, signal.collect(id::combiners::until_true(), 0));
+    ASSERT_EQ(3, invoked);
+    invoked = 0;
+    ASSERT_EQ(false, signal.collect(id::combiners::all_of(), 0));
+    ASSERT_EQ(1, invoked);
+}
+
+// First non-empty and last value.
+TEST(combiners_testing, test_combiners_2)
+{
+    id::signal<const char *(int)> signal;
+    ASSERT_EQ(nullptr, signal.collect(id::combiners::first_non_empty<const char *>(), 0));
+    auto c1 = signal.subscribe([](int x) -> const char * { return "first"; });
+    auto c2 = signal.subscribe([](int x) -> const char * { return x ? "second" : nullptr; });
+    ASSERT_EQ(std::string("second"), signal.collect(id::combiners::first_non_empty<const char *>(), 1));
+    ASSERT_EQ(std::string("first"), signal.collect(id::combiners::first_non_empty<const char *>(), 0));
+    ASSERT_EQ(std::string("first"), signal.collect(id::combiners::last_value<const char *>(), 1));
+    // The plain emission discards the return values.
+    signal(1);
+}
+
+} } } // namespace id::tests::signal
@@ -0,0 +1,124 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Connection, invocation, and explicit disconnection.
+TEST(concurrent_signal_testing, test_concurrent_signal_0)
+{
+    id::concurrent_signal<void(const std::string&)> signal;
+    // (1) Invoke with no subscriber.
+    signal("Hello, World!");
+    // (2) Invoke with one subscriber.
+    int invoked = 0;
+    auto connection = signal.subscribe([&invoked](const std::string& s) { invoked++; });
+    ASSERT_EQ(true, connection.is_connected());
+    signal("Hello, World!");
+    connection.disconnect();
+    ASSERT_EQ(false, connection.is_connected());
+    signal("Hello, World!");
+    ASSERT_EQ(1, invoked);
+}
+
+// Implicit disconnection (upon destruction of a signal).
+TEST(concurrent_signal_testing, test_concurrent_signal_1)
+{
+    id::concurrent_connection connection;
+    {
+        id::concurrent_signal<void(int)> signal;
+        connection = signal.subscribe([](int) {});
+        ASSERT_EQ(true, connection.is_connected());
+    }
+    ASSERT_EQ(false, connection.is_connected());
+    connection.disconnect();
+}
+
+// Subscription and disconnection from within a slot.
+TEST(concurrent_signal_testing, test_concurrent_signal_2)
+{
+    id::concurrent_signal<void()> signal;
+    int invoked = 0;
+    id::concurrent_connection self, other;
+    self = signal.subscribe([&]()
+    {
+        invoked++;
+        self.disconnect();
+        other = signal.subscribe([&invoked]() { invoked += 10; });
+    });
+    signal();
+    ASSERT_EQ(1, invoked);
+    signal();
+    ASSERT_EQ(11, invoked);
+}
+
+// Concurrent emission, subscription, and disconnection.
+TEST(concurrent_signal_testing, test_concurrent_signal_3)
+{
+    static const int number_of_emitters = 8;
+    static const int number_of_emissions = 20000;
+    id::concurrent_signal<void(int)> signal;
+    std::atomic<int64_t> sum(0);
+    auto permanent = signal.subscribe([&sum](int x) { sum.fetch_add(x); });
+    std::atomic<bool> stop(false);
+    std::thread churner([&]()
+    {
+        while (!stop.load())
+        {
+            auto connection = signal.subscribe([](int) {});
+            connection.disconnect();
+        }
+    });
+    std::vector<std::thread> emitters;
+    for (int i = 0; i < number_of_emitters; ++i)
+    {
+        emitters.emplace_back([&signal]()
+        {
+            for (int j = 0; j < number_of_emissions; ++j)
+            {
+                signal(1);
+            }
+        });
+    }
+    for (auto& emitter : emitters)
+    {
+        emitter.join();
+    }
+    stop.store(true);
+    churner.join();
+    ASSERT_EQ(int64_t(number_of_emitters) * number_of_emissions, sum.load());
+}
+
+// Rvalue reference and move-only parameters.
+TEST(concurrent_signal_testing, test_concurrent_signal_4)
+{
+    id::concurrent_signal<void(std::string&&)> signal_1;
+    std::string received;
+    signal_1.subscribe([&received](std::string&& x) { received = std::move(x); });
+    signal_1(std::string("hello"));
+    ASSERT_EQ("hello", received);
+
+    id::concurrent_signal<void(std::unique_ptr<int>)> signal_2;
+    int value = 0;
+    signal_2.subscribe([&value](std::unique_ptr<int> x) { value = *x; });
+    signal_2(std::make_unique<int>(42));
+    ASSERT_EQ(42, value);
+}
+
+} } } // namespace id::tests::signal
@@ -0,0 +1,120 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Blocking and unblocking a connection.
+TEST(connection_group_testing, test_shared_connection_block_0)
+{
+    id::signal<void()> signal;
+    int invoked = 0;
+    auto connection = signal.subscribe([&invoked]() { invoked++; });
+    {
+        id::shared_connection_block block(connection);
+        ASSERT_EQ(true, block.blocking());
+        ASSERT_EQ(true, connection.is_blocked());
+        ASSERT_EQ(true, connection.is_connected());
+        signal();
+        ASSERT_EQ(0, invoked);
+        // A copy of a blocking block is blocking.
+        id::shared_connection_block copy(block);
+        block.unblock();
+        ASSERT_EQ(true, connection.is_blocked());
+        signal();
+        ASSERT_EQ(0, invoked);
+        copy.unblock();
+        ASSERT_EQ(false, connection.is_blocked());
+        signal();
+        ASSERT_EQ(1, invoked);
+        block.block();
+    }
+    // The block unblocks on destruction.
+    ASSERT_EQ(false, connection.is_blocked());
+    signal();
+    ASSERT_EQ(2, invoked);
+    // A block which is not initially blocking.
+    id::shared_connection_block block(connection, false);
+    ASSERT_EQ(false, block.blocking());
+    signal();
+    ASSERT_EQ(3, invoked);
+}
+
+// Disconnecting all connections of a group.
+TEST(connection_group_testing, test_connection_group_0)
+{
+    id::signal<void()> first, second;
+    int invoked = 0;
+    id::connection outside = first.subscribe([&invoked]() { invoked += 100; });
+    id::connection kept;
+    {
+        id::connection_group group;
+        for (int i = 0; i < 16; ++i)
+        {
+            group += first.subscribe([&invoked]() { invoked++; });
+            group += second.subscribe([&invoked]() { invoked++; });
+        }
+        kept = first.subscribe([&invoked]() { invoked += 1000; });
+        group.add(kept);
+        ASSERT_EQ(33, group.size());
+        first();
+        second();
+        ASSERT_EQ(1132, invoked);
+        invoked = 0;
+        group.disconnect_all();
+        ASSERT_EQ(true, group.empty());
+        ASSERT_EQ(false, kept.is_connected());
+        ASSERT_EQ(true, outside.is_connected());
+        first();
+        second();
+        ASSERT_EQ(100, invoked);
+        // The group is reusable.
+        group += second.subscribe([&invoked]() { invoked++; });
+    }
+    // The group disconnects on destruction.
+    invoked = 0;
+    second();
+    ASSERT_EQ(0, invoked);
+}
+
+// Blocking all connections of a group.
+TEST(connection_group_testing, test_connection_group_1)
+{
+    id::signal<void()> signal;
+    int invoked = 0;
+    id::connection_group group;
+    group += signal.subscribe([&invoked]() { invoked++; });
+    group += signal.subscribe([&invoked]() { invoked++; });
+    group.block_all();
+    ASSERT_EQ(true, group.is_blocked());
+    group += signal.subscribe([&invoked]() { invoked++; });
+    signal();
+    ASSERT_EQ(0, invoked);
+    group.unblock_all();
+    signal();
+    ASSERT_EQ(3, invoked);
+    // Disconnecting from within an emission.
+    group += signal.subscribe([&group]() { group.disconnect_all(); });
+    signal();
+    invoked = 0;
+    signal();
+    ASSERT_EQ(0, invoked);
+}
+
+} } } // namespace id::tests::signal
@@ -0,0 +1,125 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Connection, invocation, and explicit disconnection.
+TEST(dense_signal_testing, test_dense_signal_0)
+{
+    id::dense_signal<void(const std::string&)> signal;
+    // (1) Invoke with no subscriber.
+    signal("Hello, World!");
+    // (2) Invoke with one subscriber.
+    int invoked = 0;
+    auto connection = signal.subscribe([&invoked](const std::string& s) { invoked++; });
+    ASSERT_EQ(true, connection.is_connected());
+    signal("Hello, World!");
+    connection.disconnect();
+    ASSERT_EQ(false, connection.is_connected());
+    signal("Hello, World!");
+    ASSERT_EQ(1, invoked);
+    ASSERT_EQ(0, signal.size());
+}
+
+// Implicit disconnection (upon destruction of a signal).
+TEST(dense_signal_testing, test_dense_signal_1)
+{
+    id::dense_connection connection;
+    {
+        id::dense_signal<void(int)> signal;
+        connection = signal.subscribe([](int) {});
+        ASSERT_EQ(true, connection.is_connected());
+    }
+    ASSERT_EQ(false, connection.is_connected());
+    connection.disconnect();
+}
+
+// Connections of removed slots stay invalid if their entries are reused.
+TEST(dense_signal_testing, test_dense_signal_2)
+{
+    id::dense_signal<void(int)> signal;
+    int sum = 0;
+    std::vector<id::dense_connection> connections;
+    for (int i = 0; i < 100; ++i)
+    {
+        connections.push_back(signal.subscribe([&sum, i](int x) { sum += i * x; }));
+    }
+    // Disconnect the even slots.
+    for (int i = 0; i < 100; i += 2)
+    {
+        auto copy = connections[i];
+        connections[i].disconnect();
+        ASSERT_EQ(false, copy.is_connected());
+    }
+    ASSERT_EQ(50, signal.size());
+    // Reuse the entries.
+    auto reused = signal.subscribe([&sum](int x) { sum += 1000 * x; });
+    for (int i = 1; i < 100; i += 2)
+    {
+        ASSERT_EQ(true, connections[i].is_connected());
+    }
+    signal(1);
+    ASSERT_EQ(2500 + 1000, sum);
+}
+
+// Subscription, disconnection, and emission from within a slot.
+TEST(dense_signal_testing, test_dense_signal_3)
+{
+    id::dense_signal<void(int)> signal;
+    int invoked = 0;
+    std::vector<id::dense_connection> connections;
+    id::dense_connection self;
+    self = signal.subscribe([&](int depth)
+    {
+        invoked++;
+        for (int i = 0; i < 32; ++i)
+        {
+            connections.push_back(signal.subscribe([&invoked](int) { invoked += 100; }));
+        }
+        if (depth > 0)
+        {
+            signal(depth - 1);
+        }
+        self.disconnect();
+    });
+    signal(1);
+    ASSERT_EQ(2, invoked);
+    ASSERT_EQ(64, signal.size());
+    signal(0);
+    ASSERT_EQ(2 + 64 * 100, invoked);
+}
+
+// Rvalue reference and move-only parameters.
+TEST(dense_signal_testing, test_dense_signal_4)
+{
+    id::dense_signal<void(std::string&&)> signal_1;
+    std::string received;
+    signal_1.subscribe([&received](std::string&& x) { received = std::move(x); });
+    signal_1(std::string("hello"));
+    ASSERT_EQ("hello", received);
+
+    id::dense_signal<void(std::unique_ptr<int>)> signal_2;
+    int value = 0;
+    signal_2.subscribe([&value](std::unique_ptr<int> x) { value = *x; });
+    signal_2(std::make_unique<int>(42));
+    ASSERT_EQ(42, value);
+}
+
+} } } // namespace id::tests::signal
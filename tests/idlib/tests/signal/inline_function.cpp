@@ -0,0 +1,173 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+namespace {
+
+/// @brief The number of heap allocations of targets derived from counted_target.
+std::atomic<size_t> g_number_of_target_allocations(0);
+
+/// @brief Targets derived from this type count their heap allocations.
+struct counted_target
+{
+    static void *operator new(size_t size)
+    {
+        g_number_of_target_allocations++;
+        return ::operator new(size);
+    }
+
+    static void operator delete(void *pointer) noexcept
+    {
+        ::operator delete(pointer);
+    }
+};
+
+/// @brief A node allocator counting its allocations.
+struct counting_node_allocator
+{
+    static std::atomic<size_t> number_of_allocations;
+
+    static void *allocate(size_t size)
+    {
+        number_of_allocations++;
+        return id::default_node_allocator::allocate(size);
+    }
+
+    static void deallocate(void *pointer, size_t size) noexcept
+    {
+        id::default_node_allocator::deallocate(pointer, size);
+    }
+};
+
+std::atomic<size_t> counting_node_allocator::number_of_allocations(0);
+
+struct widget
+{
+    int id = 0;
+    int sum = 0;
+    void on_value(int x) { sum += x; }
+    int get() const { return id; }
+};
+
+/// @brief A target with a small capture.
+struct small_target : counted_target
+{
+    widget *w;
+    int id;
+    small_target(widget *w, int id) : w(w), id(id) {}
+    void operator()(int x) const { w->sum += x * id; }
+};
+
+/// @brief A target with a large capture.
+struct large_target : counted_target
+{
+    std::array<char, 128> large;
+    large_target() { large.fill('x'); }
+    char operator()() const { return large[0]; }
+};
+
+/// @brief A target of the size and alignment of a bound member function.
+struct bound_member_like
+{
+    widget *object;
+    void (widget::*method)(int);
+    void operator()(int x) const { (object->*method)(x); }
+};
+
+} // namespace
+
+// Small captures and bound member functions are stored inline.
+TEST(inline_function_testing, test_inline_function_0)
+{
+    widget w;
+    w.id = 7;
+    ASSERT_EQ(true, (id::inline_function<void(int)>::stores_inline<small_target>()));
+    ASSERT_EQ(true, (id::inline_function<void(int)>::stores_inline<bound_member_like>()));
+    size_t before = g_number_of_target_allocations;
+    id::inline_function<void(int)> f = small_target(&w, 3);
+    id::inline_function<void(int)> g(&w, &widget::on_value);
+    id::inline_function<int()> h(static_cast<const widget *>(&w), &widget::get);
+    f(1);
+    g(2);
+    ASSERT_EQ(before, g_number_of_target_allocations);
+    ASSERT_EQ(5, w.sum);
+    ASSERT_EQ(7, h());
+    // Moving does not allocate and leaves the source empty.
+    id::inline_function<void(int)> k = std::move(f);
+    ASSERT_EQ(false, static_cast<bool>(f));
+    k(1);
+    ASSERT_EQ(8, w.sum);
+    ASSERT_EQ(before, g_number_of_target_allocations);
+}
+
+// Large captures are stored on the heap.
+TEST(inline_function_testing, test_inline_function_1)
+{
+    std::array<char, 128> large;
+    large.fill('x');
+    auto lambda = [large]() { return large[0]; };
+    ASSERT_EQ(false, (id::inline_function<char()>::stores_inline<decltype(lambda)>()));
+    ASSERT_EQ(true, (id::inline_function<char(), 256>::stores_inline<decltype(lambda)>()));
+    size_t before = g_number_of_target_allocations;
+    id::inline_function<char()> f = large_target();
+    ASSERT_EQ(before + 1, g_number_of_target_allocations);
+    id::inline_function<char(), 256> g = large_target();
+    ASSERT_EQ(before + 1, g_number_of_target_allocations);
+    // Moving does not allocate.
+    id::inline_function<char()> k = std::move(f);
+    ASSERT_EQ(before + 1, g_number_of_target_allocations);
+    ASSERT_EQ('x', k());
+    ASSERT_EQ('x', g());
+    id::inline_function<char()> empty;
+    ASSERT_THROW(empty(), std::bad_function_call);
+}
+
+// Subscribing a small capture or a member function performs a single allocation (the node).
+TEST(inline_function_testing, test_inline_function_2)
+{
+    widget w;
+    id::signal<void(int), counting_node_allocator> signal;
+    size_t before_targets = g_number_of_target_allocations;
+    size_t before_nodes = counting_node_allocator::number_of_allocations;
+    auto c0 = signal.subscribe(small_target(&w, 1));
+    ASSERT_EQ(before_nodes + 1, counting_node_allocator::number_of_allocations);
+    auto c1 = signal.subscribe(&w, &widget::on_value);
+    ASSERT_EQ(before_nodes + 2, counting_node_allocator::number_of_allocations);
+    signal(1);
+    ASSERT_EQ(before_nodes + 2, counting_node_allocator::number_of_allocations);
+    ASSERT_EQ(before_targets, g_number_of_target_allocations);
+    ASSERT_EQ(2, w.sum);
+}
+
+// Arguments passed by value are not moved from by the first slot.
+TEST(inline_function_testing, test_inline_function_3)
+{
+    id::signal<void(std::string)> signal;
+    std::vector<std::string> received;
+    auto c0 = signal.subscribe([&received](std::string s) { received.push_back(std::move(s)); });
+    auto c1 = signal.subscribe([&received](std::string s) { received.push_back(std::move(s)); });
+    signal("Hello, World!");
+    ASSERT_EQ(2, received.size());
+    ASSERT_EQ("Hello, World!", received[0]);
+    ASSERT_EQ("Hello, World!", received[1]);
+}
+
+} } } // namespace id::tests::signal
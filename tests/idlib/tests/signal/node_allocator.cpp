@@ -0,0 +1,79 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Churning connections reuses pooled nodes.
+TEST(node_allocator_testing, test_pooled_node_allocator_0)
+{
+    id::pooled_node_allocator::trim();
+    auto before = id::pooled_node_allocator::statistics();
+    {
+        id::signal<void(int), id::pooled_node_allocator> signal;
+        int sum = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            id::scoped_connection connection(signal.subscribe([&sum](int x) { sum += x; }));
+            signal(1);
+        }
+        ASSERT_EQ(1000, sum);
+        auto during = id::pooled_node_allocator::statistics();
+        ASSERT_LE(999, during.allocations_avoided - before.allocations_avoided);
+    }
+    auto after = id::pooled_node_allocator::statistics();
+    ASSERT_EQ(before.live_nodes, after.live_nodes);
+    ASSERT_LE(1, after.pooled_nodes);
+    id::pooled_node_allocator::trim();
+    ASSERT_EQ(0, id::pooled_node_allocator::statistics().pooled_nodes);
+}
+
+// Connections outliving the signal release their nodes.
+TEST(node_allocator_testing, test_pooled_node_allocator_1)
+{
+    auto before = id::pooled_node_allocator::statistics();
+    {
+        id::connection c0, c1;
+        {
+            id::signal<void(), id::pooled_node_allocator> signal;
+            c0 = signal.subscribe([]() {});
+            c1 = c0;
+            ASSERT_EQ(before.live_nodes + 1, id::pooled_node_allocator::statistics().live_nodes);
+        }
+        ASSERT_EQ(false, c0.is_connected());
+        ASSERT_EQ(before.live_nodes + 1, id::pooled_node_allocator::statistics().live_nodes);
+    }
+    ASSERT_EQ(before.live_nodes, id::pooled_node_allocator::statistics().live_nodes);
+}
+
+// Nodes are released if a connection is disconnected explicitly.
+TEST(node_allocator_testing, test_pooled_node_allocator_2)
+{
+    auto before = id::pooled_node_allocator::statistics();
+    id::signal<void(), id::pooled_node_allocator> signal;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto connection = signal.subscribe([]() {});
+        connection.disconnect();
+    }
+    signal();
+    ASSERT_EQ(before.live_nodes, id::pooled_node_allocator::statistics().live_nodes);
+}
+
+} } } // namespace id::tests::signal
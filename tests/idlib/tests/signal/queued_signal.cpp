@@ -0,0 +1,156 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Emissions are delivered when the dispatcher dispatches them.
+TEST(queued_signal_testing, test_queued_signal_0)
+{
+    id::dispatcher dispatcher;
+    id::queued_signal<void(const std::string&)> signal(dispatcher);
+    std::vector<std::string> received;
+    auto connection = signal.subscribe([&received](const std::string& s) { received.push_back(s); });
+    signal(std::string("a"));
+    signal("b");
+    ASSERT_EQ(0, received.size());
+    ASSERT_EQ(2, dispatcher.size());
+    ASSERT_EQ(2, dispatcher.dispatch());
+    ASSERT_EQ(2, received.size());
+    ASSERT_EQ("a", received[0]);
+    ASSERT_EQ("b", received[1]);
+    ASSERT_EQ(0, dispatcher.dispatch());
+}
+
+// Emissions from multiple producers.
+TEST(queued_signal_testing, test_queued_signal_1)
+{
+    static const int number_of_threads = 4;
+    static const int number_of_emissions = 10000;
+    id::dispatcher dispatcher;
+    id::queued_signal<void(int, int)> signal(dispatcher);
+    std::vector<int> last(number_of_threads, -1);
+    bool ordered = true;
+    int received = 0;
+    auto connection = signal.subscribe([&](int thread, int value)
+    {
+        ordered = ordered && (last[thread] + 1 == value);
+        last[thread] = value;
+        received++;
+    });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < number_of_threads; ++i)
+    {
+        threads.emplace_back([&signal, i]()
+        {
+            for (int j = 0; j < number_of_emissions; ++j)
+            {
+                signal(i, j);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    while (dispatcher.dispatch(128) > 0)
+    {}
+    ASSERT_EQ(number_of_threads * number_of_emissions, received);
+    ASSERT_EQ(true, ordered);
+}
+
+// Coalescing.
+TEST(queued_signal_testing, test_queued_signal_2)
+{
+    id::dispatcher dispatcher;
+    id::queued_signal<void(int)> signal(dispatcher, true);
+    std::vector<int> received;
+    auto connection = signal.subscribe([&received](int x) { received.push_back(x); });
+    signal(1);
+    signal(2);
+    signal(3);
+    ASSERT_EQ(1, dispatcher.size());
+    dispatcher.dispatch();
+    ASSERT_EQ(1, received.size());
+    ASSERT_EQ(3, received[0]);
+    signal(4);
+    dispatcher.dispatch();
+    ASSERT_EQ(2, received.size());
+    ASSERT_EQ(4, received[1]);
+}
+
+// Re-entrant emissions are queued and not dropped.
+TEST(queued_signal_testing, test_queued_signal_3)
+{
+    id::dispatcher dispatcher;
+    id::queued_signal<void(int)> signal(dispatcher);
+    std::vector<int> received;
+    auto connection = signal.subscribe([&](int x)
+    {
+        received.push_back(x);
+        if (x < 3)
+        {
+            signal(x + 1);
+        }
+    });
+    signal(0);
+    ASSERT_EQ(1, dispatcher.dispatch(1));
+    ASSERT_EQ(1, received.size());
+    while (dispatcher.dispatch() > 0)
+    {}
+    ASSERT_EQ(4, received.size());
+    ASSERT_EQ(3, received[3]);
+}
+
+// Pending emissions are discarded if the signal is destroyed.
+TEST(queued_signal_testing, test_queued_signal_4)
+{
+    id::dispatcher dispatcher;
+    int invoked = 0;
+    {
+        id::queued_signal<void(std::shared_ptr<int>)> signal(dispatcher);
+        signal.subscribe([&invoked](std::shared_ptr<int>) { invoked++; });
+        signal(std::make_shared<int>(1));
+    }
+    ASSERT_EQ(1, dispatcher.dispatch());
+    ASSERT_EQ(0, invoked);
+}
+
+// A dispatch only executes the tasks pending on entry.
+TEST(queued_signal_testing, test_queued_signal_5)
+{
+    id::dispatcher dispatcher;
+    id::queued_signal<void(int)> signal(dispatcher);
+    int received = 0;
+    auto connection = signal.subscribe([&](int x)
+    {
+        received++;
+        signal(x + 1);
+    });
+    signal(0);
+    signal(0);
+    ASSERT_EQ(2, dispatcher.dispatch());
+    ASSERT_EQ(2, received);
+    ASSERT_EQ(2, dispatcher.size());
+    ASSERT_EQ(1, dispatcher.dispatch(1));
+    ASSERT_EQ(3, received);
+    ASSERT_EQ(2, dispatcher.size());
+}
+
+} } } // namespace id::tests::signal
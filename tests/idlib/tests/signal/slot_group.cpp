@@ -0,0 +1,96 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+#include "idlib/idlib.hpp"
+
+namespace id { namespace tests { namespace signal {
+
+// Subscribers are invoked in ascending order of their groups.
+TEST(slot_group_testing, test_slot_group_0)
+{
+    id::signal<void()> signal;
+    std::string order;
+    auto c1 = signal.subscribe(2, [&order]() { order += "c"; });
+    auto c2 = signal.subscribe(-1, [&order]() { order += "a"; });
+    auto c3 = signal.subscribe([&order]() { order += "b"; });
+    auto c4 = signal.subscribe(2, [&order]() { order += "d"; });
+    signal();
+    ASSERT_EQ("abdc", order);
+    // Disconnecting and sweeping preserves the order.
+    c3.disconnect();
+    order.clear();
+    signal();
+    ASSERT_EQ("adc", order);
+}
+
+// Groups can be enabled and disabled.
+TEST(slot_group_testing, test_slot_group_1)
+{
+    id::signal<int(int)> signal;
+    auto c1 = signal.subscribe(0, [](int x) { return x; });
+    auto c2 = signal.subscribe(1, [](int x) { return 10 * x; });
+    auto c3 = signal.subscribe(1, [](int x) { return 100 * x; });
+    auto group = signal.group(1);
+    ASSERT_EQ(1, group.get());
+    ASSERT_EQ(true, group.is_enabled());
+    ASSERT_EQ(111, signal.collect(id::combiners::sum<int>(), 1));
+    group.disable();
+    ASSERT_EQ(false, group.is_enabled());
+    ASSERT_EQ(1, signal.collect(id::combiners::sum<int>(), 1));
+    // Subscribers of a disabled group remain connected.
+    ASSERT_EQ(true, c2.is_connected());
+    // Subscribing to a disabled group.
+    auto c4 = signal.subscribe(1, [](int x) { return 1000 * x; });
+    ASSERT_EQ(1, signal.collect(id::combiners::sum<int>(), 1));
+    signal.group(1).enable();
+    ASSERT_EQ(1111, signal.collect(id::combiners::sum<int>(), 1));
+}
+
+// Short-circuiting stops at the first subscriber in group order.
+TEST(slot_group_testing, test_slot_group_2)
+{
+    id::signal<bool()> signal;
+    std::string order;
+    auto c1 = signal.subscribe(10, [&order]() { order += "background"; return true; });
+    auto c2 = signal.subscribe(0, [&order]() { order += "overlay"; return true; });
+    ASSERT_EQ(true, signal.collect(id::combiners::until_true()));
+    ASSERT_EQ("overlay", order);
+    order.clear();
+    signal.group(0).disable();
+    ASSERT_EQ(true, signal.collect(id::combiners::until_true()));
+    ASSERT_EQ("background", order);
+}
+
+// Subscribers subscribed without a group are in group 0.
+TEST(slot_group_testing, test_slot_group_3)
+{
+    id::signal<int(int)> signal;
+    auto c1 = signal.subscribe([](int x) { return x; });
+    auto c2 = signal.subscribe(0, [](int x) { return 10 * x; });
+    auto c3 = signal.subscribe(1, [](int x) { return 100 * x; });
+    ASSERT_EQ(111, signal.collect(id::combiners::sum<int>(), 1));
+    signal.group(0).disable();
+    ASSERT_EQ(100, signal.collect(id::combiners::sum<int>(), 1));
+    // Subscribing without a group to a disabled group 0.
+    auto c4 = signal.subscribe([](int x) { return 1000 * x; });
+    ASSERT_EQ(100, signal.collect(id::combiners::sum<int>(), 1));
+    signal.group(0).enable();
+    ASSERT_EQ(1111, signal.collect(id::combiners::sum<int>(), 1));
+}
+
+} } } // namespace id::tests::signal
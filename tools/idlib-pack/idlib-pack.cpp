@@ -0,0 +1,85 @@
+// Copyright Michael Heilmann 2016, 2017.
+//
+// This file is part of Idlib.
+//
+// Idlib is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Idlib is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Idlib. If not, see <http://www.gnu.org/licenses/>.
+
+/// @file tools/idlib-pack/idlib-pack.cpp
+/// @brief Command-line tool creating and listing pack archives.
+/// @author Michael Heilmann
+
+#include "idlib/idlib.hpp"
+
+namespace {
+
+int usage()
+{
+    std::cerr << "usage: idlib-pack create <archive> <directory> [<prefix>]" << std::endl
+              << "       idlib-pack list <archive>" << std::endl;
+    return EXIT_FAILURE;
+}
+
+int create(const std::string& archive, const std::string& directory, const std::string& prefix)
+{
+    id::file_system::pack_builder builder;
+    builder.add_directory(directory, prefix);
+    builder.build(archive);
+    std::cout << "packed " << builder.size() << " files into `" << archive << "`" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int list(const std::string& pathname)
+{
+    id::file_system::pack_archive archive;
+    archive.open(pathname);
+    if (!archive.is_open())
+    {
+        std::cerr << "unable to open pack archive `" << pathname << "`" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0, n = archive.size(); i < n; ++i)
+    {
+        std::cout << std::setw(12) << archive.contents(i).size() << " " << archive.name(i) << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        const std::vector<std::string> arguments(argv + 1, argv + argc);
+        if (arguments.size() >= 3 && arguments.size() <= 4 && "create" == arguments[0])
+        {
+            return create(arguments[1], arguments[2], arguments.size() == 4 ? arguments[3] : std::string());
+        }
+        if (arguments.size() == 2 && "list" == arguments[0])
+        {
+            return list(arguments[1]);
+        }
+        return usage();
+    }
+    catch (const id::exception& exception)
+    {
+        std::cerr << exception.to_string() << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}